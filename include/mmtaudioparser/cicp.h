@@ -0,0 +1,173 @@
+/*-----------------------------------------------------------------------------
+Software License for The Fraunhofer FDK MPEG-H Software
+
+Copyright (c) 2024 Fraunhofer-Gesellschaft zur Förderung der angewandten
+Forschung e.V. and Contributors
+All rights reserved.
+
+1. INTRODUCTION
+
+The "Fraunhofer FDK MPEG-H Software" is software that implements the ISO/MPEG
+MPEG-H 3D Audio standard for digital audio or related system features. Patent
+licenses for necessary patent claims for the Fraunhofer FDK MPEG-H Software
+(including those of Fraunhofer), for the use in commercial products and
+services, may be obtained from the respective patent owners individually and/or
+from Via LA (www.via-la.com).
+
+Fraunhofer supports the development of MPEG-H products and services by offering
+additional software, documentation, and technical advice. In addition, it
+operates the MPEG-H Trademark Program to ease interoperability testing of end-
+products. Please visit www.mpegh.com for more information.
+
+2. COPYRIGHT LICENSE
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted without payment of copyright license fees provided that you
+satisfy the following conditions:
+
+* You must retain the complete text of this software license in redistributions
+of the Fraunhofer FDK MPEG-H Software or your modifications thereto in source
+code form.
+
+* You must retain the complete text of this software license in the
+documentation and/or other materials provided with redistributions of
+the Fraunhofer FDK MPEG-H Software or your modifications thereto in binary form.
+You must make available free of charge copies of the complete source code of
+the Fraunhofer FDK MPEG-H Software and your modifications thereto to recipients
+of copies in binary form.
+
+* The name of Fraunhofer may not be used to endorse or promote products derived
+from the Fraunhofer FDK MPEG-H Software without prior written permission.
+
+* You may not charge copyright license fees for anyone to use, copy or
+distribute the Fraunhofer FDK MPEG-H Software or your modifications thereto.
+
+* Your modified versions of the Fraunhofer FDK MPEG-H Software must carry
+prominent notices stating that you changed the software and the date of any
+change. For modified versions of the Fraunhofer FDK MPEG-H Software, the term
+"Fraunhofer FDK MPEG-H Software" must be replaced by the term "Third-Party
+Modified Version of the Fraunhofer FDK MPEG-H Software".
+
+3. No PATENT LICENSE
+
+NO EXPRESS OR IMPLIED LICENSES TO ANY PATENT CLAIMS, including without
+limitation the patents of Fraunhofer, ARE GRANTED BY THIS SOFTWARE LICENSE.
+Fraunhofer provides no warranty of patent non-infringement with respect to this
+software. You may use this Fraunhofer FDK MPEG-H Software or modifications
+thereto only for purposes that are authorized by appropriate patent licenses.
+
+4. DISCLAIMER
+
+This Fraunhofer FDK MPEG-H Software is provided by Fraunhofer on behalf of the
+copyright holders and contributors "AS IS" and WITHOUT ANY EXPRESS OR IMPLIED
+WARRANTIES, including but not limited to the implied warranties of
+merchantability and fitness for a particular purpose. IN NO EVENT SHALL THE
+COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE for any direct, indirect,
+incidental, special, exemplary, or consequential damages, including but not
+limited to procurement of substitute goods or services; loss of use, data, or
+profits, or business interruption, however caused and on any theory of
+liability, whether in contract, strict liability, or tort (including
+negligence), arising in any way out of the use of this software, even if
+advised of the possibility of such damage.
+
+5. CONTACT INFORMATION
+
+Fraunhofer Institute for Integrated Circuits IIS
+Attention: Division Audio and Media Technologies - MPEG-H FDK
+Am Wolfsmantel 33
+91058 Erlangen, Germany
+www.iis.fraunhofer.de/amm
+amm-info@iis.fraunhofer.de
+-----------------------------------------------------------------------------*/
+
+/*!
+ * @file cicp.h
+ *
+ * @brief Compile-time tables of the coding-independent code points for loudspeaker setups as
+ * defined in ISO/IEC 23091-3.
+ */
+
+#pragma once
+
+// System includes
+#include <cstddef>
+#include <cstdint>
+
+// External includes
+
+// Internal includes
+#include "mmtaudioparser/version.h"
+
+namespace mmt {
+namespace audioparser {
+namespace cicp {
+//! Position of a loudspeaker identified by a CICP SpeakerPosition index.
+struct SSpeakerGeometry {
+  //! Azimuth in degrees, positive values to the left.
+  int16_t azimuth;
+  //! Elevation in degrees, positive values above the listener.
+  int16_t elevation;
+  //! Whether the loudspeaker is a low frequency effects loudspeaker.
+  bool isLFE;
+  //! Whether the azimuth depends on the screen size, it is given as 0 then.
+  bool isScreenRelative;
+  //! Whether the index is defined, all other fields are 0 otherwise.
+  bool isValid;
+};
+
+//! Number of SpeakerPosition indices, all larger indices are reserved.
+constexpr uint8_t NUM_SPEAKER_INDICES = 43;
+//! Number of ChannelConfiguration indices, all larger indices are reserved.
+constexpr uint8_t NUM_LAYOUT_INDICES = 21;
+
+namespace detail {
+struct STables {
+  static constexpr SSpeakerGeometry SPEAKERS[NUM_SPEAKER_INDICES] = {
+      {30, 0, false, false, true},     {-30, 0, false, false, true},    // 0 - 1
+      {0, 0, false, false, true},      {0, -15, true, false, true},     // 2 - 3
+      {110, 0, false, false, true},    {-110, 0, false, false, true},   // 4 - 5
+      {22, 0, false, false, true},     {-22, 0, false, false, true},    // 6 - 7
+      {135, 0, false, false, true},    {-135, 0, false, false, true},   // 8 - 9
+      {180, 0, false, false, true},    {0, 0, false, false, false},     // 10 - 11
+      {0, 0, false, false, false},     {90, 0, false, false, true},     // 12 - 13
+      {-90, 0, false, false, true},    {60, 0, false, false, true},     // 14 - 15
+      {-60, 0, false, false, true},    {30, 35, false, false, true},    // 16 - 17
+      {-30, 35, false, false, true},   {0, 35, false, false, true},     // 18 - 19
+      {135, 35, false, false, true},   {-135, 35, false, false, true},  // 20 - 21
+      {180, 35, false, false, true},   {90, 35, false, false, true},    // 22 - 23
+      {-90, 35, false, false, true},   {0, 90, false, false, true},     // 24 - 25
+      {45, -15, true, false, true},    {45, -15, false, false, true},   // 26 - 27
+      {-45, -15, false, false, true},  {0, -15, false, false, true},    // 28 - 29
+      {110, 35, false, false, true},   {-110, 35, false, false, true},  // 30 - 31
+      {45, 35, false, false, true},    {-45, 35, false, false, true},   // 32 - 33
+      {45, 0, false, false, true},     {-45, 0, false, false, true},    // 34 - 35
+      {-45, -15, true, false, true},   {0, 0, false, true, true},       // 36 - 37
+      {0, 0, false, true, true},       {0, 0, false, true, true},       // 38 - 39
+      {0, 0, false, true, true},       {150, 0, false, false, true},    // 40 - 41
+      {-150, 0, false, false, true},                                    // 42
+  };
+
+  // Index 0 signals the channel configuration by other means and has no loudspeakers
+  static constexpr uint8_t LAYOUT_NUM_SPEAKERS[NUM_LAYOUT_INDICES] = {
+      0, 1, 2, 3, 4, 5, 6, 8, 2, 3, 4, 7, 8, 24, 8, 12, 10, 12, 14, 12, 14};
+};
+}  // namespace detail
+
+//! @returns whether the SpeakerPosition index is defined.
+constexpr bool isValidSpeakerIdx(uint8_t speakerIdx) {
+  return speakerIdx < NUM_SPEAKER_INDICES && detail::STables::SPEAKERS[speakerIdx].isValid;
+}
+
+//! @returns the geometry of the loudspeaker, with isValid unset for reserved indices.
+constexpr SSpeakerGeometry speakerGeometry(uint8_t speakerIdx) {
+  return speakerIdx < NUM_SPEAKER_INDICES ? detail::STables::SPEAKERS[speakerIdx]
+                                          : SSpeakerGeometry{0, 0, false, false, false};
+}
+
+//! @returns the number of loudspeakers of the ChannelConfiguration, 0 if it is 0 or reserved.
+constexpr uint32_t layoutNumSpeakers(uint8_t layoutIdx) {
+  return layoutIdx < NUM_LAYOUT_INDICES ? detail::STables::LAYOUT_NUM_SPEAKERS[layoutIdx] : 0;
+}
+}  // namespace cicp
+}  // namespace audioparser
+}  // namespace mmt
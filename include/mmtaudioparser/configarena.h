@@ -0,0 +1,187 @@
+/*-----------------------------------------------------------------------------
+Software License for The Fraunhofer FDK MPEG-H Software
+
+Copyright (c) 2024 Fraunhofer-Gesellschaft zur Förderung der angewandten
+Forschung e.V. and Contributors
+All rights reserved.
+
+1. INTRODUCTION
+
+The "Fraunhofer FDK MPEG-H Software" is software that implements the ISO/MPEG
+MPEG-H 3D Audio standard for digital audio or related system features. Patent
+licenses for necessary patent claims for the Fraunhofer FDK MPEG-H Software
+(including those of Fraunhofer), for the use in commercial products and
+services, may be obtained from the respective patent owners individually and/or
+from Via LA (www.via-la.com).
+
+Fraunhofer supports the development of MPEG-H products and services by offering
+additional software, documentation, and technical advice. In addition, it
+operates the MPEG-H Trademark Program to ease interoperability testing of end-
+products. Please visit www.mpegh.com for more information.
+
+2. COPYRIGHT LICENSE
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted without payment of copyright license fees provided that you
+satisfy the following conditions:
+
+* You must retain the complete text of this software license in redistributions
+of the Fraunhofer FDK MPEG-H Software or your modifications thereto in source
+code form.
+
+* You must retain the complete text of this software license in the
+documentation and/or other materials provided with redistributions of
+the Fraunhofer FDK MPEG-H Software or your modifications thereto in binary form.
+You must make available free of charge copies of the complete source code of
+the Fraunhofer FDK MPEG-H Software and your modifications thereto to recipients
+of copies in binary form.
+
+* The name of Fraunhofer may not be used to endorse or promote products derived
+from the Fraunhofer FDK MPEG-H Software without prior written permission.
+
+* You may not charge copyright license fees for anyone to use, copy or
+distribute the Fraunhofer FDK MPEG-H Software or your modifications thereto.
+
+* Your modified versions of the Fraunhofer FDK MPEG-H Software must carry
+prominent notices stating that you changed the software and the date of any
+change. For modified versions of the Fraunhofer FDK MPEG-H Software, the term
+"Fraunhofer FDK MPEG-H Software" must be replaced by the term "Third-Party
+Modified Version of the Fraunhofer FDK MPEG-H Software".
+
+3. No PATENT LICENSE
+
+NO EXPRESS OR IMPLIED LICENSES TO ANY PATENT CLAIMS, including without
+limitation the patents of Fraunhofer, ARE GRANTED BY THIS SOFTWARE LICENSE.
+Fraunhofer provides no warranty of patent non-infringement with respect to this
+software. You may use this Fraunhofer FDK MPEG-H Software or modifications
+thereto only for purposes that are authorized by appropriate patent licenses.
+
+4. DISCLAIMER
+
+This Fraunhofer FDK MPEG-H Software is provided by Fraunhofer on behalf of the
+copyright holders and contributors "AS IS" and WITHOUT ANY EXPRESS OR IMPLIED
+WARRANTIES, including but not limited to the implied warranties of
+merchantability and fitness for a particular purpose. IN NO EVENT SHALL THE
+COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE for any direct, indirect,
+incidental, special, exemplary, or consequential damages, including but not
+limited to procurement of substitute goods or services; loss of use, data, or
+profits, or business interruption, however caused and on any theory of
+liability, whether in contract, strict liability, or tort (including
+negligence), arising in any way out of the use of this software, even if
+advised of the possibility of such damage.
+
+5. CONTACT INFORMATION
+
+Fraunhofer Institute for Integrated Circuits IIS
+Attention: Division Audio and Media Technologies - MPEG-H FDK
+Am Wolfsmantel 33
+91058 Erlangen, Germany
+www.iis.fraunhofer.de/amm
+amm-info@iis.fraunhofer.de
+-----------------------------------------------------------------------------*/
+
+/*!
+ * @file configarena.h
+ *
+ * @brief Bump allocator for the storage of parsed configuration structures.
+ */
+
+#pragma once
+
+// System includes
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Internal includes
+#include "mmtaudioparser/version.h"
+
+namespace mmt {
+namespace audioparser {
+/*!
+ * @brief Memory region all storage of one parsed configuration is taken from.
+ *
+ * Allocations are served by bumping a pointer within the current block. Single allocations are
+ * never released, instead the parser resets the whole arena on the next addConfig() call. On reset,
+ * all blocks are merged into one block of the combined size, so parsing becomes allocation-free
+ * once the arena has grown to the size of the largest configuration seen so far.
+ *
+ * @note An arena must only be used by one parser at a time, since resetting it invalidates all
+ * configuration structures allocated from it. The parser claims the arena on construction and
+ * rejects an arena which is already claimed by another parser.
+ */
+class CConfigArena {
+ public:
+  //! Allocation state of the arena, see mark() and rollback().
+  struct SMark {
+    size_t block;
+    size_t used;
+  };
+
+  /*!
+   * @brief Creates an arena.
+   *
+   * @param [in] initialSize - size of the first memory block in bytes
+   */
+  explicit CConfigArena(size_t initialSize = 4096);
+  ~CConfigArena();
+
+  CConfigArena(const CConfigArena&) = delete;
+  CConfigArena& operator=(const CConfigArena&) = delete;
+
+  /*!
+   * @brief Allocates a memory region from the arena.
+   *
+   * @param [in] size - the number of bytes to allocate
+   * @param [in] alignment - the alignment of the region, must be a power of two
+   *
+   * @returns a pointer to the allocated region, which stays valid until the next reset() or a
+   * rollback() to a mark taken before this call.
+   */
+  void* allocate(size_t size, size_t alignment);
+
+  //! @returns the current allocation state, to release later allocations by rollback().
+  SMark mark() const noexcept { return SMark{m_current, m_used}; }
+
+  /*!
+   * @brief Releases all allocations made after the mark was taken and keeps their memory.
+   *
+   * All structures using the released memory must have been destroyed before.
+   */
+  void rollback(const SMark& mark) noexcept;
+
+  //! Releases all allocations at once and keeps the memory for further allocations.
+  void reset();
+
+  //! @returns the total number of bytes owned by the arena.
+  size_t capacity() const noexcept;
+
+  /*!
+   * @brief Claims the arena for the calling parser.
+   *
+   * Concurrent claims are safe, exactly one of them succeeds.
+   *
+   * @returns false if the arena is already claimed by another parser.
+   */
+  bool claim() noexcept;
+
+  //! Gives up the claim of the arena, so another parser may use it.
+  void unclaim() noexcept;
+
+ private:
+  struct SBlock {
+    uint8_t* data;
+    size_t size;
+  };
+
+  void addBlock(size_t size);
+
+  std::vector<SBlock> m_blocks;
+  // Block the allocations are taken from, later blocks are kept from before a rollback()
+  size_t m_current;
+  size_t m_used;
+  std::atomic<bool> m_claimed;
+};
+}  // namespace audioparser
+}  // namespace mmt
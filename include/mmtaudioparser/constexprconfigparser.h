@@ -0,0 +1,639 @@
+/*-----------------------------------------------------------------------------
+Software License for The Fraunhofer FDK MPEG-H Software
+
+Copyright (c) 2024 Fraunhofer-Gesellschaft zur Förderung der angewandten
+Forschung e.V. and Contributors
+All rights reserved.
+
+1. INTRODUCTION
+
+The "Fraunhofer FDK MPEG-H Software" is software that implements the ISO/MPEG
+MPEG-H 3D Audio standard for digital audio or related system features. Patent
+licenses for necessary patent claims for the Fraunhofer FDK MPEG-H Software
+(including those of Fraunhofer), for the use in commercial products and
+services, may be obtained from the respective patent owners individually and/or
+from Via LA (www.via-la.com).
+
+Fraunhofer supports the development of MPEG-H products and services by offering
+additional software, documentation, and technical advice. In addition, it
+operates the MPEG-H Trademark Program to ease interoperability testing of end-
+products. Please visit www.mpegh.com for more information.
+
+2. COPYRIGHT LICENSE
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted without payment of copyright license fees provided that you
+satisfy the following conditions:
+
+* You must retain the complete text of this software license in redistributions
+of the Fraunhofer FDK MPEG-H Software or your modifications thereto in source
+code form.
+
+* You must retain the complete text of this software license in the
+documentation and/or other materials provided with redistributions of
+the Fraunhofer FDK MPEG-H Software or your modifications thereto in binary form.
+You must make available free of charge copies of the complete source code of
+the Fraunhofer FDK MPEG-H Software and your modifications thereto to recipients
+of copies in binary form.
+
+* The name of Fraunhofer may not be used to endorse or promote products derived
+from the Fraunhofer FDK MPEG-H Software without prior written permission.
+
+* You may not charge copyright license fees for anyone to use, copy or
+distribute the Fraunhofer FDK MPEG-H Software or your modifications thereto.
+
+* Your modified versions of the Fraunhofer FDK MPEG-H Software must carry
+prominent notices stating that you changed the software and the date of any
+change. For modified versions of the Fraunhofer FDK MPEG-H Software, the term
+"Fraunhofer FDK MPEG-H Software" must be replaced by the term "Third-Party
+Modified Version of the Fraunhofer FDK MPEG-H Software".
+
+3. No PATENT LICENSE
+
+NO EXPRESS OR IMPLIED LICENSES TO ANY PATENT CLAIMS, including without
+limitation the patents of Fraunhofer, ARE GRANTED BY THIS SOFTWARE LICENSE.
+Fraunhofer provides no warranty of patent non-infringement with respect to this
+software. You may use this Fraunhofer FDK MPEG-H Software or modifications
+thereto only for purposes that are authorized by appropriate patent licenses.
+
+4. DISCLAIMER
+
+This Fraunhofer FDK MPEG-H Software is provided by Fraunhofer on behalf of the
+copyright holders and contributors "AS IS" and WITHOUT ANY EXPRESS OR IMPLIED
+WARRANTIES, including but not limited to the implied warranties of
+merchantability and fitness for a particular purpose. IN NO EVENT SHALL THE
+COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE for any direct, indirect,
+incidental, special, exemplary, or consequential damages, including but not
+limited to procurement of substitute goods or services; loss of use, data, or
+profits, or business interruption, however caused and on any theory of
+liability, whether in contract, strict liability, or tort (including
+negligence), arising in any way out of the use of this software, even if
+advised of the possibility of such damage.
+
+5. CONTACT INFORMATION
+
+Fraunhofer Institute for Integrated Circuits IIS
+Attention: Division Audio and Media Technologies - MPEG-H FDK
+Am Wolfsmantel 33
+91058 Erlangen, Germany
+www.iis.fraunhofer.de/amm
+amm-info@iis.fraunhofer.de
+-----------------------------------------------------------------------------*/
+
+/*!
+ * @file constexprconfigparser.h
+ *
+ * @brief Parser for MPEG-H 3D Audio mpegh3daConfig() structures which can be evaluated at compile
+ * time, so configs embedded as byte arrays are validated by the compiler.
+ *
+ * This header requires C++14. It is not used by the library itself, which stays usable with C++11.
+ *
+ * Usage:
+ * @code
+ * constexpr uint8_t CONFIG[] = {0x0D, 0x19, 0x80, ...};
+ * constexpr auto CONFIG_INFO = mmt::audioparser::compiletime::parseConfig(CONFIG);
+ * static_assert(CONFIG_INFO.result.isOk(), "The embedded config is invalid");
+ * @endcode
+ */
+
+#pragma once
+
+#if !(__cplusplus >= 201402L || (defined(_MSVC_LANG) && _MSVC_LANG >= 201402L))
+#error "constexprconfigparser.h requires C++14 or later"
+#endif
+
+// System includes
+#include <cstddef>
+#include <cstdint>
+
+// Internal includes
+#include "mmtaudioparser/version.h"
+#include "mmtaudioparser/cicp.h"
+#include "mmtaudioparser/mmtaudioparser.h"
+#include "mmtaudioparser/mpeghparser.h"
+
+namespace mmt {
+namespace audioparser {
+namespace compiletime {
+//! Fixed-capacity representation of a SpeakerConfig3d() structure.
+struct SStaticSpeakerConfig3d {
+  //! Capacity of CICPSpeakerIdx.
+  static constexpr uint32_t MAX_SPEAKERS = 64;
+
+  //! See CMpeghParser::SSpeakerConfig3d::speakerLayoutType.
+  uint8_t speakerLayoutType = 0;
+  //! The ChannelConfiguration value as defined in ISO/IEC 23091-3 for speakerLayoutType of 0.
+  uint8_t CICPIdx = 0;
+  //! The number of loudspeakers of this speaker configuration.
+  uint32_t numSpeakers = 0;
+  //! The LoudspeakerGeometry values for speakerLayoutType 1, numSpeakers entries are valid.
+  uint8_t CICPSpeakerIdx[MAX_SPEAKERS] = {};
+};
+
+//! Fixed-capacity representation of a signal group of the signals3d() structure.
+struct SStaticSignalGroup {
+  //! The type indicator of the signal group.
+  uint8_t signalGroupType = 255;
+  //! The number of signals in this signal group.
+  uint32_t numSignals = 0;
+  //! Whether the signal group defines its own layout instead of using the reference layout.
+  bool differsFromReferenceLayout = false;
+  //! The layout of the signal group, only valid if differsFromReferenceLayout is set.
+  SStaticSpeakerConfig3d audioChannelLayout;
+};
+
+/*!
+ * @brief Fixed-capacity counterpart of CMpeghParser::SConfigInfo, which is a literal type.
+ *
+ * Configs exceeding one of the capacities are reported as EParseError::notSupported.
+ */
+struct SStaticConfigInfo {
+  //! Capacity of signalGroups, the largest number signals3d() can signal.
+  static constexpr uint32_t MAX_SIGNAL_GROUPS = 32;
+  //! Capacity of elementConfigs.
+  static constexpr uint32_t MAX_ELEMENTS = 64;
+  //! Capacity of configExtensions.
+  static constexpr uint32_t MAX_CONFIG_EXTENSIONS = 16;
+  //! Capacity of compatibleProfileLevels, the largest number a compatible set can signal.
+  static constexpr uint32_t MAX_COMPATIBLE_PROFILE_LEVELS = 16;
+
+  //! The outcome of parsing, all other fields are only valid on success.
+  SParseResult result;
+
+  uint8_t profileLevelIndicator = 0;
+  uint8_t samplingFrequencyIndex = 0;
+  uint32_t samplingFrequency = 0;
+  uint8_t coreSbrFrameLengthIndex = 0;
+  bool cfg_reserved = false;
+  bool receiverDelayCompensation = false;
+  SStaticSpeakerConfig3d referenceLayout;
+  uint32_t numAudioChannels = 0;
+  uint32_t numAudioObjects = 0;
+  uint32_t numSAOCTransportChannels = 0;
+  uint32_t numHOATransportChannels = 0;
+  uint32_t numSignalGroups = 0;
+  SStaticSignalGroup signalGroups[MAX_SIGNAL_GROUPS] = {};
+  bool elementLengthPresent = false;
+  uint32_t numElements = 0;
+  CMpeghParser::SElementConfig elementConfigs[MAX_ELEMENTS] = {};
+  uint32_t numConfigExtensions = 0;
+  CMpeghParser::SConfigExtension configExtensions[MAX_CONFIG_EXTENSIONS] = {};
+  //! The compatibleSetIndications of the last compatible profile level set.
+  uint32_t numCompatibleProfileLevels = 0;
+  uint8_t compatibleProfileLevels[MAX_COMPATIBLE_PROFILE_LEVELS] = {};
+  bool audioPreRollPresent = false;
+};
+
+namespace detail {
+// MSB-first bit reader, recording the first error like utils::CBitReader
+class CConstBitReader {
+ public:
+  constexpr CConstBitReader(const uint8_t* data, size_t size) noexcept
+      : m_data(data), m_sizeInBits(size * 8) {}
+
+  constexpr uint32_t read(uint32_t numBits) noexcept {
+    if (!isValid()) {
+      return 0;
+    }
+    if (numBits > nofBitsLeft()) {
+      setError(EParseError::endOfBuffer, nullptr);
+      return 0;
+    }
+    uint32_t value = 0;
+    for (uint32_t i = 0; i < numBits; ++i, ++m_position) {
+      value = (value << 1) | ((m_data[m_position / 8] >> (7 - m_position % 8)) & 1u);
+    }
+    return value;
+  }
+
+  constexpr bool readBool() noexcept { return read(1) != 0; }
+
+  // escapedValue(nBits1, nBits2, nBits3) as defined in ISO/IEC 23008-3, limited to 32 bits
+  constexpr uint32_t escapedValue(uint32_t nBits1, uint32_t nBits2, uint32_t nBits3) noexcept {
+    uint32_t value = read(nBits1);
+    if (value == (1u << nBits1) - 1u) {
+      uint32_t valueAdd = read(nBits2);
+      value += valueAdd;
+      if (nBits3 > 0 && valueAdd == (1u << nBits2) - 1u) {
+        value += read(nBits3);
+      }
+    }
+    return value;
+  }
+
+  constexpr void skip(size_t numBits) noexcept {
+    if (!isValid()) {
+      return;
+    }
+    if (numBits > nofBitsLeft()) {
+      setError(EParseError::endOfBuffer, nullptr);
+      return;
+    }
+    m_position += numBits;
+  }
+
+  constexpr size_t nofBitsLeft() const noexcept { return m_sizeInBits - m_position; }
+  constexpr bool isValid() const noexcept { return m_result.error == EParseError::ok; }
+  constexpr const SParseResult& result() const noexcept { return m_result; }
+
+  constexpr void setError(EParseError error, const char* syntaxElement) noexcept {
+    if (isValid()) {
+      m_result.error = error;
+      m_result.bitOffset = m_position;
+      m_result.syntaxElement = syntaxElement;
+    }
+  }
+
+ private:
+  const uint8_t* m_data;
+  size_t m_sizeInBits;
+  size_t m_position = 0;
+  SParseResult m_result;
+};
+
+// Table is defined in ISO/IEC 23003-3:2012, Table 67
+constexpr uint32_t samplingFrequency(uint8_t samplingFrequencyIndex) noexcept {
+  constexpr uint32_t SAMPLING_FREQUENCIES[0x1f] = {
+      96000, 88200, 64000, 48000, 44100, 32000, 24000, 22050, 16000, 12000, 11025,
+      8000,  7350,  0,     0,     57600, 51200, 40000, 38400, 34150, 28800, 25600,
+      20000, 19200, 17075, 14400, 12800, 9600,  0,     0,     0};
+  return SAMPLING_FREQUENCIES[samplingFrequencyIndex];
+}
+
+constexpr void speakerConfig3d(CConstBitReader& reader, SStaticSpeakerConfig3d& speakerConfig) {
+  speakerConfig.speakerLayoutType = static_cast<uint8_t>(reader.read(2));
+  if (speakerConfig.speakerLayoutType == 0) {
+    speakerConfig.CICPIdx = static_cast<uint8_t>(reader.read(6));
+    speakerConfig.numSpeakers = cicp::layoutNumSpeakers(speakerConfig.CICPIdx);
+    if (speakerConfig.numSpeakers == 0) {
+      reader.setError(EParseError::invalidValue, "CICPspeakerLayoutIdx");
+    }
+    return;
+  }
+
+  speakerConfig.numSpeakers = reader.escapedValue(5, 8, 16) + 1;
+  if (speakerConfig.speakerLayoutType == 1) {
+    if (speakerConfig.numSpeakers > SStaticSpeakerConfig3d::MAX_SPEAKERS) {
+      reader.setError(EParseError::notSupported, "speakerConfig3d");
+      return;
+    }
+    for (uint32_t i = 0; i < speakerConfig.numSpeakers; i++) {
+      speakerConfig.CICPSpeakerIdx[i] = static_cast<uint8_t>(reader.read(7));
+    }
+  }
+  if (speakerConfig.speakerLayoutType == 2) {
+    // mpegh3daFlexibleSpeakerConfig(), only validated
+    bool angularPrecision = reader.readBool();
+    for (uint32_t i = 0; i < speakerConfig.numSpeakers && reader.isValid(); i++) {
+      // mpegh3daSpeakerDescription()
+      int32_t azimuthAngle = 0;
+      bool isScreenRelative = false;
+      if (reader.readBool()) {
+        const cicp::SSpeakerGeometry geometry =
+            cicp::speakerGeometry(static_cast<uint8_t>(reader.read(7)));
+        if (!geometry.isValid) {
+          reader.setError(EParseError::invalidValue, "CICPspeakerIdx");
+          return;
+        }
+        azimuthAngle = geometry.azimuth;
+        isScreenRelative = geometry.isScreenRelative;
+      } else {
+        uint32_t elevationClass = reader.read(2);
+        if (elevationClass == 3) {
+          uint32_t elevationAngleIdx = reader.read(angularPrecision ? 7 : 5);
+          if (elevationAngleIdx != 0) {
+            // ElevationDirection
+            reader.skip(1);
+          }
+        }
+        uint32_t azimuthAngleIdx = reader.read(angularPrecision ? 8 : 6);
+        azimuthAngle = static_cast<int32_t>(azimuthAngleIdx * (angularPrecision ? 1 : 5));
+        if (azimuthAngle != 0 && azimuthAngle != 180) {
+          // AzimuthDirection
+          reader.skip(1);
+        }
+        // isLFE
+        reader.skip(1);
+      }
+      if (isScreenRelative || (azimuthAngle != 0 && azimuthAngle != 180)) {
+        if (reader.readBool()) {
+          // alsoAddSymmetricPair
+          i++;
+        }
+      }
+    }
+  }
+}
+
+constexpr void signals3d(CConstBitReader& reader, SStaticConfigInfo& info) {
+  info.numSignalGroups = reader.read(5) + 1;
+  for (uint32_t idx = 0; idx < info.numSignalGroups && reader.isValid(); idx++) {
+    SStaticSignalGroup& signalGroup = info.signalGroups[idx];
+    signalGroup.signalGroupType = static_cast<uint8_t>(reader.read(3));
+    signalGroup.numSignals = reader.escapedValue(5, 8, 16) + 1;
+    switch (signalGroup.signalGroupType) {
+      // SignalGroupTypeChannels
+      case 0:
+        info.numAudioChannels += signalGroup.numSignals;
+        signalGroup.differsFromReferenceLayout = reader.readBool();
+        if (signalGroup.differsFromReferenceLayout) {
+          speakerConfig3d(reader, signalGroup.audioChannelLayout);
+        }
+        break;
+      // SignalGroupTypeObject
+      case 1:
+        info.numAudioObjects += signalGroup.numSignals;
+        break;
+      // SignalGroupTypeSAOC
+      case 2:
+        info.numSAOCTransportChannels += signalGroup.numSignals;
+        if (reader.readBool()) {
+          // saocDmxChannelLayout, only validated
+          SStaticSpeakerConfig3d saocDmxChannelLayout;
+          speakerConfig3d(reader, saocDmxChannelLayout);
+        }
+        break;
+      // SignalGroupTypeHOA
+      case 3:
+        info.numHOATransportChannels += signalGroup.numSignals;
+        break;
+      default:
+        reader.setError(EParseError::invalidValue, "signalGroupType");
+        break;
+    }
+  }
+}
+
+constexpr void mpegh3daCoreConfig(CConstBitReader& reader, bool& enhancedNoiseFilling) {
+  // tw_mdct, fullbandLpd, noiseFilling
+  reader.skip(1);
+  reader.skip(1);
+  reader.skip(1);
+  enhancedNoiseFilling = reader.readBool();
+  if (enhancedNoiseFilling) {
+    // igfUseEnf, igfUseHighRes, igfUseWhitening, igfAfterTnsSynth
+    reader.skip(1);
+    reader.skip(1);
+    reader.skip(1);
+    reader.skip(1);
+    // igfStartIndex, igfStopIndex
+    reader.skip(5);
+    reader.skip(4);
+  }
+}
+
+constexpr void mpegh3daChannelPairElementConfig(CConstBitReader& reader, uint8_t sbrRatioIndex,
+                                                uint32_t numChannels) {
+  if (numChannels < 2) {
+    reader.setError(EParseError::invalidValue, "mpegh3daChannelPairElementConfig");
+    return;
+  }
+  bool enhancedNoiseFilling = false;
+  mpegh3daCoreConfig(reader, enhancedNoiseFilling);
+  if (enhancedNoiseFilling) {
+    // igfIndependentTiling
+    reader.skip(1);
+  }
+  if (sbrRatioIndex > 0) {
+    reader.setError(EParseError::notSupported, "sbrConfig");
+    return;
+  }
+
+  // Number of bits of numChannels - 1
+  uint32_t nBits = 0;
+  for (uint32_t value = numChannels - 1; value != 0; value >>= 1) {
+    nBits++;
+  }
+  uint32_t qceIndex = reader.read(2);
+  if (qceIndex > 0 && reader.readBool()) {
+    // shiftChannel0
+    reader.skip(nBits);
+  }
+  if (reader.readBool()) {
+    // shiftChannel1
+    reader.skip(nBits);
+  }
+  if (qceIndex == 0) {
+    // lpdStereoIndex
+    reader.skip(1);
+  }
+}
+
+constexpr void mpegh3daExtElementConfig(CConstBitReader& reader, SStaticConfigInfo& info,
+                                        CMpeghParser::SElementConfig& elementConfig) {
+  elementConfig.extElementType = reader.escapedValue(4, 8, 16);
+  uint32_t configLength = reader.escapedValue(4, 8, 16);
+  if (reader.readBool()) {
+    elementConfig.extElementDefaultLength = reader.escapedValue(8, 16, 0) + 1;
+  }
+  elementConfig.extElementPayloadFrag = reader.readBool();
+  // ID_EXT_ELE_FILL and ID_EXT_ELE_AUDIOPREROLL are not allowed to have a config
+  if (elementConfig.extElementType == 0 || elementConfig.extElementType == 3) {
+    info.audioPreRollPresent |= elementConfig.extElementType == 3;
+    if (configLength != 0) {
+      reader.setError(EParseError::invalidValue, "usacExtElementConfigLength");
+    }
+    return;
+  }
+  reader.skip(size_t{configLength} * 8);
+}
+
+constexpr void mpegh3daDecoderConfig(CConstBitReader& reader, SStaticConfigInfo& info) {
+  uint32_t numChannels = info.numAudioChannels + info.numAudioObjects +
+                         info.numHOATransportChannels + info.numSAOCTransportChannels;
+  // coreSbrFrameLengthIndex 0 to 4 maps to sbrRatioIndex 0, 0, 2, 3 and 1
+  constexpr uint8_t SBR_RATIO_INDEX[] = {0, 0, 2, 3, 1};
+  uint8_t sbrRatioIndex = SBR_RATIO_INDEX[info.coreSbrFrameLengthIndex];
+
+  info.numElements = reader.escapedValue(4, 8, 16) + 1;
+  info.elementLengthPresent = reader.readBool();
+  if (info.numElements > SStaticConfigInfo::MAX_ELEMENTS) {
+    reader.setError(EParseError::notSupported, "mpegh3daDecoderConfig");
+    return;
+  }
+  for (uint32_t elemIdx = 0; elemIdx < info.numElements && reader.isValid(); elemIdx++) {
+    CMpeghParser::SElementConfig& elementConfig = info.elementConfigs[elemIdx];
+    elementConfig.usacElementType = reader.read(2);
+    switch (elementConfig.usacElementType) {
+      // ID_USAC_SCE
+      case 0: {
+        bool enhancedNoiseFilling = false;
+        mpegh3daCoreConfig(reader, enhancedNoiseFilling);
+        if (sbrRatioIndex > 0) {
+          reader.setError(EParseError::notSupported, "sbrConfig");
+        }
+        break;
+      }
+      // ID_USAC_CPE
+      case 1:
+        mpegh3daChannelPairElementConfig(reader, sbrRatioIndex, numChannels);
+        break;
+      // ID_USAC_LFE
+      case 2:
+        break;
+      // ID_USAC_EXT
+      default:
+        mpegh3daExtElementConfig(reader, info, elementConfig);
+        break;
+    }
+  }
+}
+
+constexpr void mpegh3daConfigExtension(CConstBitReader& reader, SStaticConfigInfo& info) {
+  info.numConfigExtensions = reader.escapedValue(2, 4, 8) + 1;
+  if (info.numConfigExtensions > SStaticConfigInfo::MAX_CONFIG_EXTENSIONS) {
+    reader.setError(EParseError::notSupported, "mpegh3daConfigExtension");
+    return;
+  }
+  for (uint32_t i = 0; i < info.numConfigExtensions && reader.isValid(); i++) {
+    CMpeghParser::SConfigExtension& configExtension = info.configExtensions[i];
+    configExtension.usacConfigExtType = reader.escapedValue(4, 8, 16);
+    configExtension.usacConfigExtLength = reader.escapedValue(4, 8, 16);
+    switch (configExtension.usacConfigExtType) {
+      // ID_CONFIG_EXT_FILL, the values of the fill bytes are not checked
+      case 0:
+        for (uint32_t j = 0; j < configExtension.usacConfigExtLength && reader.isValid(); j++) {
+          reader.skip(8);
+        }
+        break;
+      // ID_CONFIG_EXT_COMPATIBLE_PROFILELVL_SET
+      case 7:
+        info.numCompatibleProfileLevels = reader.read(4) + 1;
+        // reserved
+        reader.skip(4);
+        for (uint32_t j = 0; j < info.numCompatibleProfileLevels; j++) {
+          info.compatibleProfileLevels[j] = static_cast<uint8_t>(reader.read(8));
+        }
+        break;
+      default:
+        reader.skip(size_t{configExtension.usacConfigExtLength} * 8);
+        break;
+    }
+  }
+}
+}  // namespace detail
+
+/*!
+ * @brief Parses an mpegh3daConfig() structure, in a constant expression if the config is one.
+ *
+ * The config is validated like CMpeghParser::tryAddConfig() does, except for the values of the fill
+ * bytes. Errors name the syntax element for invalid values only.
+ *
+ * @param [in] config - pointer to the binary MPEG-H 3D Audio configuration structure
+ * @param [in] configSize - size of the binary MPEG-H 3D Audio configuration structure in bytes
+ */
+constexpr SStaticConfigInfo parseConfig(const uint8_t* config, size_t configSize) {
+  SStaticConfigInfo info;
+  if (config == nullptr || configSize == 0) {
+    info.result.error = EParseError::emptyBuffer;
+    info.result.syntaxElement = "mpegh3daConfig";
+    return info;
+  }
+
+  detail::CConstBitReader reader(config, configSize);
+  info.profileLevelIndicator = static_cast<uint8_t>(reader.read(8));
+  info.samplingFrequencyIndex = static_cast<uint8_t>(reader.read(5));
+  if (info.samplingFrequencyIndex == 0x1f) {
+    info.samplingFrequency = reader.read(24);
+  } else {
+    info.samplingFrequency = detail::samplingFrequency(info.samplingFrequencyIndex);
+  }
+  info.coreSbrFrameLengthIndex = static_cast<uint8_t>(reader.read(3));
+  info.cfg_reserved = reader.readBool();
+  info.receiverDelayCompensation = reader.readBool();
+  if (info.coreSbrFrameLengthIndex > 4) {
+    reader.setError(EParseError::invalidValue, "coreSbrFrameLengthIndex");
+  }
+  if (reader.isValid()) {
+    detail::speakerConfig3d(reader, info.referenceLayout);
+  }
+  if (reader.isValid()) {
+    detail::signals3d(reader, info);
+  }
+  if (reader.isValid()) {
+    detail::mpegh3daDecoderConfig(reader, info);
+  }
+  if (reader.readBool()) {
+    detail::mpegh3daConfigExtension(reader, info);
+  }
+
+  // Not more than 7 bits are allowed to be left after reading the config
+  if (reader.nofBitsLeft() >= 8) {
+    reader.setError(EParseError::trailingData, "mpegh3daConfig");
+  }
+  info.result = reader.result();
+  return info;
+}
+
+//! Parses a config given as array, see parseConfig(const uint8_t*, size_t).
+template <size_t N>
+constexpr SStaticConfigInfo parseConfig(const uint8_t (&config)[N]) {
+  return parseConfig(config, N);
+}
+
+/*!
+ * @brief Converts a parsed config into the info structure returned by
+ * CMpeghParser::getConfigInfo(), without parsing it again.
+ */
+inline CMpeghParser::SConfigInfo toConfigInfo(const SStaticConfigInfo& staticInfo) {
+  auto toSpeakerConfig3d = [](const SStaticSpeakerConfig3d& layout) {
+    CMpeghParser::SSpeakerConfig3d speakerConfig;
+    speakerConfig.speakerLayoutType = layout.speakerLayoutType;
+    speakerConfig.CICPIdx = layout.CICPIdx;
+    speakerConfig.numSpeakers = layout.numSpeakers;
+    if (layout.speakerLayoutType == 1) {
+      speakerConfig.CICPSpeakerIdx.assign(layout.CICPSpeakerIdx,
+                                          layout.CICPSpeakerIdx + layout.numSpeakers);
+    }
+    return speakerConfig;
+  };
+
+  CMpeghParser::SConfigInfo info;
+  info.profileLevelIndicator = staticInfo.profileLevelIndicator;
+  info.samplingFrequencyIndex = staticInfo.samplingFrequencyIndex;
+  info.samplingFrequency = staticInfo.samplingFrequency;
+  info.coreSbrFrameLengthIndex = staticInfo.coreSbrFrameLengthIndex;
+  info.cfg_reserved = staticInfo.cfg_reserved;
+  info.receiverDelayCompensation = staticInfo.receiverDelayCompensation;
+  info.referenceLayout = toSpeakerConfig3d(staticInfo.referenceLayout);
+  info.numAudioChannels = staticInfo.numAudioChannels;
+  info.numAudioObjects = staticInfo.numAudioObjects;
+  info.numSAOCTransportChannels = staticInfo.numSAOCTransportChannels;
+  info.numHOATransportChannels = staticInfo.numHOATransportChannels;
+  info.audioPreRollPresent = staticInfo.audioPreRollPresent;
+
+  uint8_t metaDataElementId = 0;
+  for (uint32_t idx = 0; idx < staticInfo.numSignalGroups; idx++) {
+    const SStaticSignalGroup& staticGroup = staticInfo.signalGroups[idx];
+    CMpeghParser::SSignalGroup signalGroup;
+    signalGroup.signalGroupType = staticGroup.signalGroupType;
+    signalGroup.numSignals = staticGroup.numSignals;
+    signalGroup.audioChannelLayout = staticGroup.differsFromReferenceLayout
+                                         ? toSpeakerConfig3d(staticGroup.audioChannelLayout)
+                                         : info.referenceLayout;
+    // Channels and objects carry one metadata element per signal, HOA one per group
+    uint32_t numMetaDataElements = 0;
+    if (staticGroup.signalGroupType <= 1) {
+      numMetaDataElements = staticGroup.numSignals;
+    } else if (staticGroup.signalGroupType == 3) {
+      numMetaDataElements = 1;
+    }
+    for (uint32_t i = 0; i < numMetaDataElements; i++) {
+      signalGroup.metaDataElementIds.push_back(metaDataElementId++);
+    }
+    info.signalGroups.push_back(signalGroup);
+  }
+
+  info.elementLengthPresent = staticInfo.elementLengthPresent;
+  info.elementConfigs.assign(staticInfo.elementConfigs,
+                             staticInfo.elementConfigs + staticInfo.numElements);
+  info.configExtensions.assign(staticInfo.configExtensions,
+                               staticInfo.configExtensions + staticInfo.numConfigExtensions);
+  info.compatibleProfileLevels.assign(
+      staticInfo.compatibleProfileLevels,
+      staticInfo.compatibleProfileLevels + staticInfo.numCompatibleProfileLevels);
+  return info;
+}
+}  // namespace compiletime
+}  // namespace audioparser
+}  // namespace mmt
@@ -0,0 +1,227 @@
+/*-----------------------------------------------------------------------------
+Software License for The Fraunhofer FDK MPEG-H Software
+
+Copyright (c) 2024 Fraunhofer-Gesellschaft zur Förderung der angewandten
+Forschung e.V. and Contributors
+All rights reserved.
+
+1. INTRODUCTION
+
+The "Fraunhofer FDK MPEG-H Software" is software that implements the ISO/MPEG
+MPEG-H 3D Audio standard for digital audio or related system features. Patent
+licenses for necessary patent claims for the Fraunhofer FDK MPEG-H Software
+(including those of Fraunhofer), for the use in commercial products and
+services, may be obtained from the respective patent owners individually and/or
+from Via LA (www.via-la.com).
+
+Fraunhofer supports the development of MPEG-H products and services by offering
+additional software, documentation, and technical advice. In addition, it
+operates the MPEG-H Trademark Program to ease interoperability testing of end-
+products. Please visit www.mpegh.com for more information.
+
+2. COPYRIGHT LICENSE
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted without payment of copyright license fees provided that you
+satisfy the following conditions:
+
+* You must retain the complete text of this software license in redistributions
+of the Fraunhofer FDK MPEG-H Software or your modifications thereto in source
+code form.
+
+* You must retain the complete text of this software license in the
+documentation and/or other materials provided with redistributions of
+the Fraunhofer FDK MPEG-H Software or your modifications thereto in binary form.
+You must make available free of charge copies of the complete source code of
+the Fraunhofer FDK MPEG-H Software and your modifications thereto to recipients
+of copies in binary form.
+
+* The name of Fraunhofer may not be used to endorse or promote products derived
+from the Fraunhofer FDK MPEG-H Software without prior written permission.
+
+* You may not charge copyright license fees for anyone to use, copy or
+distribute the Fraunhofer FDK MPEG-H Software or your modifications thereto.
+
+* Your modified versions of the Fraunhofer FDK MPEG-H Software must carry
+prominent notices stating that you changed the software and the date of any
+change. For modified versions of the Fraunhofer FDK MPEG-H Software, the term
+"Fraunhofer FDK MPEG-H Software" must be replaced by the term "Third-Party
+Modified Version of the Fraunhofer FDK MPEG-H Software".
+
+3. No PATENT LICENSE
+
+NO EXPRESS OR IMPLIED LICENSES TO ANY PATENT CLAIMS, including without
+limitation the patents of Fraunhofer, ARE GRANTED BY THIS SOFTWARE LICENSE.
+Fraunhofer provides no warranty of patent non-infringement with respect to this
+software. You may use this Fraunhofer FDK MPEG-H Software or modifications
+thereto only for purposes that are authorized by appropriate patent licenses.
+
+4. DISCLAIMER
+
+This Fraunhofer FDK MPEG-H Software is provided by Fraunhofer on behalf of the
+copyright holders and contributors "AS IS" and WITHOUT ANY EXPRESS OR IMPLIED
+WARRANTIES, including but not limited to the implied warranties of
+merchantability and fitness for a particular purpose. IN NO EVENT SHALL THE
+COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE for any direct, indirect,
+incidental, special, exemplary, or consequential damages, including but not
+limited to procurement of substitute goods or services; loss of use, data, or
+profits, or business interruption, however caused and on any theory of
+liability, whether in contract, strict liability, or tort (including
+negligence), arising in any way out of the use of this software, even if
+advised of the possibility of such damage.
+
+5. CONTACT INFORMATION
+
+Fraunhofer Institute for Integrated Circuits IIS
+Attention: Division Audio and Media Technologies - MPEG-H FDK
+Am Wolfsmantel 33
+91058 Erlangen, Germany
+www.iis.fraunhofer.de/amm
+amm-info@iis.fraunhofer.de
+-----------------------------------------------------------------------------*/
+
+/*!
+ * @file mhasdemux.h
+ *
+ * @brief Demultiplexer for MHAS byte streams carrying several packet labels.
+ */
+
+#pragma once
+
+// System includes
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// External includes
+#include "ilo/common_types.h"
+
+// Internal includes
+#include "mmtaudioparser/version.h"
+#include "mmtaudioparser/mmtaudioparser.h"
+#include "mmtaudioparser/mhasparser.h"
+#include "mmtaudioparser/mpeghparser.h"
+
+namespace mmt {
+namespace audioparser {
+//! A packet extracted by CMhasDemux together with the configuration state of its label.
+struct SMhasDemuxPacket {
+  //! The extracted packet.
+  SMhasPacket packet;
+  /*!
+   * The config parser of the packet label, nullptr if no configuration packet has been received
+   * for the label so far.
+   */
+  const CMpeghParser* configParser = nullptr;
+};
+
+//! Notification about a changed configuration of one packet label.
+struct SLabelConfigChange {
+  //! The label whose configuration changed.
+  uint64_t packetLabel = 0;
+  //! Whether this is the first valid configuration of the label.
+  bool firstConfig = false;
+  //! The new configuration.
+  std::shared_ptr<const CMpeghParser::SConfigInfo> configInfo;
+};
+
+/*!
+ * @brief Splits an MHAS byte stream into packets and keeps one configuration per packet label.
+ *
+ * MHAS streams may multiplex several programs or switch groups, each identified by its
+ * mhasPacketLabel and configured by its own PACTYP_MPEGH3DACFG packets. The demultiplexer routes
+ * the config packets of each label into a CMpeghParser instance of that label, so all labels are
+ * handled in a single pass over the stream. The parser of a label is created with the first config
+ * packet of the label and kept for the lifetime of the demultiplexer. Config packets of labels
+ * beyond SDemuxOptions::maxLabels are rejected, so a corrupt stream cannot grow the label list
+ * without bound.
+ *
+ * Successfully parsed configurations which differ from the last published one of their label are
+ * published as SLabelConfigChange events, so a corrupt config packet in between does not cause a
+ * spurious event. They are collected until takeConfigChanges() is called.
+ *
+ * Streams arriving in chunks are handled like in CMhasParser.
+ */
+class CMhasDemux {
+ public:
+  //! Options controlling the demultiplexing.
+  struct SDemuxOptions {
+    /*!
+     * Options of the config parsers of the labels. Since every label owns its parser, an arena
+     * must not be set. Configs are only published once they are known to be valid, so the parse
+     * mode has to be EParseMode::full.
+     */
+    CMpeghParser::SParserOptions parserOptions;
+    //! Maximum number of labels a config parser is kept for.
+    size_t maxLabels = 16;
+  };
+
+  CMhasDemux();
+  /*!
+   * @brief Creates a demultiplexer with the given options.
+   *
+   * @param [in] options - options of the demultiplexer and its config parsers
+   */
+  explicit CMhasDemux(const SDemuxOptions& options);
+  ~CMhasDemux();
+
+  CMhasDemux(const CMhasDemux&) = delete;
+  CMhasDemux& operator=(const CMhasDemux&) = delete;
+
+  //! @see CMhasParser::setBuffer()
+  void setBuffer(const uint8_t* data, size_t size) noexcept;
+
+  /*!
+   * @brief Extracts the next packet from the buffer and routes config packets to their label.
+   *
+   * @param [out] packet - the extracted packet and the config parser of its label, only valid on
+   * success
+   *
+   * @returns the same results as CMhasParser::nextPacket(). The outcome of parsing a config packet
+   * is reported in SMhasPacket::configResult, which is EParseError::limitExceeded for a new label
+   * beyond SDemuxOptions::maxLabels.
+   */
+  SParseResult nextPacket(SMhasDemuxPacket& packet);
+
+  //! @see CMhasParser::resync()
+  SParseResult resync(uint32_t numConfirmPackets = 2) noexcept;
+
+  //! @returns the number of bytes of the buffer consumed by the extracted packets.
+  size_t bytesConsumed() const noexcept;
+
+  /*!
+   * @returns the config parser of the given label, nullptr if no config packet has been received
+   * for the label so far.
+   */
+  const CMpeghParser* getConfigParser(uint64_t packetLabel) const noexcept;
+
+  //! @returns the labels for which config packets have been received, in order of appearance.
+  std::vector<uint64_t> getPacketLabels() const;
+
+  /*!
+   * @brief Hands out the configuration changes published since the last call.
+   *
+   * @param [out] changes - the list the changes are appended to, in stream order
+   */
+  void takeConfigChanges(std::vector<SLabelConfigChange>& changes);
+
+ private:
+  struct SLabelState {
+    uint64_t packetLabel = 0;
+    std::unique_ptr<CMpeghParser> configParser;
+    // Raw bytes of the config last published as SLabelConfigChange, empty if there is none
+    ilo::ByteBuffer publishedConfig;
+  };
+
+  // Returns nullptr for a new label beyond SDemuxOptions::maxLabels
+  SLabelState* labelState(uint64_t packetLabel);
+
+  SDemuxOptions m_options;
+  CMhasParser m_mhasParser;
+  // Multiplexes carry few labels, so a linear search beats any map
+  std::vector<SLabelState> m_labels;
+  std::vector<SLabelConfigChange> m_configChanges;
+};
+}  // namespace audioparser
+}  // namespace mmt
@@ -0,0 +1,217 @@
+/*-----------------------------------------------------------------------------
+Software License for The Fraunhofer FDK MPEG-H Software
+
+Copyright (c) 2024 Fraunhofer-Gesellschaft zur Förderung der angewandten
+Forschung e.V. and Contributors
+All rights reserved.
+
+1. INTRODUCTION
+
+The "Fraunhofer FDK MPEG-H Software" is software that implements the ISO/MPEG
+MPEG-H 3D Audio standard for digital audio or related system features. Patent
+licenses for necessary patent claims for the Fraunhofer FDK MPEG-H Software
+(including those of Fraunhofer), for the use in commercial products and
+services, may be obtained from the respective patent owners individually and/or
+from Via LA (www.via-la.com).
+
+Fraunhofer supports the development of MPEG-H products and services by offering
+additional software, documentation, and technical advice. In addition, it
+operates the MPEG-H Trademark Program to ease interoperability testing of end-
+products. Please visit www.mpegh.com for more information.
+
+2. COPYRIGHT LICENSE
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted without payment of copyright license fees provided that you
+satisfy the following conditions:
+
+* You must retain the complete text of this software license in redistributions
+of the Fraunhofer FDK MPEG-H Software or your modifications thereto in source
+code form.
+
+* You must retain the complete text of this software license in the
+documentation and/or other materials provided with redistributions of
+the Fraunhofer FDK MPEG-H Software or your modifications thereto in binary form.
+You must make available free of charge copies of the complete source code of
+the Fraunhofer FDK MPEG-H Software and your modifications thereto to recipients
+of copies in binary form.
+
+* The name of Fraunhofer may not be used to endorse or promote products derived
+from the Fraunhofer FDK MPEG-H Software without prior written permission.
+
+* You may not charge copyright license fees for anyone to use, copy or
+distribute the Fraunhofer FDK MPEG-H Software or your modifications thereto.
+
+* Your modified versions of the Fraunhofer FDK MPEG-H Software must carry
+prominent notices stating that you changed the software and the date of any
+change. For modified versions of the Fraunhofer FDK MPEG-H Software, the term
+"Fraunhofer FDK MPEG-H Software" must be replaced by the term "Third-Party
+Modified Version of the Fraunhofer FDK MPEG-H Software".
+
+3. No PATENT LICENSE
+
+NO EXPRESS OR IMPLIED LICENSES TO ANY PATENT CLAIMS, including without
+limitation the patents of Fraunhofer, ARE GRANTED BY THIS SOFTWARE LICENSE.
+Fraunhofer provides no warranty of patent non-infringement with respect to this
+software. You may use this Fraunhofer FDK MPEG-H Software or modifications
+thereto only for purposes that are authorized by appropriate patent licenses.
+
+4. DISCLAIMER
+
+This Fraunhofer FDK MPEG-H Software is provided by Fraunhofer on behalf of the
+copyright holders and contributors "AS IS" and WITHOUT ANY EXPRESS OR IMPLIED
+WARRANTIES, including but not limited to the implied warranties of
+merchantability and fitness for a particular purpose. IN NO EVENT SHALL THE
+COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE for any direct, indirect,
+incidental, special, exemplary, or consequential damages, including but not
+limited to procurement of substitute goods or services; loss of use, data, or
+profits, or business interruption, however caused and on any theory of
+liability, whether in contract, strict liability, or tort (including
+negligence), arising in any way out of the use of this software, even if
+advised of the possibility of such damage.
+
+5. CONTACT INFORMATION
+
+Fraunhofer Institute for Integrated Circuits IIS
+Attention: Division Audio and Media Technologies - MPEG-H FDK
+Am Wolfsmantel 33
+91058 Erlangen, Germany
+www.iis.fraunhofer.de/amm
+amm-info@iis.fraunhofer.de
+-----------------------------------------------------------------------------*/
+
+/*!
+ * @file mhasindexer.h
+ *
+ * @brief Random access point index for MPEG-H 3D Audio Stream (MHAS) files.
+ */
+
+#pragma once
+
+// System includes
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+// External includes
+#include "ilo/common_types.h"
+
+// Internal includes
+#include "mmtaudioparser/version.h"
+#include "mmtaudioparser/mmtaudioparser.h"
+#include "mmtaudioparser/mpeghparser.h"
+
+namespace mmt {
+namespace audioparser {
+/*!
+ * @brief Index of the configurations, frames and random access points of an MHAS stream.
+ *
+ * All offsets are byte offsets of complete MHAS packets relative to the start of the stream, so
+ * seeking to a frame or random access point is a single lookup.
+ */
+struct SMhasIndex {
+  //! Index value used if no entry is referenced.
+  static constexpr uint32_t NO_ENTRY = 0xFFFFFFFF;
+
+  //! A distinct configuration carried by PACTYP_MPEGH3DACFG packets.
+  struct SConfigEntry {
+    //! Offset of the first config packet carrying this configuration.
+    uint64_t offset = 0;
+    //! Size of the config packet including the packet header.
+    uint32_t size = 0;
+    //! The MHAS packet label of the config packet.
+    uint64_t packetLabel = 0;
+    /*!
+     * The parsed configuration, null if parsing failed. Not persisted, so it is null for indices
+     * read by load().
+     */
+    std::shared_ptr<const CMpeghParser::SConfigInfo> configInfo;
+  };
+
+  //! A PACTYP_MPEGH3DAFRAME packet.
+  struct SFrameEntry {
+    //! Offset of the frame packet.
+    uint64_t offset = 0;
+    //! Size of the frame packet including the packet header.
+    uint32_t size = 0;
+    //! Index of the configuration active for this frame, NO_ENTRY if none has been seen so far.
+    uint32_t configIdx = NO_ENTRY;
+    //! Index of the last random access point at or before this frame, NO_ENTRY if there is none.
+    uint32_t randomAccessPointIdx = NO_ENTRY;
+  };
+
+  /*!
+   * A position decoding can start at: the packets preceding an independent frame, starting with
+   * the configuration (and optionally the SYNC packet) it depends on.
+   */
+  struct SRandomAccessPoint {
+    //! Offset of the first packet of the random access point.
+    uint64_t offset = 0;
+    //! Index of the independent frame of the random access point.
+    uint32_t frameIdx = 0;
+  };
+
+  //! Size of the indexed stream in bytes.
+  uint64_t streamSize = 0;
+  //! The distinct configurations in order of their first appearance.
+  std::vector<SConfigEntry> configs;
+  //! All frames in stream order.
+  std::vector<SFrameEntry> frames;
+  //! All random access points in stream order.
+  std::vector<SRandomAccessPoint> randomAccessPoints;
+
+  /*!
+   * @brief Writes the index to a file in a compact binary format.
+   *
+   * @param [in] path - the path of the index file
+   */
+  void save(const std::string& path) const;
+
+  /*!
+   * @brief Reads an index written by save().
+   *
+   * @param [in] path - the path of the index file
+   *
+   * @returns the index, without parsed configurations.
+   */
+  static SMhasIndex load(const std::string& path);
+};
+
+/*!
+ * @brief Builds the random access point index of MHAS streams.
+ *
+ * Files are memory-mapped and walked packet by packet without copying any payload. Each frame is
+ * linked to the configuration with the same packet label that precedes it. A frame is a random
+ * access point if its usacIndependencyFlag is set and a configuration packet precedes it since the
+ * last frame.
+ *
+ * Corrupted packets are skipped by resynchronizing to the next SYNC packet.
+ */
+class CMhasIndexer {
+ public:
+  /*!
+   * @brief Indexes an MHAS file.
+   *
+   * @param [in] path - the path of the MHAS file
+   *
+   * @returns the index of the file.
+   */
+  SMhasIndex indexFile(const std::string& path);
+
+  /*!
+   * @brief Indexes an MHAS stream in memory.
+   *
+   * @param [in] data - pointer to the MHAS byte stream, starting at a packet boundary
+   * @param [in] size - size of the byte stream in bytes
+   *
+   * @returns the index of the stream.
+   */
+  SMhasIndex indexBuffer(const uint8_t* data, size_t size);
+
+ private:
+  CMpeghParser m_configParser;
+};
+}  // namespace audioparser
+}  // namespace mmt
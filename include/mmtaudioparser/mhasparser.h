@@ -0,0 +1,246 @@
+/*-----------------------------------------------------------------------------
+Software License for The Fraunhofer FDK MPEG-H Software
+
+Copyright (c) 2024 Fraunhofer-Gesellschaft zur Förderung der angewandten
+Forschung e.V. and Contributors
+All rights reserved.
+
+1. INTRODUCTION
+
+The "Fraunhofer FDK MPEG-H Software" is software that implements the ISO/MPEG
+MPEG-H 3D Audio standard for digital audio or related system features. Patent
+licenses for necessary patent claims for the Fraunhofer FDK MPEG-H Software
+(including those of Fraunhofer), for the use in commercial products and
+services, may be obtained from the respective patent owners individually and/or
+from Via LA (www.via-la.com).
+
+Fraunhofer supports the development of MPEG-H products and services by offering
+additional software, documentation, and technical advice. In addition, it
+operates the MPEG-H Trademark Program to ease interoperability testing of end-
+products. Please visit www.mpegh.com for more information.
+
+2. COPYRIGHT LICENSE
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted without payment of copyright license fees provided that you
+satisfy the following conditions:
+
+* You must retain the complete text of this software license in redistributions
+of the Fraunhofer FDK MPEG-H Software or your modifications thereto in source
+code form.
+
+* You must retain the complete text of this software license in the
+documentation and/or other materials provided with redistributions of
+the Fraunhofer FDK MPEG-H Software or your modifications thereto in binary form.
+You must make available free of charge copies of the complete source code of
+the Fraunhofer FDK MPEG-H Software and your modifications thereto to recipients
+of copies in binary form.
+
+* The name of Fraunhofer may not be used to endorse or promote products derived
+from the Fraunhofer FDK MPEG-H Software without prior written permission.
+
+* You may not charge copyright license fees for anyone to use, copy or
+distribute the Fraunhofer FDK MPEG-H Software or your modifications thereto.
+
+* Your modified versions of the Fraunhofer FDK MPEG-H Software must carry
+prominent notices stating that you changed the software and the date of any
+change. For modified versions of the Fraunhofer FDK MPEG-H Software, the term
+"Fraunhofer FDK MPEG-H Software" must be replaced by the term "Third-Party
+Modified Version of the Fraunhofer FDK MPEG-H Software".
+
+3. No PATENT LICENSE
+
+NO EXPRESS OR IMPLIED LICENSES TO ANY PATENT CLAIMS, including without
+limitation the patents of Fraunhofer, ARE GRANTED BY THIS SOFTWARE LICENSE.
+Fraunhofer provides no warranty of patent non-infringement with respect to this
+software. You may use this Fraunhofer FDK MPEG-H Software or modifications
+thereto only for purposes that are authorized by appropriate patent licenses.
+
+4. DISCLAIMER
+
+This Fraunhofer FDK MPEG-H Software is provided by Fraunhofer on behalf of the
+copyright holders and contributors "AS IS" and WITHOUT ANY EXPRESS OR IMPLIED
+WARRANTIES, including but not limited to the implied warranties of
+merchantability and fitness for a particular purpose. IN NO EVENT SHALL THE
+COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE for any direct, indirect,
+incidental, special, exemplary, or consequential damages, including but not
+limited to procurement of substitute goods or services; loss of use, data, or
+profits, or business interruption, however caused and on any theory of
+liability, whether in contract, strict liability, or tort (including
+negligence), arising in any way out of the use of this software, even if
+advised of the possibility of such damage.
+
+5. CONTACT INFORMATION
+
+Fraunhofer Institute for Integrated Circuits IIS
+Attention: Division Audio and Media Technologies - MPEG-H FDK
+Am Wolfsmantel 33
+91058 Erlangen, Germany
+www.iis.fraunhofer.de/amm
+amm-info@iis.fraunhofer.de
+-----------------------------------------------------------------------------*/
+
+/*!
+ * @file mhasparser.h
+ *
+ * @brief Packet parser for MPEG-H 3D Audio Stream (MHAS) byte streams.
+ */
+
+#pragma once
+
+// System includes
+#include <cstddef>
+#include <cstdint>
+
+// External includes
+#include "ilo/common_types.h"
+
+// Internal includes
+#include "mmtaudioparser/version.h"
+#include "mmtaudioparser/mmtaudioparser.h"
+#include "mmtaudioparser/mpeghparser.h"
+
+namespace mmt {
+namespace audioparser {
+//! MHAS packet types as defined in ISO/IEC 23008-3 table 224.
+enum class EMhasPacketType : uint32_t {
+  PACTYP_FILLDATA = 0,
+  PACTYP_MPEGH3DACFG = 1,
+  PACTYP_MPEGH3DAFRAME = 2,
+  PACTYP_AUDIOSCENEINFO = 3,
+  PACTYP_SYNC = 6,
+  PACTYP_SYNCGAP = 7,
+  PACTYP_MARKER = 8,
+  PACTYP_CRC16 = 9,
+  PACTYP_CRC32 = 10,
+  PACTYP_DESCRIPTOR = 11,
+  PACTYP_USERINTERACTION = 12,
+  PACTYP_LOUDNESS_DRC = 13,
+  PACTYP_BUFFERINFO = 14,
+  PACTYP_GLOBAL_CRC16 = 15,
+  PACTYP_GLOBAL_CRC32 = 16,
+  PACTYP_AUDIOTRUNCATION = 17,
+  PACTYP_GENDATA = 18,
+  PACTYP_EARCON = 19,
+  PACTYP_PCMCONFIG = 20,
+  PACTYP_PCMDATA = 21,
+  PACTYP_LOUDNESS = 22
+};
+
+//! Representation of one mpeghAudioStreamPacket() structure.
+struct SMhasPacket {
+  //! The type of the packet.
+  EMhasPacketType packetType = EMhasPacketType::PACTYP_FILLDATA;
+  //! The label associating packets of the same configuration.
+  uint64_t packetLabel = 0;
+  //! The number of payload bytes.
+  uint32_t packetLength = 0;
+  //! The payload of the packet. Points into the buffer handed to the parser, no data is copied.
+  const uint8_t* payload = nullptr;
+  //! The number of bytes of the complete packet including the header.
+  size_t packetSize = 0;
+  /*!
+   * Outcome of feeding the payload of a PACTYP_MPEGH3DACFG packet into the attached config parser.
+   * Set to success for all other packets.
+   */
+  SParseResult configResult;
+};
+
+/*!
+ * @brief Splits an MHAS byte stream (ISO/IEC 23008-3 clause 14) into packets.
+ *
+ * The parser works on a caller-owned buffer and hands out views into it. Payloads of config
+ * packets are routed directly into an attached CMpeghParser, so the configuration is available as
+ * soon as its packet has been extracted.
+ *
+ * A byte stream arriving in chunks is processed by handing in all bytes not consumed so far
+ * together with the new chunk. Incomplete packets at the end of the buffer are not consumed.
+ */
+class CMhasParser {
+ public:
+  //! Creates a parser which only splits the stream into packets.
+  CMhasParser();
+  /*!
+   * @brief Creates a parser routing all config packets into the given config parser.
+   *
+   * @param [in] configParser - the parser fed with PACTYP_MPEGH3DACFG payloads, must outlive this
+   * parser
+   */
+  explicit CMhasParser(CMpeghParser& configParser);
+
+  /*!
+   * @brief Sets the buffer packets are extracted from.
+   *
+   * The buffer has to stay valid as long as packets are extracted from it or their payloads are
+   * used.
+   *
+   * @param [in] data - pointer to the MHAS byte stream, starting at a packet boundary
+   * @param [in] size - size of the byte stream in bytes
+   */
+  void setBuffer(const uint8_t* data, size_t size) noexcept;
+
+  /*!
+   * @brief Extracts the next packet from the buffer.
+   *
+   * @param [out] packet - the extracted packet, only valid on success
+   *
+   * @returns success if a complete packet has been extracted. EParseError::endOfBuffer indicates
+   * that the rest of the buffer does not hold a complete packet, which is not an error for a stream
+   * arriving in chunks. Other errors indicate a corrupted packet header, the stream has to be
+   * resynchronized then.
+   */
+  SParseResult nextPacket(SMhasPacket& packet) noexcept;
+
+  /*!
+   * @brief Skips forward to the next MHAS SYNC packet, e.g. to join a stream or after data loss.
+   *
+   * On success, the next packet extracted by nextPacket() is the SYNC packet. The configuration
+   * follows with the next PACTYP_MPEGH3DACFG packet.
+   *
+   * @param [in] numConfirmPackets - number of packets following a SYNC packet candidate whose
+   * headers have to be valid to accept the candidate
+   *
+   * @returns success if a SYNC packet has been found. Otherwise EParseError::endOfBuffer is
+   * returned and all bytes which cannot be the start of a SYNC packet are consumed.
+   */
+  SParseResult resync(uint32_t numConfirmPackets = 2) noexcept;
+
+  //! @returns the number of bytes of the buffer consumed by the extracted packets.
+  size_t bytesConsumed() const noexcept;
+
+  /*!
+   * @brief Parses the header of an MHAS packet.
+   *
+   * @param [in] data - pointer to the start of the packet
+   * @param [in] size - number of bytes available at data
+   * @param [out] packet - the packet header and payload view, only valid on success
+   *
+   * @returns success if the header and the complete payload are available.
+   */
+  static SParseResult parsePacket(const uint8_t* data, size_t size, SMhasPacket& packet) noexcept;
+
+  /*!
+   * @brief Searches for the next MHAS SYNC packet.
+   *
+   * Candidates are searched with a vectorized scan for the byte pattern of the SYNC packet. A
+   * candidate is only accepted if the headers of the following packets are valid as well. Packets
+   * cut off by the end of the buffer do not reject a candidate.
+   *
+   * @param [in] data - pointer to the MHAS byte stream
+   * @param [in] size - size of the byte stream in bytes
+   * @param [in] numConfirmPackets - number of packets following a SYNC packet candidate whose
+   * headers have to be valid to accept the candidate
+   *
+   * @returns the offset of the SYNC packet or size if there is none.
+   */
+  static size_t findSyncPacket(const uint8_t* data, size_t size,
+                               uint32_t numConfirmPackets = 2) noexcept;
+
+ private:
+  CMpeghParser* m_configParser;
+  const uint8_t* m_data;
+  size_t m_size;
+  size_t m_position;
+};
+}  // namespace audioparser
+}  // namespace mmt
@@ -89,6 +89,10 @@ amm-info@iis.fraunhofer.de
 #pragma once
 
 // System includes
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <stdexcept>
 
 // External includes
 #include "ilo/common_types.h"
@@ -98,6 +102,54 @@ amm-info@iis.fraunhofer.de
 
 namespace mmt {
 namespace audioparser {
+//! Error codes reported by the exception-free parse functions.
+enum class EParseError : uint8_t {
+  //! The configuration structure was parsed successfully.
+  ok = 0,
+  //! The given buffer is empty.
+  emptyBuffer,
+  //! The configuration structure ends before all signalled syntax elements could be read.
+  endOfBuffer,
+  //! A syntax element contains a value which is invalid or reserved.
+  invalidValue,
+  //! A syntax element signals a feature the parser does not support.
+  notSupported,
+  //! More data than allowed follows the configuration structure.
+  trailingData,
+  //! The visitor of CMpeghParser::scanConfig() stopped the scan before the end of the structure.
+  stopped,
+  //! The structure exceeds a limit configured for the parser.
+  limitExceeded,
+  //! Memory for storing the parsed structure could not be allocated.
+  outOfMemory,
+};
+
+//! Outcome of an exception-free parse operation.
+struct SParseResult {
+  //! The error which stopped the parsing, EParseError::ok on success.
+  EParseError error = EParseError::ok;
+  //! The bit position within the buffer at which the error was detected.
+  size_t bitOffset = 0;
+  //! Name of the syntax element or structure being parsed when the error occurred.
+  const char* syntaxElement = nullptr;
+
+  //! @returns whether the parse operation succeeded.
+  constexpr bool isOk() const noexcept { return error == EParseError::ok; }
+};
+
+//! View of a bit range within caller-owned memory, for structures which are not byte-aligned.
+struct SBitView {
+  //! The memory the range lies in.
+  const uint8_t* data = nullptr;
+  //! Position of the first bit of the range, counted from the most significant bit of data[0].
+  size_t bitOffset = 0;
+  //! The number of bits of the range.
+  size_t bitLength = 0;
+
+  //! @returns whether the range starts and ends at byte boundaries.
+  bool isByteAligned() const noexcept { return bitOffset % 8 == 0 && bitLength % 8 == 0; }
+};
+
 /*!
  * @brief Base interface for all implemented audio parsers
  */
@@ -115,6 +167,55 @@ class IAudioParser {
    */
   virtual void addConfig(const ilo::ByteBuffer& config) = 0;
 
+  /*!
+   * @brief Feeds in a new binary config from caller-owned memory.
+   *
+   * Behaves like addConfig(const ilo::ByteBuffer&), but parses the configuration directly from the
+   * given memory region without copying it. The memory only has to stay valid during this call.
+   *
+   * The default implementation copies the memory into a buffer passed to
+   * addConfig(const ilo::ByteBuffer&), so only parsers overriding it avoid the copy.
+   *
+   * @param [in] config - pointer to the parser-specific binary configuration structure
+   * @param [in] configSize - size of the binary configuration structure in bytes
+   */
+  virtual void addConfig(const uint8_t* config, size_t configSize) {
+    addConfig(ilo::ByteBuffer(config, config + configSize));
+  }
+
+  /*!
+   * @brief Feeds in a new binary config from caller-owned memory without throwing exceptions.
+   *
+   * Behaves like addConfig(const uint8_t*, size_t), but reports invalid configurations by means of
+   * the returned result instead of an exception.
+   *
+   * The default implementation calls addConfig(const uint8_t*, size_t). Parse errors, which are
+   * thrown as std::runtime_error, are reported as EParseError::invalidValue without bit offset and
+   * syntax element, and std::bad_alloc as EParseError::outOfMemory. Other exceptions indicate a
+   * programming error and are passed on. Parsers overriding it avoid the exception, report where
+   * parsing failed and may be noexcept.
+   *
+   * @param [in] config - pointer to the parser-specific binary configuration structure
+   * @param [in] configSize - size of the binary configuration structure in bytes
+   *
+   * @returns the error code as well as the bit offset and syntax element where parsing failed.
+   */
+  virtual SParseResult tryAddConfig(const uint8_t* config, size_t configSize) {
+    SParseResult result;
+    if (config == nullptr || configSize == 0) {
+      result.error = EParseError::emptyBuffer;
+      return result;
+    }
+    try {
+      addConfig(config, configSize);
+    } catch (const std::runtime_error&) {
+      result.error = EParseError::invalidValue;
+    } catch (const std::bad_alloc&) {
+      result.error = EParseError::outOfMemory;
+    }
+    return result;
+  }
+
   /*!
    * @returns whether the last parsed configuration buffer contained a valid configuration
    * structure.
@@ -0,0 +1,195 @@
+/*-----------------------------------------------------------------------------
+Software License for The Fraunhofer FDK MPEG-H Software
+
+Copyright (c) 2024 Fraunhofer-Gesellschaft zur Förderung der angewandten
+Forschung e.V. and Contributors
+All rights reserved.
+
+1. INTRODUCTION
+
+The "Fraunhofer FDK MPEG-H Software" is software that implements the ISO/MPEG
+MPEG-H 3D Audio standard for digital audio or related system features. Patent
+licenses for necessary patent claims for the Fraunhofer FDK MPEG-H Software
+(including those of Fraunhofer), for the use in commercial products and
+services, may be obtained from the respective patent owners individually and/or
+from Via LA (www.via-la.com).
+
+Fraunhofer supports the development of MPEG-H products and services by offering
+additional software, documentation, and technical advice. In addition, it
+operates the MPEG-H Trademark Program to ease interoperability testing of end-
+products. Please visit www.mpegh.com for more information.
+
+2. COPYRIGHT LICENSE
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted without payment of copyright license fees provided that you
+satisfy the following conditions:
+
+* You must retain the complete text of this software license in redistributions
+of the Fraunhofer FDK MPEG-H Software or your modifications thereto in source
+code form.
+
+* You must retain the complete text of this software license in the
+documentation and/or other materials provided with redistributions of
+the Fraunhofer FDK MPEG-H Software or your modifications thereto in binary form.
+You must make available free of charge copies of the complete source code of
+the Fraunhofer FDK MPEG-H Software and your modifications thereto to recipients
+of copies in binary form.
+
+* The name of Fraunhofer may not be used to endorse or promote products derived
+from the Fraunhofer FDK MPEG-H Software without prior written permission.
+
+* You may not charge copyright license fees for anyone to use, copy or
+distribute the Fraunhofer FDK MPEG-H Software or your modifications thereto.
+
+* Your modified versions of the Fraunhofer FDK MPEG-H Software must carry
+prominent notices stating that you changed the software and the date of any
+change. For modified versions of the Fraunhofer FDK MPEG-H Software, the term
+"Fraunhofer FDK MPEG-H Software" must be replaced by the term "Third-Party
+Modified Version of the Fraunhofer FDK MPEG-H Software".
+
+3. No PATENT LICENSE
+
+NO EXPRESS OR IMPLIED LICENSES TO ANY PATENT CLAIMS, including without
+limitation the patents of Fraunhofer, ARE GRANTED BY THIS SOFTWARE LICENSE.
+Fraunhofer provides no warranty of patent non-infringement with respect to this
+software. You may use this Fraunhofer FDK MPEG-H Software or modifications
+thereto only for purposes that are authorized by appropriate patent licenses.
+
+4. DISCLAIMER
+
+This Fraunhofer FDK MPEG-H Software is provided by Fraunhofer on behalf of the
+copyright holders and contributors "AS IS" and WITHOUT ANY EXPRESS OR IMPLIED
+WARRANTIES, including but not limited to the implied warranties of
+merchantability and fitness for a particular purpose. IN NO EVENT SHALL THE
+COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE for any direct, indirect,
+incidental, special, exemplary, or consequential damages, including but not
+limited to procurement of substitute goods or services; loss of use, data, or
+profits, or business interruption, however caused and on any theory of
+liability, whether in contract, strict liability, or tort (including
+negligence), arising in any way out of the use of this software, even if
+advised of the possibility of such damage.
+
+5. CONTACT INFORMATION
+
+Fraunhofer Institute for Integrated Circuits IIS
+Attention: Division Audio and Media Technologies - MPEG-H FDK
+Am Wolfsmantel 33
+91058 Erlangen, Germany
+www.iis.fraunhofer.de/amm
+amm-info@iis.fraunhofer.de
+-----------------------------------------------------------------------------*/
+
+/*!
+ * @file mmtaudioreassembler.h
+ *
+ * @brief Extraction of MPEG-H 3D Audio access units from MMT protocol (MMTP) packets.
+ */
+
+#pragma once
+
+// System includes
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// External includes
+#include "ilo/common_types.h"
+
+// Internal includes
+#include "mmtaudioparser/version.h"
+#include "mmtaudioparser/mmtaudioparser.h"
+#include "mmtaudioparser/mpeghparser.h"
+
+namespace mmt {
+namespace audioparser {
+//! An MPEG-H 3D Audio access unit carried by one media fragment unit (MFU).
+struct SMmtAccessUnit {
+  //! The MPU_sequence_number of the MPU the access unit belongs to.
+  uint32_t mpuSequenceNumber = 0;
+  //! The sample_number of the access unit within its movie fragment.
+  uint32_t sampleNumber = 0;
+  //! The MHAS packets of the access unit.
+  const uint8_t* data = nullptr;
+  //! The number of bytes at data.
+  size_t size = 0;
+  //! The payload of the PACTYP_MPEGH3DAFRAME packet, nullptr if the access unit contains none.
+  const uint8_t* frame = nullptr;
+  //! The number of bytes at frame.
+  size_t frameSize = 0;
+  //! Whether the access unit carries an in-band configuration.
+  bool configPresent = false;
+  //! The outcome of parsing the in-band configuration, success if there is none.
+  SParseResult configResult;
+};
+
+/*!
+ * @brief Walks the MMTP packets of an MPEG-H 3D Audio asset and extracts its access units.
+ *
+ * The asset is expected to be delivered in MPU mode (ISO/IEC 23008-1 clause 8) with each timed MFU
+ * holding one sample of MHAS packets, as used by mhm1 tracks in ATSC 3.0. In-band configurations
+ * are fed into the attached CMpeghParser directly from the packet data.
+ *
+ * Unfragmented MFUs, including aggregated ones, are handed out as views into the packet data
+ * without copying. MFUs fragmented across several packets are collected in an internal buffer,
+ * which is reused for all MFUs so that no allocations happen in steady state.
+ *
+ * MPU metadata and movie fragment metadata are skipped, as well as packets of other assets.
+ */
+class CMmtAudioReassembler {
+ public:
+  /*!
+   * @brief Creates a reassembler for one asset.
+   *
+   * @param [in] configParser - the parser fed with the in-band configurations, must outlive this
+   * reassembler
+   * @param [in] packetId - the packet_id of the MMTP packets carrying the asset
+   */
+  CMmtAudioReassembler(CMpeghParser& configParser, uint16_t packetId);
+
+  /*!
+   * @brief Processes one MMTP packet.
+   *
+   * Access units completed by this packet are appended to accessUnits. Views into the packet data
+   * stay valid as long as the packet data, views into the internal buffer until the next call.
+   *
+   * @param [in] packet - pointer to the MMTP packet, starting with the packet header
+   * @param [in] packetSize - size of the MMTP packet in bytes
+   * @param [out] accessUnits - the list completed access units are appended to
+   *
+   * @returns an error if the packet is malformed. Lost fragments are no error, the incomplete MFU
+   * is dropped then.
+   */
+  SParseResult addPacket(const uint8_t* packet, size_t packetSize,
+                         std::vector<SMmtAccessUnit>& accessUnits);
+
+  /*!
+   * @returns the number of MFUs dropped because of missing fragments. An MFU whose first fragment
+   * was lost is counted once, no matter how many of its fragments arrive.
+   */
+  uint64_t numDroppedUnits() const noexcept;
+
+ private:
+  SParseResult addDataUnit(const uint8_t* data, size_t size, uint8_t fragmentationIndicator,
+                           uint8_t fragmentCounter, uint32_t mpuSequenceNumber,
+                           std::vector<SMmtAccessUnit>& accessUnits);
+  void addAccessUnit(const uint8_t* data, size_t size, uint32_t mpuSequenceNumber,
+                     uint32_t sampleNumber, std::vector<SMmtAccessUnit>& accessUnits);
+  void dropFragments();
+  void dropUnit(uint32_t mpuSequenceNumber, uint32_t sampleNumber);
+
+  CMpeghParser& m_configParser;
+  uint16_t m_packetId;
+  ilo::ByteBuffer m_fragments;
+  bool m_fragmentsPending;
+  uint8_t m_nextFragmentCounter;
+  uint32_t m_fragmentsMpuSequenceNumber;
+  uint32_t m_fragmentsSampleNumber;
+  // The MFU dropped last, further fragments of it are not counted again
+  bool m_unitDropped;
+  uint32_t m_droppedMpuSequenceNumber;
+  uint32_t m_droppedSampleNumber;
+  uint64_t m_numDroppedUnits;
+};
+}  // namespace audioparser
+}  // namespace mmt
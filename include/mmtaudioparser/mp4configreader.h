@@ -0,0 +1,166 @@
+/*-----------------------------------------------------------------------------
+Software License for The Fraunhofer FDK MPEG-H Software
+
+Copyright (c) 2024 Fraunhofer-Gesellschaft zur Förderung der angewandten
+Forschung e.V. and Contributors
+All rights reserved.
+
+1. INTRODUCTION
+
+The "Fraunhofer FDK MPEG-H Software" is software that implements the ISO/MPEG
+MPEG-H 3D Audio standard for digital audio or related system features. Patent
+licenses for necessary patent claims for the Fraunhofer FDK MPEG-H Software
+(including those of Fraunhofer), for the use in commercial products and
+services, may be obtained from the respective patent owners individually and/or
+from Via LA (www.via-la.com).
+
+Fraunhofer supports the development of MPEG-H products and services by offering
+additional software, documentation, and technical advice. In addition, it
+operates the MPEG-H Trademark Program to ease interoperability testing of end-
+products. Please visit www.mpegh.com for more information.
+
+2. COPYRIGHT LICENSE
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted without payment of copyright license fees provided that you
+satisfy the following conditions:
+
+* You must retain the complete text of this software license in redistributions
+of the Fraunhofer FDK MPEG-H Software or your modifications thereto in source
+code form.
+
+* You must retain the complete text of this software license in the
+documentation and/or other materials provided with redistributions of
+the Fraunhofer FDK MPEG-H Software or your modifications thereto in binary form.
+You must make available free of charge copies of the complete source code of
+the Fraunhofer FDK MPEG-H Software and your modifications thereto to recipients
+of copies in binary form.
+
+* The name of Fraunhofer may not be used to endorse or promote products derived
+from the Fraunhofer FDK MPEG-H Software without prior written permission.
+
+* You may not charge copyright license fees for anyone to use, copy or
+distribute the Fraunhofer FDK MPEG-H Software or your modifications thereto.
+
+* Your modified versions of the Fraunhofer FDK MPEG-H Software must carry
+prominent notices stating that you changed the software and the date of any
+change. For modified versions of the Fraunhofer FDK MPEG-H Software, the term
+"Fraunhofer FDK MPEG-H Software" must be replaced by the term "Third-Party
+Modified Version of the Fraunhofer FDK MPEG-H Software".
+
+3. No PATENT LICENSE
+
+NO EXPRESS OR IMPLIED LICENSES TO ANY PATENT CLAIMS, including without
+limitation the patents of Fraunhofer, ARE GRANTED BY THIS SOFTWARE LICENSE.
+Fraunhofer provides no warranty of patent non-infringement with respect to this
+software. You may use this Fraunhofer FDK MPEG-H Software or modifications
+thereto only for purposes that are authorized by appropriate patent licenses.
+
+4. DISCLAIMER
+
+This Fraunhofer FDK MPEG-H Software is provided by Fraunhofer on behalf of the
+copyright holders and contributors "AS IS" and WITHOUT ANY EXPRESS OR IMPLIED
+WARRANTIES, including but not limited to the implied warranties of
+merchantability and fitness for a particular purpose. IN NO EVENT SHALL THE
+COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE for any direct, indirect,
+incidental, special, exemplary, or consequential damages, including but not
+limited to procurement of substitute goods or services; loss of use, data, or
+profits, or business interruption, however caused and on any theory of
+liability, whether in contract, strict liability, or tort (including
+negligence), arising in any way out of the use of this software, even if
+advised of the possibility of such damage.
+
+5. CONTACT INFORMATION
+
+Fraunhofer Institute for Integrated Circuits IIS
+Attention: Division Audio and Media Technologies - MPEG-H FDK
+Am Wolfsmantel 33
+91058 Erlangen, Germany
+www.iis.fraunhofer.de/amm
+amm-info@iis.fraunhofer.de
+-----------------------------------------------------------------------------*/
+
+/*!
+ * @file mp4configreader.h
+ *
+ * @brief Extraction of MPEG-H 3D Audio configurations from ISOBMFF (MP4) files.
+ */
+
+#pragma once
+
+// System includes
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+// External includes
+#include "ilo/common_types.h"
+
+// Internal includes
+#include "mmtaudioparser/version.h"
+#include "mmtaudioparser/mmtaudioparser.h"
+#include "mmtaudioparser/mpeghparser.h"
+
+namespace mmt {
+namespace audioparser {
+//! MPEG-H 3D Audio configuration of an ISOBMFF track as defined in ISO/IEC 23008-3 clause 20.
+struct SMhaTrackConfig {
+  //! The track_ID of the track as signalled in the track header box.
+  uint32_t trackId = 0;
+  //! The four character code of the sample entry, i.e. mha1, mha2, mhm1 or mhm2.
+  uint32_t sampleEntryType = 0;
+  //! Whether the sample entry contains an MHADecoderConfigurationRecord.
+  bool configPresent = false;
+  //! The mpegh3daProfileLevelIndication of the MHADecoderConfigurationRecord.
+  uint8_t profileLevelIndication = 0;
+  //! The referenceChannelLayout of the MHADecoderConfigurationRecord.
+  uint8_t referenceChannelLayout = 0;
+  //! The outcome of parsing the contained mpegh3daConfig() structure.
+  SParseResult parseResult;
+  //! The parsed configuration, only set if configPresent is true and parsing succeeded.
+  std::shared_ptr<const CMpeghParser::SConfigInfo> configInfo;
+};
+
+/*!
+ * @brief Reads the MPEG-H 3D Audio configurations of all tracks of an ISOBMFF file.
+ *
+ * Only the boxes on the path moov/trak/mdia/minf/stbl/stsd/mha1|mha2|mhm1|mhm2/mhaC are visited,
+ * all other boxes like mdat are skipped by their size without touching their content. Files are
+ * memory-mapped and the configuration is parsed in place.
+ *
+ * A malformed box structure throws, invalid configurations are reported per track.
+ *
+ * @note The MHADecoderConfigurationRecord is optional for mhm1 and mhm2 sample entries, the
+ * configuration is carried in-band by the MHAS stream then.
+ */
+class CMp4ConfigReader {
+ public:
+  /*!
+   * @brief Reads the configurations of an ISOBMFF file.
+   *
+   * @param [in] path - the path of the ISOBMFF file
+   *
+   * @returns one entry per MPEG-H 3D Audio sample entry in file order.
+   */
+  std::vector<SMhaTrackConfig> readFile(const std::string& path);
+
+  /*!
+   * @brief Reads the configurations of an ISOBMFF file in memory.
+   *
+   * @param [in] data - pointer to the ISOBMFF file
+   * @param [in] size - size of the file in bytes
+   *
+   * @returns one entry per MPEG-H 3D Audio sample entry in file order.
+   */
+  std::vector<SMhaTrackConfig> readBuffer(const uint8_t* data, size_t size);
+
+ private:
+  void readTrack(const uint8_t* data, size_t size, std::vector<SMhaTrackConfig>& configs);
+  void readSampleEntry(const uint8_t* data, size_t size, SMhaTrackConfig& config);
+
+  CMpeghParser m_configParser;
+};
+}  // namespace audioparser
+}  // namespace mmt
@@ -0,0 +1,184 @@
+/*-----------------------------------------------------------------------------
+Software License for The Fraunhofer FDK MPEG-H Software
+
+Copyright (c) 2024 Fraunhofer-Gesellschaft zur Förderung der angewandten
+Forschung e.V. and Contributors
+All rights reserved.
+
+1. INTRODUCTION
+
+The "Fraunhofer FDK MPEG-H Software" is software that implements the ISO/MPEG
+MPEG-H 3D Audio standard for digital audio or related system features. Patent
+licenses for necessary patent claims for the Fraunhofer FDK MPEG-H Software
+(including those of Fraunhofer), for the use in commercial products and
+services, may be obtained from the respective patent owners individually and/or
+from Via LA (www.via-la.com).
+
+Fraunhofer supports the development of MPEG-H products and services by offering
+additional software, documentation, and technical advice. In addition, it
+operates the MPEG-H Trademark Program to ease interoperability testing of end-
+products. Please visit www.mpegh.com for more information.
+
+2. COPYRIGHT LICENSE
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted without payment of copyright license fees provided that you
+satisfy the following conditions:
+
+* You must retain the complete text of this software license in redistributions
+of the Fraunhofer FDK MPEG-H Software or your modifications thereto in source
+code form.
+
+* You must retain the complete text of this software license in the
+documentation and/or other materials provided with redistributions of
+the Fraunhofer FDK MPEG-H Software or your modifications thereto in binary form.
+You must make available free of charge copies of the complete source code of
+the Fraunhofer FDK MPEG-H Software and your modifications thereto to recipients
+of copies in binary form.
+
+* The name of Fraunhofer may not be used to endorse or promote products derived
+from the Fraunhofer FDK MPEG-H Software without prior written permission.
+
+* You may not charge copyright license fees for anyone to use, copy or
+distribute the Fraunhofer FDK MPEG-H Software or your modifications thereto.
+
+* Your modified versions of the Fraunhofer FDK MPEG-H Software must carry
+prominent notices stating that you changed the software and the date of any
+change. For modified versions of the Fraunhofer FDK MPEG-H Software, the term
+"Fraunhofer FDK MPEG-H Software" must be replaced by the term "Third-Party
+Modified Version of the Fraunhofer FDK MPEG-H Software".
+
+3. No PATENT LICENSE
+
+NO EXPRESS OR IMPLIED LICENSES TO ANY PATENT CLAIMS, including without
+limitation the patents of Fraunhofer, ARE GRANTED BY THIS SOFTWARE LICENSE.
+Fraunhofer provides no warranty of patent non-infringement with respect to this
+software. You may use this Fraunhofer FDK MPEG-H Software or modifications
+thereto only for purposes that are authorized by appropriate patent licenses.
+
+4. DISCLAIMER
+
+This Fraunhofer FDK MPEG-H Software is provided by Fraunhofer on behalf of the
+copyright holders and contributors "AS IS" and WITHOUT ANY EXPRESS OR IMPLIED
+WARRANTIES, including but not limited to the implied warranties of
+merchantability and fitness for a particular purpose. IN NO EVENT SHALL THE
+COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE for any direct, indirect,
+incidental, special, exemplary, or consequential damages, including but not
+limited to procurement of substitute goods or services; loss of use, data, or
+profits, or business interruption, however caused and on any theory of
+liability, whether in contract, strict liability, or tort (including
+negligence), arising in any way out of the use of this software, even if
+advised of the possibility of such damage.
+
+5. CONTACT INFORMATION
+
+Fraunhofer Institute for Integrated Circuits IIS
+Attention: Division Audio and Media Technologies - MPEG-H FDK
+Am Wolfsmantel 33
+91058 Erlangen, Germany
+www.iis.fraunhofer.de/amm
+amm-info@iis.fraunhofer.de
+-----------------------------------------------------------------------------*/
+
+/*!
+ * @file mpeghbatchparser.h
+ *
+ * @brief Parallel parsing of many MPEG-H 3D Audio configuration structures.
+ */
+
+#pragma once
+
+// System includes
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// External includes
+#include "ilo/common_types.h"
+
+// Internal includes
+#include "mmtaudioparser/version.h"
+#include "mmtaudioparser/mmtaudioparser.h"
+#include "mmtaudioparser/mpeghparser.h"
+
+namespace mmt {
+namespace audioparser {
+/*!
+ * @brief Parses batches of independent MPEG-H 3D Audio configuration structures on a worker pool.
+ *
+ * The input is split into small chunks which idle workers claim one after another, so a worker
+ * hitting expensive configurations does not hold back the others. Every worker keeps its own
+ * CMpeghParser (including its arena) across chunks and batches, so no parser state is shared
+ * between threads and steady-state parsing does not allocate beyond the result snapshots.
+ *
+ * @note One batch parser instance must not run multiple batches concurrently.
+ */
+class CMpeghBatchParser {
+ public:
+  //! Options controlling the batch parsing.
+  struct SBatchOptions {
+    //! Number of worker threads, 0 selects the number of hardware threads.
+    uint32_t numWorkers = 0;
+    //! Number of configurations claimed by a worker at once.
+    size_t chunkSize = 64;
+  };
+
+  //! A binary configuration structure in caller-owned memory.
+  struct SInput {
+    //! Pointer to the binary MPEG-H 3D Audio configuration structure.
+    const uint8_t* data = nullptr;
+    //! Size of the binary MPEG-H 3D Audio configuration structure in bytes.
+    size_t size = 0;
+  };
+
+  //! Outcome of parsing one configuration of a batch.
+  struct SItemResult {
+    //! The error code as well as the bit offset and syntax element where parsing failed.
+    SParseResult parseResult;
+    //! The parsed configuration info, only set if parsing succeeded.
+    std::shared_ptr<const CMpeghParser::SConfigInfo> configInfo;
+  };
+
+  CMpeghBatchParser();
+  explicit CMpeghBatchParser(const SBatchOptions& options);
+  ~CMpeghBatchParser();
+
+  CMpeghBatchParser(const CMpeghBatchParser&) = delete;
+  CMpeghBatchParser& operator=(const CMpeghBatchParser&) = delete;
+
+  /*!
+   * @brief Parses the given configuration structures.
+   *
+   * The memory of all inputs only has to stay valid during this call. Invalid configurations are
+   * reported in the corresponding result entry and do not affect the other entries. If not all
+   * worker threads can be started, the batch is parsed by the ones started so far.
+   *
+   * @note The configurations are parsed by CMpeghParser::tryAddConfig(), so running out of memory
+   * while parsing an input is reported as EParseError::outOfMemory in its result entry.
+   *
+   * @param [in] inputs - pointer to the first entry of the configuration list
+   * @param [in] numInputs - the number of configurations to parse
+   *
+   * @returns one result per input in input order.
+   */
+  std::vector<SItemResult> parse(const SInput* inputs, size_t numInputs);
+
+  /*!
+   * @brief Parses the given configuration buffers.
+   *
+   * @param [in] configs - the binary MPEG-H 3D Audio configuration structures
+   *
+   * @returns one result per input in input order.
+   */
+  std::vector<SItemResult> parse(const std::vector<ilo::ByteBuffer>& configs);
+
+  //! @returns the number of worker threads used for parsing.
+  uint32_t numWorkers() const noexcept;
+
+ private:
+  SBatchOptions m_options;
+  std::vector<CUCMpeghParser> m_parsers;
+};
+}  // namespace audioparser
+}  // namespace mmt
@@ -0,0 +1,207 @@
+/*-----------------------------------------------------------------------------
+Software License for The Fraunhofer FDK MPEG-H Software
+
+Copyright (c) 2024 Fraunhofer-Gesellschaft zur Förderung der angewandten
+Forschung e.V. and Contributors
+All rights reserved.
+
+1. INTRODUCTION
+
+The "Fraunhofer FDK MPEG-H Software" is software that implements the ISO/MPEG
+MPEG-H 3D Audio standard for digital audio or related system features. Patent
+licenses for necessary patent claims for the Fraunhofer FDK MPEG-H Software
+(including those of Fraunhofer), for the use in commercial products and
+services, may be obtained from the respective patent owners individually and/or
+from Via LA (www.via-la.com).
+
+Fraunhofer supports the development of MPEG-H products and services by offering
+additional software, documentation, and technical advice. In addition, it
+operates the MPEG-H Trademark Program to ease interoperability testing of end-
+products. Please visit www.mpegh.com for more information.
+
+2. COPYRIGHT LICENSE
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted without payment of copyright license fees provided that you
+satisfy the following conditions:
+
+* You must retain the complete text of this software license in redistributions
+of the Fraunhofer FDK MPEG-H Software or your modifications thereto in source
+code form.
+
+* You must retain the complete text of this software license in the
+documentation and/or other materials provided with redistributions of
+the Fraunhofer FDK MPEG-H Software or your modifications thereto in binary form.
+You must make available free of charge copies of the complete source code of
+the Fraunhofer FDK MPEG-H Software and your modifications thereto to recipients
+of copies in binary form.
+
+* The name of Fraunhofer may not be used to endorse or promote products derived
+from the Fraunhofer FDK MPEG-H Software without prior written permission.
+
+* You may not charge copyright license fees for anyone to use, copy or
+distribute the Fraunhofer FDK MPEG-H Software or your modifications thereto.
+
+* Your modified versions of the Fraunhofer FDK MPEG-H Software must carry
+prominent notices stating that you changed the software and the date of any
+change. For modified versions of the Fraunhofer FDK MPEG-H Software, the term
+"Fraunhofer FDK MPEG-H Software" must be replaced by the term "Third-Party
+Modified Version of the Fraunhofer FDK MPEG-H Software".
+
+3. No PATENT LICENSE
+
+NO EXPRESS OR IMPLIED LICENSES TO ANY PATENT CLAIMS, including without
+limitation the patents of Fraunhofer, ARE GRANTED BY THIS SOFTWARE LICENSE.
+Fraunhofer provides no warranty of patent non-infringement with respect to this
+software. You may use this Fraunhofer FDK MPEG-H Software or modifications
+thereto only for purposes that are authorized by appropriate patent licenses.
+
+4. DISCLAIMER
+
+This Fraunhofer FDK MPEG-H Software is provided by Fraunhofer on behalf of the
+copyright holders and contributors "AS IS" and WITHOUT ANY EXPRESS OR IMPLIED
+WARRANTIES, including but not limited to the implied warranties of
+merchantability and fitness for a particular purpose. IN NO EVENT SHALL THE
+COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE for any direct, indirect,
+incidental, special, exemplary, or consequential damages, including but not
+limited to procurement of substitute goods or services; loss of use, data, or
+profits, or business interruption, however caused and on any theory of
+liability, whether in contract, strict liability, or tort (including
+negligence), arising in any way out of the use of this software, even if
+advised of the possibility of such damage.
+
+5. CONTACT INFORMATION
+
+Fraunhofer Institute for Integrated Circuits IIS
+Attention: Division Audio and Media Technologies - MPEG-H FDK
+Am Wolfsmantel 33
+91058 Erlangen, Germany
+www.iis.fraunhofer.de/amm
+amm-info@iis.fraunhofer.de
+-----------------------------------------------------------------------------*/
+
+/*!
+ * @file mpeghconfigvisitor.h
+ *
+ * @brief Visitor interface receiving the structures of an MPEG-H 3D Audio mpegh3daConfig() while
+ * it is scanned by CMpeghParser::scanConfig().
+ */
+
+#pragma once
+
+// System includes
+#include <cstdint>
+
+// Internal includes
+#include "mmtaudioparser/version.h"
+
+namespace mmt {
+namespace audioparser {
+/*!
+ * @brief Receives the structures of an mpegh3daConfig() in bitstream order as they are decoded.
+ *
+ * Each structure is reported as soon as its own fields are decoded, so it is reported before the
+ * structures nested into it. E.g. a signal group is followed by its layout, which is followed by
+ * its loudspeakers. The reported values are only valid during the call.
+ *
+ * Every function returns whether the scan shall continue. Returning false stops the scan right
+ * away, so a visitor only interested in the first structures does not pay for the remaining ones.
+ * All functions default to continuing the scan. They are noexcept, since the scan itself does not
+ * throw exceptions.
+ */
+class IMpeghConfigVisitor {
+ public:
+  //! Value used for structures not belonging to a signal group.
+  static constexpr uint32_t NO_SIGNAL_GROUP = 0xFFFFFFFF;
+
+  //! The fields of mpegh3daConfig() preceding the reference layout.
+  struct SHeader {
+    //! Indication of the MPEG-H 3D audio profile and level according to ISO/IEC 23008-3 table 67.
+    uint8_t profileLevelIndicator = 0;
+    //! The index into the USAC sampling frequency mapping.
+    uint8_t samplingFrequencyIndex = 0;
+    //! The effective sampling frequency in Hz.
+    uint32_t samplingFrequency = 0;
+    //! The index into the core coder frame length and SBR ratio mapping.
+    uint8_t coreSbrFrameLengthIndex = 0;
+    //! Whether the receiver delay compensation is active.
+    bool receiverDelayCompensation = false;
+  };
+
+  //! A SpeakerConfig3d() structure.
+  struct SSpeakerLayout {
+    //! The signal group defining the layout, NO_SIGNAL_GROUP for the reference layout.
+    uint32_t signalGroupIdx = NO_SIGNAL_GROUP;
+    //! Whether the layout is the downmix layout of an SAOC signal group.
+    bool isSaocDownmixLayout = false;
+    //! The speakerLayoutType, 0 if the layout is given by a CICP ChannelConfiguration index.
+    uint8_t speakerLayoutType = 0;
+    //! The CICP ChannelConfiguration index, only valid for speakerLayoutType 0.
+    uint8_t CICPIdx = 0;
+    //! The number of loudspeakers.
+    uint32_t numSpeakers = 0;
+  };
+
+  /*!
+   * One loudspeaker of the last reported SpeakerConfig3d(), if its speakerLayoutType is 1 or 2.
+   * The loudspeakers of a CICP ChannelConfiguration are not reported, a symmetric pair is reported
+   * as two loudspeakers.
+   */
+  struct SSpeaker {
+    //! Index of the loudspeaker within its layout.
+    uint32_t speakerIdx = 0;
+    //! Whether the loudspeaker is given by a CICP SpeakerPosition index.
+    bool isCICPspeakerIdx = false;
+    //! The CICP SpeakerPosition index, only valid if isCICPspeakerIdx is set.
+    uint8_t CICPspeakerIdx = 0;
+    //! Azimuth in degrees, positive values to the left. 0 for screen-relative loudspeakers.
+    int32_t azimuth = 0;
+    //! Elevation in degrees, positive values above the listener.
+    int32_t elevation = 0;
+    //! Whether the loudspeaker is a low frequency effects loudspeaker.
+    bool isLFE = false;
+  };
+
+  //! One signal group of the Signals3d() structure.
+  struct SSignalGroup {
+    //! Index of the signal group.
+    uint32_t signalGroupIdx = 0;
+    //! The signal group type, as defined in ISO/IEC 23008-3 table 34.
+    uint8_t signalGroupType = 0;
+    //! The number of signals in this signal group.
+    uint32_t numSignals = 0;
+  };
+
+  //! One element config of the mpegh3daDecoderConfig() structure.
+  struct SElement {
+    //! Index of the element.
+    uint32_t elementIdx = 0;
+    //! The usacElementType.
+    uint8_t usacElementType = 0;
+    //! The usacExtElementType, only valid for extension elements.
+    uint32_t usacExtElementType = 0;
+  };
+
+  //! One entry of the mpegh3daConfigExtension() structure.
+  struct SConfigExtension {
+    //! The usacConfigExtType.
+    uint32_t usacConfigExtType = 0;
+    //! The length of the extension payload in bytes.
+    uint32_t usacConfigExtLength = 0;
+  };
+
+  virtual ~IMpeghConfigVisitor() noexcept = default;
+
+  virtual bool visitHeader(const SHeader& /*header*/) noexcept { return true; }
+  virtual bool visitSpeakerLayout(const SSpeakerLayout& /*layout*/) noexcept { return true; }
+  virtual bool visitSpeaker(const SSpeaker& /*speaker*/) noexcept { return true; }
+  virtual bool visitSignalGroup(const SSignalGroup& /*signalGroup*/) noexcept { return true; }
+  virtual bool visitElement(const SElement& /*element*/) noexcept { return true; }
+  //! Reports every compatibleSetIndication of the compatible profile level sets.
+  virtual bool visitCompatibleProfileLevel(uint8_t /*profileLevel*/) noexcept { return true; }
+  virtual bool visitConfigExtension(const SConfigExtension& /*configExtension*/) noexcept {
+    return true;
+  }
+};
+}  // namespace audioparser
+}  // namespace mmt
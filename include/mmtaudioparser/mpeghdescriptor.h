@@ -0,0 +1,172 @@
+/*-----------------------------------------------------------------------------
+Software License for The Fraunhofer FDK MPEG-H Software
+
+Copyright (c) 2024 Fraunhofer-Gesellschaft zur Förderung der angewandten
+Forschung e.V. and Contributors
+All rights reserved.
+
+1. INTRODUCTION
+
+The "Fraunhofer FDK MPEG-H Software" is software that implements the ISO/MPEG
+MPEG-H 3D Audio standard for digital audio or related system features. Patent
+licenses for necessary patent claims for the Fraunhofer FDK MPEG-H Software
+(including those of Fraunhofer), for the use in commercial products and
+services, may be obtained from the respective patent owners individually and/or
+from Via LA (www.via-la.com).
+
+Fraunhofer supports the development of MPEG-H products and services by offering
+additional software, documentation, and technical advice. In addition, it
+operates the MPEG-H Trademark Program to ease interoperability testing of end-
+products. Please visit www.mpegh.com for more information.
+
+2. COPYRIGHT LICENSE
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted without payment of copyright license fees provided that you
+satisfy the following conditions:
+
+* You must retain the complete text of this software license in redistributions
+of the Fraunhofer FDK MPEG-H Software or your modifications thereto in source
+code form.
+
+* You must retain the complete text of this software license in the
+documentation and/or other materials provided with redistributions of
+the Fraunhofer FDK MPEG-H Software or your modifications thereto in binary form.
+You must make available free of charge copies of the complete source code of
+the Fraunhofer FDK MPEG-H Software and your modifications thereto to recipients
+of copies in binary form.
+
+* The name of Fraunhofer may not be used to endorse or promote products derived
+from the Fraunhofer FDK MPEG-H Software without prior written permission.
+
+* You may not charge copyright license fees for anyone to use, copy or
+distribute the Fraunhofer FDK MPEG-H Software or your modifications thereto.
+
+* Your modified versions of the Fraunhofer FDK MPEG-H Software must carry
+prominent notices stating that you changed the software and the date of any
+change. For modified versions of the Fraunhofer FDK MPEG-H Software, the term
+"Fraunhofer FDK MPEG-H Software" must be replaced by the term "Third-Party
+Modified Version of the Fraunhofer FDK MPEG-H Software".
+
+3. No PATENT LICENSE
+
+NO EXPRESS OR IMPLIED LICENSES TO ANY PATENT CLAIMS, including without
+limitation the patents of Fraunhofer, ARE GRANTED BY THIS SOFTWARE LICENSE.
+Fraunhofer provides no warranty of patent non-infringement with respect to this
+software. You may use this Fraunhofer FDK MPEG-H Software or modifications
+thereto only for purposes that are authorized by appropriate patent licenses.
+
+4. DISCLAIMER
+
+This Fraunhofer FDK MPEG-H Software is provided by Fraunhofer on behalf of the
+copyright holders and contributors "AS IS" and WITHOUT ANY EXPRESS OR IMPLIED
+WARRANTIES, including but not limited to the implied warranties of
+merchantability and fitness for a particular purpose. IN NO EVENT SHALL THE
+COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE for any direct, indirect,
+incidental, special, exemplary, or consequential damages, including but not
+limited to procurement of substitute goods or services; loss of use, data, or
+profits, or business interruption, however caused and on any theory of
+liability, whether in contract, strict liability, or tort (including
+negligence), arising in any way out of the use of this software, even if
+advised of the possibility of such damage.
+
+5. CONTACT INFORMATION
+
+Fraunhofer Institute for Integrated Circuits IIS
+Attention: Division Audio and Media Technologies - MPEG-H FDK
+Am Wolfsmantel 33
+91058 Erlangen, Germany
+www.iis.fraunhofer.de/amm
+amm-info@iis.fraunhofer.de
+-----------------------------------------------------------------------------*/
+
+/*!
+ * @file mpeghdescriptor.h
+ *
+ * @brief Parsers for the MPEG-H 3D Audio transport signalling descriptors.
+ */
+
+#pragma once
+
+// System includes
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// External includes
+#include "ilo/common_types.h"
+
+// Internal includes
+#include "mmtaudioparser/version.h"
+#include "mmtaudioparser/mmtaudioparser.h"
+#include "mmtaudioparser/mpeghparser.h"
+
+namespace mmt {
+namespace audioparser {
+//! Representation of the MPEG-H_3dAudio_descriptor() as defined in ISO/IEC 13818-1.
+struct SMpegh3daDescriptor {
+  //! The tag of the descriptor as signalled in the descriptor header.
+  uint16_t descriptorTag = 0;
+  //! Indication of the MPEG-H 3D audio profile and level according to ISO/IEC 23008-3 table 67.
+  uint8_t profileLevelIndication = 0;
+  //! Whether the audio stream contains elements enabling user interactivity.
+  bool interactivityEnabled = false;
+  //! The ChannelConfiguration as defined in ISO/IEC 23091-3 the content is produced for.
+  uint8_t referenceChannelLayout = 0;
+  //! The compatible profile level sets, empty if not signalled.
+  std::vector<uint8_t> compatibleSetIndications;
+};
+
+/*!
+ * @brief Parsers for the descriptors carrying the MPEG-H 3D Audio stream properties in transport
+ * signalling tables.
+ *
+ * The descriptors arrive with the signalling tables ahead of the first in-band configuration, so
+ * the derived configuration info can be handed to CMpeghParser::setPreliminaryConfig() to start
+ * playback early.
+ */
+class CMpeghDescriptorParser {
+ public:
+  //! The descriptor_tag of the extension descriptor in an MPEG-2 TS.
+  static constexpr uint8_t TS_EXTENSION_DESCRIPTOR_TAG = 0x3F;
+  //! The descriptor_tag_extension of the MPEG-H_3dAudio_descriptor() in an MPEG-2 TS.
+  static constexpr uint8_t TS_MPEGH_3DAUDIO_DESCRIPTOR_TAG_EXTENSION = 0x08;
+
+  /*!
+   * @brief Parses an MPEG-H_3dAudio_descriptor() from an MPEG-2 TS program map table.
+   *
+   * @param [in] data - pointer to the descriptor, starting with the descriptor_tag
+   * @param [in] size - number of bytes available at data
+   * @param [out] descriptor - the parsed descriptor, only valid on success
+   *
+   * @returns EParseError::notSupported if the data holds another descriptor, any other error if the
+   * descriptor is malformed.
+   */
+  static SParseResult parseTsDescriptor(const uint8_t* data, size_t size,
+                                        SMpegh3daDescriptor& descriptor) noexcept;
+
+  /*!
+   * @brief Parses an MPEG-H 3D Audio descriptor from an MMT signalling table, e.g. the MMT Package
+   * Table.
+   *
+   * MMT descriptors start with a 16 bit descriptor_tag and an 8 bit descriptor_length, followed by
+   * the same fields as the MPEG-2 TS descriptor. The value of the tag is assigned by the
+   * application standard, so it is returned in the descriptor for the caller to check.
+   *
+   * @param [in] data - pointer to the descriptor, starting with the descriptor_tag
+   * @param [in] size - number of bytes available at data
+   * @param [out] descriptor - the parsed descriptor, only valid on success
+   */
+  static SParseResult parseMmtDescriptor(const uint8_t* data, size_t size,
+                                         SMpegh3daDescriptor& descriptor) noexcept;
+
+  /*!
+   * @brief Derives the configuration info signalled by a descriptor.
+   *
+   * Only the profile level, the reference layout and the compatible profile level sets are known
+   * from a descriptor, all other fields keep their default values.
+   */
+  static CMpeghParser::SConfigInfo toConfigInfo(const SMpegh3daDescriptor& descriptor);
+};
+}  // namespace audioparser
+}  // namespace mmt
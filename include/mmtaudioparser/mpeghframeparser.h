@@ -0,0 +1,221 @@
+/*-----------------------------------------------------------------------------
+Software License for The Fraunhofer FDK MPEG-H Software
+
+Copyright (c) 2024 Fraunhofer-Gesellschaft zur Förderung der angewandten
+Forschung e.V. and Contributors
+All rights reserved.
+
+1. INTRODUCTION
+
+The "Fraunhofer FDK MPEG-H Software" is software that implements the ISO/MPEG
+MPEG-H 3D Audio standard for digital audio or related system features. Patent
+licenses for necessary patent claims for the Fraunhofer FDK MPEG-H Software
+(including those of Fraunhofer), for the use in commercial products and
+services, may be obtained from the respective patent owners individually and/or
+from Via LA (www.via-la.com).
+
+Fraunhofer supports the development of MPEG-H products and services by offering
+additional software, documentation, and technical advice. In addition, it
+operates the MPEG-H Trademark Program to ease interoperability testing of end-
+products. Please visit www.mpegh.com for more information.
+
+2. COPYRIGHT LICENSE
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted without payment of copyright license fees provided that you
+satisfy the following conditions:
+
+* You must retain the complete text of this software license in redistributions
+of the Fraunhofer FDK MPEG-H Software or your modifications thereto in source
+code form.
+
+* You must retain the complete text of this software license in the
+documentation and/or other materials provided with redistributions of
+the Fraunhofer FDK MPEG-H Software or your modifications thereto in binary form.
+You must make available free of charge copies of the complete source code of
+the Fraunhofer FDK MPEG-H Software and your modifications thereto to recipients
+of copies in binary form.
+
+* The name of Fraunhofer may not be used to endorse or promote products derived
+from the Fraunhofer FDK MPEG-H Software without prior written permission.
+
+* You may not charge copyright license fees for anyone to use, copy or
+distribute the Fraunhofer FDK MPEG-H Software or your modifications thereto.
+
+* Your modified versions of the Fraunhofer FDK MPEG-H Software must carry
+prominent notices stating that you changed the software and the date of any
+change. For modified versions of the Fraunhofer FDK MPEG-H Software, the term
+"Fraunhofer FDK MPEG-H Software" must be replaced by the term "Third-Party
+Modified Version of the Fraunhofer FDK MPEG-H Software".
+
+3. No PATENT LICENSE
+
+NO EXPRESS OR IMPLIED LICENSES TO ANY PATENT CLAIMS, including without
+limitation the patents of Fraunhofer, ARE GRANTED BY THIS SOFTWARE LICENSE.
+Fraunhofer provides no warranty of patent non-infringement with respect to this
+software. You may use this Fraunhofer FDK MPEG-H Software or modifications
+thereto only for purposes that are authorized by appropriate patent licenses.
+
+4. DISCLAIMER
+
+This Fraunhofer FDK MPEG-H Software is provided by Fraunhofer on behalf of the
+copyright holders and contributors "AS IS" and WITHOUT ANY EXPRESS OR IMPLIED
+WARRANTIES, including but not limited to the implied warranties of
+merchantability and fitness for a particular purpose. IN NO EVENT SHALL THE
+COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE for any direct, indirect,
+incidental, special, exemplary, or consequential damages, including but not
+limited to procurement of substitute goods or services; loss of use, data, or
+profits, or business interruption, however caused and on any theory of
+liability, whether in contract, strict liability, or tort (including
+negligence), arising in any way out of the use of this software, even if
+advised of the possibility of such damage.
+
+5. CONTACT INFORMATION
+
+Fraunhofer Institute for Integrated Circuits IIS
+Attention: Division Audio and Media Technologies - MPEG-H FDK
+Am Wolfsmantel 33
+91058 Erlangen, Germany
+www.iis.fraunhofer.de/amm
+amm-info@iis.fraunhofer.de
+-----------------------------------------------------------------------------*/
+
+/*!
+ * @file mpeghframeparser.h
+ *
+ * @brief Splitter for the elements of the MPEG-H 3D Audio mpegh3daFrame() structure and parser of
+ * the AudioPreRoll() extension payload.
+ */
+
+#pragma once
+
+// System includes
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// External includes
+#include "ilo/common_types.h"
+
+// Internal includes
+#include "mmtaudioparser/version.h"
+#include "mmtaudioparser/mmtaudioparser.h"
+#include "mmtaudioparser/mpeghparser.h"
+
+namespace mmt {
+namespace audioparser {
+//! Position of one element within an mpegh3daFrame() structure.
+struct SFrameElement {
+  //! Value used for elements not carrying any signal of a signal group.
+  static constexpr uint32_t NO_SIGNAL_GROUP = 0xFFFFFFFF;
+
+  //! Index of the element in CMpeghParser::SConfigInfo::elementConfigs.
+  uint32_t elementIdx = 0;
+  //! Index of the signal group the element carries signals of, NO_SIGNAL_GROUP for extensions.
+  uint32_t signalGroupIdx = NO_SIGNAL_GROUP;
+  //! Bit position of the element within the frame, including its length or presence fields.
+  size_t bitOffset = 0;
+  //! Number of bits of the element, including its length or presence fields.
+  size_t bitLength = 0;
+  /*!
+   * Bit position of the element payload within the frame. For extension elements, this is the
+   * position of the usacExtElementSegmentData.
+   */
+  size_t payloadBitOffset = 0;
+  //! Number of bits of the element payload.
+  size_t payloadBitLength = 0;
+  //! Whether an extension element is present in this frame, always true for audio elements.
+  bool present = true;
+  //! The usacExtElementStart flag of a present extension element.
+  bool extElementStart = true;
+  //! The usacExtElementStop flag of a present extension element.
+  bool extElementStop = true;
+};
+
+//! Representation of the element layout of one mpegh3daFrame() structure.
+struct SFrameLayout {
+  //! Whether the frame can be decoded without the preceding frames.
+  bool usacIndependencyFlag = false;
+  //! One entry per element in bitstream order.
+  std::vector<SFrameElement> elements;
+};
+
+//! Representation of the AudioPreRoll() structure carried at seamless switching points.
+struct SAudioPreRoll {
+  //! Whether the frame carries an AudioPreRoll() payload.
+  bool present = false;
+  //! The embedded mpegh3daConfig(), empty if the payload carries no config.
+  SBitView config;
+  //! Whether the decoder shall crossfade from the previous configuration.
+  bool applyCrossfade = false;
+  //! The pre-roll access units, each holding one mpegh3daFrame() structure, in decoding order.
+  std::vector<SBitView> accessUnits;
+};
+
+/*!
+ * @brief Splits mpegh3daFrame() structures into their elements without decoding any audio.
+ *
+ * This requires the configuration to signal elementLengthPresent, since the length of the audio
+ * elements is not known otherwise. Extension elements always carry their length.
+ *
+ * Elements are neither byte-aligned nor padded, so all positions are given in bits relative to the
+ * start of the frame memory.
+ */
+class CMpeghFrameParser {
+ public:
+  /*!
+   * @brief Creates a frame parser for the given configuration.
+   *
+   * @param [in] configInfo - the configuration the frames belong to, must not be null
+   */
+  explicit CMpeghFrameParser(std::shared_ptr<const CMpeghParser::SConfigInfo> configInfo);
+
+  /*!
+   * @brief Splits a frame into its elements.
+   *
+   * @param [in] frame - pointer to the mpegh3daFrame() structure, e.g. the payload of an MHAS
+   * PACTYP_MPEGH3DAFRAME packet
+   * @param [in] frameSize - size of the frame in bytes
+   * @param [out] layout - the element layout of the frame, only complete on success. The element
+   * list is reused, so no allocations happen in steady state.
+   *
+   * @returns EParseError::notSupported if the configuration does not signal elementLengthPresent.
+   */
+  SParseResult splitFrame(const uint8_t* frame, size_t frameSize, SFrameLayout& layout) const;
+
+  /*!
+   * @brief Splits a frame which is not byte-aligned into its elements, e.g. a pre-roll access unit.
+   *
+   * The positions of the elements are relative to frame.data.
+   */
+  SParseResult splitFrame(const SBitView& frame, SFrameLayout& layout) const;
+
+  /*!
+   * @brief Parses the AudioPreRoll() payload of a frame.
+   *
+   * The embedded config and the access units are returned as views into the frame, nothing is
+   * copied. CMpeghParser::tryAddConfig(const SBitView&) recognizes an embedded config identical to
+   * the current one in place, and the access units can be split with splitFrame(const SBitView&,
+   * SFrameLayout&).
+   *
+   * @param [in] frame - pointer to the mpegh3daFrame() structure
+   * @param [in] frameSize - size of the frame in bytes
+   * @param [in] layout - the layout of the frame as returned by splitFrame()
+   * @param [out] preRoll - the AudioPreRoll() structure, not present if the frame carries no
+   * AudioPreRoll() payload. The access unit list is reused.
+   *
+   * @returns EParseError::notSupported if the payload is fragmented across frames.
+   */
+  SParseResult parseAudioPreRoll(const uint8_t* frame, size_t frameSize, const SFrameLayout& layout,
+                                 SAudioPreRoll& preRoll) const;
+
+  //! @returns the configuration the frames are split for.
+  const CMpeghParser::SConfigInfo& getConfigInfo() const noexcept;
+
+ private:
+  std::shared_ptr<const CMpeghParser::SConfigInfo> m_configInfo;
+  std::vector<uint32_t> m_signalGroupIdxs;
+};
+}  // namespace audioparser
+}  // namespace mmt
@@ -89,8 +89,10 @@ amm-info@iis.fraunhofer.de
 #pragma once
 
 // System includes
+#include <atomic>
 #include <cstdint>
 #include <memory>
+#include <mutex>
 #include <vector>
 
 // External includes
@@ -99,9 +101,12 @@ amm-info@iis.fraunhofer.de
 // Internal includes
 #include "mmtaudioparser/version.h"
 #include "mmtaudioparser/mmtaudioparser.h"
+#include "mmtaudioparser/configarena.h"
 
 namespace mmt {
 namespace audioparser {
+class IMpeghConfigVisitor;
+
 /*!
  * @brief Parser for MPEG-H 3D Audio configuration structure.
  *
@@ -126,6 +131,10 @@ class CMpeghParser : public IAudioParser {
     uint32_t usacElementType = 0;
     //! The extension element type indicator for the element configuration.
     uint32_t extElementType = 0;
+    //! The default payload length in bytes of an extension element, 0 if not signalled.
+    uint32_t extElementDefaultLength = 0;
+    //! Whether the payload of an extension element may be fragmented across frames.
+    bool extElementPayloadFrag = false;
   };
 
   //! Representation of the speakerConfig3d() structure.
@@ -163,6 +172,86 @@ class CMpeghParser : public IAudioParser {
     uint32_t numSignals = 0;
   };
 
+  //! Parsing depth used by addConfig().
+  enum class EParseMode {
+    //! The complete mpegh3daConfig() structure is parsed and validated by addConfig().
+    full,
+    /*!
+     * Only the header of the mpegh3daConfig() structure up to the reference layout is parsed by
+     * addConfig(). The remaining structures are parsed on demand by the first accessor needing
+     * them.
+     */
+    headerOnly
+  };
+
+  /*!
+   * @brief Instantiation of the config parser.
+   *
+   * Both profiles parse every valid config to the same result. They are separate instantiations
+   * of the parse functions, so the diagnostics of the strict profile cost nothing in the minimal
+   * one.
+   */
+  enum class EParserProfile {
+    /*!
+     * Every consistency check of ISO/IEC 23008-3 is applied and errors name the syntax element
+     * they occurred in.
+     */
+    strict,
+    /*!
+     * Only the checks needed to parse the config are applied, so some invalid configs are accepted.
+     * Errors report their bit position, but mostly no syntax element.
+     */
+    minimal
+  };
+
+  //! Options controlling the behavior of the parser.
+  struct SParserOptions {
+    //! Parsing depth used by addConfig().
+    EParseMode parseMode = EParseMode::full;
+    //! Instantiation of the config parser.
+    EParserProfile profile = EParserProfile::strict;
+    /*!
+     * Arena backing the storage of the parsed configuration structures. It is reset on every
+     * addConfig() call which parses a new configuration. If not set, the parser creates its own.
+     * An arena can only be used by one parser at a time, constructing a second parser with the
+     * same arena throws.
+     */
+    std::shared_ptr<CConfigArena> arena;
+    /*!
+     * @brief Publish every successfully parsed configuration as an immutable snapshot.
+     *
+     * addConfig() then parses the complete configuration, builds the info structure and publishes
+     * it atomically. getConfigSnapshot() may be called from any number of reader threads
+     * concurrently to addConfig() without further locking. A reader keeps its snapshot alive across
+     * config changes, and a failing addConfig() leaves the last valid snapshot published.
+     */
+    bool publishSnapshots = false;
+  };
+
+  //! Representation of the mpegh3daConfig() header fields preceding the signals3d() structure.
+  struct SConfigHeader {
+    //! Indication of the MPEG-H 3D audio profile and level according to ISO/IEC 23008-3 table 67.
+    uint8_t profileLevelIndicator = 0;
+    /*!
+     * The index into the USAC sampling frequency mapping, as defined in ISO/IEC 23003-3
+     * subclause 6.
+     */
+    uint8_t samplingFrequencyIndex = 0;
+    //! The effective sampling frequency in Hz.
+    uint32_t samplingFrequency = 0;
+    /*!
+     * The index into the SBR and output frame length mapping, as defined in ISO/IEC 23003-3
+     * subclause 6.
+     */
+    uint8_t coreSbrFrameLengthIndex = 0;
+    //! Reserved value, ignore.
+    bool cfg_reserved = false;
+    //! Force decoder to operate in constant delay.
+    bool receiverDelayCompensation = false;
+    //! Reference speakerConfig3d() structure the audio content is produced for.
+    SSpeakerConfig3d referenceLayout;
+  };
+
   //! Representation of the mpegh3daConfig() and its children structure.
   struct SConfigInfo {
     //! Indication of the MPEG-H 3D audio profile and level according to ISO/IEC 23008-3 table 67.
@@ -198,6 +287,8 @@ class CMpeghParser : public IAudioParser {
     uint32_t numHOATransportChannels = 0;
     //! The signal groups contained in this configuration.
     std::vector<SSignalGroup> signalGroups;
+    //! Whether the length of each audio element is signalled in the mpegh3daFrame() structure.
+    bool elementLengthPresent = false;
     //! The element configuration entries in this configuration.
     std::vector<SElementConfig> elementConfigs;
     //! The USAC configuration extensions in this configuration.
@@ -215,6 +306,7 @@ class CMpeghParser : public IAudioParser {
   };
 
   CMpeghParser();
+  explicit CMpeghParser(const SParserOptions& options);
   ~CMpeghParser() override;
 
   /*!
@@ -227,18 +319,153 @@ class CMpeghParser : public IAudioParser {
    */
   void addConfig(const ilo::ByteBuffer& config) override;
 
+  /*!
+   * @brief Feeds in a new binary config from caller-owned memory.
+   *
+   * This function parses the given memory region in place and fills in the MPEG-H 3D Audio
+   * configuration structure, overwriting any previously extracted configuration. The memory only
+   * has to stay valid during this call.
+   *
+   * @param [in] config - pointer to the binary MPEG-H 3D Audio configuration structure
+   * @param [in] configSize - size of the binary MPEG-H 3D Audio configuration structure in bytes
+   */
+  void addConfig(const uint8_t* config, size_t configSize) override;
+
+  /*!
+   * @brief Feeds in a new binary config from caller-owned memory without throwing exceptions.
+   *
+   * Behaves like addConfig(const uint8_t*, size_t), but an invalid configuration is reported by the
+   * returned result instead of an exception, so malformed configs can be rejected cheaply.
+   * Running out of memory while storing the configuration is reported as EParseError::outOfMemory.
+   *
+   * @param [in] config - pointer to the binary MPEG-H 3D Audio configuration structure
+   * @param [in] configSize - size of the binary MPEG-H 3D Audio configuration structure in bytes
+   *
+   * @returns the error code as well as the bit offset and syntax element where parsing failed.
+   */
+  SParseResult tryAddConfig(const uint8_t* config, size_t configSize) noexcept override;
+
+  /*!
+   * @brief Feeds in a binary config which is not byte-aligned, e.g. the config embedded in an
+   * AudioPreRoll (see CMpeghFrameParser::parseAudioPreRoll()).
+   *
+   * A config identical to the current one is recognized by comparing the bits in place, so neither
+   * copying nor parsing takes place then. Other configs are copied to be byte-aligned and parsed
+   * like with tryAddConfig(const uint8_t*, size_t).
+   *
+   * @param [in] config - the bit range of the binary MPEG-H 3D Audio configuration structure
+   *
+   * @returns the error code as well as the bit offset and syntax element where parsing failed. The
+   * bit offset is relative to the start of the configuration.
+   */
+  SParseResult tryAddConfig(const SBitView& config) noexcept;
+
+  /*!
+   * @brief Feeds in the next fragment of a binary config split across several transport units.
+   *
+   * The fragments are parsed as far as the data received so far allows, so most of the parsing is
+   * done before the last fragment arrives and errors are detected early. The first fragment of a
+   * config discards any previously extracted configuration. Fragments only have to stay valid
+   * during this call.
+   *
+   * A config in progress is dropped by an error, as well as by addConfig() or tryAddConfig().
+   *
+   * @param [in] fragment - pointer to the next part of the binary MPEG-H 3D Audio configuration
+   * @param [in] fragmentSize - size of the fragment in bytes, may be 0
+   * @param [in] lastFragment - whether the fragment completes the configuration structure
+   *
+   * @returns the error code as well as the bit offset and syntax element where parsing failed.
+   * For fragments other than the last one, success only means that no error was found so far.
+   */
+  SParseResult addConfigFragment(const uint8_t* fragment, size_t fragmentSize,
+                                 bool lastFragment) noexcept;
+
+  /*!
+   * @brief Reports the structures of a binary config to a visitor without storing them.
+   *
+   * The config is decoded like by tryAddConfig() with EParserProfile::strict, but neither the
+   * configuration structure nor the info structure is built, so no memory is allocated. This suits
+   * tools needing only a few fields, e.g. the element types or the loudspeakers.
+   *
+   * @param [in] config - pointer to the binary MPEG-H 3D Audio configuration structure
+   * @param [in] configSize - size of the binary MPEG-H 3D Audio configuration structure in bytes
+   * @param [in] visitor - receives the structures in bitstream order (see IMpeghConfigVisitor)
+   *
+   * @returns EParseError::stopped if the visitor stopped the scan, otherwise the error code as well
+   * as the bit offset and syntax element where parsing failed.
+   */
+  static SParseResult scanConfig(const uint8_t* config, size_t configSize,
+                                 IMpeghConfigVisitor& visitor) noexcept;
+
+  /*!
+   * @brief Sets a preliminary configuration derived from transport signalling.
+   *
+   * Signalling descriptors (see CMpeghDescriptorParser) arrive ahead of the first in-band
+   * configuration. Until an in-band configuration has been parsed successfully, getConfigInfo() and
+   * getConfigSnapshot() return the preliminary configuration. The first successfully parsed
+   * in-band configuration replaces it, and hasConfigChanged() then tells whether the in-band
+   * configuration deviates from the preliminary one in the signalled fields.
+   *
+   * The call is ignored if a valid in-band configuration is present.
+   *
+   * @param [in] configInfo - the configuration known from the signalling
+   */
+  void setPreliminaryConfig(const SConfigInfo& configInfo);
+
+  //! @returns whether the configuration info is the preliminary one set by setPreliminaryConfig().
+  bool isPreliminaryConfig() const;
+
   /*!
    * @brief Returns whether the last read binary configuration structure contains a valid MPEG-H 3D
    * Audio configuration structure.
    *
    * On an empty parser (no binary configuration buffer has been read so far), false is returned.
+   *
+   * @note In EParseMode::headerOnly only the header has been validated. Errors in the remaining
+   * structures are reported by the first accessor needing them, which invalidates the config. An
+   * identical config fed in again is then parsed and rejected again.
    */
   bool isValidConfig() const override;
 
+  /*!
+   * @brief Returns whether the last call to addConfig() changed the configuration.
+   *
+   * A config which is byte-identical to the last valid one is not parsed again. In this case the
+   * previously extracted configuration is kept and false is returned.
+   */
+  bool hasConfigChanged() const;
+
+  /*!
+   * @returns the header of the last read MPEG-H 3D Audio configuration structure.
+   *
+   * This accessor never requires the configuration structures following the header, so it does
+   * not trigger the deferred parsing in EParseMode::headerOnly.
+   */
+  SConfigHeader getConfigHeader() const;
+
   /*!
    * @returns the last read MPEG-H 3D Audio configuration info structure.
+   *
+   * The info structure is built once per configuration change and cached, so repeated calls do not
+   * copy anything. The returned reference stays valid until the next addConfig() call changing
+   * the configuration.
+   *
+   * In EParseMode::full the info structure is built by addConfig(). In EParseMode::headerOnly the
+   * first accessor needing it completes the configuration under a lock. Either way, any number of
+   * threads may call the const accessors concurrently, as long as no addConfig() runs meanwhile.
+   */
+  const SConfigInfo& getConfigInfo() const;
+
+  /*!
+   * @brief Returns the last read MPEG-H 3D Audio configuration info structure as a shared snapshot.
+   *
+   * The snapshot is immutable and shared with the parser's cache, so it is cheap to obtain and
+   * stays valid independent of later addConfig() calls.
+   *
+   * @note With SParserOptions::publishSnapshots set, this is the only accessor which may be called
+   * concurrently to addConfig(). It returns the last published snapshot without locking.
    */
-  SConfigInfo getConfigInfo() const;
+  std::shared_ptr<const SConfigInfo> getConfigSnapshot() const;
 
   /*!
    * @brief Returns whether the bitstream profile is low complexity and signals baseline
@@ -251,8 +478,29 @@ class CMpeghParser : public IAudioParser {
   class CMpeghPimpl;
 
  private:
+  // Rewrites configs based on the bit positions recorded in the parsed structures
+  friend class CMpeghStreamThinner;
+
+  void invalidateConfig() noexcept;
+  SParseResult finishConfig(SParseResult result);
+  // Parses the structures deferred by EParseMode::headerOnly and builds the info, at most once per
+  // config even if called by several reader threads
+  void completeDeferredConfig() const;
+  std::shared_ptr<const SConfigInfo> buildConfigInfo() const;
+
   std::unique_ptr<CMpeghPimpl> m_mpeghPimpl;
-  bool m_validConfig;
+  // Cleared by the const accessors if the deferred parsing fails
+  mutable std::atomic<bool> m_validConfig;
+  bool m_configChanged;
+  bool m_publishSnapshots;
+  bool m_fragmentsPending;
+  std::shared_ptr<const SConfigInfo> m_preliminaryConfigInfo;
+  // Accessed via std::atomic_load/std::atomic_store only if m_publishSnapshots is set.
+  mutable std::shared_ptr<const SConfigInfo> m_configInfo;
+  // Set once the config is complete and m_configInfo is built, or the deferred parsing failed
+  mutable std::atomic<bool> m_configComplete;
+  mutable std::mutex m_deferredMutex;
+  mutable SParseResult m_deferredResult;
 };
 
 /*!
@@ -0,0 +1,208 @@
+/*-----------------------------------------------------------------------------
+Software License for The Fraunhofer FDK MPEG-H Software
+
+Copyright (c) 2024 Fraunhofer-Gesellschaft zur Förderung der angewandten
+Forschung e.V. and Contributors
+All rights reserved.
+
+1. INTRODUCTION
+
+The "Fraunhofer FDK MPEG-H Software" is software that implements the ISO/MPEG
+MPEG-H 3D Audio standard for digital audio or related system features. Patent
+licenses for necessary patent claims for the Fraunhofer FDK MPEG-H Software
+(including those of Fraunhofer), for the use in commercial products and
+services, may be obtained from the respective patent owners individually and/or
+from Via LA (www.via-la.com).
+
+Fraunhofer supports the development of MPEG-H products and services by offering
+additional software, documentation, and technical advice. In addition, it
+operates the MPEG-H Trademark Program to ease interoperability testing of end-
+products. Please visit www.mpegh.com for more information.
+
+2. COPYRIGHT LICENSE
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted without payment of copyright license fees provided that you
+satisfy the following conditions:
+
+* You must retain the complete text of this software license in redistributions
+of the Fraunhofer FDK MPEG-H Software or your modifications thereto in source
+code form.
+
+* You must retain the complete text of this software license in the
+documentation and/or other materials provided with redistributions of
+the Fraunhofer FDK MPEG-H Software or your modifications thereto in binary form.
+You must make available free of charge copies of the complete source code of
+the Fraunhofer FDK MPEG-H Software and your modifications thereto to recipients
+of copies in binary form.
+
+* The name of Fraunhofer may not be used to endorse or promote products derived
+from the Fraunhofer FDK MPEG-H Software without prior written permission.
+
+* You may not charge copyright license fees for anyone to use, copy or
+distribute the Fraunhofer FDK MPEG-H Software or your modifications thereto.
+
+* Your modified versions of the Fraunhofer FDK MPEG-H Software must carry
+prominent notices stating that you changed the software and the date of any
+change. For modified versions of the Fraunhofer FDK MPEG-H Software, the term
+"Fraunhofer FDK MPEG-H Software" must be replaced by the term "Third-Party
+Modified Version of the Fraunhofer FDK MPEG-H Software".
+
+3. No PATENT LICENSE
+
+NO EXPRESS OR IMPLIED LICENSES TO ANY PATENT CLAIMS, including without
+limitation the patents of Fraunhofer, ARE GRANTED BY THIS SOFTWARE LICENSE.
+Fraunhofer provides no warranty of patent non-infringement with respect to this
+software. You may use this Fraunhofer FDK MPEG-H Software or modifications
+thereto only for purposes that are authorized by appropriate patent licenses.
+
+4. DISCLAIMER
+
+This Fraunhofer FDK MPEG-H Software is provided by Fraunhofer on behalf of the
+copyright holders and contributors "AS IS" and WITHOUT ANY EXPRESS OR IMPLIED
+WARRANTIES, including but not limited to the implied warranties of
+merchantability and fitness for a particular purpose. IN NO EVENT SHALL THE
+COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE for any direct, indirect,
+incidental, special, exemplary, or consequential damages, including but not
+limited to procurement of substitute goods or services; loss of use, data, or
+profits, or business interruption, however caused and on any theory of
+liability, whether in contract, strict liability, or tort (including
+negligence), arising in any way out of the use of this software, even if
+advised of the possibility of such damage.
+
+5. CONTACT INFORMATION
+
+Fraunhofer Institute for Integrated Circuits IIS
+Attention: Division Audio and Media Technologies - MPEG-H FDK
+Am Wolfsmantel 33
+91058 Erlangen, Germany
+www.iis.fraunhofer.de/amm
+amm-info@iis.fraunhofer.de
+-----------------------------------------------------------------------------*/
+
+/*!
+ * @file mpeghstreamthinner.h
+ *
+ * @brief Removal of signal groups from MPEG-H 3D Audio configurations and frames.
+ */
+
+#pragma once
+
+// System includes
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// External includes
+#include "ilo/common_types.h"
+
+// Internal includes
+#include "mmtaudioparser/version.h"
+#include "mmtaudioparser/mmtaudioparser.h"
+#include "mmtaudioparser/mpeghframeparser.h"
+#include "mmtaudioparser/mpeghparser.h"
+
+namespace mmt {
+namespace audioparser {
+/*!
+ * @brief Thins an MPEG-H 3D Audio stream by removing signal groups without re-encoding.
+ *
+ * The reduced mpegh3daConfig() is assembled from the bit ranges of the kept signal groups,
+ * element configurations and configuration extensions, which are copied unchanged. Only the count
+ * fields and the signal group information extension are written anew. The reduced configuration
+ * is built once per configuration change and reused for all following frames.
+ *
+ * Frames are rewritten by copying the bit ranges of the kept elements, which requires the
+ * configuration to signal elementLengthPresent. AudioPreRoll extension payloads are rewritten
+ * recursively, so that the embedded configuration and access units match the reduced stream.
+ *
+ * Structures which refer to signals or signal groups by index and would have to be decoded to be
+ * adapted are rejected with EParseError::notSupported as soon as any signal group is removed. This
+ * applies to
+ * - channel pair elements using the QCE channel shift,
+ * - the MPEG Surround, SAOC, MCT, TCC, HOA enhancement layer, HREP and enhanced object metadata
+ *   extension elements,
+ * - all configuration extensions except fill data, the signal group information, the compatible
+ *   profile level set and the audio scene information, e.g. downmix, loudness info, HOA matrix and
+ *   ICG.
+ *
+ * Object metadata, SAOC 3D and HOA extension elements are removed together with the n-th signal
+ * group of the respective type. The audio scene information configuration extension is dropped as
+ * a whole, since its groups and presets refer to the original signals.
+ */
+class CMpeghStreamThinner {
+ public:
+  CMpeghStreamThinner();
+  ~CMpeghStreamThinner();
+
+  CMpeghStreamThinner(const CMpeghStreamThinner&) = delete;
+  CMpeghStreamThinner& operator=(const CMpeghStreamThinner&) = delete;
+
+  /*!
+   * @brief Selects the signal groups to remove.
+   *
+   * The selection takes effect with the next call to rewriteConfig(). Indices not present in the
+   * configuration are ignored.
+   *
+   * @param [in] signalGroupIdxs - indices into CMpeghParser::SConfigInfo::signalGroups
+   */
+  void setRemovedSignalGroups(const std::vector<uint32_t>& signalGroupIdxs);
+
+  /*!
+   * @brief Rewrites an mpegh3daConfig() structure without the removed signal groups.
+   *
+   * A configuration byte-identical to the previous one is not parsed again, the cached reduced
+   * configuration is returned instead.
+   *
+   * @param [in] config - pointer to the binary MPEG-H 3D Audio configuration structure
+   * @param [in] configSize - size of the configuration in bytes
+   * @param [out] thinnedConfig - the reduced configuration, padded to full bytes
+   *
+   * @returns EParseError::invalidValue if all signal groups are removed and
+   * EParseError::notSupported if the configuration cannot be thinned (see class description).
+   */
+  SParseResult rewriteConfig(const uint8_t* config, size_t configSize,
+                             ilo::ByteBuffer& thinnedConfig);
+
+  /*!
+   * @brief Rewrites an mpegh3daFrame() structure without the elements of the removed signal groups.
+   *
+   * @param [in] frame - pointer to the frame, e.g. the payload of an MHAS PACTYP_MPEGH3DAFRAME
+   * packet
+   * @param [in] frameSize - size of the frame in bytes
+   * @param [out] thinnedFrame - the reduced frame, padded to full bytes
+   *
+   * @pre The last call to rewriteConfig() succeeded.
+   */
+  SParseResult rewriteFrame(const uint8_t* frame, size_t frameSize, ilo::ByteBuffer& thinnedFrame);
+
+  //! @returns whether the last call to rewriteConfig() succeeded.
+  bool isValidConfig() const noexcept;
+
+ private:
+  SParseResult buildThinnedConfig();
+  SParseResult selectElements();
+  SParseResult thinFrame(const SBitView& frame, SFrameLayout& layout,
+                         ilo::ByteBuffer& thinnedFrame, bool preRollFrame);
+  SParseResult thinAudioPreRoll(const SAudioPreRoll& preRoll, ilo::ByteBuffer& thinnedPayload);
+
+  CMpeghParser m_parser;
+  std::unique_ptr<CMpeghFrameParser> m_frameParser;
+  std::vector<uint32_t> m_removedSignalGroupIdxs;
+  // Per signal group and per element of the current config
+  std::vector<bool> m_removedSignalGroups;
+  std::vector<bool> m_keptElements;
+  bool m_selectionChanged;
+  bool m_validConfig;
+  // Whether any signal group of the current config is removed
+  bool m_thinning;
+  ilo::ByteBuffer m_thinnedConfig;
+  SFrameLayout m_layout;
+  SAudioPreRoll m_preRoll;
+  SFrameLayout m_preRollLayout;
+  ilo::ByteBuffer m_thinnedAccessUnit;
+  ilo::ByteBuffer m_thinnedPayload;
+};
+}  // namespace audioparser
+}  // namespace mmt
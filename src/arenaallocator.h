@@ -0,0 +1,171 @@
+/*-----------------------------------------------------------------------------
+Software License for The Fraunhofer FDK MPEG-H Software
+
+Copyright (c) 2024 Fraunhofer-Gesellschaft zur Förderung der angewandten
+Forschung e.V. and Contributors
+All rights reserved.
+
+1. INTRODUCTION
+
+The "Fraunhofer FDK MPEG-H Software" is software that implements the ISO/MPEG
+MPEG-H 3D Audio standard for digital audio or related system features. Patent
+licenses for necessary patent claims for the Fraunhofer FDK MPEG-H Software
+(including those of Fraunhofer), for the use in commercial products and
+services, may be obtained from the respective patent owners individually and/or
+from Via LA (www.via-la.com).
+
+Fraunhofer supports the development of MPEG-H products and services by offering
+additional software, documentation, and technical advice. In addition, it
+operates the MPEG-H Trademark Program to ease interoperability testing of end-
+products. Please visit www.mpegh.com for more information.
+
+2. COPYRIGHT LICENSE
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted without payment of copyright license fees provided that you
+satisfy the following conditions:
+
+* You must retain the complete text of this software license in redistributions
+of the Fraunhofer FDK MPEG-H Software or your modifications thereto in source
+code form.
+
+* You must retain the complete text of this software license in the
+documentation and/or other materials provided with redistributions of
+the Fraunhofer FDK MPEG-H Software or your modifications thereto in binary form.
+You must make available free of charge copies of the complete source code of
+the Fraunhofer FDK MPEG-H Software and your modifications thereto to recipients
+of copies in binary form.
+
+* The name of Fraunhofer may not be used to endorse or promote products derived
+from the Fraunhofer FDK MPEG-H Software without prior written permission.
+
+* You may not charge copyright license fees for anyone to use, copy or
+distribute the Fraunhofer FDK MPEG-H Software or your modifications thereto.
+
+* Your modified versions of the Fraunhofer FDK MPEG-H Software must carry
+prominent notices stating that you changed the software and the date of any
+change. For modified versions of the Fraunhofer FDK MPEG-H Software, the term
+"Fraunhofer FDK MPEG-H Software" must be replaced by the term "Third-Party
+Modified Version of the Fraunhofer FDK MPEG-H Software".
+
+3. No PATENT LICENSE
+
+NO EXPRESS OR IMPLIED LICENSES TO ANY PATENT CLAIMS, including without
+limitation the patents of Fraunhofer, ARE GRANTED BY THIS SOFTWARE LICENSE.
+Fraunhofer provides no warranty of patent non-infringement with respect to this
+software. You may use this Fraunhofer FDK MPEG-H Software or modifications
+thereto only for purposes that are authorized by appropriate patent licenses.
+
+4. DISCLAIMER
+
+This Fraunhofer FDK MPEG-H Software is provided by Fraunhofer on behalf of the
+copyright holders and contributors "AS IS" and WITHOUT ANY EXPRESS OR IMPLIED
+WARRANTIES, including but not limited to the implied warranties of
+merchantability and fitness for a particular purpose. IN NO EVENT SHALL THE
+COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE for any direct, indirect,
+incidental, special, exemplary, or consequential damages, including but not
+limited to procurement of substitute goods or services; loss of use, data, or
+profits, or business interruption, however caused and on any theory of
+liability, whether in contract, strict liability, or tort (including
+negligence), arising in any way out of the use of this software, even if
+advised of the possibility of such damage.
+
+5. CONTACT INFORMATION
+
+Fraunhofer Institute for Integrated Circuits IIS
+Attention: Division Audio and Media Technologies - MPEG-H FDK
+Am Wolfsmantel 33
+91058 Erlangen, Germany
+www.iis.fraunhofer.de/amm
+amm-info@iis.fraunhofer.de
+-----------------------------------------------------------------------------*/
+
+#pragma once
+
+// System includes
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <vector>
+
+// Internal includes
+#include "mmtaudioparser/version.h"
+#include "mmtaudioparser/configarena.h"
+
+namespace mmt {
+namespace audioparser {
+namespace utils {
+//! @returns the arena bound to the calling thread by CArenaScope, nullptr if there is none.
+CConfigArena* currentArena() noexcept;
+
+/*!
+ * @brief Binds an arena to the calling thread for the lifetime of this object.
+ *
+ * Containers using CArenaAllocator which are default constructed within this scope take their
+ * memory from the bound arena. This way the parse functions do not need to pass allocators to
+ * every structure they construct.
+ */
+class CArenaScope {
+ public:
+  explicit CArenaScope(CConfigArena& arena) noexcept;
+  ~CArenaScope();
+
+  CArenaScope(const CArenaScope&) = delete;
+  CArenaScope& operator=(const CArenaScope&) = delete;
+
+ private:
+  CConfigArena* m_parentArena;
+};
+
+/*!
+ * @brief Standard allocator serving memory from the arena bound at construction time.
+ *
+ * Without a bound arena the allocator falls back to the global heap.
+ */
+template <typename T>
+class CArenaAllocator {
+ public:
+  using value_type = T;
+  using propagate_on_container_copy_assignment = std::true_type;
+  using propagate_on_container_move_assignment = std::true_type;
+  using propagate_on_container_swap = std::true_type;
+
+  CArenaAllocator() noexcept : m_arena(currentArena()) {}
+
+  template <typename U>
+  CArenaAllocator(const CArenaAllocator<U>& other) noexcept : m_arena(other.arena()) {}
+
+  T* allocate(size_t n) {
+    if (m_arena == nullptr) {
+      return static_cast<T*>(::operator new(n * sizeof(T)));
+    }
+    return static_cast<T*>(m_arena->allocate(n * sizeof(T), alignof(T)));
+  }
+
+  void deallocate(T* p, size_t /*n*/) noexcept {
+    if (m_arena == nullptr) {
+      ::operator delete(p);
+    }
+  }
+
+  CConfigArena* arena() const noexcept { return m_arena; }
+
+ private:
+  CConfigArena* m_arena;
+};
+
+template <typename T, typename U>
+bool operator==(const CArenaAllocator<T>& lhs, const CArenaAllocator<U>& rhs) noexcept {
+  return lhs.arena() == rhs.arena();
+}
+
+template <typename T, typename U>
+bool operator!=(const CArenaAllocator<T>& lhs, const CArenaAllocator<U>& rhs) noexcept {
+  return !(lhs == rhs);
+}
+
+template <typename T>
+using ArenaVector = std::vector<T, CArenaAllocator<T>>;
+}  // namespace utils
+}  // namespace audioparser
+}  // namespace mmt
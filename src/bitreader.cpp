@@ -0,0 +1,189 @@
+/*-----------------------------------------------------------------------------
+Software License for The Fraunhofer FDK MPEG-H Software
+
+Copyright (c) 2024 Fraunhofer-Gesellschaft zur Förderung der angewandten
+Forschung e.V. and Contributors
+All rights reserved.
+
+1. INTRODUCTION
+
+The "Fraunhofer FDK MPEG-H Software" is software that implements the ISO/MPEG
+MPEG-H 3D Audio standard for digital audio or related system features. Patent
+licenses for necessary patent claims for the Fraunhofer FDK MPEG-H Software
+(including those of Fraunhofer), for the use in commercial products and
+services, may be obtained from the respective patent owners individually and/or
+from Via LA (www.via-la.com).
+
+Fraunhofer supports the development of MPEG-H products and services by offering
+additional software, documentation, and technical advice. In addition, it
+operates the MPEG-H Trademark Program to ease interoperability testing of end-
+products. Please visit www.mpegh.com for more information.
+
+2. COPYRIGHT LICENSE
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted without payment of copyright license fees provided that you
+satisfy the following conditions:
+
+* You must retain the complete text of this software license in redistributions
+of the Fraunhofer FDK MPEG-H Software or your modifications thereto in source
+code form.
+
+* You must retain the complete text of this software license in the
+documentation and/or other materials provided with redistributions of
+the Fraunhofer FDK MPEG-H Software or your modifications thereto in binary form.
+You must make available free of charge copies of the complete source code of
+the Fraunhofer FDK MPEG-H Software and your modifications thereto to recipients
+of copies in binary form.
+
+* The name of Fraunhofer may not be used to endorse or promote products derived
+from the Fraunhofer FDK MPEG-H Software without prior written permission.
+
+* You may not charge copyright license fees for anyone to use, copy or
+distribute the Fraunhofer FDK MPEG-H Software or your modifications thereto.
+
+* Your modified versions of the Fraunhofer FDK MPEG-H Software must carry
+prominent notices stating that you changed the software and the date of any
+change. For modified versions of the Fraunhofer FDK MPEG-H Software, the term
+"Fraunhofer FDK MPEG-H Software" must be replaced by the term "Third-Party
+Modified Version of the Fraunhofer FDK MPEG-H Software".
+
+3. No PATENT LICENSE
+
+NO EXPRESS OR IMPLIED LICENSES TO ANY PATENT CLAIMS, including without
+limitation the patents of Fraunhofer, ARE GRANTED BY THIS SOFTWARE LICENSE.
+Fraunhofer provides no warranty of patent non-infringement with respect to this
+software. You may use this Fraunhofer FDK MPEG-H Software or modifications
+thereto only for purposes that are authorized by appropriate patent licenses.
+
+4. DISCLAIMER
+
+This Fraunhofer FDK MPEG-H Software is provided by Fraunhofer on behalf of the
+copyright holders and contributors "AS IS" and WITHOUT ANY EXPRESS OR IMPLIED
+WARRANTIES, including but not limited to the implied warranties of
+merchantability and fitness for a particular purpose. IN NO EVENT SHALL THE
+COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE for any direct, indirect,
+incidental, special, exemplary, or consequential damages, including but not
+limited to procurement of substitute goods or services; loss of use, data, or
+profits, or business interruption, however caused and on any theory of
+liability, whether in contract, strict liability, or tort (including
+negligence), arising in any way out of the use of this software, even if
+advised of the possibility of such damage.
+
+5. CONTACT INFORMATION
+
+Fraunhofer Institute for Integrated Circuits IIS
+Attention: Division Audio and Media Technologies - MPEG-H FDK
+Am Wolfsmantel 33
+91058 Erlangen, Germany
+www.iis.fraunhofer.de/amm
+amm-info@iis.fraunhofer.de
+-----------------------------------------------------------------------------*/
+// System includes
+
+// External includes
+
+// Internal includes
+#include "bitreader.h"
+
+namespace mmt {
+namespace audioparser {
+namespace utils {
+CBitReader::CBitReader(const uint8_t* data, size_t size) noexcept
+    : m_data(data), m_sizeInBits(data != nullptr ? size * 8 : 0), m_position(0) {}
+
+CBitReader::CBitReader(const SBitView& view) noexcept
+    : m_data(view.data),
+      m_sizeInBits(view.data != nullptr ? view.bitOffset + view.bitLength : 0),
+      m_position(0) {
+  if (m_sizeInBits != 0) {
+    seek(view.bitOffset);
+  }
+}
+
+void CBitReader::setError(EParseError error, const char* syntaxElement) noexcept {
+  if (!isValid()) {
+    return;
+  }
+  m_result.error = error;
+  m_result.bitOffset = m_position;
+  m_result.syntaxElement = syntaxElement;
+  // All following reads take the slow path, which returns zero
+  m_cache = 0;
+  m_cacheBits = 0;
+}
+
+uint64_t CBitReader::readBitsRefill(uint32_t numBits) noexcept {
+  if (!isValid() || numBits == 0) {
+    return 0;
+  }
+  if (numBits > nofBitsLeft()) {
+    setError(EParseError::endOfBuffer);
+    return 0;
+  }
+
+  // The cache holds at least 57 bits after a refill, so wider reads are split
+  uint64_t value = 0;
+  if (numBits > 32) {
+    value = readBitsRefill(numBits - 32) << 32;
+    numBits = 32;
+  }
+  if (numBits > m_cacheBits) {
+    refill();
+  }
+  value |= m_cache >> (64 - numBits);
+  consume(numBits);
+  return value;
+}
+
+void CBitReader::skipRefill(size_t numBits) noexcept {
+  if (!isValid()) {
+    return;
+  }
+  if (numBits > nofBitsLeft()) {
+    setError(EParseError::endOfBuffer);
+    return;
+  }
+  seek(m_position + numBits);
+}
+
+void CBitReader::refill() noexcept {
+  size_t dataSize = (m_sizeInBits + 7) / 8;
+  if (m_nextByte + 8 <= dataSize) {
+    // Load 8 bytes at once and keep the whole ones fitting into the cache
+    uint64_t word = 0;
+    for (size_t i = 0; i < 8; ++i) {
+      word = (word << 8) | m_data[m_nextByte + i];
+    }
+    uint32_t numBytes = (64 - m_cacheBits) / 8;
+    m_cache |= (word >> m_cacheBits) & (~uint64_t{0} << (64 - m_cacheBits - numBytes * 8));
+    m_cacheBits += numBytes * 8;
+    m_nextByte += numBytes;
+  } else {
+    while (m_cacheBits <= 56 && m_nextByte < dataSize) {
+      m_cache |= static_cast<uint64_t>(m_data[m_nextByte++]) << (56 - m_cacheBits);
+      m_cacheBits += 8;
+    }
+  }
+
+  // Bits of the last byte beyond the end of the data are not part of the cache
+  if (m_cacheBits > nofBitsLeft()) {
+    m_cacheBits = static_cast<uint32_t>(nofBitsLeft());
+  }
+}
+
+void CBitReader::seek(size_t position) noexcept {
+  uint32_t bitsInByte = static_cast<uint32_t>(position & 7u);
+  m_position = position - bitsInByte;
+  m_nextByte = m_position / 8;
+  m_cache = 0;
+  m_cacheBits = 0;
+  if (bitsInByte != 0) {
+    // The byte holding the position is within the data, so the cache covers the skipped bits
+    refill();
+    consume(bitsInByte);
+  }
+}
+}  // namespace utils
+}  // namespace audioparser
+}  // namespace mmt
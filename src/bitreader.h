@@ -0,0 +1,252 @@
+/*-----------------------------------------------------------------------------
+Software License for The Fraunhofer FDK MPEG-H Software
+
+Copyright (c) 2024 Fraunhofer-Gesellschaft zur Förderung der angewandten
+Forschung e.V. and Contributors
+All rights reserved.
+
+1. INTRODUCTION
+
+The "Fraunhofer FDK MPEG-H Software" is software that implements the ISO/MPEG
+MPEG-H 3D Audio standard for digital audio or related system features. Patent
+licenses for necessary patent claims for the Fraunhofer FDK MPEG-H Software
+(including those of Fraunhofer), for the use in commercial products and
+services, may be obtained from the respective patent owners individually and/or
+from Via LA (www.via-la.com).
+
+Fraunhofer supports the development of MPEG-H products and services by offering
+additional software, documentation, and technical advice. In addition, it
+operates the MPEG-H Trademark Program to ease interoperability testing of end-
+products. Please visit www.mpegh.com for more information.
+
+2. COPYRIGHT LICENSE
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted without payment of copyright license fees provided that you
+satisfy the following conditions:
+
+* You must retain the complete text of this software license in redistributions
+of the Fraunhofer FDK MPEG-H Software or your modifications thereto in source
+code form.
+
+* You must retain the complete text of this software license in the
+documentation and/or other materials provided with redistributions of
+the Fraunhofer FDK MPEG-H Software or your modifications thereto in binary form.
+You must make available free of charge copies of the complete source code of
+the Fraunhofer FDK MPEG-H Software and your modifications thereto to recipients
+of copies in binary form.
+
+* The name of Fraunhofer may not be used to endorse or promote products derived
+from the Fraunhofer FDK MPEG-H Software without prior written permission.
+
+* You may not charge copyright license fees for anyone to use, copy or
+distribute the Fraunhofer FDK MPEG-H Software or your modifications thereto.
+
+* Your modified versions of the Fraunhofer FDK MPEG-H Software must carry
+prominent notices stating that you changed the software and the date of any
+change. For modified versions of the Fraunhofer FDK MPEG-H Software, the term
+"Fraunhofer FDK MPEG-H Software" must be replaced by the term "Third-Party
+Modified Version of the Fraunhofer FDK MPEG-H Software".
+
+3. No PATENT LICENSE
+
+NO EXPRESS OR IMPLIED LICENSES TO ANY PATENT CLAIMS, including without
+limitation the patents of Fraunhofer, ARE GRANTED BY THIS SOFTWARE LICENSE.
+Fraunhofer provides no warranty of patent non-infringement with respect to this
+software. You may use this Fraunhofer FDK MPEG-H Software or modifications
+thereto only for purposes that are authorized by appropriate patent licenses.
+
+4. DISCLAIMER
+
+This Fraunhofer FDK MPEG-H Software is provided by Fraunhofer on behalf of the
+copyright holders and contributors "AS IS" and WITHOUT ANY EXPRESS OR IMPLIED
+WARRANTIES, including but not limited to the implied warranties of
+merchantability and fitness for a particular purpose. IN NO EVENT SHALL THE
+COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE for any direct, indirect,
+incidental, special, exemplary, or consequential damages, including but not
+limited to procurement of substitute goods or services; loss of use, data, or
+profits, or business interruption, however caused and on any theory of
+liability, whether in contract, strict liability, or tort (including
+negligence), arising in any way out of the use of this software, even if
+advised of the possibility of such damage.
+
+5. CONTACT INFORMATION
+
+Fraunhofer Institute for Integrated Circuits IIS
+Attention: Division Audio and Media Technologies - MPEG-H FDK
+Am Wolfsmantel 33
+91058 Erlangen, Germany
+www.iis.fraunhofer.de/amm
+amm-info@iis.fraunhofer.de
+-----------------------------------------------------------------------------*/
+
+#pragma once
+
+// System includes
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+// Internal includes
+#include "mmtaudioparser/version.h"
+#include "mmtaudioparser/mmtaudioparser.h"
+
+namespace mmt {
+namespace audioparser {
+namespace utils {
+// Smallest unsigned type holding numBits bits
+template <uint32_t numBits>
+using UintForBits = typename std::conditional<(numBits <= 32), uint32_t, uint64_t>::type;
+
+// Smallest unsigned type holding maxValue
+template <uint64_t maxValue>
+using UintForValue = typename std::conditional<(maxValue <= 0xFFFFFFFFu), uint32_t, uint64_t>::type;
+
+// Largest value of escapedValue(nBits1, nBits2, nBits3) as defined in ISO/IEC 23008-3
+template <uint32_t nBits1, uint32_t nBits2, uint32_t nBits3>
+struct SEscapedValueMax {
+  static constexpr uint64_t value = ((uint64_t{1} << nBits1) - 1u) +
+                                    ((uint64_t{1} << nBits2) - 1u) +
+                                    ((uint64_t{1} << nBits3) - 1u);
+};
+
+/*!
+ * @brief MSB-first bit reader operating on caller-owned memory.
+ *
+ * The reader neither copies nor owns the underlying data, so the memory has to stay valid for the
+ * lifetime of the reader.
+ *
+ * The upcoming bits are kept in a 64-bit cache word, which is refilled with up to 8 bytes at once.
+ * The cache never holds bits beyond the end of the data, so the bounds are checked once per refill
+ * and reads served from the cache need a single comparison. Widths known at compile time should
+ * be read with read<N>() and escapedValue<N1, N2, N3>(), which inline into this comparison.
+ *
+ * Errors do not throw. Instead, the first error is recorded together with its position and the
+ * current syntax element, and all following reads return zero.
+ */
+class CBitReader {
+ public:
+  CBitReader(const uint8_t* data, size_t size) noexcept;
+  //! Reads the given bit range only. Positions stay relative to the start of the memory.
+  explicit CBitReader(const SBitView& view) noexcept;
+
+  template <typename T>
+  T read(uint32_t numBits) noexcept {
+    return static_cast<T>(readBits(numBits));
+  }
+
+  //! Reads N bits, with N known at compile time.
+  template <uint32_t N>
+  UintForBits<N> read() noexcept {
+    static_assert(N > 0 && N <= 64, "Between 1 and 64 bits can be read at once");
+    if (N < 64 && N <= m_cacheBits) {
+      auto value = static_cast<UintForBits<N>>(m_cache >> (64 - N));
+      consume(N);
+      return value;
+    }
+    return static_cast<UintForBits<N>>(readBitsRefill(N));
+  }
+
+  bool readBool() noexcept { return read<1>() != 0; }
+
+  //! Reads escapedValue(N1, N2, N3) as defined in ISO/IEC 23008-3.
+  template <uint32_t N1, uint32_t N2, uint32_t N3>
+  UintForValue<SEscapedValueMax<N1, N2, N3>::value> escapedValue() noexcept {
+    static_assert(N1 < 64 && N2 < 64 && N3 < 64, "The escaped value must fit into 64 bits");
+    using TValue = UintForValue<SEscapedValueMax<N1, N2, N3>::value>;
+    TValue value = read<N1>();
+    if (value == (uint64_t{1} << N1) - 1u) {
+      TValue valueAdd = read<N2>();
+      value += valueAdd;
+      if (N3 > 0 && valueAdd == (uint64_t{1} << N2) - 1u) {
+        value += readEscapeTail<N3>();
+      }
+    }
+    return value;
+  }
+
+  void skip(size_t numBits) noexcept {
+    if (numBits < 64 && numBits <= m_cacheBits) {
+      consume(static_cast<uint32_t>(numBits));
+      return;
+    }
+    skipRefill(numBits);
+  }
+
+  size_t tell() const noexcept { return m_position; }
+  size_t nofBitsLeft() const noexcept { return m_sizeInBits - m_position; }
+
+  bool isValid() const noexcept { return m_result.error == EParseError::ok; }
+  const SParseResult& result() const noexcept { return m_result; }
+
+  //! Records the given error, unless an error has already been recorded.
+  void setError(EParseError error, const char* syntaxElement) noexcept;
+  void setError(EParseError error) noexcept { setError(error, m_syntaxElement); }
+
+ private:
+  friend class CSyntaxElementScope;
+
+  // The escape tail of a zero width does not exist, so it must not be instantiated as read<0>()
+  template <uint32_t N>
+  typename std::enable_if<(N > 0), uint64_t>::type readEscapeTail() noexcept {
+    return read<N>();
+  }
+  template <uint32_t N>
+  typename std::enable_if<(N == 0), uint64_t>::type readEscapeTail() noexcept {
+    return 0;
+  }
+
+  uint64_t readBits(uint32_t numBits) noexcept {
+    if (numBits != 0 && numBits < 64 && numBits <= m_cacheBits) {
+      uint64_t value = m_cache >> (64 - numBits);
+      consume(numBits);
+      return value;
+    }
+    return readBitsRefill(numBits);
+  }
+
+  void consume(uint32_t numBits) noexcept {
+    m_cache <<= numBits;
+    m_cacheBits -= numBits;
+    m_position += numBits;
+  }
+
+  uint64_t readBitsRefill(uint32_t numBits) noexcept;
+  void skipRefill(size_t numBits) noexcept;
+  // Loads whole bytes into the cache until it holds at least 57 bits or the data ends
+  void refill() noexcept;
+  // Restarts the cache at the given bit position
+  void seek(size_t position) noexcept;
+
+  const uint8_t* m_data;
+  size_t m_sizeInBits;
+  size_t m_position;
+  // The upcoming bits, left-aligned, and the number of valid bits in it
+  uint64_t m_cache = 0;
+  uint32_t m_cacheBits = 0;
+  // The next byte to be loaded into the cache
+  size_t m_nextByte = 0;
+  const char* m_syntaxElement = nullptr;
+  SParseResult m_result;
+};
+
+//! Names the syntax element reported by errors of the reader for the lifetime of this object.
+class CSyntaxElementScope {
+ public:
+  CSyntaxElementScope(CBitReader& bitReader, const char* syntaxElement) noexcept
+      : m_bitReader(bitReader), m_parentElement(bitReader.m_syntaxElement) {
+    m_bitReader.m_syntaxElement = syntaxElement;
+  }
+
+  ~CSyntaxElementScope() { m_bitReader.m_syntaxElement = m_parentElement; }
+
+  CSyntaxElementScope(const CSyntaxElementScope&) = delete;
+  CSyntaxElementScope& operator=(const CSyntaxElementScope&) = delete;
+
+ private:
+  CBitReader& m_bitReader;
+  const char* m_parentElement;
+};
+}  // namespace utils
+}  // namespace audioparser
+}  // namespace mmt
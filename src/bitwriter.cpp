@@ -0,0 +1,175 @@
+/*-----------------------------------------------------------------------------
+Software License for The Fraunhofer FDK MPEG-H Software
+
+Copyright (c) 2024 Fraunhofer-Gesellschaft zur Förderung der angewandten
+Forschung e.V. and Contributors
+All rights reserved.
+
+1. INTRODUCTION
+
+The "Fraunhofer FDK MPEG-H Software" is software that implements the ISO/MPEG
+MPEG-H 3D Audio standard for digital audio or related system features. Patent
+licenses for necessary patent claims for the Fraunhofer FDK MPEG-H Software
+(including those of Fraunhofer), for the use in commercial products and
+services, may be obtained from the respective patent owners individually and/or
+from Via LA (www.via-la.com).
+
+Fraunhofer supports the development of MPEG-H products and services by offering
+additional software, documentation, and technical advice. In addition, it
+operates the MPEG-H Trademark Program to ease interoperability testing of end-
+products. Please visit www.mpegh.com for more information.
+
+2. COPYRIGHT LICENSE
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted without payment of copyright license fees provided that you
+satisfy the following conditions:
+
+* You must retain the complete text of this software license in redistributions
+of the Fraunhofer FDK MPEG-H Software or your modifications thereto in source
+code form.
+
+* You must retain the complete text of this software license in the
+documentation and/or other materials provided with redistributions of
+the Fraunhofer FDK MPEG-H Software or your modifications thereto in binary form.
+You must make available free of charge copies of the complete source code of
+the Fraunhofer FDK MPEG-H Software and your modifications thereto to recipients
+of copies in binary form.
+
+* The name of Fraunhofer may not be used to endorse or promote products derived
+from the Fraunhofer FDK MPEG-H Software without prior written permission.
+
+* You may not charge copyright license fees for anyone to use, copy or
+distribute the Fraunhofer FDK MPEG-H Software or your modifications thereto.
+
+* Your modified versions of the Fraunhofer FDK MPEG-H Software must carry
+prominent notices stating that you changed the software and the date of any
+change. For modified versions of the Fraunhofer FDK MPEG-H Software, the term
+"Fraunhofer FDK MPEG-H Software" must be replaced by the term "Third-Party
+Modified Version of the Fraunhofer FDK MPEG-H Software".
+
+3. No PATENT LICENSE
+
+NO EXPRESS OR IMPLIED LICENSES TO ANY PATENT CLAIMS, including without
+limitation the patents of Fraunhofer, ARE GRANTED BY THIS SOFTWARE LICENSE.
+Fraunhofer provides no warranty of patent non-infringement with respect to this
+software. You may use this Fraunhofer FDK MPEG-H Software or modifications
+thereto only for purposes that are authorized by appropriate patent licenses.
+
+4. DISCLAIMER
+
+This Fraunhofer FDK MPEG-H Software is provided by Fraunhofer on behalf of the
+copyright holders and contributors "AS IS" and WITHOUT ANY EXPRESS OR IMPLIED
+WARRANTIES, including but not limited to the implied warranties of
+merchantability and fitness for a particular purpose. IN NO EVENT SHALL THE
+COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE for any direct, indirect,
+incidental, special, exemplary, or consequential damages, including but not
+limited to procurement of substitute goods or services; loss of use, data, or
+profits, or business interruption, however caused and on any theory of
+liability, whether in contract, strict liability, or tort (including
+negligence), arising in any way out of the use of this software, even if
+advised of the possibility of such damage.
+
+5. CONTACT INFORMATION
+
+Fraunhofer Institute for Integrated Circuits IIS
+Attention: Division Audio and Media Technologies - MPEG-H FDK
+Am Wolfsmantel 33
+91058 Erlangen, Germany
+www.iis.fraunhofer.de/amm
+amm-info@iis.fraunhofer.de
+-----------------------------------------------------------------------------*/
+// System includes
+
+// External includes
+#include "ilo/common_types.h"
+
+// Internal includes
+#include "bitwriter.h"
+#include "logging.h"
+
+namespace mmt {
+namespace audioparser {
+namespace utils {
+CBitWriter::CBitWriter(ilo::ByteBuffer& buffer) noexcept : m_buffer(buffer) {
+  m_buffer.clear();
+}
+
+void CBitWriter::write(uint32_t value, uint32_t numBits) {
+  ILO_ASSERT(numBits <= 32, "Not more than 32 bits can be written at once");
+  if (numBits == 0) {
+    return;
+  }
+  uint64_t mask = (uint64_t{1} << numBits) - 1u;
+  m_cache = (m_cache << numBits) | (value & mask);
+  m_cacheBits += numBits;
+  while (m_cacheBits >= 8) {
+    m_cacheBits -= 8;
+    m_buffer.push_back(static_cast<uint8_t>(m_cache >> m_cacheBits));
+  }
+  m_cache &= (uint64_t{1} << m_cacheBits) - 1u;
+}
+
+void CBitWriter::writeEscapedValue(uint32_t value, uint32_t nBits1, uint32_t nBits2,
+                                   uint32_t nBits3) {
+  uint32_t maxValue1 = (1u << nBits1) - 1u;
+  if (value < maxValue1) {
+    write(value, nBits1);
+    return;
+  }
+  write(maxValue1, nBits1);
+  value -= maxValue1;
+
+  uint32_t maxValue2 = (1u << nBits2) - 1u;
+  if (value < maxValue2 || nBits3 == 0) {
+    ILO_ASSERT(value <= maxValue2, "Value exceeds the range of the escaped value");
+    write(value, nBits2);
+    return;
+  }
+  write(maxValue2, nBits2);
+  value -= maxValue2;
+  ILO_ASSERT(nBits3 == 32 || value < (1u << nBits3),
+             "Value exceeds the range of the escaped value");
+  write(value, nBits3);
+}
+
+void CBitWriter::copyBits(const uint8_t* data, size_t bitPosition, size_t numBits) {
+  // Byte-aligned source and destination allow to copy the bulk of the range as a whole
+  if (m_cacheBits == 0 && (bitPosition & 7u) == 0) {
+    size_t numBytes = numBits / 8;
+    m_buffer.insert(m_buffer.end(), data + bitPosition / 8, data + bitPosition / 8 + numBytes);
+    bitPosition += numBytes * 8;
+    numBits -= numBytes * 8;
+  }
+
+  // Otherwise every output byte is assembled from two neighbouring source bytes
+  while (numBits >= 8) {
+    uint32_t shift = static_cast<uint32_t>(bitPosition & 7u);
+    const uint8_t* source = data + bitPosition / 8;
+    uint32_t value = static_cast<uint32_t>(source[0]) << shift;
+    if (shift != 0) {
+      value |= static_cast<uint32_t>(source[1]) >> (8 - shift);
+    }
+    write(value & 0xFFu, 8);
+    bitPosition += 8;
+    numBits -= 8;
+  }
+  if (numBits > 0) {
+    uint32_t shift = static_cast<uint32_t>(bitPosition & 7u);
+    const uint8_t* source = data + bitPosition / 8;
+    uint32_t value = static_cast<uint32_t>(source[0]) << shift;
+    if (shift + numBits > 8) {
+      value |= static_cast<uint32_t>(source[1]) >> (8 - shift);
+    }
+    write((value & 0xFFu) >> (8 - numBits), static_cast<uint32_t>(numBits));
+  }
+}
+
+void CBitWriter::byteAlign() {
+  if (m_cacheBits != 0) {
+    write(0, 8 - m_cacheBits);
+  }
+}
+}  // namespace utils
+}  // namespace audioparser
+}  // namespace mmt
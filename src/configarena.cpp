@@ -0,0 +1,185 @@
+/*-----------------------------------------------------------------------------
+Software License for The Fraunhofer FDK MPEG-H Software
+
+Copyright (c) 2024 Fraunhofer-Gesellschaft zur Förderung der angewandten
+Forschung e.V. and Contributors
+All rights reserved.
+
+1. INTRODUCTION
+
+The "Fraunhofer FDK MPEG-H Software" is software that implements the ISO/MPEG
+MPEG-H 3D Audio standard for digital audio or related system features. Patent
+licenses for necessary patent claims for the Fraunhofer FDK MPEG-H Software
+(including those of Fraunhofer), for the use in commercial products and
+services, may be obtained from the respective patent owners individually and/or
+from Via LA (www.via-la.com).
+
+Fraunhofer supports the development of MPEG-H products and services by offering
+additional software, documentation, and technical advice. In addition, it
+operates the MPEG-H Trademark Program to ease interoperability testing of end-
+products. Please visit www.mpegh.com for more information.
+
+2. COPYRIGHT LICENSE
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted without payment of copyright license fees provided that you
+satisfy the following conditions:
+
+* You must retain the complete text of this software license in redistributions
+of the Fraunhofer FDK MPEG-H Software or your modifications thereto in source
+code form.
+
+* You must retain the complete text of this software license in the
+documentation and/or other materials provided with redistributions of
+the Fraunhofer FDK MPEG-H Software or your modifications thereto in binary form.
+You must make available free of charge copies of the complete source code of
+the Fraunhofer FDK MPEG-H Software and your modifications thereto to recipients
+of copies in binary form.
+
+* The name of Fraunhofer may not be used to endorse or promote products derived
+from the Fraunhofer FDK MPEG-H Software without prior written permission.
+
+* You may not charge copyright license fees for anyone to use, copy or
+distribute the Fraunhofer FDK MPEG-H Software or your modifications thereto.
+
+* Your modified versions of the Fraunhofer FDK MPEG-H Software must carry
+prominent notices stating that you changed the software and the date of any
+change. For modified versions of the Fraunhofer FDK MPEG-H Software, the term
+"Fraunhofer FDK MPEG-H Software" must be replaced by the term "Third-Party
+Modified Version of the Fraunhofer FDK MPEG-H Software".
+
+3. No PATENT LICENSE
+
+NO EXPRESS OR IMPLIED LICENSES TO ANY PATENT CLAIMS, including without
+limitation the patents of Fraunhofer, ARE GRANTED BY THIS SOFTWARE LICENSE.
+Fraunhofer provides no warranty of patent non-infringement with respect to this
+software. You may use this Fraunhofer FDK MPEG-H Software or modifications
+thereto only for purposes that are authorized by appropriate patent licenses.
+
+4. DISCLAIMER
+
+This Fraunhofer FDK MPEG-H Software is provided by Fraunhofer on behalf of the
+copyright holders and contributors "AS IS" and WITHOUT ANY EXPRESS OR IMPLIED
+WARRANTIES, including but not limited to the implied warranties of
+merchantability and fitness for a particular purpose. IN NO EVENT SHALL THE
+COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE for any direct, indirect,
+incidental, special, exemplary, or consequential damages, including but not
+limited to procurement of substitute goods or services; loss of use, data, or
+profits, or business interruption, however caused and on any theory of
+liability, whether in contract, strict liability, or tort (including
+negligence), arising in any way out of the use of this software, even if
+advised of the possibility of such damage.
+
+5. CONTACT INFORMATION
+
+Fraunhofer Institute for Integrated Circuits IIS
+Attention: Division Audio and Media Technologies - MPEG-H FDK
+Am Wolfsmantel 33
+91058 Erlangen, Germany
+www.iis.fraunhofer.de/amm
+amm-info@iis.fraunhofer.de
+-----------------------------------------------------------------------------*/
+// System includes
+#include <algorithm>
+#include <cstdint>
+#include <new>
+
+// External includes
+
+// Internal includes
+#include "mmtaudioparser/configarena.h"
+#include "arenaallocator.h"
+
+namespace mmt {
+namespace audioparser {
+CConfigArena::CConfigArena(size_t initialSize) : m_current(0), m_used(0), m_claimed(false) {
+  addBlock(std::max<size_t>(initialSize, 64));
+}
+
+CConfigArena::~CConfigArena() {
+  for (const auto& block : m_blocks) {
+    ::operator delete(block.data);
+  }
+}
+
+void* CConfigArena::allocate(size_t size, size_t alignment) {
+  SBlock* block = &m_blocks[m_current];
+  auto address = reinterpret_cast<uintptr_t>(block->data) + m_used;
+  size_t padding = (alignment - (address & (alignment - 1))) & (alignment - 1);
+  while (m_used + padding + size > block->size) {
+    if (m_current + 1 < m_blocks.size()) {
+      // Blocks kept from before a rollback are used before new ones are added
+      m_current++;
+    } else {
+      addBlock(std::max(2 * block->size, size + alignment));
+    }
+    m_used = 0;
+    block = &m_blocks[m_current];
+    address = reinterpret_cast<uintptr_t>(block->data);
+    padding = (alignment - (address & (alignment - 1))) & (alignment - 1);
+  }
+
+  void* memory = block->data + m_used + padding;
+  m_used += padding + size;
+  return memory;
+}
+
+void CConfigArena::rollback(const SMark& mark) noexcept {
+  m_current = mark.block;
+  m_used = mark.used;
+}
+
+void CConfigArena::reset() {
+  if (m_blocks.size() > 1) {
+    size_t totalSize = capacity();
+    for (const auto& block : m_blocks) {
+      ::operator delete(block.data);
+    }
+    m_blocks.clear();
+    addBlock(totalSize);
+  }
+  m_current = 0;
+  m_used = 0;
+}
+
+size_t CConfigArena::capacity() const noexcept {
+  size_t totalSize = 0;
+  for (const auto& block : m_blocks) {
+    totalSize += block.size;
+  }
+  return totalSize;
+}
+
+void CConfigArena::addBlock(size_t size) {
+  m_blocks.reserve(m_blocks.size() + 1);
+  SBlock block{static_cast<uint8_t*>(::operator new(size)), size};
+  m_blocks.push_back(block);
+  m_current = m_blocks.size() - 1;
+}
+
+bool CConfigArena::claim() noexcept {
+  // Parsers sharing an arena may be constructed on different threads
+  return !m_claimed.exchange(true, std::memory_order_acq_rel);
+}
+
+void CConfigArena::unclaim() noexcept {
+  m_claimed.store(false, std::memory_order_release);
+}
+
+namespace utils {
+static thread_local CConfigArena* g_currentArena = nullptr;
+
+CConfigArena* currentArena() noexcept {
+  return g_currentArena;
+}
+
+CArenaScope::CArenaScope(CConfigArena& arena) noexcept : m_parentArena(g_currentArena) {
+  g_currentArena = &arena;
+}
+
+CArenaScope::~CArenaScope() {
+  g_currentArena = m_parentArena;
+}
+}  // namespace utils
+}  // namespace audioparser
+}  // namespace mmt
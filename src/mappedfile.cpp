@@ -0,0 +1,182 @@
+/*-----------------------------------------------------------------------------
+Software License for The Fraunhofer FDK MPEG-H Software
+
+Copyright (c) 2024 Fraunhofer-Gesellschaft zur Förderung der angewandten
+Forschung e.V. and Contributors
+All rights reserved.
+
+1. INTRODUCTION
+
+The "Fraunhofer FDK MPEG-H Software" is software that implements the ISO/MPEG
+MPEG-H 3D Audio standard for digital audio or related system features. Patent
+licenses for necessary patent claims for the Fraunhofer FDK MPEG-H Software
+(including those of Fraunhofer), for the use in commercial products and
+services, may be obtained from the respective patent owners individually and/or
+from Via LA (www.via-la.com).
+
+Fraunhofer supports the development of MPEG-H products and services by offering
+additional software, documentation, and technical advice. In addition, it
+operates the MPEG-H Trademark Program to ease interoperability testing of end-
+products. Please visit www.mpegh.com for more information.
+
+2. COPYRIGHT LICENSE
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted without payment of copyright license fees provided that you
+satisfy the following conditions:
+
+* You must retain the complete text of this software license in redistributions
+of the Fraunhofer FDK MPEG-H Software or your modifications thereto in source
+code form.
+
+* You must retain the complete text of this software license in the
+documentation and/or other materials provided with redistributions of
+the Fraunhofer FDK MPEG-H Software or your modifications thereto in binary form.
+You must make available free of charge copies of the complete source code of
+the Fraunhofer FDK MPEG-H Software and your modifications thereto to recipients
+of copies in binary form.
+
+* The name of Fraunhofer may not be used to endorse or promote products derived
+from the Fraunhofer FDK MPEG-H Software without prior written permission.
+
+* You may not charge copyright license fees for anyone to use, copy or
+distribute the Fraunhofer FDK MPEG-H Software or your modifications thereto.
+
+* Your modified versions of the Fraunhofer FDK MPEG-H Software must carry
+prominent notices stating that you changed the software and the date of any
+change. For modified versions of the Fraunhofer FDK MPEG-H Software, the term
+"Fraunhofer FDK MPEG-H Software" must be replaced by the term "Third-Party
+Modified Version of the Fraunhofer FDK MPEG-H Software".
+
+3. No PATENT LICENSE
+
+NO EXPRESS OR IMPLIED LICENSES TO ANY PATENT CLAIMS, including without
+limitation the patents of Fraunhofer, ARE GRANTED BY THIS SOFTWARE LICENSE.
+Fraunhofer provides no warranty of patent non-infringement with respect to this
+software. You may use this Fraunhofer FDK MPEG-H Software or modifications
+thereto only for purposes that are authorized by appropriate patent licenses.
+
+4. DISCLAIMER
+
+This Fraunhofer FDK MPEG-H Software is provided by Fraunhofer on behalf of the
+copyright holders and contributors "AS IS" and WITHOUT ANY EXPRESS OR IMPLIED
+WARRANTIES, including but not limited to the implied warranties of
+merchantability and fitness for a particular purpose. IN NO EVENT SHALL THE
+COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE for any direct, indirect,
+incidental, special, exemplary, or consequential damages, including but not
+limited to procurement of substitute goods or services; loss of use, data, or
+profits, or business interruption, however caused and on any theory of
+liability, whether in contract, strict liability, or tort (including
+negligence), arising in any way out of the use of this software, even if
+advised of the possibility of such damage.
+
+5. CONTACT INFORMATION
+
+Fraunhofer Institute for Integrated Circuits IIS
+Attention: Division Audio and Media Technologies - MPEG-H FDK
+Am Wolfsmantel 33
+91058 Erlangen, Germany
+www.iis.fraunhofer.de/amm
+amm-info@iis.fraunhofer.de
+-----------------------------------------------------------------------------*/
+// System includes
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// External includes
+#include "ilo/common_types.h"
+
+// Internal includes
+#include "mappedfile.h"
+#include "logging.h"
+
+namespace mmt {
+namespace audioparser {
+namespace utils {
+#if defined(_WIN32)
+CMappedFile::CMappedFile(const std::string& path, EAccessPattern accessPattern)
+    : m_data(nullptr), m_size(0), m_file(INVALID_HANDLE_VALUE), m_mapping(nullptr) {
+  DWORD accessFlag = accessPattern == EAccessPattern::sequential ? FILE_FLAG_SEQUENTIAL_SCAN
+                                                                 : FILE_FLAG_RANDOM_ACCESS;
+  m_file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                       FILE_ATTRIBUTE_NORMAL | accessFlag, nullptr);
+  ILO_ASSERT(m_file != INVALID_HANDLE_VALUE, "Unable to open file %s", path.c_str());
+
+  LARGE_INTEGER fileSize;
+  if (!GetFileSizeEx(m_file, &fileSize)) {
+    CloseHandle(m_file);
+    ILO_ASSERT(false, "Unable to determine the size of file %s", path.c_str());
+  }
+  m_size = static_cast<size_t>(fileSize.QuadPart);
+  // Empty files cannot be mapped
+  if (m_size == 0) {
+    return;
+  }
+
+  m_mapping = CreateFileMappingA(m_file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+  if (m_mapping != nullptr) {
+    m_data = static_cast<const uint8_t*>(MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0));
+  }
+  if (m_data == nullptr) {
+    if (m_mapping != nullptr) {
+      CloseHandle(m_mapping);
+    }
+    CloseHandle(m_file);
+    ILO_ASSERT(false, "Unable to map file %s", path.c_str());
+  }
+}
+
+CMappedFile::~CMappedFile() {
+  if (m_data != nullptr) {
+    UnmapViewOfFile(m_data);
+  }
+  if (m_mapping != nullptr) {
+    CloseHandle(m_mapping);
+  }
+  CloseHandle(m_file);
+}
+#else
+CMappedFile::CMappedFile(const std::string& path, EAccessPattern accessPattern)
+    : m_data(nullptr), m_size(0) {
+  int fd = open(path.c_str(), O_RDONLY);
+  ILO_ASSERT(fd >= 0, "Unable to open file %s", path.c_str());
+
+  struct stat fileStat;
+  if (fstat(fd, &fileStat) != 0) {
+    close(fd);
+    ILO_ASSERT(false, "Unable to determine the size of file %s", path.c_str());
+  }
+  m_size = static_cast<size_t>(fileStat.st_size);
+  // Empty files cannot be mapped
+  if (m_size == 0) {
+    close(fd);
+    return;
+  }
+
+  void* mapping = mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  // The mapping stays valid after closing the file descriptor
+  close(fd);
+  ILO_ASSERT(mapping != MAP_FAILED, "Unable to map file %s", path.c_str());
+  madvise(mapping, m_size,
+          accessPattern == EAccessPattern::sequential ? MADV_SEQUENTIAL : MADV_RANDOM);
+  m_data = static_cast<const uint8_t*>(mapping);
+}
+
+CMappedFile::~CMappedFile() {
+  if (m_data != nullptr) {
+    munmap(const_cast<uint8_t*>(m_data), m_size);
+  }
+}
+#endif
+}  // namespace utils
+}  // namespace audioparser
+}  // namespace mmt
@@ -0,0 +1,200 @@
+/*-----------------------------------------------------------------------------
+Software License for The Fraunhofer FDK MPEG-H Software
+
+Copyright (c) 2024 Fraunhofer-Gesellschaft zur Förderung der angewandten
+Forschung e.V. and Contributors
+All rights reserved.
+
+1. INTRODUCTION
+
+The "Fraunhofer FDK MPEG-H Software" is software that implements the ISO/MPEG
+MPEG-H 3D Audio standard for digital audio or related system features. Patent
+licenses for necessary patent claims for the Fraunhofer FDK MPEG-H Software
+(including those of Fraunhofer), for the use in commercial products and
+services, may be obtained from the respective patent owners individually and/or
+from Via LA (www.via-la.com).
+
+Fraunhofer supports the development of MPEG-H products and services by offering
+additional software, documentation, and technical advice. In addition, it
+operates the MPEG-H Trademark Program to ease interoperability testing of end-
+products. Please visit www.mpegh.com for more information.
+
+2. COPYRIGHT LICENSE
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted without payment of copyright license fees provided that you
+satisfy the following conditions:
+
+* You must retain the complete text of this software license in redistributions
+of the Fraunhofer FDK MPEG-H Software or your modifications thereto in source
+code form.
+
+* You must retain the complete text of this software license in the
+documentation and/or other materials provided with redistributions of
+the Fraunhofer FDK MPEG-H Software or your modifications thereto in binary form.
+You must make available free of charge copies of the complete source code of
+the Fraunhofer FDK MPEG-H Software and your modifications thereto to recipients
+of copies in binary form.
+
+* The name of Fraunhofer may not be used to endorse or promote products derived
+from the Fraunhofer FDK MPEG-H Software without prior written permission.
+
+* You may not charge copyright license fees for anyone to use, copy or
+distribute the Fraunhofer FDK MPEG-H Software or your modifications thereto.
+
+* Your modified versions of the Fraunhofer FDK MPEG-H Software must carry
+prominent notices stating that you changed the software and the date of any
+change. For modified versions of the Fraunhofer FDK MPEG-H Software, the term
+"Fraunhofer FDK MPEG-H Software" must be replaced by the term "Third-Party
+Modified Version of the Fraunhofer FDK MPEG-H Software".
+
+3. No PATENT LICENSE
+
+NO EXPRESS OR IMPLIED LICENSES TO ANY PATENT CLAIMS, including without
+limitation the patents of Fraunhofer, ARE GRANTED BY THIS SOFTWARE LICENSE.
+Fraunhofer provides no warranty of patent non-infringement with respect to this
+software. You may use this Fraunhofer FDK MPEG-H Software or modifications
+thereto only for purposes that are authorized by appropriate patent licenses.
+
+4. DISCLAIMER
+
+This Fraunhofer FDK MPEG-H Software is provided by Fraunhofer on behalf of the
+copyright holders and contributors "AS IS" and WITHOUT ANY EXPRESS OR IMPLIED
+WARRANTIES, including but not limited to the implied warranties of
+merchantability and fitness for a particular purpose. IN NO EVENT SHALL THE
+COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE for any direct, indirect,
+incidental, special, exemplary, or consequential damages, including but not
+limited to procurement of substitute goods or services; loss of use, data, or
+profits, or business interruption, however caused and on any theory of
+liability, whether in contract, strict liability, or tort (including
+negligence), arising in any way out of the use of this software, even if
+advised of the possibility of such damage.
+
+5. CONTACT INFORMATION
+
+Fraunhofer Institute for Integrated Circuits IIS
+Attention: Division Audio and Media Technologies - MPEG-H FDK
+Am Wolfsmantel 33
+91058 Erlangen, Germany
+www.iis.fraunhofer.de/amm
+amm-info@iis.fraunhofer.de
+-----------------------------------------------------------------------------*/
+// System includes
+#include <algorithm>
+#include <utility>
+
+// External includes
+#include "ilo/common_types.h"
+
+// Internal includes
+#include "mmtaudioparser/mhasdemux.h"
+#include "logging.h"
+
+namespace mmt {
+namespace audioparser {
+CMhasDemux::CMhasDemux() : CMhasDemux(SDemuxOptions{}) {}
+
+CMhasDemux::CMhasDemux(const SDemuxOptions& options) : m_options(options) {
+  ILO_ASSERT(m_options.parserOptions.arena == nullptr,
+             "The config parsers of the labels cannot share an arena");
+  ILO_ASSERT(m_options.parserOptions.parseMode == CMpeghParser::EParseMode::full,
+             "The config parsers of the labels have to parse configs completely");
+}
+
+CMhasDemux::~CMhasDemux() = default;
+
+void CMhasDemux::setBuffer(const uint8_t* data, size_t size) noexcept {
+  m_mhasParser.setBuffer(data, size);
+}
+
+SParseResult CMhasDemux::nextPacket(SMhasDemuxPacket& packet) {
+  packet.configParser = nullptr;
+  SParseResult result = m_mhasParser.nextPacket(packet.packet);
+  if (!result.isOk()) {
+    return result;
+  }
+
+  uint64_t packetLabel = packet.packet.packetLabel;
+  if (packet.packet.packetType != EMhasPacketType::PACTYP_MPEGH3DACFG) {
+    packet.configParser = getConfigParser(packetLabel);
+    return result;
+  }
+
+  SLabelState* state = labelState(packetLabel);
+  if (state == nullptr) {
+    packet.packet.configResult = SParseResult{};
+    packet.packet.configResult.error = EParseError::limitExceeded;
+    packet.packet.configResult.syntaxElement = "mhasPacketLabel";
+    return result;
+  }
+
+  CMpeghParser& configParser = *state->configParser;
+  const uint8_t* config = packet.packet.payload;
+  size_t configSize = packet.packet.packetLength;
+  packet.packet.configResult = configParser.tryAddConfig(config, configSize);
+  packet.configParser = &configParser;
+  // A failed config packet invalidates the parser, so the next valid config is parsed again even
+  // if it equals the published one
+  if (packet.packet.configResult.isOk() && configParser.hasConfigChanged() &&
+      !(state->publishedConfig.size() == configSize &&
+        std::equal(config, config + configSize, state->publishedConfig.begin()))) {
+    SLabelConfigChange change;
+    change.packetLabel = packetLabel;
+    change.firstConfig = state->publishedConfig.empty();
+    change.configInfo = configParser.getConfigSnapshot();
+    m_configChanges.push_back(std::move(change));
+    state->publishedConfig.assign(config, config + configSize);
+  }
+  return result;
+}
+
+SParseResult CMhasDemux::resync(uint32_t numConfirmPackets) noexcept {
+  return m_mhasParser.resync(numConfirmPackets);
+}
+
+size_t CMhasDemux::bytesConsumed() const noexcept {
+  return m_mhasParser.bytesConsumed();
+}
+
+const CMpeghParser* CMhasDemux::getConfigParser(uint64_t packetLabel) const noexcept {
+  for (const auto& state : m_labels) {
+    if (state.packetLabel == packetLabel) {
+      return state.configParser.get();
+    }
+  }
+  return nullptr;
+}
+
+std::vector<uint64_t> CMhasDemux::getPacketLabels() const {
+  std::vector<uint64_t> packetLabels;
+  packetLabels.reserve(m_labels.size());
+  for (const auto& state : m_labels) {
+    packetLabels.push_back(state.packetLabel);
+  }
+  return packetLabels;
+}
+
+void CMhasDemux::takeConfigChanges(std::vector<SLabelConfigChange>& changes) {
+  for (auto& change : m_configChanges) {
+    changes.push_back(std::move(change));
+  }
+  m_configChanges.clear();
+}
+
+CMhasDemux::SLabelState* CMhasDemux::labelState(uint64_t packetLabel) {
+  for (auto& state : m_labels) {
+    if (state.packetLabel == packetLabel) {
+      return &state;
+    }
+  }
+  if (m_labels.size() >= m_options.maxLabels) {
+    return nullptr;
+  }
+  SLabelState state;
+  state.packetLabel = packetLabel;
+  state.configParser.reset(new CMpeghParser(m_options.parserOptions));
+  m_labels.push_back(std::move(state));
+  return &m_labels.back();
+}
+}  // namespace audioparser
+}  // namespace mmt
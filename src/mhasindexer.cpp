@@ -0,0 +1,313 @@
+/*-----------------------------------------------------------------------------
+Software License for The Fraunhofer FDK MPEG-H Software
+
+Copyright (c) 2024 Fraunhofer-Gesellschaft zur Förderung der angewandten
+Forschung e.V. and Contributors
+All rights reserved.
+
+1. INTRODUCTION
+
+The "Fraunhofer FDK MPEG-H Software" is software that implements the ISO/MPEG
+MPEG-H 3D Audio standard for digital audio or related system features. Patent
+licenses for necessary patent claims for the Fraunhofer FDK MPEG-H Software
+(including those of Fraunhofer), for the use in commercial products and
+services, may be obtained from the respective patent owners individually and/or
+from Via LA (www.via-la.com).
+
+Fraunhofer supports the development of MPEG-H products and services by offering
+additional software, documentation, and technical advice. In addition, it
+operates the MPEG-H Trademark Program to ease interoperability testing of end-
+products. Please visit www.mpegh.com for more information.
+
+2. COPYRIGHT LICENSE
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted without payment of copyright license fees provided that you
+satisfy the following conditions:
+
+* You must retain the complete text of this software license in redistributions
+of the Fraunhofer FDK MPEG-H Software or your modifications thereto in source
+code form.
+
+* You must retain the complete text of this software license in the
+documentation and/or other materials provided with redistributions of
+the Fraunhofer FDK MPEG-H Software or your modifications thereto in binary form.
+You must make available free of charge copies of the complete source code of
+the Fraunhofer FDK MPEG-H Software and your modifications thereto to recipients
+of copies in binary form.
+
+* The name of Fraunhofer may not be used to endorse or promote products derived
+from the Fraunhofer FDK MPEG-H Software without prior written permission.
+
+* You may not charge copyright license fees for anyone to use, copy or
+distribute the Fraunhofer FDK MPEG-H Software or your modifications thereto.
+
+* Your modified versions of the Fraunhofer FDK MPEG-H Software must carry
+prominent notices stating that you changed the software and the date of any
+change. For modified versions of the Fraunhofer FDK MPEG-H Software, the term
+"Fraunhofer FDK MPEG-H Software" must be replaced by the term "Third-Party
+Modified Version of the Fraunhofer FDK MPEG-H Software".
+
+3. No PATENT LICENSE
+
+NO EXPRESS OR IMPLIED LICENSES TO ANY PATENT CLAIMS, including without
+limitation the patents of Fraunhofer, ARE GRANTED BY THIS SOFTWARE LICENSE.
+Fraunhofer provides no warranty of patent non-infringement with respect to this
+software. You may use this Fraunhofer FDK MPEG-H Software or modifications
+thereto only for purposes that are authorized by appropriate patent licenses.
+
+4. DISCLAIMER
+
+This Fraunhofer FDK MPEG-H Software is provided by Fraunhofer on behalf of the
+copyright holders and contributors "AS IS" and WITHOUT ANY EXPRESS OR IMPLIED
+WARRANTIES, including but not limited to the implied warranties of
+merchantability and fitness for a particular purpose. IN NO EVENT SHALL THE
+COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE for any direct, indirect,
+incidental, special, exemplary, or consequential damages, including but not
+limited to procurement of substitute goods or services; loss of use, data, or
+profits, or business interruption, however caused and on any theory of
+liability, whether in contract, strict liability, or tort (including
+negligence), arising in any way out of the use of this software, even if
+advised of the possibility of such damage.
+
+5. CONTACT INFORMATION
+
+Fraunhofer Institute for Integrated Circuits IIS
+Attention: Division Audio and Media Technologies - MPEG-H FDK
+Am Wolfsmantel 33
+91058 Erlangen, Germany
+www.iis.fraunhofer.de/amm
+amm-info@iis.fraunhofer.de
+-----------------------------------------------------------------------------*/
+// System includes
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <map>
+
+// External includes
+#include "ilo/common_types.h"
+
+// Internal includes
+#include "mmtaudioparser/mhasindexer.h"
+#include "mmtaudioparser/mhasparser.h"
+#include "mappedfile.h"
+#include "logging.h"
+
+namespace mmt {
+namespace audioparser {
+constexpr uint32_t SMhasIndex::NO_ENTRY;
+
+// Layout of the index file, all values little-endian:
+//   header:  "MHIX", version (4), streamSize (8), numConfigs (4), numFrames (4), numRaps (4)
+//   configs: offset (8), size (4), packetLabel (8)
+//   frames:  offset (8), size (4), configIdx (4)
+//   raps:    offset (8), frameIdx (4)
+// The random access point of each frame is not stored, it is restored from the raps on load.
+static const uint8_t INDEX_MAGIC[4] = {'M', 'H', 'I', 'X'};
+static const uint32_t INDEX_VERSION = 1;
+static const size_t INDEX_HEADER_SIZE = 28;
+static const size_t CONFIG_ENTRY_SIZE = 20;
+static const size_t FRAME_ENTRY_SIZE = 16;
+static const size_t RAP_ENTRY_SIZE = 12;
+
+static void writeLe(ilo::ByteBuffer& buffer, uint64_t value, size_t numBytes) {
+  for (size_t i = 0; i < numBytes; ++i) {
+    buffer.push_back(static_cast<uint8_t>(value >> (8 * i)));
+  }
+}
+
+static uint64_t readLe(const uint8_t*& data, size_t numBytes) {
+  uint64_t value = 0;
+  for (size_t i = 0; i < numBytes; ++i) {
+    value |= static_cast<uint64_t>(data[i]) << (8 * i);
+  }
+  data += numBytes;
+  return value;
+}
+
+void SMhasIndex::save(const std::string& path) const {
+  ilo::ByteBuffer buffer;
+  buffer.reserve(INDEX_HEADER_SIZE + configs.size() * CONFIG_ENTRY_SIZE +
+                 frames.size() * FRAME_ENTRY_SIZE + randomAccessPoints.size() * RAP_ENTRY_SIZE);
+  buffer.insert(buffer.end(), std::begin(INDEX_MAGIC), std::end(INDEX_MAGIC));
+  writeLe(buffer, INDEX_VERSION, 4);
+  writeLe(buffer, streamSize, 8);
+  writeLe(buffer, configs.size(), 4);
+  writeLe(buffer, frames.size(), 4);
+  writeLe(buffer, randomAccessPoints.size(), 4);
+  for (const auto& config : configs) {
+    writeLe(buffer, config.offset, 8);
+    writeLe(buffer, config.size, 4);
+    writeLe(buffer, config.packetLabel, 8);
+  }
+  for (const auto& frame : frames) {
+    writeLe(buffer, frame.offset, 8);
+    writeLe(buffer, frame.size, 4);
+    writeLe(buffer, frame.configIdx, 4);
+  }
+  for (const auto& randomAccessPoint : randomAccessPoints) {
+    writeLe(buffer, randomAccessPoint.offset, 8);
+    writeLe(buffer, randomAccessPoint.frameIdx, 4);
+  }
+
+  std::ofstream file(path, std::ios::binary | std::ios::trunc);
+  ILO_ASSERT(file.is_open(), "Unable to open index file %s for writing", path.c_str());
+  file.write(reinterpret_cast<const char*>(buffer.data()),
+             static_cast<std::streamsize>(buffer.size()));
+  ILO_ASSERT(file.good(), "Unable to write index file %s", path.c_str());
+}
+
+SMhasIndex SMhasIndex::load(const std::string& path) {
+  std::ifstream file(path, std::ios::binary);
+  ILO_ASSERT(file.is_open(), "Unable to open index file %s", path.c_str());
+  ilo::ByteBuffer buffer((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+  ILO_ASSERT(buffer.size() >= INDEX_HEADER_SIZE &&
+                 std::memcmp(buffer.data(), INDEX_MAGIC, sizeof(INDEX_MAGIC)) == 0,
+             "%s is no MHAS index file", path.c_str());
+  const uint8_t* data = buffer.data() + sizeof(INDEX_MAGIC);
+  uint32_t version = static_cast<uint32_t>(readLe(data, 4));
+  ILO_ASSERT(version == INDEX_VERSION, "Unsupported MHAS index version %u", version);
+
+  SMhasIndex index;
+  index.streamSize = readLe(data, 8);
+  size_t numConfigs = static_cast<size_t>(readLe(data, 4));
+  size_t numFrames = static_cast<size_t>(readLe(data, 4));
+  size_t numRaps = static_cast<size_t>(readLe(data, 4));
+  ILO_ASSERT(buffer.size() == INDEX_HEADER_SIZE + numConfigs * CONFIG_ENTRY_SIZE +
+                                  numFrames * FRAME_ENTRY_SIZE + numRaps * RAP_ENTRY_SIZE,
+             "The MHAS index file %s is corrupted", path.c_str());
+
+  index.configs.resize(numConfigs);
+  for (auto& config : index.configs) {
+    config.offset = readLe(data, 8);
+    config.size = static_cast<uint32_t>(readLe(data, 4));
+    config.packetLabel = readLe(data, 8);
+  }
+  index.frames.resize(numFrames);
+  for (auto& frame : index.frames) {
+    frame.offset = readLe(data, 8);
+    frame.size = static_cast<uint32_t>(readLe(data, 4));
+    frame.configIdx = static_cast<uint32_t>(readLe(data, 4));
+  }
+  index.randomAccessPoints.resize(numRaps);
+  for (auto& randomAccessPoint : index.randomAccessPoints) {
+    randomAccessPoint.offset = readLe(data, 8);
+    randomAccessPoint.frameIdx = static_cast<uint32_t>(readLe(data, 4));
+    ILO_ASSERT(randomAccessPoint.frameIdx < numFrames, "The MHAS index file %s is corrupted",
+               path.c_str());
+  }
+
+  // Restore the random access point each frame belongs to, which is tracked per packet label
+  std::map<uint64_t, uint32_t> randomAccessPointIdxs;
+  size_t nextRandomAccessPoint = 0;
+  for (size_t frameIdx = 0; frameIdx < numFrames; ++frameIdx) {
+    auto& frame = index.frames[frameIdx];
+    if (frame.configIdx == NO_ENTRY) {
+      continue;
+    }
+    ILO_ASSERT(frame.configIdx < numConfigs, "The MHAS index file %s is corrupted", path.c_str());
+    auto inserted = randomAccessPointIdxs.insert(
+        std::make_pair(index.configs[frame.configIdx].packetLabel, NO_ENTRY));
+    uint32_t& randomAccessPointIdx = inserted.first->second;
+    if (nextRandomAccessPoint < numRaps &&
+        index.randomAccessPoints[nextRandomAccessPoint].frameIdx == frameIdx) {
+      randomAccessPointIdx = static_cast<uint32_t>(nextRandomAccessPoint++);
+    }
+    frame.randomAccessPointIdx = randomAccessPointIdx;
+  }
+  return index;
+}
+
+SMhasIndex CMhasIndexer::indexFile(const std::string& path) {
+  // The file is walked front to back exactly once
+  utils::CMappedFile file(path, utils::CMappedFile::EAccessPattern::sequential);
+  return indexBuffer(file.data(), file.size());
+}
+
+SMhasIndex CMhasIndexer::indexBuffer(const uint8_t* data, size_t size) {
+  struct SLabelState {
+    uint32_t configIdx = SMhasIndex::NO_ENTRY;
+    uint32_t randomAccessPointIdx = SMhasIndex::NO_ENTRY;
+    // Whether a config packet has been read since the last frame, and where its group started
+    bool configSinceFrame = false;
+    uint64_t groupOffset = 0;
+  };
+  std::map<uint64_t, SLabelState> labels;
+
+  SMhasIndex index;
+  index.streamSize = size;
+  // Offset of the first packet following the last frame, e.g. a SYNC packet preceding the config
+  uint64_t groupOffset = 0;
+
+  CMhasParser mhasParser;
+  mhasParser.setBuffer(data, size);
+  SMhasPacket packet;
+  for (;;) {
+    uint64_t offset = mhasParser.bytesConsumed();
+    SParseResult result = mhasParser.nextPacket(packet);
+    if (offset == size) {
+      break;
+    }
+    if (!result.isOk()) {
+      // A corrupted packet type or length lets the packet run past the end of the stream just like
+      // a truncated last packet. Only a valid SYNC packet following it tells both apart.
+      if (!mhasParser.resync().isOk()) {
+        break;
+      }
+      ILO_LOG_WARNING("Skipping corrupted MHAS packet at offset %llu",
+                      static_cast<unsigned long long>(offset));
+      groupOffset = mhasParser.bytesConsumed();
+      continue;
+    }
+
+    if (packet.packetType == EMhasPacketType::PACTYP_MPEGH3DACFG) {
+      SLabelState& label = labels[packet.packetLabel];
+      // Configs are repeated at every random access point, a repetition shares the entry
+      bool repeated = false;
+      if (label.configIdx != SMhasIndex::NO_ENTRY) {
+        const auto& config = index.configs[label.configIdx];
+        repeated = config.size == packet.packetSize &&
+                   std::memcmp(data + config.offset, data + offset, packet.packetSize) == 0;
+      }
+      if (!repeated) {
+        SMhasIndex::SConfigEntry config;
+        config.offset = offset;
+        config.size = static_cast<uint32_t>(packet.packetSize);
+        config.packetLabel = packet.packetLabel;
+        if (m_configParser.tryAddConfig(packet.payload, packet.packetLength).isOk()) {
+          config.configInfo = m_configParser.getConfigSnapshot();
+        }
+        label.configIdx = static_cast<uint32_t>(index.configs.size());
+        index.configs.push_back(config);
+      }
+      label.configSinceFrame = true;
+      label.groupOffset = groupOffset;
+    } else if (packet.packetType == EMhasPacketType::PACTYP_MPEGH3DAFRAME) {
+      SLabelState& label = labels[packet.packetLabel];
+      auto frameIdx = static_cast<uint32_t>(index.frames.size());
+      // The first bit of mpegh3daFrame() is the usacIndependencyFlag
+      bool independent = packet.packetLength != 0 && (packet.payload[0] & 0x80) != 0;
+      if (independent && label.configSinceFrame && label.configIdx != SMhasIndex::NO_ENTRY) {
+        SMhasIndex::SRandomAccessPoint randomAccessPoint;
+        randomAccessPoint.offset = label.groupOffset;
+        randomAccessPoint.frameIdx = frameIdx;
+        label.randomAccessPointIdx = static_cast<uint32_t>(index.randomAccessPoints.size());
+        index.randomAccessPoints.push_back(randomAccessPoint);
+      }
+      label.configSinceFrame = false;
+
+      SMhasIndex::SFrameEntry frame;
+      frame.offset = offset;
+      frame.size = static_cast<uint32_t>(packet.packetSize);
+      frame.configIdx = label.configIdx;
+      frame.randomAccessPointIdx = label.randomAccessPointIdx;
+      index.frames.push_back(frame);
+      groupOffset = offset + packet.packetSize;
+    }
+  }
+  return index;
+}
+}  // namespace audioparser
+}  // namespace mmt
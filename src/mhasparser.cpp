@@ -0,0 +1,209 @@
+/*-----------------------------------------------------------------------------
+Software License for The Fraunhofer FDK MPEG-H Software
+
+Copyright (c) 2024 Fraunhofer-Gesellschaft zur Förderung der angewandten
+Forschung e.V. and Contributors
+All rights reserved.
+
+1. INTRODUCTION
+
+The "Fraunhofer FDK MPEG-H Software" is software that implements the ISO/MPEG
+MPEG-H 3D Audio standard for digital audio or related system features. Patent
+licenses for necessary patent claims for the Fraunhofer FDK MPEG-H Software
+(including those of Fraunhofer), for the use in commercial products and
+services, may be obtained from the respective patent owners individually and/or
+from Via LA (www.via-la.com).
+
+Fraunhofer supports the development of MPEG-H products and services by offering
+additional software, documentation, and technical advice. In addition, it
+operates the MPEG-H Trademark Program to ease interoperability testing of end-
+products. Please visit www.mpegh.com for more information.
+
+2. COPYRIGHT LICENSE
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted without payment of copyright license fees provided that you
+satisfy the following conditions:
+
+* You must retain the complete text of this software license in redistributions
+of the Fraunhofer FDK MPEG-H Software or your modifications thereto in source
+code form.
+
+* You must retain the complete text of this software license in the
+documentation and/or other materials provided with redistributions of
+the Fraunhofer FDK MPEG-H Software or your modifications thereto in binary form.
+You must make available free of charge copies of the complete source code of
+the Fraunhofer FDK MPEG-H Software and your modifications thereto to recipients
+of copies in binary form.
+
+* The name of Fraunhofer may not be used to endorse or promote products derived
+from the Fraunhofer FDK MPEG-H Software without prior written permission.
+
+* You may not charge copyright license fees for anyone to use, copy or
+distribute the Fraunhofer FDK MPEG-H Software or your modifications thereto.
+
+* Your modified versions of the Fraunhofer FDK MPEG-H Software must carry
+prominent notices stating that you changed the software and the date of any
+change. For modified versions of the Fraunhofer FDK MPEG-H Software, the term
+"Fraunhofer FDK MPEG-H Software" must be replaced by the term "Third-Party
+Modified Version of the Fraunhofer FDK MPEG-H Software".
+
+3. No PATENT LICENSE
+
+NO EXPRESS OR IMPLIED LICENSES TO ANY PATENT CLAIMS, including without
+limitation the patents of Fraunhofer, ARE GRANTED BY THIS SOFTWARE LICENSE.
+Fraunhofer provides no warranty of patent non-infringement with respect to this
+software. You may use this Fraunhofer FDK MPEG-H Software or modifications
+thereto only for purposes that are authorized by appropriate patent licenses.
+
+4. DISCLAIMER
+
+This Fraunhofer FDK MPEG-H Software is provided by Fraunhofer on behalf of the
+copyright holders and contributors "AS IS" and WITHOUT ANY EXPRESS OR IMPLIED
+WARRANTIES, including but not limited to the implied warranties of
+merchantability and fitness for a particular purpose. IN NO EVENT SHALL THE
+COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE for any direct, indirect,
+incidental, special, exemplary, or consequential damages, including but not
+limited to procurement of substitute goods or services; loss of use, data, or
+profits, or business interruption, however caused and on any theory of
+liability, whether in contract, strict liability, or tort (including
+negligence), arising in any way out of the use of this software, even if
+advised of the possibility of such damage.
+
+5. CONTACT INFORMATION
+
+Fraunhofer Institute for Integrated Circuits IIS
+Attention: Division Audio and Media Technologies - MPEG-H FDK
+Am Wolfsmantel 33
+91058 Erlangen, Germany
+www.iis.fraunhofer.de/amm
+amm-info@iis.fraunhofer.de
+-----------------------------------------------------------------------------*/
+// System includes
+
+// External includes
+
+// Internal includes
+#include "mmtaudioparser/mhasparser.h"
+#include "bitreader.h"
+#include "parserutils.h"
+#include "syncsearch.h"
+
+namespace mmt {
+namespace audioparser {
+using namespace utils;
+
+CMhasParser::CMhasParser() : m_configParser(nullptr), m_data(nullptr), m_size(0), m_position(0) {}
+
+CMhasParser::CMhasParser(CMpeghParser& configParser) : CMhasParser() {
+  m_configParser = &configParser;
+}
+
+void CMhasParser::setBuffer(const uint8_t* data, size_t size) noexcept {
+  m_data = data;
+  m_size = data != nullptr ? size : 0;
+  m_position = 0;
+}
+
+SParseResult CMhasParser::nextPacket(SMhasPacket& packet) noexcept {
+  SParseResult result = parsePacket(m_data + m_position, m_size - m_position, packet);
+  if (!result.isOk()) {
+    // Report the error position relative to the whole buffer
+    result.bitOffset += 8 * m_position;
+    return result;
+  }
+
+  m_position += packet.packetSize;
+  if (m_configParser != nullptr && packet.packetType == EMhasPacketType::PACTYP_MPEGH3DACFG) {
+    packet.configResult = m_configParser->tryAddConfig(packet.payload, packet.packetLength);
+  }
+  return result;
+}
+
+SParseResult CMhasParser::resync(uint32_t numConfirmPackets) noexcept {
+  size_t remaining = m_size - m_position;
+  size_t offset = findSyncPacket(m_data + m_position, remaining, numConfirmPackets);
+  if (offset != remaining) {
+    m_position += offset;
+    return SParseResult{};
+  }
+
+  // Keep the bytes which may be the beginning of a SYNC packet completed by the next data
+  if (remaining >= MHAS_SYNC_PACKET_SIZE) {
+    m_position += remaining - (MHAS_SYNC_PACKET_SIZE - 1);
+  }
+  SParseResult result;
+  result.error = EParseError::endOfBuffer;
+  result.bitOffset = 8 * m_size;
+  result.syntaxElement = "mpeghAudioStreamPacket";
+  return result;
+}
+
+size_t CMhasParser::bytesConsumed() const noexcept {
+  return m_position;
+}
+
+SParseResult CMhasParser::parsePacket(const uint8_t* data, size_t size,
+                                      SMhasPacket& packet) noexcept {
+  packet = SMhasPacket{};
+  CBitReader bitParser(data, size);
+  CSyntaxElementScope scope(bitParser, "mpeghAudioStreamPacket");
+  packet.packetType = static_cast<EMhasPacketType>(bitParser.escapedValue<3, 8, 8>());
+  packet.packetLabel = bitParser.escapedValue<2, 8, 32>();
+  packet.packetLength = bitParser.escapedValue<11, 24, 24>();
+  if (!bitParser.isValid()) {
+    return bitParser.result();
+  }
+
+  // All possible header sizes are multiples of 8 bits, so the payload is always byte-aligned
+  size_t headerSize = bitParser.tell() / 8;
+  if (size - headerSize < packet.packetLength) {
+    bitParser.setError(EParseError::endOfBuffer, "mpeghAudioStreamPacketPayload");
+    return bitParser.result();
+  }
+
+  packet.payload = data + headerSize;
+  packet.packetSize = headerSize + packet.packetLength;
+  return SParseResult{};
+}
+
+static bool isKnownPacketType(EMhasPacketType packetType) noexcept {
+  auto type = static_cast<uint32_t>(packetType);
+  // Packet types 4 and 5 are reserved
+  return type <= static_cast<uint32_t>(EMhasPacketType::PACTYP_LOUDNESS) && type != 4 && type != 5;
+}
+
+// Checks whether the packets following a SYNC packet candidate are valid as far as data is
+// available
+static bool confirmSyncPacket(const uint8_t* data, size_t size, uint32_t numConfirmPackets) {
+  size_t position = MHAS_SYNC_PACKET_SIZE;
+  for (uint32_t i = 0; i < numConfirmPackets && position < size; ++i) {
+    SMhasPacket packet;
+    SParseResult result = CMhasParser::parsePacket(data + position, size - position, packet);
+    if (result.error == EParseError::endOfBuffer) {
+      // The packet is cut off, so only the part of the header read so far can be checked
+      return isKnownPacketType(packet.packetType);
+    }
+    if (!result.isOk() || !isKnownPacketType(packet.packetType)) {
+      return false;
+    }
+    position += packet.packetSize;
+  }
+  return true;
+}
+
+size_t CMhasParser::findSyncPacket(const uint8_t* data, size_t size,
+                                   uint32_t numConfirmPackets) noexcept {
+  size_t offset = 0;
+  while (offset < size) {
+    size_t candidate = offset + findSyncCandidate(data + offset, size - offset);
+    if (candidate == size || confirmSyncPacket(data + candidate, size - candidate,
+                                               numConfirmPackets)) {
+      return candidate;
+    }
+    offset = candidate + 1;
+  }
+  return size;
+}
+}  // namespace audioparser
+}  // namespace mmt
@@ -0,0 +1,335 @@
+/*-----------------------------------------------------------------------------
+Software License for The Fraunhofer FDK MPEG-H Software
+
+Copyright (c) 2024 Fraunhofer-Gesellschaft zur Förderung der angewandten
+Forschung e.V. and Contributors
+All rights reserved.
+
+1. INTRODUCTION
+
+The "Fraunhofer FDK MPEG-H Software" is software that implements the ISO/MPEG
+MPEG-H 3D Audio standard for digital audio or related system features. Patent
+licenses for necessary patent claims for the Fraunhofer FDK MPEG-H Software
+(including those of Fraunhofer), for the use in commercial products and
+services, may be obtained from the respective patent owners individually and/or
+from Via LA (www.via-la.com).
+
+Fraunhofer supports the development of MPEG-H products and services by offering
+additional software, documentation, and technical advice. In addition, it
+operates the MPEG-H Trademark Program to ease interoperability testing of end-
+products. Please visit www.mpegh.com for more information.
+
+2. COPYRIGHT LICENSE
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted without payment of copyright license fees provided that you
+satisfy the following conditions:
+
+* You must retain the complete text of this software license in redistributions
+of the Fraunhofer FDK MPEG-H Software or your modifications thereto in source
+code form.
+
+* You must retain the complete text of this software license in the
+documentation and/or other materials provided with redistributions of
+the Fraunhofer FDK MPEG-H Software or your modifications thereto in binary form.
+You must make available free of charge copies of the complete source code of
+the Fraunhofer FDK MPEG-H Software and your modifications thereto to recipients
+of copies in binary form.
+
+* The name of Fraunhofer may not be used to endorse or promote products derived
+from the Fraunhofer FDK MPEG-H Software without prior written permission.
+
+* You may not charge copyright license fees for anyone to use, copy or
+distribute the Fraunhofer FDK MPEG-H Software or your modifications thereto.
+
+* Your modified versions of the Fraunhofer FDK MPEG-H Software must carry
+prominent notices stating that you changed the software and the date of any
+change. For modified versions of the Fraunhofer FDK MPEG-H Software, the term
+"Fraunhofer FDK MPEG-H Software" must be replaced by the term "Third-Party
+Modified Version of the Fraunhofer FDK MPEG-H Software".
+
+3. No PATENT LICENSE
+
+NO EXPRESS OR IMPLIED LICENSES TO ANY PATENT CLAIMS, including without
+limitation the patents of Fraunhofer, ARE GRANTED BY THIS SOFTWARE LICENSE.
+Fraunhofer provides no warranty of patent non-infringement with respect to this
+software. You may use this Fraunhofer FDK MPEG-H Software or modifications
+thereto only for purposes that are authorized by appropriate patent licenses.
+
+4. DISCLAIMER
+
+This Fraunhofer FDK MPEG-H Software is provided by Fraunhofer on behalf of the
+copyright holders and contributors "AS IS" and WITHOUT ANY EXPRESS OR IMPLIED
+WARRANTIES, including but not limited to the implied warranties of
+merchantability and fitness for a particular purpose. IN NO EVENT SHALL THE
+COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE for any direct, indirect,
+incidental, special, exemplary, or consequential damages, including but not
+limited to procurement of substitute goods or services; loss of use, data, or
+profits, or business interruption, however caused and on any theory of
+liability, whether in contract, strict liability, or tort (including
+negligence), arising in any way out of the use of this software, even if
+advised of the possibility of such damage.
+
+5. CONTACT INFORMATION
+
+Fraunhofer Institute for Integrated Circuits IIS
+Attention: Division Audio and Media Technologies - MPEG-H FDK
+Am Wolfsmantel 33
+91058 Erlangen, Germany
+www.iis.fraunhofer.de/amm
+amm-info@iis.fraunhofer.de
+-----------------------------------------------------------------------------*/
+// System includes
+
+// External includes
+
+// Internal includes
+#include "mmtaudioparser/mmtaudioreassembler.h"
+#include "mmtaudioparser/mhasparser.h"
+#include "bitreader.h"
+#include "parserutils.h"
+#include "logging.h"
+
+namespace mmt {
+namespace audioparser {
+using namespace utils;
+
+// MMTP payload type of MPU mode packets
+static const uint8_t MMTP_TYPE_MPU = 0x00;
+// FEC types signalling a trailing source_FEC_payload_ID and repair packets
+static const uint8_t FEC_TYPE_SOURCE_PAYLOAD_ID = 1;
+static const uint8_t FEC_TYPE_REPAIR = 2;
+// MPU fragment type of media fragment units
+static const uint8_t FRAGMENT_TYPE_MFU = 2;
+// Values of the fragmentation indicator
+static const uint8_t FRAGMENT_COMPLETE = 0;
+static const uint8_t FRAGMENT_FIRST = 1;
+static const uint8_t FRAGMENT_MIDDLE = 2;
+// Size of the fields of the MPU payload header following its length field
+static const size_t MPU_HEADER_SIZE = 6;
+// Size of the DU header of timed MFUs: movie_fragment_sequence_number (32), sample_number (32),
+// offset (32), priority (8), dep_counter (8)
+static const size_t TIMED_MFU_HEADER_SIZE = 14;
+
+static uint32_t readBe32(const uint8_t* data) {
+  return (static_cast<uint32_t>(data[0]) << 24) | (static_cast<uint32_t>(data[1]) << 16) |
+         (static_cast<uint32_t>(data[2]) << 8) | static_cast<uint32_t>(data[3]);
+}
+
+CMmtAudioReassembler::CMmtAudioReassembler(CMpeghParser& configParser, uint16_t packetId)
+    : m_configParser(configParser),
+      m_packetId(packetId),
+      m_fragmentsPending(false),
+      m_nextFragmentCounter(0),
+      m_fragmentsMpuSequenceNumber(0),
+      m_fragmentsSampleNumber(0),
+      m_unitDropped(false),
+      m_droppedMpuSequenceNumber(0),
+      m_droppedSampleNumber(0),
+      m_numDroppedUnits(0) {}
+
+SParseResult CMmtAudioReassembler::addPacket(const uint8_t* packet, size_t packetSize,
+                                             std::vector<SMmtAccessUnit>& accessUnits) {
+  CBitReader bitParser(packet, packetSize);
+  CSyntaxElementScope scope(bitParser, "mmtp_packet");
+  uint8_t version = bitParser.read<2>();
+  bool packetCounterFlag = readBool(bitParser);
+  uint8_t fecType = bitParser.read<2>();
+  skipBits(bitParser, 1);  // reserved
+  bool extensionFlag = readBool(bitParser);
+  skipBits(bitParser, 1);  // RAP_flag
+  skipBits(bitParser, 2);  // reserved
+  uint8_t type = bitParser.read<6>();
+  uint16_t packetId = bitParser.read<16>();
+  skipBits(bitParser, 32);  // timestamp
+  skipBits(bitParser, 32);  // packet_sequence_number
+  if (packetCounterFlag) {
+    skipBits(bitParser, 32);  // packet_counter
+  }
+  if (extensionFlag) {
+    skipBits(bitParser, 16);  // type
+    skipBits(bitParser, 8 * bitParser.read<16>());
+  }
+  if (!bitParser.isValid()) {
+    return bitParser.result();
+  }
+  if (version != 0) {
+    bitParser.setError(EParseError::notSupported, "version");
+    return bitParser.result();
+  }
+  if (packetId != m_packetId || type != MMTP_TYPE_MPU || fecType == FEC_TYPE_REPAIR) {
+    return SParseResult{};
+  }
+
+  size_t headerSize = bitParser.tell() / 8;
+  size_t payloadEnd = packetSize;
+  if (fecType == FEC_TYPE_SOURCE_PAYLOAD_ID) {
+    // The source_FEC_payload_ID follows the payload
+    if (payloadEnd - headerSize < 4) {
+      bitParser.setError(EParseError::endOfBuffer, "source_FEC_payload_ID");
+      return bitParser.result();
+    }
+    payloadEnd -= 4;
+  }
+
+  // MMTP payload header for MPU mode
+  CBitReader payloadParser(packet, payloadEnd);
+  CSyntaxElementScope payloadScope(payloadParser, "MPU");
+  payloadParser.skip(8 * headerSize);
+  uint16_t length = payloadParser.read<16>();
+  uint8_t fragmentType = payloadParser.read<4>();
+  bool timed = readBool(payloadParser);
+  uint8_t fragmentationIndicator = payloadParser.read<2>();
+  bool aggregation = readBool(payloadParser);
+  uint8_t fragmentCounter = payloadParser.read<8>();
+  uint32_t mpuSequenceNumber = payloadParser.read<32>();
+  if (!payloadParser.isValid()) {
+    return payloadParser.result();
+  }
+  if (length < MPU_HEADER_SIZE || length > payloadEnd - headerSize - 2) {
+    payloadParser.setError(EParseError::invalidValue, "length");
+    return payloadParser.result();
+  }
+  if (fragmentType != FRAGMENT_TYPE_MFU || !timed) {
+    return SParseResult{};
+  }
+
+  const uint8_t* dataUnits = packet + headerSize + 2 + MPU_HEADER_SIZE;
+  size_t dataUnitsSize = length - MPU_HEADER_SIZE;
+  if (!aggregation) {
+    return addDataUnit(dataUnits, dataUnitsSize, fragmentationIndicator, fragmentCounter,
+                       mpuSequenceNumber, accessUnits);
+  }
+
+  // Aggregated data units are always complete and prefixed by their length
+  CBitReader dataUnitParser(dataUnits, dataUnitsSize);
+  CSyntaxElementScope dataUnitScope(dataUnitParser, "DU_length");
+  while (dataUnitParser.nofBitsLeft() != 0) {
+    size_t dataUnitLength = dataUnitParser.read<16>();
+    size_t dataUnitOffset = dataUnitParser.tell() / 8;
+    if (!dataUnitParser.isValid() || dataUnitLength > dataUnitsSize - dataUnitOffset) {
+      dataUnitParser.setError(EParseError::endOfBuffer);
+      SParseResult result = dataUnitParser.result();
+      result.bitOffset += 8 * (dataUnits - packet);
+      return result;
+    }
+    SParseResult result =
+        addDataUnit(dataUnits + dataUnitOffset, dataUnitLength, FRAGMENT_COMPLETE, 0,
+                    mpuSequenceNumber, accessUnits);
+    if (!result.isOk()) {
+      return result;
+    }
+    dataUnitParser.skip(8 * dataUnitLength);
+  }
+  return SParseResult{};
+}
+
+SParseResult CMmtAudioReassembler::addDataUnit(const uint8_t* data, size_t size,
+                                               uint8_t fragmentationIndicator,
+                                               uint8_t fragmentCounter,
+                                               uint32_t mpuSequenceNumber,
+                                               std::vector<SMmtAccessUnit>& accessUnits) {
+  if (size < TIMED_MFU_HEADER_SIZE) {
+    SParseResult result;
+    result.error = EParseError::endOfBuffer;
+    result.syntaxElement = "MFU";
+    return result;
+  }
+  uint32_t sampleNumber = readBe32(data + 4);
+  const uint8_t* sample = data + TIMED_MFU_HEADER_SIZE;
+  size_t sampleSize = size - TIMED_MFU_HEADER_SIZE;
+
+  if (fragmentationIndicator == FRAGMENT_COMPLETE) {
+    if (m_fragmentsPending) {
+      dropFragments();
+    }
+    addAccessUnit(sample, sampleSize, mpuSequenceNumber, sampleNumber, accessUnits);
+    return SParseResult{};
+  }
+
+  if (fragmentationIndicator == FRAGMENT_FIRST) {
+    if (m_fragmentsPending) {
+      dropFragments();
+    }
+    m_fragments.assign(sample, sample + sampleSize);
+    m_fragmentsPending = true;
+    m_fragmentsMpuSequenceNumber = mpuSequenceNumber;
+    m_fragmentsSampleNumber = sampleNumber;
+  } else {
+    // The fragment counter counts down to 0 for the last fragment
+    if (!m_fragmentsPending || fragmentCounter != m_nextFragmentCounter ||
+        mpuSequenceNumber != m_fragmentsMpuSequenceNumber ||
+        sampleNumber != m_fragmentsSampleNumber) {
+      if (m_fragmentsPending) {
+        dropFragments();
+      }
+      // The first fragment of this MFU was lost, so all its fragments are dropped as one unit
+      if (!m_unitDropped || mpuSequenceNumber != m_droppedMpuSequenceNumber ||
+          sampleNumber != m_droppedSampleNumber) {
+        dropUnit(mpuSequenceNumber, sampleNumber);
+      }
+      return SParseResult{};
+    }
+    m_fragments.insert(m_fragments.end(), sample, sample + sampleSize);
+  }
+
+  if (fragmentationIndicator == FRAGMENT_FIRST || fragmentationIndicator == FRAGMENT_MIDDLE) {
+    if (fragmentCounter == 0) {
+      dropFragments();
+      return SParseResult{};
+    }
+    m_nextFragmentCounter = static_cast<uint8_t>(fragmentCounter - 1);
+    return SParseResult{};
+  }
+
+  m_fragmentsPending = false;
+  addAccessUnit(m_fragments.data(), m_fragments.size(), m_fragmentsMpuSequenceNumber,
+                m_fragmentsSampleNumber, accessUnits);
+  return SParseResult{};
+}
+
+void CMmtAudioReassembler::addAccessUnit(const uint8_t* data, size_t size,
+                                         uint32_t mpuSequenceNumber, uint32_t sampleNumber,
+                                         std::vector<SMmtAccessUnit>& accessUnits) {
+  SMmtAccessUnit accessUnit;
+  accessUnit.mpuSequenceNumber = mpuSequenceNumber;
+  accessUnit.sampleNumber = sampleNumber;
+  accessUnit.data = data;
+  accessUnit.size = size;
+
+  // The MHAS parser feeds the in-band config into the config parser
+  CMhasParser mhasParser(m_configParser);
+  mhasParser.setBuffer(data, size);
+  SMhasPacket packet;
+  while (mhasParser.nextPacket(packet).isOk()) {
+    if (packet.packetType == EMhasPacketType::PACTYP_MPEGH3DACFG) {
+      accessUnit.configPresent = true;
+      accessUnit.configResult = packet.configResult;
+    } else if (packet.packetType == EMhasPacketType::PACTYP_MPEGH3DAFRAME &&
+               accessUnit.frame == nullptr) {
+      accessUnit.frame = packet.payload;
+      accessUnit.frameSize = packet.packetLength;
+    }
+  }
+  accessUnits.push_back(accessUnit);
+}
+
+void CMmtAudioReassembler::dropFragments() {
+  m_fragmentsPending = false;
+  dropUnit(m_fragmentsMpuSequenceNumber, m_fragmentsSampleNumber);
+}
+
+void CMmtAudioReassembler::dropUnit(uint32_t mpuSequenceNumber, uint32_t sampleNumber) {
+  ILO_LOG_WARNING("Dropping MFU %u of MPU %u due to missing fragments", sampleNumber,
+                  mpuSequenceNumber);
+  m_unitDropped = true;
+  m_droppedMpuSequenceNumber = mpuSequenceNumber;
+  m_droppedSampleNumber = sampleNumber;
+  ++m_numDroppedUnits;
+}
+
+uint64_t CMmtAudioReassembler::numDroppedUnits() const noexcept {
+  return m_numDroppedUnits;
+}
+}  // namespace audioparser
+}  // namespace mmt
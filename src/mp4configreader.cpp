@@ -0,0 +1,270 @@
+/*-----------------------------------------------------------------------------
+Software License for The Fraunhofer FDK MPEG-H Software
+
+Copyright (c) 2024 Fraunhofer-Gesellschaft zur Förderung der angewandten
+Forschung e.V. and Contributors
+All rights reserved.
+
+1. INTRODUCTION
+
+The "Fraunhofer FDK MPEG-H Software" is software that implements the ISO/MPEG
+MPEG-H 3D Audio standard for digital audio or related system features. Patent
+licenses for necessary patent claims for the Fraunhofer FDK MPEG-H Software
+(including those of Fraunhofer), for the use in commercial products and
+services, may be obtained from the respective patent owners individually and/or
+from Via LA (www.via-la.com).
+
+Fraunhofer supports the development of MPEG-H products and services by offering
+additional software, documentation, and technical advice. In addition, it
+operates the MPEG-H Trademark Program to ease interoperability testing of end-
+products. Please visit www.mpegh.com for more information.
+
+2. COPYRIGHT LICENSE
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted without payment of copyright license fees provided that you
+satisfy the following conditions:
+
+* You must retain the complete text of this software license in redistributions
+of the Fraunhofer FDK MPEG-H Software or your modifications thereto in source
+code form.
+
+* You must retain the complete text of this software license in the
+documentation and/or other materials provided with redistributions of
+the Fraunhofer FDK MPEG-H Software or your modifications thereto in binary form.
+You must make available free of charge copies of the complete source code of
+the Fraunhofer FDK MPEG-H Software and your modifications thereto to recipients
+of copies in binary form.
+
+* The name of Fraunhofer may not be used to endorse or promote products derived
+from the Fraunhofer FDK MPEG-H Software without prior written permission.
+
+* You may not charge copyright license fees for anyone to use, copy or
+distribute the Fraunhofer FDK MPEG-H Software or your modifications thereto.
+
+* Your modified versions of the Fraunhofer FDK MPEG-H Software must carry
+prominent notices stating that you changed the software and the date of any
+change. For modified versions of the Fraunhofer FDK MPEG-H Software, the term
+"Fraunhofer FDK MPEG-H Software" must be replaced by the term "Third-Party
+Modified Version of the Fraunhofer FDK MPEG-H Software".
+
+3. No PATENT LICENSE
+
+NO EXPRESS OR IMPLIED LICENSES TO ANY PATENT CLAIMS, including without
+limitation the patents of Fraunhofer, ARE GRANTED BY THIS SOFTWARE LICENSE.
+Fraunhofer provides no warranty of patent non-infringement with respect to this
+software. You may use this Fraunhofer FDK MPEG-H Software or modifications
+thereto only for purposes that are authorized by appropriate patent licenses.
+
+4. DISCLAIMER
+
+This Fraunhofer FDK MPEG-H Software is provided by Fraunhofer on behalf of the
+copyright holders and contributors "AS IS" and WITHOUT ANY EXPRESS OR IMPLIED
+WARRANTIES, including but not limited to the implied warranties of
+merchantability and fitness for a particular purpose. IN NO EVENT SHALL THE
+COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE for any direct, indirect,
+incidental, special, exemplary, or consequential damages, including but not
+limited to procurement of substitute goods or services; loss of use, data, or
+profits, or business interruption, however caused and on any theory of
+liability, whether in contract, strict liability, or tort (including
+negligence), arising in any way out of the use of this software, even if
+advised of the possibility of such damage.
+
+5. CONTACT INFORMATION
+
+Fraunhofer Institute for Integrated Circuits IIS
+Attention: Division Audio and Media Technologies - MPEG-H FDK
+Am Wolfsmantel 33
+91058 Erlangen, Germany
+www.iis.fraunhofer.de/amm
+amm-info@iis.fraunhofer.de
+-----------------------------------------------------------------------------*/
+// System includes
+
+// External includes
+#include "ilo/common_types.h"
+
+// Internal includes
+#include "mmtaudioparser/mp4configreader.h"
+#include "mappedfile.h"
+#include "logging.h"
+
+namespace mmt {
+namespace audioparser {
+static constexpr uint32_t fourCC(char a, char b, char c, char d) {
+  return (static_cast<uint32_t>(a) << 24) | (static_cast<uint32_t>(b) << 16) |
+         (static_cast<uint32_t>(c) << 8) | static_cast<uint32_t>(d);
+}
+
+static const uint32_t BOX_MOOV = fourCC('m', 'o', 'o', 'v');
+static const uint32_t BOX_TRAK = fourCC('t', 'r', 'a', 'k');
+static const uint32_t BOX_TKHD = fourCC('t', 'k', 'h', 'd');
+static const uint32_t BOX_MDIA = fourCC('m', 'd', 'i', 'a');
+static const uint32_t BOX_MINF = fourCC('m', 'i', 'n', 'f');
+static const uint32_t BOX_STBL = fourCC('s', 't', 'b', 'l');
+static const uint32_t BOX_STSD = fourCC('s', 't', 's', 'd');
+static const uint32_t BOX_MHAC = fourCC('m', 'h', 'a', 'C');
+static const uint32_t SAMPLE_ENTRY_MHA1 = fourCC('m', 'h', 'a', '1');
+static const uint32_t SAMPLE_ENTRY_MHA2 = fourCC('m', 'h', 'a', '2');
+static const uint32_t SAMPLE_ENTRY_MHM1 = fourCC('m', 'h', 'm', '1');
+static const uint32_t SAMPLE_ENTRY_MHM2 = fourCC('m', 'h', 'm', '2');
+
+// Size of the SampleEntry and AudioSampleEntry fields preceding the child boxes
+static const size_t AUDIO_SAMPLE_ENTRY_SIZE = 28;
+
+static uint32_t readBe(const uint8_t* data, size_t numBytes) {
+  uint32_t value = 0;
+  for (size_t i = 0; i < numBytes; ++i) {
+    value = (value << 8) | data[i];
+  }
+  return value;
+}
+
+namespace {
+struct SBox {
+  uint32_t type = 0;
+  const uint8_t* payload = nullptr;
+  size_t payloadSize = 0;
+};
+
+// Iterates over the boxes contained in a memory region
+class CBoxIterator {
+ public:
+  CBoxIterator(const uint8_t* data, size_t size) : m_data(data), m_size(size), m_position(0) {}
+
+  bool next(SBox& box) {
+    size_t remaining = m_size - m_position;
+    if (remaining == 0) {
+      return false;
+    }
+    ILO_ASSERT(remaining >= 8, "Truncated box header at offset %zu", m_position);
+    const uint8_t* header = m_data + m_position;
+    uint64_t boxSize = readBe(header, 4);
+    box.type = readBe(header + 4, 4);
+    size_t headerSize = 8;
+    if (boxSize == 1) {
+      ILO_ASSERT(remaining >= 16, "Truncated box header at offset %zu", m_position);
+      boxSize = (static_cast<uint64_t>(readBe(header + 8, 4)) << 32) | readBe(header + 12, 4);
+      headerSize = 16;
+    } else if (boxSize == 0) {
+      // The box extends to the end of the enclosing region
+      boxSize = remaining;
+    }
+    ILO_ASSERT(boxSize >= headerSize && boxSize <= remaining,
+               "Invalid size of box at offset %zu", m_position);
+
+    box.payload = header + headerSize;
+    box.payloadSize = static_cast<size_t>(boxSize) - headerSize;
+    m_position += static_cast<size_t>(boxSize);
+    return true;
+  }
+
+ private:
+  const uint8_t* m_data;
+  size_t m_size;
+  size_t m_position;
+};
+}  // namespace
+
+static bool findBox(const uint8_t* data, size_t size, uint32_t type, SBox& box) {
+  CBoxIterator boxes(data, size);
+  while (boxes.next(box)) {
+    if (box.type == type) {
+      return true;
+    }
+  }
+  return false;
+}
+
+static bool isMhaSampleEntry(uint32_t type) {
+  return type == SAMPLE_ENTRY_MHA1 || type == SAMPLE_ENTRY_MHA2 || type == SAMPLE_ENTRY_MHM1 ||
+         type == SAMPLE_ENTRY_MHM2;
+}
+
+std::vector<SMhaTrackConfig> CMp4ConfigReader::readFile(const std::string& path) {
+  // Boxes like mdat are skipped by their size, so readahead would only pull in their content
+  utils::CMappedFile file(path, utils::CMappedFile::EAccessPattern::random);
+  return readBuffer(file.data(), file.size());
+}
+
+std::vector<SMhaTrackConfig> CMp4ConfigReader::readBuffer(const uint8_t* data, size_t size) {
+  std::vector<SMhaTrackConfig> configs;
+  SBox moov;
+  if (data == nullptr || !findBox(data, size, BOX_MOOV, moov)) {
+    return configs;
+  }
+
+  CBoxIterator boxes(moov.payload, moov.payloadSize);
+  SBox box;
+  while (boxes.next(box)) {
+    if (box.type == BOX_TRAK) {
+      readTrack(box.payload, box.payloadSize, configs);
+    }
+  }
+  return configs;
+}
+
+void CMp4ConfigReader::readTrack(const uint8_t* data, size_t size,
+                                 std::vector<SMhaTrackConfig>& configs) {
+  SBox mdia, minf, stbl, stsd;
+  if (!findBox(data, size, BOX_MDIA, mdia) ||
+      !findBox(mdia.payload, mdia.payloadSize, BOX_MINF, minf) ||
+      !findBox(minf.payload, minf.payloadSize, BOX_STBL, stbl) ||
+      !findBox(stbl.payload, stbl.payloadSize, BOX_STSD, stsd)) {
+    return;
+  }
+
+  uint32_t trackId = 0;
+  SBox tkhd;
+  if (findBox(data, size, BOX_TKHD, tkhd) && tkhd.payloadSize >= 4) {
+    // The creation and modification times preceding the track_ID are 64 bit wide in version 1
+    size_t trackIdOffset = tkhd.payload[0] == 1 ? 20 : 12;
+    ILO_ASSERT(tkhd.payloadSize >= trackIdOffset + 4, "Truncated track header box");
+    trackId = readBe(tkhd.payload + trackIdOffset, 4);
+  }
+
+  // The sample description box is a full box followed by the entry count
+  ILO_ASSERT(stsd.payloadSize >= 8, "Truncated sample description box");
+  CBoxIterator sampleEntries(stsd.payload + 8, stsd.payloadSize - 8);
+  SBox sampleEntry;
+  while (sampleEntries.next(sampleEntry)) {
+    if (!isMhaSampleEntry(sampleEntry.type)) {
+      continue;
+    }
+    SMhaTrackConfig config;
+    config.trackId = trackId;
+    config.sampleEntryType = sampleEntry.type;
+    readSampleEntry(sampleEntry.payload, sampleEntry.payloadSize, config);
+    configs.push_back(config);
+  }
+}
+
+void CMp4ConfigReader::readSampleEntry(const uint8_t* data, size_t size,
+                                       SMhaTrackConfig& config) {
+  ILO_ASSERT(size >= AUDIO_SAMPLE_ENTRY_SIZE, "Truncated audio sample entry");
+  SBox mhaC;
+  if (!findBox(data + AUDIO_SAMPLE_ENTRY_SIZE, size - AUDIO_SAMPLE_ENTRY_SIZE, BOX_MHAC, mhaC)) {
+    ILO_ASSERT(config.sampleEntryType == SAMPLE_ENTRY_MHM1 ||
+                   config.sampleEntryType == SAMPLE_ENTRY_MHM2,
+               "The mhaC box is mandatory for mha1 and mha2 sample entries");
+    return;
+  }
+
+  // MHADecoderConfigurationRecord: configurationVersion (8), mpegh3daProfileLevelIndication (8),
+  // referenceChannelLayout (8), mpegh3daConfigLength (16), mpegh3daConfig()
+  ILO_ASSERT(mhaC.payloadSize >= 5, "Truncated MHADecoderConfigurationRecord");
+  ILO_ASSERT(mhaC.payload[0] == 1, "Unsupported MHADecoderConfigurationRecord version %u",
+             mhaC.payload[0]);
+  config.configPresent = true;
+  config.profileLevelIndication = mhaC.payload[1];
+  config.referenceChannelLayout = mhaC.payload[2];
+  uint32_t configLength = readBe(mhaC.payload + 3, 2);
+  ILO_ASSERT(configLength <= mhaC.payloadSize - 5, "Truncated MHADecoderConfigurationRecord");
+
+  config.parseResult = m_configParser.tryAddConfig(mhaC.payload + 5, configLength);
+  if (config.parseResult.isOk()) {
+    config.configInfo = m_configParser.getConfigSnapshot();
+  }
+}
+}  // namespace audioparser
+}  // namespace mmt
@@ -0,0 +1,202 @@
+/*-----------------------------------------------------------------------------
+Software License for The Fraunhofer FDK MPEG-H Software
+
+Copyright (c) 2024 Fraunhofer-Gesellschaft zur Förderung der angewandten
+Forschung e.V. and Contributors
+All rights reserved.
+
+1. INTRODUCTION
+
+The "Fraunhofer FDK MPEG-H Software" is software that implements the ISO/MPEG
+MPEG-H 3D Audio standard for digital audio or related system features. Patent
+licenses for necessary patent claims for the Fraunhofer FDK MPEG-H Software
+(including those of Fraunhofer), for the use in commercial products and
+services, may be obtained from the respective patent owners individually and/or
+from Via LA (www.via-la.com).
+
+Fraunhofer supports the development of MPEG-H products and services by offering
+additional software, documentation, and technical advice. In addition, it
+operates the MPEG-H Trademark Program to ease interoperability testing of end-
+products. Please visit www.mpegh.com for more information.
+
+2. COPYRIGHT LICENSE
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted without payment of copyright license fees provided that you
+satisfy the following conditions:
+
+* You must retain the complete text of this software license in redistributions
+of the Fraunhofer FDK MPEG-H Software or your modifications thereto in source
+code form.
+
+* You must retain the complete text of this software license in the
+documentation and/or other materials provided with redistributions of
+the Fraunhofer FDK MPEG-H Software or your modifications thereto in binary form.
+You must make available free of charge copies of the complete source code of
+the Fraunhofer FDK MPEG-H Software and your modifications thereto to recipients
+of copies in binary form.
+
+* The name of Fraunhofer may not be used to endorse or promote products derived
+from the Fraunhofer FDK MPEG-H Software without prior written permission.
+
+* You may not charge copyright license fees for anyone to use, copy or
+distribute the Fraunhofer FDK MPEG-H Software or your modifications thereto.
+
+* Your modified versions of the Fraunhofer FDK MPEG-H Software must carry
+prominent notices stating that you changed the software and the date of any
+change. For modified versions of the Fraunhofer FDK MPEG-H Software, the term
+"Fraunhofer FDK MPEG-H Software" must be replaced by the term "Third-Party
+Modified Version of the Fraunhofer FDK MPEG-H Software".
+
+3. No PATENT LICENSE
+
+NO EXPRESS OR IMPLIED LICENSES TO ANY PATENT CLAIMS, including without
+limitation the patents of Fraunhofer, ARE GRANTED BY THIS SOFTWARE LICENSE.
+Fraunhofer provides no warranty of patent non-infringement with respect to this
+software. You may use this Fraunhofer FDK MPEG-H Software or modifications
+thereto only for purposes that are authorized by appropriate patent licenses.
+
+4. DISCLAIMER
+
+This Fraunhofer FDK MPEG-H Software is provided by Fraunhofer on behalf of the
+copyright holders and contributors "AS IS" and WITHOUT ANY EXPRESS OR IMPLIED
+WARRANTIES, including but not limited to the implied warranties of
+merchantability and fitness for a particular purpose. IN NO EVENT SHALL THE
+COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE for any direct, indirect,
+incidental, special, exemplary, or consequential damages, including but not
+limited to procurement of substitute goods or services; loss of use, data, or
+profits, or business interruption, however caused and on any theory of
+liability, whether in contract, strict liability, or tort (including
+negligence), arising in any way out of the use of this software, even if
+advised of the possibility of such damage.
+
+5. CONTACT INFORMATION
+
+Fraunhofer Institute for Integrated Circuits IIS
+Attention: Division Audio and Media Technologies - MPEG-H FDK
+Am Wolfsmantel 33
+91058 Erlangen, Germany
+www.iis.fraunhofer.de/amm
+amm-info@iis.fraunhofer.de
+-----------------------------------------------------------------------------*/
+// System includes
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <system_error>
+#include <thread>
+
+// External includes
+#include "ilo/memory.h"
+
+// Internal includes
+#include "mmtaudioparser/mpeghbatchparser.h"
+#include "logging.h"
+
+namespace mmt {
+namespace audioparser {
+using SInput = CMpeghBatchParser::SInput;
+using SItemResult = CMpeghBatchParser::SItemResult;
+
+static void parseChunks(CMpeghParser& parser, const SInput* inputs, size_t numInputs,
+                        size_t chunkSize, std::atomic<size_t>& nextChunk,
+                        std::vector<SItemResult>& results) {
+  for (;;) {
+    size_t begin = nextChunk.fetch_add(1, std::memory_order_relaxed) * chunkSize;
+    if (begin >= numInputs) {
+      return;
+    }
+    size_t end = std::min(begin + chunkSize, numInputs);
+    for (size_t i = begin; i < end; ++i) {
+      // Each result entry is written by exactly one worker, so no synchronization is needed.
+      SItemResult& result = results[i];
+      result.parseResult = parser.tryAddConfig(inputs[i].data, inputs[i].size);
+      if (result.parseResult.isOk()) {
+        result.configInfo = parser.getConfigSnapshot();
+      }
+    }
+  }
+}
+
+CMpeghBatchParser::CMpeghBatchParser() : CMpeghBatchParser(SBatchOptions{}) {}
+
+CMpeghBatchParser::CMpeghBatchParser(const SBatchOptions& options) : m_options(options) {
+  if (m_options.numWorkers == 0) {
+    m_options.numWorkers = std::max(1u, std::thread::hardware_concurrency());
+  }
+  m_options.chunkSize = std::max<size_t>(m_options.chunkSize, 1);
+
+  m_parsers.reserve(m_options.numWorkers);
+  for (uint32_t i = 0; i < m_options.numWorkers; ++i) {
+    m_parsers.push_back(ilo::make_unique<CMpeghParser>());
+  }
+}
+
+CMpeghBatchParser::~CMpeghBatchParser() = default;
+
+std::vector<SItemResult> CMpeghBatchParser::parse(const SInput* inputs, size_t numInputs) {
+  std::vector<SItemResult> results(numInputs);
+  std::atomic<size_t> nextChunk{0};
+
+  // Rounding up by adding chunkSize - 1 would overflow for huge chunk sizes
+  size_t numChunks = numInputs / m_options.chunkSize + (numInputs % m_options.chunkSize != 0);
+  size_t numThreads = std::min<size_t>(m_options.numWorkers, numChunks);
+  if (numThreads <= 1) {
+    if (numThreads == 1) {
+      parseChunks(*m_parsers[0], inputs, numInputs, m_options.chunkSize, nextChunk, results);
+    }
+    return results;
+  }
+
+  // The calling thread acts as the last worker. Parsing reports running out of memory in the
+  // result entry, exceptions of the remaining calls are passed on to the caller once all workers
+  // have finished.
+  std::vector<std::exception_ptr> errors(numThreads);
+  auto work = [&](size_t worker) {
+    try {
+      parseChunks(*m_parsers[worker], inputs, numInputs, m_options.chunkSize, nextChunk, results);
+    } catch (...) {
+      errors[worker] = std::current_exception();
+      // Let the remaining workers run out of chunks quickly.
+      nextChunk.store(numChunks, std::memory_order_relaxed);
+    }
+  };
+  std::vector<std::thread> threads;
+  threads.reserve(numThreads - 1);
+  for (size_t worker = 0; worker + 1 < numThreads; ++worker) {
+    try {
+      threads.emplace_back(work, worker);
+    } catch (const std::system_error&) {
+      // The chunks are distributed dynamically, so the workers started so far and the calling
+      // thread parse all of them.
+      ILO_LOG_WARNING("Started only %zu of %zu batch parser threads", worker, numThreads - 1);
+      break;
+    }
+  }
+  work(numThreads - 1);
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  for (const auto& error : errors) {
+    if (error) {
+      std::rethrow_exception(error);
+    }
+  }
+  return results;
+}
+
+std::vector<SItemResult> CMpeghBatchParser::parse(const std::vector<ilo::ByteBuffer>& configs) {
+  std::vector<SInput> inputs(configs.size());
+  for (size_t i = 0; i < configs.size(); ++i) {
+    inputs[i].data = configs[i].data();
+    inputs[i].size = configs[i].size();
+  }
+  return parse(inputs.data(), inputs.size());
+}
+
+uint32_t CMpeghBatchParser::numWorkers() const noexcept {
+  return m_options.numWorkers;
+}
+}  // namespace audioparser
+}  // namespace mmt
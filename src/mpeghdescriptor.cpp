@@ -0,0 +1,180 @@
+/*-----------------------------------------------------------------------------
+Software License for The Fraunhofer FDK MPEG-H Software
+
+Copyright (c) 2024 Fraunhofer-Gesellschaft zur Förderung der angewandten
+Forschung e.V. and Contributors
+All rights reserved.
+
+1. INTRODUCTION
+
+The "Fraunhofer FDK MPEG-H Software" is software that implements the ISO/MPEG
+MPEG-H 3D Audio standard for digital audio or related system features. Patent
+licenses for necessary patent claims for the Fraunhofer FDK MPEG-H Software
+(including those of Fraunhofer), for the use in commercial products and
+services, may be obtained from the respective patent owners individually and/or
+from Via LA (www.via-la.com).
+
+Fraunhofer supports the development of MPEG-H products and services by offering
+additional software, documentation, and technical advice. In addition, it
+operates the MPEG-H Trademark Program to ease interoperability testing of end-
+products. Please visit www.mpegh.com for more information.
+
+2. COPYRIGHT LICENSE
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted without payment of copyright license fees provided that you
+satisfy the following conditions:
+
+* You must retain the complete text of this software license in redistributions
+of the Fraunhofer FDK MPEG-H Software or your modifications thereto in source
+code form.
+
+* You must retain the complete text of this software license in the
+documentation and/or other materials provided with redistributions of
+the Fraunhofer FDK MPEG-H Software or your modifications thereto in binary form.
+You must make available free of charge copies of the complete source code of
+the Fraunhofer FDK MPEG-H Software and your modifications thereto to recipients
+of copies in binary form.
+
+* The name of Fraunhofer may not be used to endorse or promote products derived
+from the Fraunhofer FDK MPEG-H Software without prior written permission.
+
+* You may not charge copyright license fees for anyone to use, copy or
+distribute the Fraunhofer FDK MPEG-H Software or your modifications thereto.
+
+* Your modified versions of the Fraunhofer FDK MPEG-H Software must carry
+prominent notices stating that you changed the software and the date of any
+change. For modified versions of the Fraunhofer FDK MPEG-H Software, the term
+"Fraunhofer FDK MPEG-H Software" must be replaced by the term "Third-Party
+Modified Version of the Fraunhofer FDK MPEG-H Software".
+
+3. No PATENT LICENSE
+
+NO EXPRESS OR IMPLIED LICENSES TO ANY PATENT CLAIMS, including without
+limitation the patents of Fraunhofer, ARE GRANTED BY THIS SOFTWARE LICENSE.
+Fraunhofer provides no warranty of patent non-infringement with respect to this
+software. You may use this Fraunhofer FDK MPEG-H Software or modifications
+thereto only for purposes that are authorized by appropriate patent licenses.
+
+4. DISCLAIMER
+
+This Fraunhofer FDK MPEG-H Software is provided by Fraunhofer on behalf of the
+copyright holders and contributors "AS IS" and WITHOUT ANY EXPRESS OR IMPLIED
+WARRANTIES, including but not limited to the implied warranties of
+merchantability and fitness for a particular purpose. IN NO EVENT SHALL THE
+COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE for any direct, indirect,
+incidental, special, exemplary, or consequential damages, including but not
+limited to procurement of substitute goods or services; loss of use, data, or
+profits, or business interruption, however caused and on any theory of
+liability, whether in contract, strict liability, or tort (including
+negligence), arising in any way out of the use of this software, even if
+advised of the possibility of such damage.
+
+5. CONTACT INFORMATION
+
+Fraunhofer Institute for Integrated Circuits IIS
+Attention: Division Audio and Media Technologies - MPEG-H FDK
+Am Wolfsmantel 33
+91058 Erlangen, Germany
+www.iis.fraunhofer.de/amm
+amm-info@iis.fraunhofer.de
+-----------------------------------------------------------------------------*/
+// System includes
+
+// External includes
+
+// Internal includes
+#include "mmtaudioparser/mpeghdescriptor.h"
+#include "mmtaudioparser/cicp.h"
+#include "bitreader.h"
+#include "parserutils.h"
+
+namespace mmt {
+namespace audioparser {
+using namespace utils;
+
+constexpr uint8_t CMpeghDescriptorParser::TS_EXTENSION_DESCRIPTOR_TAG;
+constexpr uint8_t CMpeghDescriptorParser::TS_MPEGH_3DAUDIO_DESCRIPTOR_TAG_EXTENSION;
+
+// Parses the descriptor fields following the descriptor header, which are the same for MPEG-2 TS
+// and MMT
+static void mpegh3daDescriptorBody(CBitReader& bitParser, SMpegh3daDescriptor& descriptor) {
+  descriptor.profileLevelIndication = bitParser.read<8>();
+  descriptor.interactivityEnabled = readBool(bitParser);
+  bool compatibleProfileSetsPresent = readBool(bitParser);
+  skipBits(bitParser, 6);  // reserved
+  descriptor.referenceChannelLayout = bitParser.read<8>();
+  if (compatibleProfileSetsPresent) {
+    uint8_t numCompatibleSets = bitParser.read<8>();
+    for (uint8_t i = 0; i < numCompatibleSets && bitParser.isValid(); ++i) {
+      descriptor.compatibleSetIndications.push_back(bitParser.read<8>());
+    }
+  }
+  // Any remaining bytes are reserved
+}
+
+SParseResult CMpeghDescriptorParser::parseTsDescriptor(const uint8_t* data, size_t size,
+                                                       SMpegh3daDescriptor& descriptor) noexcept {
+  descriptor = SMpegh3daDescriptor{};
+  CBitReader bitParser(data, size);
+  CSyntaxElementScope scope(bitParser, "MPEG-H_3dAudio_descriptor");
+  descriptor.descriptorTag = bitParser.read<8>();
+  size_t descriptorLength = bitParser.read<8>();
+  uint8_t descriptorTagExtension = bitParser.read<8>();
+  if (!bitParser.isValid()) {
+    return bitParser.result();
+  }
+  if (descriptor.descriptorTag != TS_EXTENSION_DESCRIPTOR_TAG ||
+      descriptorTagExtension != TS_MPEGH_3DAUDIO_DESCRIPTOR_TAG_EXTENSION) {
+    bitParser.setError(EParseError::notSupported, "descriptor_tag");
+    return bitParser.result();
+  }
+  if (descriptorLength < 1 || descriptorLength > size - 2) {
+    bitParser.setError(EParseError::endOfBuffer, "descriptor_length");
+    return bitParser.result();
+  }
+
+  // The descriptor_length includes the descriptor_tag_extension
+  CBitReader bodyParser(data + 3, descriptorLength - 1);
+  CSyntaxElementScope bodyScope(bodyParser, "MPEG-H_3dAudio_descriptor");
+  mpegh3daDescriptorBody(bodyParser, descriptor);
+  SParseResult result = bodyParser.result();
+  result.bitOffset += 3 * 8;
+  return result;
+}
+
+SParseResult CMpeghDescriptorParser::parseMmtDescriptor(const uint8_t* data, size_t size,
+                                                        SMpegh3daDescriptor& descriptor) noexcept {
+  descriptor = SMpegh3daDescriptor{};
+  CBitReader bitParser(data, size);
+  CSyntaxElementScope scope(bitParser, "MPEG-H_3dAudio_descriptor");
+  descriptor.descriptorTag = bitParser.read<16>();
+  size_t descriptorLength = bitParser.read<8>();
+  if (!bitParser.isValid()) {
+    return bitParser.result();
+  }
+  if (descriptorLength > size - 3) {
+    bitParser.setError(EParseError::endOfBuffer, "descriptor_length");
+    return bitParser.result();
+  }
+
+  CBitReader bodyParser(data + 3, descriptorLength);
+  CSyntaxElementScope bodyScope(bodyParser, "MPEG-H_3dAudio_descriptor");
+  mpegh3daDescriptorBody(bodyParser, descriptor);
+  SParseResult result = bodyParser.result();
+  result.bitOffset += 3 * 8;
+  return result;
+}
+
+CMpeghParser::SConfigInfo CMpeghDescriptorParser::toConfigInfo(
+    const SMpegh3daDescriptor& descriptor) {
+  CMpeghParser::SConfigInfo info{};
+  info.profileLevelIndicator = descriptor.profileLevelIndication;
+  info.referenceLayout.speakerLayoutType = 0;
+  info.referenceLayout.CICPIdx = descriptor.referenceChannelLayout;
+  info.referenceLayout.numSpeakers = cicp::layoutNumSpeakers(descriptor.referenceChannelLayout);
+  info.compatibleProfileLevels = descriptor.compatibleSetIndications;
+  return info;
+}
+}  // namespace audioparser
+}  // namespace mmt
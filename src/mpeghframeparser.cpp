@@ -0,0 +1,266 @@
+/*-----------------------------------------------------------------------------
+Software License for The Fraunhofer FDK MPEG-H Software
+
+Copyright (c) 2024 Fraunhofer-Gesellschaft zur Förderung der angewandten
+Forschung e.V. and Contributors
+All rights reserved.
+
+1. INTRODUCTION
+
+The "Fraunhofer FDK MPEG-H Software" is software that implements the ISO/MPEG
+MPEG-H 3D Audio standard for digital audio or related system features. Patent
+licenses for necessary patent claims for the Fraunhofer FDK MPEG-H Software
+(including those of Fraunhofer), for the use in commercial products and
+services, may be obtained from the respective patent owners individually and/or
+from Via LA (www.via-la.com).
+
+Fraunhofer supports the development of MPEG-H products and services by offering
+additional software, documentation, and technical advice. In addition, it
+operates the MPEG-H Trademark Program to ease interoperability testing of end-
+products. Please visit www.mpegh.com for more information.
+
+2. COPYRIGHT LICENSE
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted without payment of copyright license fees provided that you
+satisfy the following conditions:
+
+* You must retain the complete text of this software license in redistributions
+of the Fraunhofer FDK MPEG-H Software or your modifications thereto in source
+code form.
+
+* You must retain the complete text of this software license in the
+documentation and/or other materials provided with redistributions of
+the Fraunhofer FDK MPEG-H Software or your modifications thereto in binary form.
+You must make available free of charge copies of the complete source code of
+the Fraunhofer FDK MPEG-H Software and your modifications thereto to recipients
+of copies in binary form.
+
+* The name of Fraunhofer may not be used to endorse or promote products derived
+from the Fraunhofer FDK MPEG-H Software without prior written permission.
+
+* You may not charge copyright license fees for anyone to use, copy or
+distribute the Fraunhofer FDK MPEG-H Software or your modifications thereto.
+
+* Your modified versions of the Fraunhofer FDK MPEG-H Software must carry
+prominent notices stating that you changed the software and the date of any
+change. For modified versions of the Fraunhofer FDK MPEG-H Software, the term
+"Fraunhofer FDK MPEG-H Software" must be replaced by the term "Third-Party
+Modified Version of the Fraunhofer FDK MPEG-H Software".
+
+3. No PATENT LICENSE
+
+NO EXPRESS OR IMPLIED LICENSES TO ANY PATENT CLAIMS, including without
+limitation the patents of Fraunhofer, ARE GRANTED BY THIS SOFTWARE LICENSE.
+Fraunhofer provides no warranty of patent non-infringement with respect to this
+software. You may use this Fraunhofer FDK MPEG-H Software or modifications
+thereto only for purposes that are authorized by appropriate patent licenses.
+
+4. DISCLAIMER
+
+This Fraunhofer FDK MPEG-H Software is provided by Fraunhofer on behalf of the
+copyright holders and contributors "AS IS" and WITHOUT ANY EXPRESS OR IMPLIED
+WARRANTIES, including but not limited to the implied warranties of
+merchantability and fitness for a particular purpose. IN NO EVENT SHALL THE
+COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE for any direct, indirect,
+incidental, special, exemplary, or consequential damages, including but not
+limited to procurement of substitute goods or services; loss of use, data, or
+profits, or business interruption, however caused and on any theory of
+liability, whether in contract, strict liability, or tort (including
+negligence), arising in any way out of the use of this software, even if
+advised of the possibility of such damage.
+
+5. CONTACT INFORMATION
+
+Fraunhofer Institute for Integrated Circuits IIS
+Attention: Division Audio and Media Technologies - MPEG-H FDK
+Am Wolfsmantel 33
+91058 Erlangen, Germany
+www.iis.fraunhofer.de/amm
+amm-info@iis.fraunhofer.de
+-----------------------------------------------------------------------------*/
+// System includes
+#include <utility>
+
+// External includes
+#include "ilo/common_types.h"
+
+// Internal includes
+#include "mmtaudioparser/mpeghframeparser.h"
+#include "bitreader.h"
+#include "common.h"
+#include "parserutils.h"
+#include "logging.h"
+
+namespace mmt {
+namespace audioparser {
+using namespace utils;
+
+constexpr uint32_t SFrameElement::NO_SIGNAL_GROUP;
+
+// As defined in ISO/IEC 23008-3
+static constexpr uint32_t ID_EXT_ELE_AUDIOPREROLL = 3;
+
+CMpeghFrameParser::CMpeghFrameParser(std::shared_ptr<const CMpeghParser::SConfigInfo> configInfo)
+    : m_configInfo(std::move(configInfo)) {
+  ILO_ASSERT(m_configInfo != nullptr, "The frame parser requires a configuration");
+
+  // The audio elements carry the signals of all signal groups in order, one signal per SCE and
+  // LFE and two per CPE
+  m_signalGroupIdxs.reserve(m_configInfo->elementConfigs.size());
+  uint32_t signalGroupIdx = 0;
+  uint32_t signalIdx = 0;
+  for (const auto& elementConfig : m_configInfo->elementConfigs) {
+    auto elementType = static_cast<EUsacElementType>(elementConfig.usacElementType);
+    if (elementType == EUsacElementType::ID_USAC_EXT) {
+      m_signalGroupIdxs.push_back(SFrameElement::NO_SIGNAL_GROUP);
+      continue;
+    }
+    while (signalGroupIdx < m_configInfo->signalGroups.size() &&
+           signalIdx >= m_configInfo->signalGroups[signalGroupIdx].numSignals) {
+      signalIdx -= m_configInfo->signalGroups[signalGroupIdx].numSignals;
+      ++signalGroupIdx;
+    }
+    m_signalGroupIdxs.push_back(signalGroupIdx < m_configInfo->signalGroups.size()
+                                    ? signalGroupIdx
+                                    : SFrameElement::NO_SIGNAL_GROUP);
+    signalIdx += elementType == EUsacElementType::ID_USAC_CPE ? 2 : 1;
+  }
+}
+
+SParseResult CMpeghFrameParser::splitFrame(const uint8_t* frame, size_t frameSize,
+                                           SFrameLayout& layout) const {
+  SBitView view;
+  view.data = frame;
+  view.bitLength = frame != nullptr ? frameSize * 8 : 0;
+  return splitFrame(view, layout);
+}
+
+SParseResult CMpeghFrameParser::splitFrame(const SBitView& frame, SFrameLayout& layout) const {
+  layout.elements.clear();
+  CBitReader bitParser(frame);
+  CSyntaxElementScope scope(bitParser, "mpegh3daFrame");
+  if (!m_configInfo->elementLengthPresent) {
+    bitParser.setError(EParseError::notSupported, "elementLengthPresent");
+    return bitParser.result();
+  }
+
+  layout.usacIndependencyFlag = readBool(bitParser);
+  const auto& elementConfigs = m_configInfo->elementConfigs;
+  for (uint32_t elementIdx = 0; elementIdx < elementConfigs.size(); ++elementIdx) {
+    const auto& elementConfig = elementConfigs[elementIdx];
+    SFrameElement element;
+    element.elementIdx = elementIdx;
+    element.signalGroupIdx = m_signalGroupIdxs[elementIdx];
+    element.bitOffset = bitParser.tell();
+
+    if (static_cast<EUsacElementType>(elementConfig.usacElementType) !=
+        EUsacElementType::ID_USAC_EXT) {
+      CSyntaxElementScope elementScope(bitParser, "elementLength");
+      size_t elementLength = bitParser.read<16>();
+      element.payloadBitOffset = bitParser.tell();
+      element.payloadBitLength = elementLength;
+      skipBits(bitParser, static_cast<uint32_t>(elementLength));
+    } else {
+      CSyntaxElementScope elementScope(bitParser, "mpegh3daExtElement");
+      element.present = readBool(bitParser);
+      uint32_t payloadLength = 0;
+      if (element.present) {
+        bool useDefaultLength = readBool(bitParser);
+        if (useDefaultLength) {
+          payloadLength = elementConfig.extElementDefaultLength;
+        } else {
+          payloadLength = bitParser.read<8>();
+          if (payloadLength == 255) {
+            payloadLength += bitParser.read<16>() - 2;
+          }
+        }
+        if (payloadLength > 0 && elementConfig.extElementPayloadFrag) {
+          element.extElementStart = readBool(bitParser);
+          element.extElementStop = readBool(bitParser);
+        }
+      }
+      element.payloadBitOffset = bitParser.tell();
+      element.payloadBitLength = 8 * static_cast<size_t>(payloadLength);
+      bitParser.skip(element.payloadBitLength);
+    }
+
+    if (!bitParser.isValid()) {
+      return bitParser.result();
+    }
+    element.bitLength = bitParser.tell() - element.bitOffset;
+    layout.elements.push_back(element);
+  }
+  return bitParser.result();
+}
+
+SParseResult CMpeghFrameParser::parseAudioPreRoll(const uint8_t* frame, size_t frameSize,
+                                                  const SFrameLayout& layout,
+                                                  SAudioPreRoll& preRoll) const {
+  preRoll.present = false;
+  preRoll.config = SBitView{};
+  preRoll.applyCrossfade = false;
+  preRoll.accessUnits.clear();
+
+  const SFrameElement* preRollElement = nullptr;
+  for (const auto& element : layout.elements) {
+    const auto& elementConfig = m_configInfo->elementConfigs[element.elementIdx];
+    if (elementConfig.usacElementType == static_cast<uint32_t>(EUsacElementType::ID_USAC_EXT) &&
+        elementConfig.extElementType == ID_EXT_ELE_AUDIOPREROLL && element.present &&
+        element.payloadBitLength > 0) {
+      preRollElement = &element;
+      break;
+    }
+  }
+  if (preRollElement == nullptr) {
+    return SParseResult{};
+  }
+
+  SBitView payload;
+  payload.data = frame;
+  payload.bitOffset = preRollElement->payloadBitOffset;
+  payload.bitLength = preRollElement->payloadBitLength;
+  CBitReader bitParser(payload);
+  CSyntaxElementScope scope(bitParser, "AudioPreRoll");
+  if (payload.bitOffset + payload.bitLength > frameSize * 8) {
+    bitParser.setError(EParseError::endOfBuffer);
+    return bitParser.result();
+  }
+  if (!preRollElement->extElementStart || !preRollElement->extElementStop) {
+    bitParser.setError(EParseError::notSupported, "usacExtElementSegmentData");
+    return bitParser.result();
+  }
+
+  uint32_t configLength = bitParser.escapedValue<4, 4, 8>();
+  preRoll.config.data = frame;
+  preRoll.config.bitOffset = bitParser.tell();
+  preRoll.config.bitLength = configLength * size_t{8};
+  skipBits(bitParser, configLength * 8);
+  preRoll.applyCrossfade = readBool(bitParser);
+  // reserved
+  skipBits(bitParser, 1);
+  uint32_t numPreRollFrames = bitParser.escapedValue<2, 4, 0>();
+  for (uint32_t frameIdx = 0; frameIdx < numPreRollFrames && bitParser.isValid(); ++frameIdx) {
+    uint32_t auLength = bitParser.escapedValue<16, 16, 0>();
+    SBitView accessUnit;
+    accessUnit.data = frame;
+    accessUnit.bitOffset = bitParser.tell();
+    accessUnit.bitLength = auLength * size_t{8};
+    skipBits(bitParser, auLength * 8);
+    if (bitParser.isValid()) {
+      preRoll.accessUnits.push_back(accessUnit);
+    }
+  }
+  if (!bitParser.isValid()) {
+    preRoll.accessUnits.clear();
+    return bitParser.result();
+  }
+  preRoll.present = true;
+  return SParseResult{};
+}
+
+const CMpeghParser::SConfigInfo& CMpeghFrameParser::getConfigInfo() const noexcept {
+  return *m_configInfo;
+}
+}  // namespace audioparser
+}  // namespace mmt
@@ -82,6 +82,8 @@ amm-info@iis.fraunhofer.de
 
 // System includes
 #include <algorithm>
+#include <atomic>
+#include <new>
 
 // External includes
 #include "ilo/memory.h"
@@ -89,30 +91,255 @@ amm-info@iis.fraunhofer.de
 // Internal includes
 #include "mmtaudioparser/mpeghparser.h"
 #include "mpeghparserpimpl.h"
+#include "bitwriter.h"
+#include "parserutils.h"
 #include "logging.h"
 
 namespace mmt {
 namespace audioparser {
-CMpeghParser::CMpeghParser()
-    : m_mpeghPimpl(ilo::make_unique<CMpeghParser::CMpeghPimpl>()), m_validConfig(false) {}
+static SParseResult outOfMemoryResult() noexcept {
+  SParseResult result;
+  result.error = EParseError::outOfMemory;
+  result.syntaxElement = "mpegh3daConfig";
+  return result;
+}
+
+static void assertParseResult(const SParseResult& result) {
+  if (result.error == EParseError::outOfMemory) {
+    throw std::bad_alloc();
+  }
+  ILO_ASSERT(result.isOk(), "Parsing the config failed in %s at bit %zu: %s",
+             result.syntaxElement != nullptr ? result.syntaxElement : "mpegh3daConfig",
+             result.bitOffset, utils::errorDescription(result.error));
+}
+
+CMpeghParser::CMpeghParser() : CMpeghParser(SParserOptions{}) {}
+
+CMpeghParser::CMpeghParser(const SParserOptions& options)
+    : m_mpeghPimpl(ilo::make_unique<CMpeghParser::CMpeghPimpl>(options)),
+      m_validConfig(false),
+      m_configChanged(false),
+      m_publishSnapshots(options.publishSnapshots),
+      m_fragmentsPending(false),
+      m_configComplete(false) {}
 
 CMpeghParser::~CMpeghParser() = default;
 
 void CMpeghParser::addConfig(const ilo::ByteBuffer& config) {
+  addConfig(config.data(), config.size());
+}
+
+void CMpeghParser::addConfig(const uint8_t* config, size_t configSize) {
+  ILO_ASSERT(config != nullptr && configSize != 0,
+             "The Parameter config is not allowed to be empty");
+  assertParseResult(tryAddConfig(config, configSize));
+}
+
+SParseResult CMpeghParser::tryAddConfig(const uint8_t* config, size_t configSize) noexcept {
+  // MPEG-H streams repeat the same config at every random access point, so a byte-identical config
+  // keeps the already parsed state.
+  if (m_validConfig && m_mpeghPimpl->isSameConfig(config, configSize)) {
+    m_configChanged = false;
+    return SParseResult{};
+  }
+
+  invalidateConfig();
+  if (config == nullptr || configSize == 0) {
+    SParseResult result;
+    result.error = EParseError::emptyBuffer;
+    result.syntaxElement = "mpegh3daConfig";
+    return result;
+  }
+
+  try {
+    return finishConfig(m_mpeghPimpl->addConfig(config, configSize));
+  } catch (const std::bad_alloc&) {
+    invalidateConfig();
+    return outOfMemoryResult();
+  }
+}
+
+SParseResult CMpeghParser::tryAddConfig(const SBitView& config) noexcept {
+  if (m_validConfig && m_mpeghPimpl->isSameConfig(config)) {
+    m_configChanged = false;
+    return SParseResult{};
+  }
+  if (config.isByteAligned()) {
+    return tryAddConfig(config.data + config.bitOffset / 8, config.bitLength / 8);
+  }
+
+  try {
+    utils::CBitWriter writer(m_mpeghPimpl->m_alignedConfig);
+    writer.copyBits(config.data, config.bitOffset, config.bitLength);
+    writer.byteAlign();
+  } catch (const std::bad_alloc&) {
+    invalidateConfig();
+    return outOfMemoryResult();
+  }
+  return tryAddConfig(m_mpeghPimpl->m_alignedConfig.data(), m_mpeghPimpl->m_alignedConfig.size());
+}
+
+SParseResult CMpeghParser::addConfigFragment(const uint8_t* fragment, size_t fragmentSize,
+                                             bool lastFragment) noexcept {
+  try {
+    if (!m_fragmentsPending) {
+      invalidateConfig();
+      m_mpeghPimpl->beginConfig();
+      m_fragmentsPending = true;
+    }
+
+    SParseResult result = m_mpeghPimpl->addConfigFragment(fragment, fragmentSize, lastFragment);
+    if (!result.isOk() || lastFragment) {
+      m_fragmentsPending = false;
+      return finishConfig(result);
+    }
+    return result;
+  } catch (const std::bad_alloc&) {
+    invalidateConfig();
+    return outOfMemoryResult();
+  }
+}
+
+SParseResult CMpeghParser::scanConfig(const uint8_t* config, size_t configSize,
+                                      IMpeghConfigVisitor& visitor) noexcept {
+  if (config == nullptr || configSize == 0) {
+    SParseResult result;
+    result.error = EParseError::emptyBuffer;
+    result.syntaxElement = "mpegh3daConfig";
+    return result;
+  }
+  return CMpeghPimpl::scanConfig(config, configSize, visitor);
+}
+
+void CMpeghParser::invalidateConfig() noexcept {
   m_validConfig = false;
-  ILO_ASSERT(!config.empty(), "The Parameter config is not allowed to be empty");
-  m_mpeghPimpl->addConfig(config);
-  m_validConfig = true;
+  m_fragmentsPending = false;
+  m_configChanged = true;
+  m_configComplete = false;
+  m_deferredResult = SParseResult{};
+  if (!m_publishSnapshots) {
+    m_configInfo.reset();
+  }
+}
+
+// Compares the fields known from transport signalling descriptors
+static bool matchesSignalledFields(const CMpeghParser::SConfigInfo& preliminary,
+                                   const CMpeghParser::SConfigInfo& inBand) {
+  return preliminary.profileLevelIndicator == inBand.profileLevelIndicator &&
+         inBand.referenceLayout.speakerLayoutType == 0 &&
+         preliminary.referenceLayout.CICPIdx == inBand.referenceLayout.CICPIdx &&
+         preliminary.compatibleProfileLevels == inBand.compatibleProfileLevels;
+}
+
+SParseResult CMpeghParser::finishConfig(SParseResult result) {
+  // Readers only ever see complete snapshots, and the comparison with a preliminary config needs
+  // the complete config as well, so in these cases the whole config is parsed up front. A fully
+  // parsed config gets its info here as well, so the const accessors never have to build it.
+  if (result.isOk() && (m_publishSnapshots || m_preliminaryConfigInfo ||
+                        m_mpeghPimpl->m_parseMode == EParseMode::full)) {
+    result = m_mpeghPimpl->completeConfig();
+    if (result.isOk()) {
+      std::shared_ptr<const SConfigInfo> configInfo = buildConfigInfo();
+      if (m_preliminaryConfigInfo) {
+        m_configChanged = !matchesSignalledFields(*m_preliminaryConfigInfo, *configInfo);
+        m_preliminaryConfigInfo.reset();
+      }
+      if (m_publishSnapshots) {
+        std::atomic_store(&m_configInfo, configInfo);
+      } else {
+        m_configInfo = configInfo;
+      }
+      m_configComplete = true;
+    }
+  }
+  m_validConfig = result.isOk();
+  return result;
+}
+
+void CMpeghParser::setPreliminaryConfig(const SConfigInfo& configInfo) {
+  if (m_validConfig) {
+    return;
+  }
+
+  m_preliminaryConfigInfo = std::make_shared<const SConfigInfo>(configInfo);
+  if (m_publishSnapshots) {
+    std::atomic_store(&m_configInfo, m_preliminaryConfigInfo);
+  }
+}
+
+bool CMpeghParser::isPreliminaryConfig() const {
+  return !m_validConfig && m_preliminaryConfigInfo != nullptr;
 }
 
 bool CMpeghParser::isValidConfig() const {
   return m_validConfig;
 }
 
-CMpeghParser::SConfigInfo CMpeghParser::getConfigInfo() const {
+bool CMpeghParser::hasConfigChanged() const {
+  return m_configChanged;
+}
+
+CMpeghParser::SConfigHeader CMpeghParser::getConfigHeader() const {
+  ILO_ASSERT(m_validConfig, "No vaild config read, so info about the config possible");
+
+  SConfigHeader header{};
+  header.profileLevelIndicator = m_mpeghPimpl->m_config.mpegh3daProfileLevelIndicator;
+  header.samplingFrequencyIndex = m_mpeghPimpl->m_config.usacSamplingFrequencyIndex;
+  header.samplingFrequency = m_mpeghPimpl->m_config.usacSamplingFrequency;
+  header.coreSbrFrameLengthIndex = m_mpeghPimpl->m_config.coreSbrFrameLengthIndex;
+  header.cfg_reserved = m_mpeghPimpl->m_config.cfg_reserved;
+  header.receiverDelayCompensation = m_mpeghPimpl->m_config.receiverDelayCompensation;
+  header.referenceLayout.speakerLayoutType =
+      m_mpeghPimpl->m_config.referenceLayout.speakerLayoutType;
+  header.referenceLayout.CICPIdx = m_mpeghPimpl->m_config.referenceLayout.CICPspeakerLayoutIdx;
+  header.referenceLayout.CICPSpeakerIdx.assign(
+      m_mpeghPimpl->m_config.referenceLayout.CICPspeakerIdx.begin(),
+      m_mpeghPimpl->m_config.referenceLayout.CICPspeakerIdx.end());
+  header.referenceLayout.numSpeakers = m_mpeghPimpl->m_config.referenceLayout.numSpeakers;
+  return header;
+}
+
+const CMpeghParser::SConfigInfo& CMpeghParser::getConfigInfo() const {
+  return *getConfigSnapshot();
+}
+
+std::shared_ptr<const CMpeghParser::SConfigInfo> CMpeghParser::getConfigSnapshot() const {
+  if (m_publishSnapshots) {
+    // Only the published snapshot is touched here, so this is safe against concurrent addConfig().
+    std::shared_ptr<const SConfigInfo> snapshot = std::atomic_load(&m_configInfo);
+    ILO_ASSERT(snapshot != nullptr, "No vaild config published so far");
+    return snapshot;
+  }
+
+  if (!m_validConfig && m_preliminaryConfigInfo) {
+    return m_preliminaryConfigInfo;
+  }
   ILO_ASSERT(m_validConfig, "No vaild config read, so info about the config possible");
+  completeDeferredConfig();
+  return m_configInfo;
+}
 
-  SConfigInfo info{};
+void CMpeghParser::completeDeferredConfig() const {
+  if (!m_configComplete.load(std::memory_order_acquire)) {
+    std::lock_guard<std::mutex> lock(m_deferredMutex);
+    if (!m_configComplete.load(std::memory_order_relaxed)) {
+      m_deferredResult = m_mpeghPimpl->completeConfig();
+      if (m_deferredResult.isOk()) {
+        m_configInfo = buildConfigInfo();
+      } else {
+        // Drop the raw config as well, so that feeding it in again does not skip the parsing
+        m_mpeghPimpl->m_rawConfig.clear();
+        m_validConfig = false;
+      }
+      m_configComplete.store(true, std::memory_order_release);
+    }
+  }
+  assertParseResult(m_deferredResult);
+}
+
+std::shared_ptr<const CMpeghParser::SConfigInfo> CMpeghParser::buildConfigInfo() const {
+  auto configInfo = std::make_shared<SConfigInfo>();
+  SConfigInfo& info = *configInfo;
   info.profileLevelIndicator = m_mpeghPimpl->m_config.mpegh3daProfileLevelIndicator;
   info.samplingFrequencyIndex = m_mpeghPimpl->m_config.usacSamplingFrequencyIndex;
   info.samplingFrequency = m_mpeghPimpl->m_config.usacSamplingFrequency;
@@ -121,7 +348,9 @@ CMpeghParser::SConfigInfo CMpeghParser::getConfigInfo() const {
   info.receiverDelayCompensation = m_mpeghPimpl->m_config.receiverDelayCompensation;
   info.referenceLayout.speakerLayoutType = m_mpeghPimpl->m_config.referenceLayout.speakerLayoutType;
   info.referenceLayout.CICPIdx = m_mpeghPimpl->m_config.referenceLayout.CICPspeakerLayoutIdx;
-  info.referenceLayout.CICPSpeakerIdx = m_mpeghPimpl->m_config.referenceLayout.CICPspeakerIdx;
+  info.referenceLayout.CICPSpeakerIdx.assign(
+      m_mpeghPimpl->m_config.referenceLayout.CICPspeakerIdx.begin(),
+      m_mpeghPimpl->m_config.referenceLayout.CICPspeakerIdx.end());
   info.referenceLayout.numSpeakers = m_mpeghPimpl->m_config.referenceLayout.numSpeakers;
   info.numAudioChannels = m_mpeghPimpl->m_config.signals.numAudioChannels;
   info.numAudioObjects = m_mpeghPimpl->m_config.signals.numAudioObjects;
@@ -133,14 +362,16 @@ CMpeghParser::SConfigInfo CMpeghParser::getConfigInfo() const {
     SSignalGroup sigGrp;
 
     sigGrp.signalGroupType = signalGroup.signalGroupType;
-    sigGrp.metaDataElementIds = signalGroup.metaDataElementIds;
+    sigGrp.metaDataElementIds.assign(signalGroup.metaDataElementIds.begin(),
+                                     signalGroup.metaDataElementIds.end());
     sigGrp.numSignals = signalGroup.bsNumberOfSignals + 1;
 
     if (signalGroup.differsFromReferenceLayout) {
       SSpeakerConfig3d audioChannelLayout;
       audioChannelLayout.numSpeakers = signalGroup.audioChannelLayout.numSpeakers;
       audioChannelLayout.CICPIdx = signalGroup.audioChannelLayout.CICPspeakerLayoutIdx;
-      audioChannelLayout.CICPSpeakerIdx = signalGroup.audioChannelLayout.CICPspeakerIdx;
+      const auto& CICPspeakerIdx = signalGroup.audioChannelLayout.CICPspeakerIdx;
+      audioChannelLayout.CICPSpeakerIdx.assign(CICPspeakerIdx.begin(), CICPspeakerIdx.end());
       audioChannelLayout.speakerLayoutType = signalGroup.audioChannelLayout.speakerLayoutType;
       sigGrp.audioChannelLayout = audioChannelLayout;
     } else {
@@ -150,44 +381,39 @@ CMpeghParser::SConfigInfo CMpeghParser::getConfigInfo() const {
     info.signalGroups.push_back(sigGrp);
   }
 
-  info.elementConfigs.reserve(m_mpeghPimpl->m_config.decoderConfig.elementConfigs.size());
-  for (const auto& elementConfig : m_mpeghPimpl->m_config.decoderConfig.elementConfigs) {
+  const auto& decoderConfig = m_mpeghPimpl->m_config.decoderConfig;
+  info.elementLengthPresent = decoderConfig.elementLengthPresent;
+  info.elementConfigs.reserve(decoderConfig.elementConfigs.size());
+  for (const auto& elementConfig : decoderConfig.elementConfigs) {
     SElementConfig addElementConfig;
-    addElementConfig.usacElementType = elementConfig->usacElementType;
-    if (addElementConfig.usacElementType == 3) {
-      const auto* extElementConfig =
-          dynamic_cast<CMpeghParser::CMpeghPimpl::SExtElementConfig*>(elementConfig.get());
-      ILO_ASSERT(extElementConfig != nullptr,
-                 "usacElementType equals 3, but casting to SExtElementConfig returns a nullptr.");
-      addElementConfig.extElementType = static_cast<uint32_t>(extElementConfig->usacExtElementType);
+    addElementConfig.usacElementType = elementConfig.usacElementType;
+    if (elementConfig.usacElementType == static_cast<uint8_t>(EUsacElementType::ID_USAC_EXT)) {
+      const auto& extElementConfig = decoderConfig.extElementConfigs[elementConfig.configIdx];
+      addElementConfig.extElementType = extElementConfig.usacExtElementType;
+      addElementConfig.extElementDefaultLength = extElementConfig.usacExtElementDefaultLength;
+      addElementConfig.extElementPayloadFrag = extElementConfig.usacExtElementPayloadFrag;
     } else {
       addElementConfig.extElementType = 0;
     }
     info.elementConfigs.push_back(addElementConfig);
   }
   if (m_mpeghPimpl->m_config.usacConfigExtensionPresent) {
-    const auto& extensions = m_mpeghPimpl->m_config.configExtension.singleConfigExtensions;
-    info.configExtensions.reserve(extensions.size());
-    for (const auto& configExtension : extensions) {
+    const auto& configExtension = m_mpeghPimpl->m_config.configExtension;
+    info.configExtensions.reserve(configExtension.singleConfigExtensions.size());
+    for (const auto& singleConfigExtension : configExtension.singleConfigExtensions) {
       SConfigExtension addConfigExtension;
       addConfigExtension.usacConfigExtType =
-          static_cast<uint32_t>(configExtension->usacConfigExtType);
-      addConfigExtension.usacConfigExtLength = configExtension->usacConfigExtLength;
+          static_cast<uint32_t>(singleConfigExtension.usacConfigExtType);
+      addConfigExtension.usacConfigExtLength = singleConfigExtension.usacConfigExtLength;
       info.configExtensions.push_back(addConfigExtension);
-
-      if (configExtension->usacConfigExtType ==
-          CMpeghPimpl::EUsacConfigExtType::ID_CONFIG_EXT_COMPATIBLE_PROFILELVL_SET) {
-        const auto* configExt =
-            dynamic_cast<CMpeghParser::CMpeghPimpl::SCompatibleProfileLevelSet*>(
-                configExtension.get());
-        ILO_ASSERT(configExt != nullptr,
-                   "usacConfigExtType equals 7, but casting to SCompatibleProfileLevelSet returns "
-                   "a nullptr.");
-        info.compatibleProfileLevels = configExt->compatibleSetIndications;
-      }
+    }
+    if (!configExtension.compatibleProfileLevelSets.empty()) {
+      const auto& compatibleSet = configExtension.compatibleProfileLevelSets.back();
+      info.compatibleProfileLevels.assign(compatibleSet.compatibleSetIndications.begin(),
+                                          compatibleSet.compatibleSetIndications.end());
     }
   }
-  return info;
+  return configInfo;
 }
 
 static bool isLowComplexityProfile(uint8_t profileLevel) noexcept {
@@ -208,15 +434,14 @@ bool CMpeghParser::isLowComplexityWithBaselineCompatibleSignalling() const {
     return false;
   }
 
+  completeDeferredConfig();
+
   if (m_mpeghPimpl->m_config.usacConfigExtensionPresent) {
-    for (const auto& configExtension :
-         m_mpeghPimpl->m_config.configExtension.singleConfigExtensions) {
-      if (const auto* compatibleSet =
-              dynamic_cast<const CMpeghPimpl::SCompatibleProfileLevelSet*>(configExtension.get())) {
-        if (std::any_of(compatibleSet->compatibleSetIndications.begin(),
-                        compatibleSet->compatibleSetIndications.end(), isBaselineProfile)) {
-          return true;
-        }
+    for (const auto& compatibleSet :
+         m_mpeghPimpl->m_config.configExtension.compatibleProfileLevelSets) {
+      if (std::any_of(compatibleSet.compatibleSetIndications.begin(),
+                      compatibleSet.compatibleSetIndications.end(), isBaselineProfile)) {
+        return true;
       }
     }
   }
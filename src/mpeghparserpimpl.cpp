@@ -83,16 +83,15 @@ amm-info@iis.fraunhofer.de
 // System includes
 #include <array>
 #include <cmath>
-#include <map>
-
-// External includes
-#include "ilo/bitparser.h"
-#include "ilo/memory.h"
+#include <cstring>
+#include <utility>
 
 // Internal includes
+#include "mmtaudioparser/cicp.h"
 #include "common.h"
 #include "parserutils.h"
 #include "mpeghparserpimpl.h"
+#include "parserpolicies.h"
 #include "logging.h"
 
 namespace mmt {
@@ -111,110 +110,304 @@ static constexpr std::array<uint32_t, 0x21> samplingFrequencyIndex = {
     0,     0,     0,     0      /* 0x1c - 0x1f, 0x20 */
 };
 
-/* Table is defined in ISO/IEC 23003-3:2012, Table 67 */
-static constexpr std::array<int32_t, 0x80> CICPLoudspeakerIndexAzimuth = {
-    30,    -30,   0,     0,     110,   -110,  22,    -22,   /* 0x00 - 0x07 */
-    135,   -135,  180,   -9999, -9999, 90,    -90,   60,    /* 0x08 - 0x0f */
-    -60,   30,    -30,   0,     135,   -135,  180,   90,    /* 0x10 - 0x17 */
-    -90,   0,     45,    45,    -45,   0,     110,   -110,  /* 0x18 - 0x1f */
-    45,    -45,   45,    -45,   -45,   -1111, -1111, -1111, /* 0x20 - 0x27 */
-    -1111, 150,   -150,  -9999, -9999, -9999, -9999, -9999, /* 0x27 - 0x2f */
-    -9999, -9999, -9999, -9999, -9999, -9999, -9999, -9999, /* 0x30 - 0x37 */
-    -9999, -9999, -9999, -9999, -9999, -9999, -9999, -9999, /* 0x38 - 0x3f */
-    -9999, -9999, -9999, -9999, -9999, -9999, -9999, -9999, /* 0x40 - 0x47 */
-    -9999, -9999, -9999, -9999, -9999, -9999, -9999, -9999, /* 0x48 - 0x4f */
-    -9999, -9999, -9999, -9999, -9999, -9999, -9999, -9999, /* 0x50 - 0x57 */
-    -9999, -9999, -9999, -9999, -9999, -9999, -9999, -9999, /* 0x58 - 0x5f */
-    -9999, -9999, -9999, -9999, -9999, -9999, -9999, -9999, /* 0x60 - 0x67 */
-    -9999, -9999, -9999, -9999, -9999, -9999, -9999, -9999, /* 0x68 - 0x6f */
-    -9999, -9999, -9999, -9999, -9999, -9999, -9999, -9999, /* 0x70 - 0x77 */
-    -9999, -9999, -9999, -9999, -9999, -9999, -9999, -9999, /* 0x78 - 0x7f */
-};
+template <typename TPolicy>
+class CMpeghParser::CMpeghPimpl::CSyntaxParser {
+ public:
+  static SParseResult parseStages(CMpeghPimpl& pimpl, const uint8_t* config, size_t configSize,
+                                  bool completeData, EParseStage untilStage);
+  static SParseResult scan(const uint8_t* config, size_t configSize,
+                           IMpeghConfigVisitor& visitor);
+
+ private:
+  using Scope = typename TPolicy::Trace::Scope;
+  using Validation = typename TPolicy::Validation;
+  using Output = typename TPolicy::Output;
+
+  explicit CSyntaxParser(IMpeghConfigVisitor* visitor) noexcept : m_visitor(visitor) {}
+
+  // Stores a parsed structure in the config tree, unless the policy only visits the structures
+  template <typename TList, typename TItem>
+  static void store(TList& list, TItem&& item) {
+    if (Output::buildTree) {
+      list.push_back(std::forward<TItem>(item));
+    }
+  }
 
-static constexpr std::array<int32_t, 0x80> CICPLoudspeakerIndexElevation = {
-    0,     0,     0,     -15,   0,     0,     0,     0,     /* 0x00 - 0x07 */
-    0,     0,     0,     -9999, -9999, 0,     0,     0,     /* 0x08 - 0x0f */
-    0,     35,    35,    35,    35,    35,    35,    35,    /* 0x10 - 0x17 */
-    35,    90,    -15,   -15,   -15,   -15,   35,    35,    /* 0x18 - 0x1f */
-    35,    35,    0,     0,     -15,   0,     0,     0,     /* 0x20 - 0x27 */
-    0,     0,     0,     -9999, -9999, -9999, -9999, -9999, /* 0x27 - 0x2f */
-    -9999, -9999, -9999, -9999, -9999, -9999, -9999, -9999, /* 0x30 - 0x37 */
-    -9999, -9999, -9999, -9999, -9999, -9999, -9999, -9999, /* 0x38 - 0x3f */
-    -9999, -9999, -9999, -9999, -9999, -9999, -9999, -9999, /* 0x40 - 0x47 */
-    -9999, -9999, -9999, -9999, -9999, -9999, -9999, -9999, /* 0x48 - 0x4f */
-    -9999, -9999, -9999, -9999, -9999, -9999, -9999, -9999, /* 0x50 - 0x57 */
-    -9999, -9999, -9999, -9999, -9999, -9999, -9999, -9999, /* 0x58 - 0x5f */
-    -9999, -9999, -9999, -9999, -9999, -9999, -9999, -9999, /* 0x60 - 0x67 */
-    -9999, -9999, -9999, -9999, -9999, -9999, -9999, -9999, /* 0x68 - 0x6f */
-    -9999, -9999, -9999, -9999, -9999, -9999, -9999, -9999, /* 0x70 - 0x77 */
-    -9999, -9999, -9999, -9999, -9999, -9999, -9999, -9999, /* 0x78 - 0x7f */
-};
+  // Reports a parsed structure to the visitor, a visitor returning false stops the parsing
+  template <typename TCallback, typename TStructure>
+  void visit(CBitReader& bitParser, TCallback callback, const TStructure& structure) {
+    if (Output::visit && bitParser.isValid() && !(m_visitor->*callback)(structure)) {
+      bitParser.setError(EParseError::stopped, nullptr);
+    }
+  }
 
-static constexpr std::array<bool, 0x80> CICPLoudspeakerIndexIsLFE = {
-    false, false, false, true,  false, false, false, false, /* 0x00 - 0x07 */
-    false, false, false, false, false, false, false, false, /* 0x08 - 0x0f */
-    false, false, true,  false, false, false, false, false, /* 0x10 - 0x17 */
-    false, false, false, false, false, false, false, false, /* 0x18 - 0x1f */
-    false, false, false, false, true,  false, false, false, /* 0x20 - 0x27 */
-    false, false, false, false, false, false, false, false, /* 0x27 - 0x2f */
-    false, false, false, false, false, false, false, false, /* 0x30 - 0x37 */
-    false, false, false, false, false, false, false, false, /* 0x38 - 0x3f */
-    false, false, false, false, false, false, false, false, /* 0x40 - 0x47 */
-    false, false, false, false, false, false, false, false, /* 0x48 - 0x4f */
-    false, false, false, false, false, false, false, false, /* 0x50 - 0x57 */
-    false, false, false, false, false, false, false, false, /* 0x58 - 0x5f */
-    false, false, false, false, false, false, false, false, /* 0x60 - 0x67 */
-    false, false, false, false, false, false, false, false, /* 0x68 - 0x6f */
-    false, false, false, false, false, false, false, false, /* 0x70 - 0x77 */
-    false, false, false, false, false, false, false, false, /* 0x78 - 0x7f */
+  // Reports more than 7 bits following the config as error
+  static void checkTrailingData(CBitReader& bitParser);
+  void parseStage(CBitReader& bitParser, EParseStage stage, SMpegh3daConfig& mpegh3daConfig);
+  void mpegh3daConfigHeader(CBitReader& bitParser, SMpegh3daConfig& mpegh3daConfig);
+  void mpegh3daConfigDecoderConfig(CBitReader& bitParser, SMpegh3daConfig& mpegh3daConfig);
+  void mpegh3daConfigExtensionStage(CBitReader& bitParser, SMpegh3daConfig& mpegh3daConfig);
+  SSignals3d signals3d(CBitReader& bitParser);
+  SSpeakerConfig3d speakerConfig3d(CBitReader& bitParser,
+                                   IMpeghConfigVisitor::SSpeakerLayout layout);
+  SFlexibleSpeakerConfig mpegh3daFlexibleSpeakerConfig(CBitReader& bitParser,
+                                                       uint32_t numSpeakers);
+  SMpegh3daSpeakerDescription mpegh3daSpeakerDescription(CBitReader& bitParser,
+                                                         bool angularPrecision);
+  SDecoderConfig mpegh3daDecoderConfig(CBitReader& bitParser, uint8_t sbrRatioIndex,
+                                       uint32_t numChannels, SMpegh3daConfig& mpegh3daConfig);
+  SSingleChannelElementConfig mpegh3daSingleChannelElementConfig(CBitReader& bitParser,
+                                                                 uint8_t sbrRatioIndex);
+  SChannelPairElementConfig mpegh3daChannelPairElementConfig(CBitReader& bitParser,
+                                                             uint8_t sbrRatioIndex,
+                                                             uint32_t numChannels);
+  SLfeElementConfig mpegh3daLfeElementConfig();
+  SExtElementConfig mpegh3daExtElementConfig(CBitReader& bitParser,
+                                             SMpegh3daConfig& mpegh3daConfig);
+  S3dacoreConfig mpegh3daCoreConfig(CBitReader& bitParser);
+  SCompatibleProfileLevelSet mpegh3daCompatibleProfileLevelSet(CBitReader& bitParser);
+  SConfigExtension mpegh3daConfigExtension(CBitReader& bitParser);
+  SSbrConfig sbrConfig(CBitReader& bitParser);
+  SMpsConfig mps121Config(CBitReader& bitParser, uint8_t stereoConfigIdx);
+
+  // Receives the parsed structures if the policy visits them, nullptr otherwise
+  IMpeghConfigVisitor* m_visitor;
 };
 
-void CMpeghParser::CMpeghPimpl::addConfig(const ilo::ByteBuffer& config) {
-  ilo::CBitParser bitParser(config);
-  m_config = mpegh3daConfig(bitParser);
-  uint32_t bitsLeft = bitParser.nofBitsLeft();
-  ILO_ASSERT(bitsLeft < 8,
-             "%i number of bits left after reading the config. There are not more than 7 allowed",
-             bitsLeft);
+CMpeghParser::CMpeghPimpl::CMpeghPimpl(const SParserOptions& options)
+    : m_parseMode(options.parseMode),
+      m_parseStages(options.profile == EParserProfile::minimal
+                        ? &CSyntaxParser<SMinimalParserPolicy>::parseStages
+                        : &CSyntaxParser<SStrictParserPolicy>::parseStages),
+      m_arena(options.arena ? options.arena : std::make_shared<CConfigArena>()) {
+  bool claimed = m_arena->claim();
+  ILO_ASSERT(claimed, "The arena is already used by another parser");
 }
 
-CMpeghParser::CMpeghPimpl::SSbrConfig CMpeghParser::CMpeghPimpl::sbrConfig(
-    ilo::CBitParser& /*bitParser*/) {
-  ILO_ASSERT(false, "SBR-config not implemented until now");
-  return SSbrConfig{};
+CMpeghParser::CMpeghPimpl::~CMpeghPimpl() {
+  m_arena->unclaim();
 }
 
-CMpeghParser::CMpeghPimpl::SMpsConfig CMpeghParser::CMpeghPimpl::mps121Config(
-    ilo::CBitParser& /*bitParser*/, uint8_t /*stereoConfigIdx*/) {
-  ILO_ASSERT(false, "MPS212-config not implemented until now");
-  return SMpsConfig{};
+SParseResult CMpeghParser::CMpeghPimpl::addConfig(const uint8_t* config, size_t configSize) {
+  beginConfig();
+  CArenaScope arenaScope(*m_arena);
+  SParseResult result = parseStages(config, configSize, true, parseModeStage());
+  if (result.isOk()) {
+    m_rawConfig.assign(config, config + configSize);
+  }
+  return result;
 }
 
-CMpeghParser::CMpeghPimpl::SMpegh3daConfig CMpeghParser::CMpeghPimpl::mpegh3daConfig(
-    ilo::CBitParser& bitParser) {
+void CMpeghParser::CMpeghPimpl::beginConfig() {
+  m_rawConfig.clear();
+  m_stage = EParseStage::header;
+  m_stageBitPosition = 0;
+
+  // The previous config has to be released before its storage is reset
+  m_config = SMpegh3daConfig{};
+  m_arena->reset();
+  CArenaScope arenaScope(*m_arena);
+  m_config = SMpegh3daConfig{};
+}
+
+SParseResult CMpeghParser::CMpeghPimpl::addConfigFragment(const uint8_t* fragment,
+                                                          size_t fragmentSize, bool lastFragment) {
+  // The fragments are collected in m_rawConfig, which ends up holding the complete config
+  if (fragmentSize != 0) {
+    m_rawConfig.insert(m_rawConfig.end(), fragment, fragment + fragmentSize);
+  }
+  CArenaScope arenaScope(*m_arena);
+  SParseResult result =
+      parseStages(m_rawConfig.data(), m_rawConfig.size(), lastFragment, parseModeStage());
+  if (!result.isOk()) {
+    m_rawConfig.clear();
+  }
+  return result;
+}
+
+SParseResult CMpeghParser::CMpeghPimpl::completeConfig() {
+  if (m_stage == EParseStage::done) {
+    return SParseResult{};
+  }
+
+  CArenaScope arenaScope(*m_arena);
+  return parseStages(m_rawConfig.data(), m_rawConfig.size(), true, EParseStage::done);
+}
+
+void CMpeghParser::CMpeghPimpl::releaseStage(EParseStage stage,
+                                             const CConfigArena::SMark& stageMark) {
+  switch (stage) {
+    case EParseStage::header:
+      m_config.referenceLayout = SSpeakerConfig3d{};
+      break;
+    case EParseStage::signals3d:
+      m_config.signals = SSignals3d{};
+      break;
+    case EParseStage::decoderConfig:
+      m_config.decoderConfig = SDecoderConfig{};
+      break;
+    case EParseStage::configExtension:
+      m_config.configExtension = SConfigExtension{};
+      break;
+    case EParseStage::done:
+      break;
+  }
+  m_arena->rollback(stageMark);
+}
+
+SParseResult CMpeghParser::CMpeghPimpl::scanConfig(const uint8_t* config, size_t configSize,
+                                                   IMpeghConfigVisitor& visitor) {
+  return CSyntaxParser<SScanParserPolicy>::scan(config, configSize, visitor);
+}
+
+CMpeghParser::CMpeghPimpl::EParseStage CMpeghParser::CMpeghPimpl::parseModeStage() const {
+  return m_parseMode == EParseMode::headerOnly ? EParseStage::signals3d : EParseStage::done;
+}
+
+template <typename TPolicy>
+SParseResult CMpeghParser::CMpeghPimpl::CSyntaxParser<TPolicy>::parseStages(
+    CMpeghPimpl& pimpl, const uint8_t* config, size_t configSize, bool completeData,
+    EParseStage untilStage) {
+  CSyntaxParser parser(nullptr);
+  CBitReader bitParser(config, configSize);
+  bitParser.skip(pimpl.m_stageBitPosition);
+  while (pimpl.m_stage < untilStage) {
+    const CConfigArena::SMark stageMark = pimpl.m_arena->mark();
+    parser.parseStage(bitParser, pimpl.m_stage, pimpl.m_config);
+    if (!bitParser.isValid()) {
+      // A stage running out of data is parsed again from its start once more data is available,
+      // and a failed deferred stage again by the next accessor needing it
+      pimpl.releaseStage(pimpl.m_stage, stageMark);
+      if (!completeData && bitParser.result().error == EParseError::endOfBuffer) {
+        return SParseResult{};
+      }
+      return bitParser.result();
+    }
+    pimpl.m_stageBitPosition = bitParser.tell();
+    pimpl.m_stage = static_cast<EParseStage>(static_cast<uint8_t>(pimpl.m_stage) + 1);
+    pimpl.m_stageBitPositions[static_cast<size_t>(pimpl.m_stage)] = pimpl.m_stageBitPosition;
+  }
+
+  if (pimpl.m_stage == EParseStage::done && completeData) {
+    checkTrailingData(bitParser);
+  }
+  return bitParser.result();
+}
+
+template <typename TPolicy>
+SParseResult CMpeghParser::CMpeghPimpl::CSyntaxParser<TPolicy>::scan(
+    const uint8_t* config, size_t configSize, IMpeghConfigVisitor& visitor) {
+  // Only the values needed by later stages end up in the config, all lists stay empty
   SMpegh3daConfig mpegh3daConfig;
+  CSyntaxParser parser(&visitor);
+  CBitReader bitParser(config, configSize);
+  for (auto stage = EParseStage::header; stage < EParseStage::done && bitParser.isValid();
+       stage = static_cast<EParseStage>(static_cast<uint8_t>(stage) + 1)) {
+    parser.parseStage(bitParser, stage, mpegh3daConfig);
+  }
+  checkTrailingData(bitParser);
+  return bitParser.result();
+}
+
+template <typename TPolicy>
+void CMpeghParser::CMpeghPimpl::CSyntaxParser<TPolicy>::checkTrailingData(CBitReader& bitParser) {
+  // Not more than 7 bits are allowed to be left after reading the config
+  if (Validation::checkConsistency && bitParser.isValid() && bitParser.nofBitsLeft() >= 8) {
+    bitParser.setError(EParseError::trailingData, "mpegh3daConfig");
+  }
+}
+
+template <typename TPolicy>
+void CMpeghParser::CMpeghPimpl::CSyntaxParser<TPolicy>::parseStage(
+    CBitReader& bitParser, EParseStage stage, SMpegh3daConfig& mpegh3daConfig) {
+  switch (stage) {
+    case EParseStage::header:
+      mpegh3daConfigHeader(bitParser, mpegh3daConfig);
+      break;
+    case EParseStage::signals3d:
+      mpegh3daConfig.signals = signals3d(bitParser);
+      break;
+    case EParseStage::decoderConfig:
+      mpegh3daConfigDecoderConfig(bitParser, mpegh3daConfig);
+      break;
+    case EParseStage::configExtension:
+      mpegh3daConfigExtensionStage(bitParser, mpegh3daConfig);
+      break;
+    case EParseStage::done:
+      break;
+  }
+}
+
+bool CMpeghParser::CMpeghPimpl::isSameConfig(const uint8_t* config, size_t configSize) const {
+  return config != nullptr && configSize != 0 && configSize == m_rawConfig.size() &&
+         std::memcmp(config, m_rawConfig.data(), configSize) == 0;
+}
 
-  mpegh3daConfig.mpegh3daProfileLevelIndicator = bitParser.read<uint8_t>(8);
-  mpegh3daConfig.usacSamplingFrequencyIndex = bitParser.read<uint8_t>(5);
+bool CMpeghParser::CMpeghPimpl::isSameConfig(const SBitView& config) const {
+  return config.bitLength != 0 && isSameBits(config, m_rawConfig.data(), m_rawConfig.size());
+}
+
+template <typename TPolicy>
+CMpeghParser::CMpeghPimpl::SSbrConfig
+CMpeghParser::CMpeghPimpl::CSyntaxParser<TPolicy>::sbrConfig(CBitReader& bitParser) {
+  // SBR-config not implemented until now
+  bitParser.setError(EParseError::notSupported, "sbrConfig");
+  return SSbrConfig{};
+}
+
+template <typename TPolicy>
+CMpeghParser::CMpeghPimpl::SMpsConfig
+CMpeghParser::CMpeghPimpl::CSyntaxParser<TPolicy>::mps121Config(CBitReader& bitParser,
+                                                                uint8_t /*stereoConfigIdx*/) {
+  // MPS212-config not implemented until now
+  bitParser.setError(EParseError::notSupported, "mps212Config");
+  return SMpsConfig{};
+}
+
+template <typename TPolicy>
+void CMpeghParser::CMpeghPimpl::CSyntaxParser<TPolicy>::mpegh3daConfigHeader(
+    CBitReader& bitParser, SMpegh3daConfig& mpegh3daConfig) {
+  Scope scope(bitParser, "mpegh3daConfig");
+  mpegh3daConfig.mpegh3daProfileLevelIndicator = bitParser.read<8>();
+  mpegh3daConfig.usacSamplingFrequencyIndex = bitParser.read<5>();
   if (mpegh3daConfig.usacSamplingFrequencyIndex == 0x1f) {
-    mpegh3daConfig.usacSamplingFrequency = bitParser.read<uint32_t>(24);
+    mpegh3daConfig.usacSamplingFrequency = bitParser.read<24>();
   } else {
     mpegh3daConfig.usacSamplingFrequency =
         samplingFrequencyIndex.at(mpegh3daConfig.usacSamplingFrequencyIndex);
   }
 
-  mpegh3daConfig.coreSbrFrameLengthIndex = bitParser.read<uint8_t>(3);
-  mpegh3daConfig.cfg_reserved = readBool(bitParser);
-  mpegh3daConfig.receiverDelayCompensation = readBool(bitParser);
+  mpegh3daConfig.coreSbrFrameLengthIndex = bitParser.read<3>();
+  mpegh3daConfig.cfg_reserved = bitParser.readBool();
+  mpegh3daConfig.receiverDelayCompensation = bitParser.readBool();
+
+  if (mpegh3daConfig.coreSbrFrameLengthIndex > 4) {
+    bitParser.setError(EParseError::invalidValue, "coreSbrFrameLengthIndex");
+    return;
+  }
+
+  if (Output::visit) {
+    IMpeghConfigVisitor::SHeader header;
+    header.profileLevelIndicator = mpegh3daConfig.mpegh3daProfileLevelIndicator;
+    header.samplingFrequencyIndex = mpegh3daConfig.usacSamplingFrequencyIndex;
+    header.samplingFrequency = mpegh3daConfig.usacSamplingFrequency;
+    header.coreSbrFrameLengthIndex = mpegh3daConfig.coreSbrFrameLengthIndex;
+    header.receiverDelayCompensation = mpegh3daConfig.receiverDelayCompensation;
+    visit(bitParser, &IMpeghConfigVisitor::visitHeader, header);
+  }
+
+  mpegh3daConfig.referenceLayout = speakerConfig3d(bitParser, {});
+}
 
-  mpegh3daConfig.referenceLayout = speakerConfig3d(bitParser);
-  mpegh3daConfig.signals = signals3d(bitParser);
+template <typename TPolicy>
+void CMpeghParser::CMpeghPimpl::CSyntaxParser<TPolicy>::mpegh3daConfigDecoderConfig(
+    CBitReader& bitParser, SMpegh3daConfig& mpegh3daConfig) {
+  Scope scope(bitParser, "mpegh3daConfig");
   uint32_t numberChannels = mpegh3daConfig.signals.numAudioChannels +
                             mpegh3daConfig.signals.numAudioObjects +
                             mpegh3daConfig.signals.numHOATransportChannels +
                             mpegh3daConfig.signals.numSAOCTransportChannels;
   uint8_t sbrRatioIndex = 0;
-  ILO_ASSERT(mpegh3daConfig.coreSbrFrameLengthIndex <= 4, "SBRCoreFrameLengthIndex is invalid");
   switch (mpegh3daConfig.coreSbrFrameLengthIndex) {
     case 0:
     case 1:
@@ -230,37 +423,64 @@ CMpeghParser::CMpeghPimpl::SMpegh3daConfig CMpeghParser::CMpeghPimpl::mpegh3daCo
       sbrRatioIndex = 1;
       break;
     default:
-      ILO_ASSERT(false, "Invalid value for coreSbrFrameLengthIndex found.");
+      bitParser.setError(EParseError::invalidValue, "coreSbrFrameLengthIndex");
+      return;
   }
   mpegh3daConfig.decoderConfig =
       mpegh3daDecoderConfig(bitParser, sbrRatioIndex, numberChannels, mpegh3daConfig);
+}
 
-  mpegh3daConfig.usacConfigExtensionPresent = readBool(bitParser);
+template <typename TPolicy>
+void CMpeghParser::CMpeghPimpl::CSyntaxParser<TPolicy>::mpegh3daConfigExtensionStage(
+    CBitReader& bitParser, SMpegh3daConfig& mpegh3daConfig) {
+  Scope scope(bitParser, "mpegh3daConfig");
+  mpegh3daConfig.usacConfigExtensionPresent = bitParser.readBool();
   if (mpegh3daConfig.usacConfigExtensionPresent) {
     mpegh3daConfig.configExtension = mpegh3daConfigExtension(bitParser);
   }
-
-  return mpegh3daConfig;
 }
 
-CMpeghParser::CMpeghPimpl::SSignals3d CMpeghParser::CMpeghPimpl::signals3d(
-    ilo::CBitParser& bitParser) {
+template <typename TPolicy>
+CMpeghParser::CMpeghPimpl::SSignals3d
+CMpeghParser::CMpeghPimpl::CSyntaxParser<TPolicy>::signals3d(CBitReader& bitParser) {
+  Scope scope(bitParser, "signals3d");
   SSignals3d signals;
   uint8_t currentMetaDataElementId = 0;
-  signals.signalGroups.resize(bitParser.read<uint8_t>(5) + 1u);
-  for (auto& signalGroup : signals.signalGroups) {
-    signalGroup.signalGroupType = bitParser.read<uint8_t>(3);
-    signalGroup.bsNumberOfSignals = escapedValueTo32Bit(bitParser, 5, 8, 16);
+  uint32_t numSignalGroups = bitParser.read<5>() + 1u;
+  if (Output::buildTree) {
+    signals.signalGroups.reserve(numSignalGroups);
+  }
+  for (uint32_t signalGroupIdx = 0; signalGroupIdx < numSignalGroups && bitParser.isValid();
+       signalGroupIdx++) {
+    SSignalGroup signalGroup;
+    signalGroup.bitRange.bitPosition = bitParser.tell();
+    signalGroup.signalGroupType = bitParser.read<3>();
+    signalGroup.bsNumberOfSignals = bitParser.escapedValue<5, 8, 16>();
+    if (signalGroup.signalGroupType >= 0x4) {
+      // Config is invalid. Not defined signalGroupType
+      bitParser.setError(EParseError::invalidValue, "signalGroupType");
+      break;
+    }
+    if (Output::visit) {
+      IMpeghConfigVisitor::SSignalGroup visitedGroup;
+      visitedGroup.signalGroupIdx = signalGroupIdx;
+      visitedGroup.signalGroupType = signalGroup.signalGroupType;
+      visitedGroup.numSignals = signalGroup.bsNumberOfSignals + 1;
+      visit(bitParser, &IMpeghConfigVisitor::visitSignalGroup, visitedGroup);
+    }
+
+    IMpeghConfigVisitor::SSpeakerLayout layout;
+    layout.signalGroupIdx = signalGroupIdx;
     // SignalGroupTypeChannels
     if (signalGroup.signalGroupType == 0x0) {
       signals.numAudioChannels += signalGroup.bsNumberOfSignals + 1;
-      signalGroup.differsFromReferenceLayout = readBool(bitParser);
+      signalGroup.differsFromReferenceLayout = bitParser.readBool();
       if (signalGroup.differsFromReferenceLayout) {
-        signalGroup.audioChannelLayout = speakerConfig3d(bitParser);
+        signalGroup.audioChannelLayout = speakerConfig3d(bitParser, layout);
       }
 
       for (uint32_t offset = 0; offset < signalGroup.bsNumberOfSignals + 1; offset++) {
-        signalGroup.metaDataElementIds.push_back(currentMetaDataElementId);
+        store(signalGroup.metaDataElementIds, currentMetaDataElementId);
         currentMetaDataElementId++;
       }
     }
@@ -269,120 +489,166 @@ CMpeghParser::CMpeghPimpl::SSignals3d CMpeghParser::CMpeghPimpl::signals3d(
       signals.numAudioObjects += signalGroup.bsNumberOfSignals + 1;
 
       for (uint32_t offset = 0; offset < signalGroup.bsNumberOfSignals + 1; offset++) {
-        signalGroup.metaDataElementIds.push_back(currentMetaDataElementId);
+        store(signalGroup.metaDataElementIds, currentMetaDataElementId);
         currentMetaDataElementId++;
       }
     }
     // SignalGroupTypeSAOC
     if (signalGroup.signalGroupType == 0x2) {
       signals.numSAOCTransportChannels += signalGroup.bsNumberOfSignals + 1;
-      signalGroup.saocDmxLayoutPresent = readBool(bitParser);
+      signalGroup.saocDmxLayoutPresent = bitParser.readBool();
       if (signalGroup.saocDmxLayoutPresent) {
-        signalGroup.saocDmxChannelLayout = speakerConfig3d(bitParser);
+        layout.isSaocDownmixLayout = true;
+        signalGroup.saocDmxChannelLayout = speakerConfig3d(bitParser, layout);
       }
     }
     // SignalGroupTypeHOA
     if (signalGroup.signalGroupType == 0x3) {
       signals.numHOATransportChannels += signalGroup.bsNumberOfSignals + 1;
 
-      signalGroup.metaDataElementIds.push_back(currentMetaDataElementId);
+      store(signalGroup.metaDataElementIds, currentMetaDataElementId);
       currentMetaDataElementId++;
     }
-
-    ILO_ASSERT(signalGroup.signalGroupType < 0x4, "Config is invalid. Not defined signalGroupType");
+    signalGroup.bitRange.bitLength = bitParser.tell() - signalGroup.bitRange.bitPosition;
+    store(signals.signalGroups, std::move(signalGroup));
   }
   return signals;
 }
 
-CMpeghParser::CMpeghPimpl::SSpeakerConfig3d CMpeghParser::CMpeghPimpl::speakerConfig3d(
-    ilo::CBitParser& bitParser) {
+template <typename TPolicy>
+CMpeghParser::CMpeghPimpl::SSpeakerConfig3d
+CMpeghParser::CMpeghPimpl::CSyntaxParser<TPolicy>::speakerConfig3d(
+    CBitReader& bitParser, IMpeghConfigVisitor::SSpeakerLayout layout) {
+  Scope scope(bitParser, "speakerConfig3d");
   SSpeakerConfig3d speakerConfig;
 
-  speakerConfig.speakerLayoutType = bitParser.read<uint8_t>(2);
+  speakerConfig.speakerLayoutType = bitParser.read<2>();
   if (speakerConfig.speakerLayoutType == 0) {
-    speakerConfig.CICPspeakerLayoutIdx = bitParser.read<uint8_t>(6);
-
-    // CICPspeakerLayoutIdx
-    const std::map<uint8_t, uint32_t> NUM_SPEAKERS{
-        {uint8_t(1), 1},   {uint8_t(2), 2},   {uint8_t(3), 3},   {uint8_t(4), 4},
-        {uint8_t(5), 5},   {uint8_t(6), 6},   {uint8_t(7), 8},   {uint8_t(8), 2},
-        {uint8_t(9), 3},   {uint8_t(10), 4},  {uint8_t(11), 6},  {uint8_t(12), 8},
-        {uint8_t(13), 24}, {uint8_t(14), 8},  {uint8_t(15), 12}, {uint8_t(16), 10},
-        {uint8_t(17), 12}, {uint8_t(18), 14}, {uint8_t(19), 12}, {uint8_t(20), 14}};
-
-    ILO_ASSERT(NUM_SPEAKERS.count(speakerConfig.CICPspeakerLayoutIdx) != 0,
-               "No valid cicp index found.");
-    speakerConfig.numSpeakers = NUM_SPEAKERS.at(speakerConfig.CICPspeakerLayoutIdx);
+    speakerConfig.CICPspeakerLayoutIdx = bitParser.read<6>();
+    speakerConfig.numSpeakers = cicp::layoutNumSpeakers(speakerConfig.CICPspeakerLayoutIdx);
+    if (speakerConfig.numSpeakers == 0) {
+      // No valid cicp index found
+      bitParser.setError(EParseError::invalidValue, "CICPspeakerLayoutIdx");
+      return speakerConfig;
+    }
   } else {
-    speakerConfig.numSpeakers = escapedValueTo32Bit(bitParser, 5, 8, 16) + 1;
-    if (speakerConfig.speakerLayoutType == 1) {
-      speakerConfig.CICPspeakerIdx.clear();
-      for (uint32_t i = 0; i < speakerConfig.numSpeakers; i++) {
-        speakerConfig.CICPspeakerIdx.push_back(bitParser.read<uint8_t>(7));
+    speakerConfig.numSpeakers = bitParser.escapedValue<5, 8, 16>() + 1;
+  }
+
+  layout.speakerLayoutType = speakerConfig.speakerLayoutType;
+  layout.CICPIdx = speakerConfig.CICPspeakerLayoutIdx;
+  layout.numSpeakers = speakerConfig.numSpeakers;
+  visit(bitParser, &IMpeghConfigVisitor::visitSpeakerLayout, layout);
+
+  if (speakerConfig.speakerLayoutType == 1) {
+    speakerConfig.CICPspeakerIdx.clear();
+    for (uint32_t i = 0; i < speakerConfig.numSpeakers && bitParser.isValid(); i++) {
+      uint8_t CICPspeakerIdx = bitParser.read<7>();
+      store(speakerConfig.CICPspeakerIdx, CICPspeakerIdx);
+      if (Output::visit) {
+        const cicp::SSpeakerGeometry geometry = cicp::speakerGeometry(CICPspeakerIdx);
+        IMpeghConfigVisitor::SSpeaker speaker;
+        speaker.speakerIdx = i;
+        speaker.isCICPspeakerIdx = true;
+        speaker.CICPspeakerIdx = CICPspeakerIdx;
+        speaker.azimuth = geometry.azimuth;
+        speaker.elevation = geometry.elevation;
+        speaker.isLFE = geometry.isLFE;
+        visit(bitParser, &IMpeghConfigVisitor::visitSpeaker, speaker);
       }
     }
-    if (speakerConfig.speakerLayoutType == 2) {
-      speakerConfig.flexibleSpeakerConfig =
-          mpegh3daFlexibleSpeakerConfig(bitParser, speakerConfig.numSpeakers);
-    }
+  }
+  if (speakerConfig.speakerLayoutType == 2) {
+    speakerConfig.flexibleSpeakerConfig =
+        mpegh3daFlexibleSpeakerConfig(bitParser, speakerConfig.numSpeakers);
   }
   return speakerConfig;
 }
 
+template <typename TPolicy>
 CMpeghParser::CMpeghPimpl::SFlexibleSpeakerConfig
-CMpeghParser::CMpeghPimpl::mpegh3daFlexibleSpeakerConfig(ilo::CBitParser& bitParser,
-                                                         uint32_t numSpeakers) {
+CMpeghParser::CMpeghPimpl::CSyntaxParser<TPolicy>::mpegh3daFlexibleSpeakerConfig(
+    CBitReader& bitParser, uint32_t numSpeakers) {
+  Scope scope(bitParser, "mpegh3daFlexibleSpeakerConfig");
   SFlexibleSpeakerConfig flexibleSpeakerConfig;
-  flexibleSpeakerConfig.angularPrecision = readBool(bitParser);
+  flexibleSpeakerConfig.angularPrecision = bitParser.readBool();
   flexibleSpeakerConfig.mpegh3daSpeakerDescription.clear();
   flexibleSpeakerConfig.alsoAddSymmetricPair.clear();
-  for (uint32_t i = 0; i < numSpeakers; i++) {
+  for (uint32_t i = 0; i < numSpeakers && bitParser.isValid(); i++) {
     SMpegh3daSpeakerDescription newSpeakerDescription =
         mpegh3daSpeakerDescription(bitParser, flexibleSpeakerConfig.angularPrecision);
-    flexibleSpeakerConfig.mpegh3daSpeakerDescription.push_back(newSpeakerDescription);
-    if (newSpeakerDescription.AzimuthAngle != 0 && newSpeakerDescription.AzimuthAngle != 180) {
-      bool tmp = readBool(bitParser);
-      flexibleSpeakerConfig.alsoAddSymmetricPair.push_back(tmp);
-      if (tmp) {
-        i++;
+    store(flexibleSpeakerConfig.mpegh3daSpeakerDescription, newSpeakerDescription);
+    bool alsoAddSymmetricPair = false;
+    // Screen-relative loudspeakers have no fixed azimuth and are never placed on the median plane
+    if (newSpeakerDescription.isScreenRelative ||
+        (newSpeakerDescription.AzimuthAngle != 0 && newSpeakerDescription.AzimuthAngle != 180)) {
+      alsoAddSymmetricPair = bitParser.readBool();
+      store(flexibleSpeakerConfig.alsoAddSymmetricPair, alsoAddSymmetricPair);
+    }
+
+    if (Output::visit) {
+      IMpeghConfigVisitor::SSpeaker speaker;
+      speaker.speakerIdx = i;
+      speaker.isCICPspeakerIdx = newSpeakerDescription.isCICPspeakerIdx;
+      speaker.CICPspeakerIdx = newSpeakerDescription.CICPspeakerIdx;
+      speaker.azimuth = newSpeakerDescription.AzimuthAngle;
+      speaker.elevation = newSpeakerDescription.ElevationAngle;
+      speaker.isLFE = newSpeakerDescription.isLFE;
+      visit(bitParser, &IMpeghConfigVisitor::visitSpeaker, speaker);
+      if (alsoAddSymmetricPair) {
+        // The mirrored loudspeaker has no CICP SpeakerPosition index of its own
+        speaker.speakerIdx = i + 1;
+        speaker.isCICPspeakerIdx = false;
+        speaker.CICPspeakerIdx = 0;
+        speaker.azimuth = -speaker.azimuth;
+        visit(bitParser, &IMpeghConfigVisitor::visitSpeaker, speaker);
       }
     }
+    if (alsoAddSymmetricPair) {
+      i++;
+    }
   }
   return flexibleSpeakerConfig;
 }
 
+template <typename TPolicy>
 CMpeghParser::CMpeghPimpl::SMpegh3daSpeakerDescription
-CMpeghParser::CMpeghPimpl::mpegh3daSpeakerDescription(ilo::CBitParser& bitParser,
-                                                      bool angularPrecision) {
+CMpeghParser::CMpeghPimpl::CSyntaxParser<TPolicy>::mpegh3daSpeakerDescription(
+    CBitReader& bitParser, bool angularPrecision) {
+  Scope scope(bitParser, "mpegh3daSpeakerDescription");
   SMpegh3daSpeakerDescription mpegh3daSpeakerDescription;
-  mpegh3daSpeakerDescription.isCICPspeakerIdx = readBool(bitParser);
+  mpegh3daSpeakerDescription.isCICPspeakerIdx = bitParser.readBool();
   if (mpegh3daSpeakerDescription.isCICPspeakerIdx) {
-    mpegh3daSpeakerDescription.CICPspeakerIdx = bitParser.read<uint8_t>(7);
-    mpegh3daSpeakerDescription.AzimuthAngle =
-        CICPLoudspeakerIndexAzimuth.at(mpegh3daSpeakerDescription.CICPspeakerIdx);
-    mpegh3daSpeakerDescription.ElevationAngle =
-        CICPLoudspeakerIndexElevation.at(mpegh3daSpeakerDescription.CICPspeakerIdx);
-    mpegh3daSpeakerDescription.isLFE =
-        CICPLoudspeakerIndexIsLFE.at(mpegh3daSpeakerDescription.CICPspeakerIdx);
+    mpegh3daSpeakerDescription.CICPspeakerIdx = bitParser.read<7>();
+    const cicp::SSpeakerGeometry geometry =
+        cicp::speakerGeometry(mpegh3daSpeakerDescription.CICPspeakerIdx);
+    if (!geometry.isValid) {
+      bitParser.setError(EParseError::invalidValue, "CICPspeakerIdx");
+      return mpegh3daSpeakerDescription;
+    }
+    mpegh3daSpeakerDescription.AzimuthAngle = geometry.azimuth;
+    mpegh3daSpeakerDescription.ElevationAngle = geometry.elevation;
+    mpegh3daSpeakerDescription.isLFE = geometry.isLFE;
+    mpegh3daSpeakerDescription.isScreenRelative = geometry.isScreenRelative;
   } else {
-    mpegh3daSpeakerDescription.ElevationClass = bitParser.read<uint8_t>(2);
+    mpegh3daSpeakerDescription.ElevationClass = bitParser.read<2>();
     if (mpegh3daSpeakerDescription.ElevationClass == 3) {
       if (angularPrecision) {
-        mpegh3daSpeakerDescription.ElevationAngleIdx = bitParser.read<uint8_t>(7);
+        mpegh3daSpeakerDescription.ElevationAngleIdx = bitParser.read<7>();
       } else {
-        mpegh3daSpeakerDescription.ElevationAngleIdx = bitParser.read<uint8_t>(5);
+        mpegh3daSpeakerDescription.ElevationAngleIdx = bitParser.read<5>();
       }
       if (mpegh3daSpeakerDescription.ElevationAngleIdx != 0) {
-        mpegh3daSpeakerDescription.ElevationDirection = readBool(bitParser);
+        mpegh3daSpeakerDescription.ElevationDirection = bitParser.readBool();
       }
     } else {
       mpegh3daSpeakerDescription.ElevationAngleIdx = 0;
       mpegh3daSpeakerDescription.ElevationDirection = false;
     }
     if (angularPrecision) {
-      mpegh3daSpeakerDescription.AzimuthAngleIdx = bitParser.read<uint8_t>(8);
+      mpegh3daSpeakerDescription.AzimuthAngleIdx = bitParser.read<8>();
     } else {
-      mpegh3daSpeakerDescription.AzimuthAngleIdx = bitParser.read<uint8_t>(6);
+      mpegh3daSpeakerDescription.AzimuthAngleIdx = bitParser.read<6>();
     }
 
     if (angularPrecision) {
@@ -397,61 +663,85 @@ CMpeghParser::CMpeghPimpl::mpegh3daSpeakerDescription(ilo::CBitParser& bitParser
     }
     if (mpegh3daSpeakerDescription.AzimuthAngle != 0 &&
         (mpegh3daSpeakerDescription.AzimuthAngle != 180)) {
-      mpegh3daSpeakerDescription.AzimuthDirection = readBool(bitParser);
+      mpegh3daSpeakerDescription.AzimuthDirection = bitParser.readBool();
       if (mpegh3daSpeakerDescription.AzimuthDirection) {
         mpegh3daSpeakerDescription.AzimuthAngle *= -1;
       }
     }
-    mpegh3daSpeakerDescription.isLFE = readBool(bitParser);
+    mpegh3daSpeakerDescription.isLFE = bitParser.readBool();
   }
   return mpegh3daSpeakerDescription;
 }
 
-CMpeghParser::CMpeghPimpl::SDecoderConfig CMpeghParser::CMpeghPimpl::mpegh3daDecoderConfig(
-    ilo::CBitParser& bitParser, uint8_t sbrRatioIndex, uint32_t numChannels,
+template <typename TPolicy>
+CMpeghParser::CMpeghPimpl::SDecoderConfig
+CMpeghParser::CMpeghPimpl::CSyntaxParser<TPolicy>::mpegh3daDecoderConfig(
+    CBitReader& bitParser, uint8_t sbrRatioIndex, uint32_t numChannels,
     SMpegh3daConfig& mpegh3daConfig) {
+  Scope scope(bitParser, "mpegh3daDecoderConfig");
   SDecoderConfig decoderConfig;
-  auto numElements = escapedValueTo32Bit(bitParser, 4, 8, 16) + 1;
-  decoderConfig.elementLengthPresent = readBool(bitParser);
-  decoderConfig.elementConfigs.reserve(numElements);
-  for (uint32_t elemIdx = 0; elemIdx < numElements; elemIdx++) {
-    switch (static_cast<EUsacElementType>(bitParser.read<uint8_t>(2))) {
+  auto numElements = bitParser.escapedValue<4, 8, 16>() + 1;
+  decoderConfig.elementLengthPresent = bitParser.readBool();
+  if (Output::buildTree) {
+    decoderConfig.elementConfigs.reserve(numElements);
+  }
+  for (uint32_t elemIdx = 0; elemIdx < numElements && bitParser.isValid(); elemIdx++) {
+    SElementConfig elementConfig;
+    uint32_t usacExtElementType = 0;
+    elementConfig.bitRange.bitPosition = bitParser.tell();
+    elementConfig.usacElementType = bitParser.read<2>();
+    switch (static_cast<EUsacElementType>(elementConfig.usacElementType)) {
       case EUsacElementType::ID_USAC_SCE: {
-        SSingleChannelElementConfig singleElement =
-            mpegh3daSingleChannelElementConfig(bitParser, sbrRatioIndex);
-        decoderConfig.elementConfigs.push_back(
-            ilo::make_unique<SSingleChannelElementConfig>(singleElement));
+        elementConfig.configIdx =
+            static_cast<uint32_t>(decoderConfig.singleChannelElementConfigs.size());
+        store(decoderConfig.singleChannelElementConfigs,
+              mpegh3daSingleChannelElementConfig(bitParser, sbrRatioIndex));
         break;
       }
       case EUsacElementType::ID_USAC_CPE: {
-        SChannelPairElementConfig channelPairElement =
-            mpegh3daChannelPairElementConfig(bitParser, sbrRatioIndex, numChannels);
-        decoderConfig.elementConfigs.push_back(
-            ilo::make_unique<SChannelPairElementConfig>(channelPairElement));
+        elementConfig.configIdx =
+            static_cast<uint32_t>(decoderConfig.channelPairElementConfigs.size());
+        store(decoderConfig.channelPairElementConfigs,
+              mpegh3daChannelPairElementConfig(bitParser, sbrRatioIndex, numChannels));
         break;
       }
       case EUsacElementType::ID_USAC_LFE: {
-        SLfeElementConfig lfeElement = mpegh3daLfeElementConfig();
-        decoderConfig.elementConfigs.push_back(ilo::make_unique<SLfeElementConfig>(lfeElement));
+        elementConfig.configIdx = static_cast<uint32_t>(decoderConfig.lfeElementConfigs.size());
+        store(decoderConfig.lfeElementConfigs, mpegh3daLfeElementConfig());
         break;
       }
       case EUsacElementType::ID_USAC_EXT: {
-        SExtElementConfig extElement = mpegh3daExtElementConfig(bitParser, mpegh3daConfig);
-        decoderConfig.elementConfigs.push_back(ilo::make_unique<SExtElementConfig>(extElement));
+        elementConfig.configIdx = static_cast<uint32_t>(decoderConfig.extElementConfigs.size());
+        SExtElementConfig extElementConfig = mpegh3daExtElementConfig(bitParser, mpegh3daConfig);
+        usacExtElementType = extElementConfig.usacExtElementType;
+        store(decoderConfig.extElementConfigs, extElementConfig);
         break;
       }
       default:
-        ILO_ASSERT(false, "Invalid value for extension element type found.");
+        // Invalid value for extension element type found
+        bitParser.setError(EParseError::invalidValue, "usacElementType");
+        break;
+    }
+    elementConfig.bitRange.bitLength = bitParser.tell() - elementConfig.bitRange.bitPosition;
+    store(decoderConfig.elementConfigs, elementConfig);
+
+    if (Output::visit) {
+      IMpeghConfigVisitor::SElement element;
+      element.elementIdx = elemIdx;
+      element.usacElementType = elementConfig.usacElementType;
+      element.usacExtElementType = usacExtElementType;
+      visit(bitParser, &IMpeghConfigVisitor::visitElement, element);
     }
   }
   return decoderConfig;
 }
 
+template <typename TPolicy>
 CMpeghParser::CMpeghPimpl::SSingleChannelElementConfig
-CMpeghParser::CMpeghPimpl::mpegh3daSingleChannelElementConfig(ilo::CBitParser& bitParser,
-                                                              uint8_t sbrRatioIndex) {
+CMpeghParser::CMpeghPimpl::CSyntaxParser<TPolicy>::mpegh3daSingleChannelElementConfig(
+    CBitReader& bitParser, uint8_t sbrRatioIndex) {
+  Scope scope(bitParser, "mpegh3daSingleChannelElementConfig");
   SSingleChannelElementConfig singleChannelElementConfig;
-  singleChannelElementConfig.usacElementType = 0;
   singleChannelElementConfig.core = mpegh3daCoreConfig(bitParser);
   if (sbrRatioIndex > 0) {
     singleChannelElementConfig.sbrConfig = sbrConfig(bitParser);
@@ -461,22 +751,26 @@ CMpeghParser::CMpeghPimpl::mpegh3daSingleChannelElementConfig(ilo::CBitParser& b
   return singleChannelElementConfig;
 }
 
+template <typename TPolicy>
 CMpeghParser::CMpeghPimpl::SChannelPairElementConfig
-CMpeghParser::CMpeghPimpl::mpegh3daChannelPairElementConfig(ilo::CBitParser& bitParser,
-                                                            uint8_t sbrRatioIndex,
-                                                            uint32_t numChannels) {
+CMpeghParser::CMpeghPimpl::CSyntaxParser<TPolicy>::mpegh3daChannelPairElementConfig(
+    CBitReader& bitParser, uint8_t sbrRatioIndex, uint32_t numChannels) {
+  Scope scope(bitParser, "mpegh3daChannelPairElementConfig");
   SChannelPairElementConfig channelPairElementConfig;
-  channelPairElementConfig.usacElementType = 1;
-  ILO_ASSERT(numChannels > 1, "numberOfChannels must be at least 2");
+  if (numChannels < 2) {
+    // numberOfChannels must be at least 2
+    bitParser.setError(EParseError::invalidValue);
+    return channelPairElementConfig;
+  }
   channelPairElementConfig.core = mpegh3daCoreConfig(bitParser);
   if (channelPairElementConfig.core.enhancedNoiseFilling) {
-    channelPairElementConfig.igfIndependentTiling = readBool(bitParser);
+    channelPairElementConfig.igfIndependentTiling = bitParser.readBool();
   } else {
     channelPairElementConfig.igfIndependentTiling = false;
   }
   if (sbrRatioIndex > 0) {
     channelPairElementConfig.sbrConfig = sbrConfig(bitParser);
-    channelPairElementConfig.stereoConfigIdx = bitParser.read<uint8_t>(2);
+    channelPairElementConfig.stereoConfigIdx = bitParser.read<2>();
   } else {
     channelPairElementConfig.stereoConfigIdx = 0;
     channelPairElementConfig.sbrConfig = SSbrConfig{};
@@ -490,9 +784,9 @@ CMpeghParser::CMpeghPimpl::mpegh3daChannelPairElementConfig(ilo::CBitParser& bit
   }
 
   uint32_t nBits = static_cast<uint32_t>(std::floor(std::log2(numChannels - 1))) + 1;
-  channelPairElementConfig.qceIndex = bitParser.read<uint8_t>(2);
+  channelPairElementConfig.qceIndex = bitParser.read<2>();
   if (channelPairElementConfig.qceIndex > 0) {
-    channelPairElementConfig.shiftIndex0 = readBool(bitParser);
+    channelPairElementConfig.shiftIndex0 = bitParser.readBool();
     if (channelPairElementConfig.shiftIndex0) {
       channelPairElementConfig.shiftChannel0 = bitParser.read<uint32_t>(nBits);
     } else {
@@ -503,7 +797,7 @@ CMpeghParser::CMpeghPimpl::mpegh3daChannelPairElementConfig(ilo::CBitParser& bit
     channelPairElementConfig.shiftChannel0 = 0;
   }
 
-  channelPairElementConfig.shiftIndex1 = readBool(bitParser);
+  channelPairElementConfig.shiftIndex1 = bitParser.readBool();
   if (channelPairElementConfig.shiftIndex1) {
     channelPairElementConfig.shiftChannel1 = bitParser.read<uint32_t>(nBits);
   } else {
@@ -511,7 +805,7 @@ CMpeghParser::CMpeghPimpl::mpegh3daChannelPairElementConfig(ilo::CBitParser& bit
   }
 
   if (sbrRatioIndex == 0 && channelPairElementConfig.qceIndex == 0) {
-    channelPairElementConfig.lpdStereoIndex = readBool(bitParser);
+    channelPairElementConfig.lpdStereoIndex = bitParser.readBool();
   } else {
     channelPairElementConfig.lpdStereoIndex = false;
   }
@@ -519,10 +813,11 @@ CMpeghParser::CMpeghPimpl::mpegh3daChannelPairElementConfig(ilo::CBitParser& bit
   return channelPairElementConfig;
 }
 
-CMpeghParser::CMpeghPimpl::SLfeElementConfig CMpeghParser::CMpeghPimpl::mpegh3daLfeElementConfig() {
+template <typename TPolicy>
+CMpeghParser::CMpeghPimpl::SLfeElementConfig
+CMpeghParser::CMpeghPimpl::CSyntaxParser<TPolicy>::mpegh3daLfeElementConfig() {
   SLfeElementConfig lfeElement;
 
-  lfeElement.usacElementType = 2;
   lfeElement.core.tw_mdct = false;
   lfeElement.core.fullbandLpd = false;
   lfeElement.core.noiseFilling = false;
@@ -538,55 +833,67 @@ CMpeghParser::CMpeghPimpl::SLfeElementConfig CMpeghParser::CMpeghPimpl::mpegh3da
   return lfeElement;
 }
 
-CMpeghParser::CMpeghPimpl::SExtElementConfig CMpeghParser::CMpeghPimpl::mpegh3daExtElementConfig(
-    ilo::CBitParser& bitParser, SMpegh3daConfig& mpegh3daConfig) {
+template <typename TPolicy>
+CMpeghParser::CMpeghPimpl::SExtElementConfig
+CMpeghParser::CMpeghPimpl::CSyntaxParser<TPolicy>::mpegh3daExtElementConfig(
+    CBitReader& bitParser, SMpegh3daConfig& mpegh3daConfig) {
+  Scope scope(bitParser, "mpegh3daExtElementConfig");
   SExtElementConfig extElement{};
 
-  extElement.usacElementType = 3;
-  extElement.usacExtElementType = escapedValueTo32Bit(bitParser, 4, 8, 16);
-  extElement.usacExtElementConfigLength = escapedValueTo32Bit(bitParser, 4, 8, 16);
-  extElement.usacExtElementDefaultLengthPresent = readBool(bitParser);
+  extElement.usacExtElementType = bitParser.escapedValue<4, 8, 16>();
+  extElement.usacExtElementConfigLength = bitParser.escapedValue<4, 8, 16>();
+  extElement.usacExtElementDefaultLengthPresent = bitParser.readBool();
   if (extElement.usacExtElementDefaultLengthPresent) {
-    extElement.usacExtElementDefaultLength = escapedValueTo32Bit(bitParser, 8, 16, 0) + 1;
+    extElement.usacExtElementDefaultLength = bitParser.escapedValue<8, 16, 0>() + 1;
   } else {
     extElement.usacExtElementDefaultLength = 0;
   }
-  extElement.usacExtElementPayloadFrag = readBool(bitParser);
+  extElement.usacExtElementPayloadFrag = bitParser.readBool();
   switch (extElement.usacExtElementType) {
       // ID_EXT_ELE_FILL
     case 0:
-      ILO_ASSERT(extElement.usacExtElementConfigLength == 0,
-                 "ID_EXT_ELE_FILL is not allowed to have a Config Length");
+      if (Validation::checkConsistency && extElement.usacExtElementConfigLength != 0) {
+        // ID_EXT_ELE_FILL is not allowed to have a Config Length
+        bitParser.setError(EParseError::invalidValue, "usacExtElementConfigLength");
+      }
       break;
       // ID_EXT_ELE_AUDIOPREROLL
     case 3:
       mpegh3daConfig.audioPreRollPresent = true;
-      ILO_ASSERT(extElement.usacExtElementConfigLength == 0,
-                 "ID_EXT_ELE_AUDIOPREROLL is not allowed to have a Config Length");
+      if (Validation::checkConsistency && extElement.usacExtElementConfigLength != 0) {
+        // ID_EXT_ELE_AUDIOPREROLL is not allowed to have a Config Length
+        bitParser.setError(EParseError::invalidValue, "usacExtElementConfigLength");
+      }
       break;
     default:
-      skipBits(bitParser, extElement.usacExtElementConfigLength * 8);
       break;
   }
+  // Without validation a misplaced config of ID_EXT_ELE_FILL or ID_EXT_ELE_AUDIOPREROLL is skipped
+  if (!Validation::checkConsistency || (extElement.usacExtElementType != 0 &&
+                                        extElement.usacExtElementType != 3)) {
+    bitParser.skip(extElement.usacExtElementConfigLength * 8);
+  }
 
   return extElement;
 }
 
-CMpeghParser::CMpeghPimpl::S3dacoreConfig CMpeghParser::CMpeghPimpl::mpegh3daCoreConfig(
-    ilo::CBitParser& bitParser) {
+template <typename TPolicy>
+CMpeghParser::CMpeghPimpl::S3dacoreConfig
+CMpeghParser::CMpeghPimpl::CSyntaxParser<TPolicy>::mpegh3daCoreConfig(CBitReader& bitParser) {
+  Scope scope(bitParser, "mpegh3daCoreConfig");
   S3dacoreConfig coreConfig;
 
-  coreConfig.tw_mdct = readBool(bitParser);
-  coreConfig.fullbandLpd = readBool(bitParser);
-  coreConfig.noiseFilling = readBool(bitParser);
-  coreConfig.enhancedNoiseFilling = readBool(bitParser);
+  coreConfig.tw_mdct = bitParser.readBool();
+  coreConfig.fullbandLpd = bitParser.readBool();
+  coreConfig.noiseFilling = bitParser.readBool();
+  coreConfig.enhancedNoiseFilling = bitParser.readBool();
   if (coreConfig.enhancedNoiseFilling) {
-    coreConfig.igfUseEnf = readBool(bitParser);
-    coreConfig.igfUseHightRes = readBool(bitParser);
-    coreConfig.igfUseWhitening = readBool(bitParser);
-    coreConfig.igfAfterTnsSynth = readBool(bitParser);
-    coreConfig.igfStartIndex = bitParser.read<uint8_t>(5);
-    coreConfig.igfStopIndex = bitParser.read<uint8_t>(4);
+    coreConfig.igfUseEnf = bitParser.readBool();
+    coreConfig.igfUseHightRes = bitParser.readBool();
+    coreConfig.igfUseWhitening = bitParser.readBool();
+    coreConfig.igfAfterTnsSynth = bitParser.readBool();
+    coreConfig.igfStartIndex = bitParser.read<5>();
+    coreConfig.igfStopIndex = bitParser.read<4>();
   } else {
     coreConfig.igfUseEnf = false;
     coreConfig.igfUseHightRes = false;
@@ -599,63 +906,80 @@ CMpeghParser::CMpeghPimpl::S3dacoreConfig CMpeghParser::CMpeghPimpl::mpegh3daCor
   return coreConfig;
 }
 
-std::unique_ptr<CMpeghParser::CMpeghPimpl::SCompatibleProfileLevelSet>
-CMpeghParser::CMpeghPimpl::mpegh3daCompatibleProfileLevelSet(ilo::CBitParser& bitParser,
-                                                             uint32_t configExtLength) {
+template <typename TPolicy>
+CMpeghParser::CMpeghPimpl::SCompatibleProfileLevelSet
+CMpeghParser::CMpeghPimpl::CSyntaxParser<TPolicy>::mpegh3daCompatibleProfileLevelSet(
+    CBitReader& bitParser) {
+  Scope scope(bitParser, "mpegh3daCompatibleProfileLevelSet");
   SCompatibleProfileLevelSet compProfLvlSet;
 
-  compProfLvlSet.usacConfigExtType = EUsacConfigExtType::ID_CONFIG_EXT_COMPATIBLE_PROFILELVL_SET;
-  compProfLvlSet.usacConfigExtLength = configExtLength;
-
-  auto numCompatibleSets = static_cast<uint8_t>(bitParser.read<uint8_t>(4) + 1U);
+  auto numCompatibleSets = static_cast<uint8_t>(bitParser.read<4>() + 1U);
 
   // reserved
-  bitParser.read<uint8_t>(4);
+  bitParser.read<4>();
 
   for (uint8_t i = 0; i < numCompatibleSets; i++) {
-    compProfLvlSet.compatibleSetIndications.push_back(bitParser.read<uint8_t>(8));
+    uint8_t compatibleSetIndication = bitParser.read<8>();
+    store(compProfLvlSet.compatibleSetIndications, compatibleSetIndication);
+    visit(bitParser, &IMpeghConfigVisitor::visitCompatibleProfileLevel, compatibleSetIndication);
   }
 
-  return ilo::make_unique<SCompatibleProfileLevelSet>(compProfLvlSet);
+  return compProfLvlSet;
 }
 
-CMpeghParser::CMpeghPimpl::SConfigExtension CMpeghParser::CMpeghPimpl::mpegh3daConfigExtension(
-    ilo::CBitParser& bitParser) {
+template <typename TPolicy>
+CMpeghParser::CMpeghPimpl::SConfigExtension
+CMpeghParser::CMpeghPimpl::CSyntaxParser<TPolicy>::mpegh3daConfigExtension(CBitReader& bitParser) {
+  Scope scope(bitParser, "mpegh3daConfigExtension");
   SConfigExtension configExtension;
-  auto numConfigExtensions = escapedValueTo32Bit(bitParser, 2, 4, 8) + 1;
-  configExtension.singleConfigExtensions.reserve(numConfigExtensions);
-  for (uint32_t i = 0; i < numConfigExtensions; i++) {
-    auto configExtType = static_cast<EUsacConfigExtType>(escapedValueTo32Bit(bitParser, 4, 8, 16));
-    uint32_t configExtLength = escapedValueTo32Bit(bitParser, 4, 8, 16);
+  auto numConfigExtensions = bitParser.escapedValue<2, 4, 8>() + 1;
+  if (Output::buildTree) {
+    configExtension.singleConfigExtensions.reserve(numConfigExtensions);
+  }
+  for (uint32_t i = 0; i < numConfigExtensions && bitParser.isValid(); i++) {
+    size_t entryBitPosition = bitParser.tell();
+    auto configExtType = static_cast<EUsacConfigExtType>(bitParser.escapedValue<4, 8, 16>());
+    uint32_t configExtLength = bitParser.escapedValue<4, 8, 16>();
 
     SSingleConfigExtension singleConfigExtension;
     singleConfigExtension.usacConfigExtType = configExtType;
     singleConfigExtension.usacConfigExtLength = configExtLength;
+    singleConfigExtension.bitRange.bitPosition = entryBitPosition;
+    singleConfigExtension.payloadBitPosition = bitParser.tell();
+    if (Output::visit) {
+      IMpeghConfigVisitor::SConfigExtension visitedExtension;
+      visitedExtension.usacConfigExtType = static_cast<uint32_t>(configExtType);
+      visitedExtension.usacConfigExtLength = configExtLength;
+      visit(bitParser, &IMpeghConfigVisitor::visitConfigExtension, visitedExtension);
+    }
 
     switch (configExtType) {
       case EUsacConfigExtType::ID_CONFIG_EXT_FILL: {
-        for (uint32_t j = 0; j < singleConfigExtension.usacConfigExtLength; j++) {
-          uint8_t val = bitParser.read<uint8_t>(8);
-          if (val != 0xA5) {
+        if (!Validation::checkConsistency) {
+          bitParser.skip(singleConfigExtension.usacConfigExtLength * 8);
+          break;
+        }
+        for (uint32_t j = 0; j < singleConfigExtension.usacConfigExtLength && bitParser.isValid();
+             j++) {
+          uint8_t val = bitParser.read<8>();
+          if (bitParser.isValid() && val != 0xA5) {
             ILO_LOG_WARNING(
                 "Fill ExElement has wrong digits, the value should be 0xA5, but it is %02x", val);
           }
         }
-        configExtension.singleConfigExtensions.push_back(
-            ilo::make_unique<SSingleConfigExtension>(singleConfigExtension));
         break;
       }
       case EUsacConfigExtType::ID_CONFIG_EXT_COMPATIBLE_PROFILELVL_SET: {
-        configExtension.singleConfigExtensions.push_back(
-            mpegh3daCompatibleProfileLevelSet(bitParser, configExtLength));
+        store(configExtension.compatibleProfileLevelSets,
+              mpegh3daCompatibleProfileLevelSet(bitParser));
         break;
       }
       default:
-        skipBits(bitParser, singleConfigExtension.usacConfigExtLength * 8);
-        configExtension.singleConfigExtensions.push_back(
-            ilo::make_unique<SSingleConfigExtension>(singleConfigExtension));
+        bitParser.skip(singleConfigExtension.usacConfigExtLength * 8);
         break;
     }
+    singleConfigExtension.bitRange.bitLength = bitParser.tell() - entryBitPosition;
+    store(configExtension.singleConfigExtensions, singleConfigExtension);
   }
 
   return configExtension;
@@ -83,16 +83,20 @@ amm-info@iis.fraunhofer.de
 #pragma once
 
 // System includes
+#include <array>
 #include <memory>
-#include <vector>
 
 // External includes
-#include "ilo/bitparser.h"
 #include "ilo/common_types.h"
 
 // Internal includes
 #include "mmtaudioparser/version.h"
 #include "mmtaudioparser/mpeghparser.h"
+#include "mmtaudioparser/configarena.h"
+#include "mmtaudioparser/mpeghconfigvisitor.h"
+#include "arenaallocator.h"
+#include "bitreader.h"
+#include "common.h"
 
 namespace mmt {
 namespace audioparser {
@@ -110,25 +114,36 @@ class CMpeghParser::CMpeghPimpl {
     ID_CONFIG_EXT_COMPATIBLE_PROFILELVL_SET = 7,
   };
 
+  // Position of a syntax structure within the raw config, used to rewrite the config
+  struct SBitRange {
+    size_t bitPosition = 0;
+    size_t bitLength = 0;
+  };
+
   struct SSingleConfigExtension {
     EUsacConfigExtType usacConfigExtType;
     uint32_t usacConfigExtLength = 0;
-
-    virtual ~SSingleConfigExtension() noexcept = default;
+    // Range of the whole entry, and position of the payload following the type and length fields
+    SBitRange bitRange;
+    size_t payloadBitPosition = 0;
   };
 
-  struct SConfigExtension {
-    std::vector<std::unique_ptr<SSingleConfigExtension>> singleConfigExtensions;
+  struct SCompatibleProfileLevelSet {
+    utils::ArenaVector<uint8_t> compatibleSetIndications;
   };
 
-  struct SCompatibleProfileLevelSet : SSingleConfigExtension {
-    std::vector<uint8_t> compatibleSetIndications;
+  struct SConfigExtension {
+    utils::ArenaVector<SSingleConfigExtension> singleConfigExtensions;
+    // Payloads of all ID_CONFIG_EXT_COMPATIBLE_PROFILELVL_SET entries in bitstream order
+    utils::ArenaVector<SCompatibleProfileLevelSet> compatibleProfileLevelSets;
   };
 
   struct SElementConfig {
     uint8_t usacElementType = 0;
-
-    virtual ~SElementConfig() noexcept = default;
+    // Index into the element type specific config list of SDecoderConfig
+    uint32_t configIdx = 0;
+    // Range of the element config including the usacElementType field
+    SBitRange bitRange;
   };
 
   struct SSbrConfig {};
@@ -148,25 +163,24 @@ class CMpeghParser::CMpeghPimpl {
     uint8_t igfStopIndex = 0;
   };
 
-  struct SLfeElementConfig : SElementConfig {
+  struct SLfeElementConfig {
     S3dacoreConfig core;
   };
 
-  struct SExtElementConfig : SElementConfig {
+  struct SExtElementConfig {
     uint32_t usacExtElementType = 0;
     uint32_t usacExtElementConfigLength = 0;
     bool usacExtElementDefaultLengthPresent = false;
     uint32_t usacExtElementDefaultLength = 0;
     bool usacExtElementPayloadFrag = false;
-    // if also extensionElementConfigs get parsed, add a virtual struct here
   };
 
-  struct SSingleChannelElementConfig : SElementConfig {
+  struct SSingleChannelElementConfig {
     S3dacoreConfig core;
     SSbrConfig sbrConfig;
   };
 
-  struct SChannelPairElementConfig : SElementConfig {
+  struct SChannelPairElementConfig {
     S3dacoreConfig core;
     bool igfIndependentTiling = false;
     SSbrConfig sbrConfig;
@@ -180,9 +194,15 @@ class CMpeghParser::CMpeghPimpl {
     bool lpdStereoIndex = 0;
   };
 
+  // The element configs are stored contiguously per element type. elementConfigs keeps the
+  // bitstream order and references the type specific lists.
   struct SDecoderConfig {
     bool elementLengthPresent = false;
-    std::vector<std::unique_ptr<SElementConfig>> elementConfigs;
+    utils::ArenaVector<SElementConfig> elementConfigs;
+    utils::ArenaVector<SSingleChannelElementConfig> singleChannelElementConfigs;
+    utils::ArenaVector<SChannelPairElementConfig> channelPairElementConfigs;
+    utils::ArenaVector<SLfeElementConfig> lfeElementConfigs;
+    utils::ArenaVector<SExtElementConfig> extElementConfigs;
   };
 
   struct SMpegh3daSpeakerDescription {
@@ -196,21 +216,22 @@ class CMpeghParser::CMpeghPimpl {
     int32_t AzimuthAngle = 0;
     int32_t ElevationAngle = 0;
     bool isLFE = false;
+    bool isScreenRelative = false;
   };
 
   struct SFlexibleSpeakerConfig {
     bool angularPrecision = false;
     // NOTE: for AzimuthAngle != 0 or AzimuthAngle != 180, the following both vectors are NOT in
     // sync
-    std::vector<SMpegh3daSpeakerDescription> mpegh3daSpeakerDescription;
-    std::vector<bool> alsoAddSymmetricPair;
+    utils::ArenaVector<SMpegh3daSpeakerDescription> mpegh3daSpeakerDescription;
+    utils::ArenaVector<bool> alsoAddSymmetricPair;
   };
 
   struct SSpeakerConfig3d {
     uint8_t speakerLayoutType = 0;
     uint8_t CICPspeakerLayoutIdx = 0;
     uint32_t numSpeakers = 0;
-    std::vector<uint8_t> CICPspeakerIdx;
+    utils::ArenaVector<uint8_t> CICPspeakerIdx;
     SFlexibleSpeakerConfig flexibleSpeakerConfig;
   };
 
@@ -221,7 +242,8 @@ class CMpeghParser::CMpeghPimpl {
     SSpeakerConfig3d audioChannelLayout;
     bool saocDmxLayoutPresent = false;
     SSpeakerConfig3d saocDmxChannelLayout;
-    std::vector<uint8_t> metaDataElementIds;
+    utils::ArenaVector<uint8_t> metaDataElementIds;
+    SBitRange bitRange;
   };
 
   struct SSignals3d {
@@ -229,7 +251,7 @@ class CMpeghParser::CMpeghPimpl {
     uint32_t numAudioObjects = 0;
     uint32_t numSAOCTransportChannels = 0;
     uint32_t numHOATransportChannels = 0;
-    std::vector<SSignalGroup> signalGroups;
+    utils::ArenaVector<SSignalGroup> signalGroups;
   };
 
   struct SMpegh3daConfig {
@@ -244,37 +266,67 @@ class CMpeghParser::CMpeghPimpl {
     SSignals3d signals;
     SDecoderConfig decoderConfig;
     SConfigExtension configExtension;
-    std::vector<uint8_t> compatibleProfileLevels;
+    utils::ArenaVector<uint8_t> compatibleProfileLevels;
     bool audioPreRollPresent = false;
   };
 
-  void addConfig(const ilo::ByteBuffer& config);
-
-  SMpegh3daConfig mpegh3daConfig(ilo::CBitParser& bitParser);
-  SSignals3d signals3d(ilo::CBitParser& bitParser);
-  SSpeakerConfig3d speakerConfig3d(ilo::CBitParser& bitParser);
-  SFlexibleSpeakerConfig mpegh3daFlexibleSpeakerConfig(ilo::CBitParser& bitParser,
-                                                       uint32_t numSpeakers);
-  SMpegh3daSpeakerDescription mpegh3daSpeakerDescription(ilo::CBitParser& bitParser,
-                                                         bool angularPrecision);
-  SDecoderConfig mpegh3daDecoderConfig(ilo::CBitParser& bitParser, uint8_t sbrRatioIndex,
-                                       uint32_t numChannels, SMpegh3daConfig& mpegh3daConfig);
-  SSingleChannelElementConfig mpegh3daSingleChannelElementConfig(ilo::CBitParser& bitParser,
-                                                                 uint8_t sbrRatioIndex);
-  SChannelPairElementConfig mpegh3daChannelPairElementConfig(ilo::CBitParser& bitParser,
-                                                             uint8_t sbrRatioIndex,
-                                                             uint32_t numChannels);
-  SLfeElementConfig mpegh3daLfeElementConfig();
-  SExtElementConfig mpegh3daExtElementConfig(ilo::CBitParser& bitParser,
-                                             SMpegh3daConfig& mpegh3daConfig);
-  S3dacoreConfig mpegh3daCoreConfig(ilo::CBitParser& bitParser);
-  std::unique_ptr<SCompatibleProfileLevelSet> mpegh3daCompatibleProfileLevelSet(
-      ilo::CBitParser& bitParser, uint32_t configExtLength);
-  SConfigExtension mpegh3daConfigExtension(ilo::CBitParser& bitParser);
-  SSbrConfig sbrConfig(ilo::CBitParser& bitParser);
-  SMpsConfig mps121Config(ilo::CBitParser& bitParser, uint8_t stereoConfigIdx);
-
+  // Top-level parts of mpegh3daConfig() which are parsed as a whole. A config arriving in
+  // fragments is parsed stage by stage, a stage lacking data is parsed again on the next fragment.
+  enum class EParseStage : uint8_t { header, signals3d, decoderConfig, configExtension, done };
+
+  explicit CMpeghPimpl(const SParserOptions& options);
+  ~CMpeghPimpl();
+
+  CMpeghPimpl(const CMpeghPimpl&) = delete;
+  CMpeghPimpl& operator=(const CMpeghPimpl&) = delete;
+
+  SParseResult addConfig(const uint8_t* config, size_t configSize);
+  bool isSameConfig(const uint8_t* config, size_t configSize) const;
+  bool isSameConfig(const SBitView& config) const;
+  // Discards the current config, so fragments of a new one can be added
+  void beginConfig();
+  // Parses the stages completely contained in the fragments collected so far
+  SParseResult addConfigFragment(const uint8_t* fragment, size_t fragmentSize, bool lastFragment);
+  // Parses the structures following the header, if deferred by EParseMode::headerOnly
+  SParseResult completeConfig();
+  // Destroys the structures of a stage which failed to parse and releases their storage back to
+  // the given mark, so parsing the stage again does not grow the arena
+  void releaseStage(EParseStage stage, const CConfigArena::SMark& stageMark);
+
+  // Reports the structures of the config to the visitor without building the config tree
+  static SParseResult scanConfig(const uint8_t* config, size_t configSize,
+                                 IMpeghConfigVisitor& visitor);
+
+  EParseStage parseModeStage() const;
+  // Parses the stages up to untilStage, using the instantiation selected by the parser profile
+  SParseResult parseStages(const uint8_t* config, size_t configSize, bool completeData,
+                           EParseStage untilStage) {
+    return m_parseStages(*this, config, configSize, completeData, untilStage);
+  }
+
+  // The parse functions of mpegh3daConfig(), instantiated per policy of parserpolicies.h
+  template <typename TPolicy>
+  class CSyntaxParser;
+
+  using ParseStagesFunction = SParseResult (*)(CMpeghPimpl& pimpl, const uint8_t* config,
+                                               size_t configSize, bool completeData,
+                                               EParseStage untilStage);
+
+  EParseMode m_parseMode;
+  ParseStagesFunction m_parseStages;
+  // Backs all storage of m_config, so it has to outlive it
+  std::shared_ptr<CConfigArena> m_arena;
   SMpegh3daConfig m_config;
+  // Raw bytes of the last successfully parsed config, or the fragments collected so far
+  ilo::ByteBuffer m_rawConfig;
+  // Byte-aligned copy of a config given as bit range
+  ilo::ByteBuffer m_alignedConfig;
+  // Next stage to parse and its bit position within the config
+  EParseStage m_stage = EParseStage::header;
+  size_t m_stageBitPosition = 0;
+  // Start position of every stage within the raw config, the entry of EParseStage::done is the end
+  // of the config
+  std::array<size_t, static_cast<size_t>(EParseStage::done) + 1> m_stageBitPositions{};
 };
 }  // namespace audioparser
 }  // namespace mmt
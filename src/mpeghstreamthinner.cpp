@@ -0,0 +1,476 @@
+/*-----------------------------------------------------------------------------
+Software License for The Fraunhofer FDK MPEG-H Software
+
+Copyright (c) 2024 Fraunhofer-Gesellschaft zur Förderung der angewandten
+Forschung e.V. and Contributors
+All rights reserved.
+
+1. INTRODUCTION
+
+The "Fraunhofer FDK MPEG-H Software" is software that implements the ISO/MPEG
+MPEG-H 3D Audio standard for digital audio or related system features. Patent
+licenses for necessary patent claims for the Fraunhofer FDK MPEG-H Software
+(including those of Fraunhofer), for the use in commercial products and
+services, may be obtained from the respective patent owners individually and/or
+from Via LA (www.via-la.com).
+
+Fraunhofer supports the development of MPEG-H products and services by offering
+additional software, documentation, and technical advice. In addition, it
+operates the MPEG-H Trademark Program to ease interoperability testing of end-
+products. Please visit www.mpegh.com for more information.
+
+2. COPYRIGHT LICENSE
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted without payment of copyright license fees provided that you
+satisfy the following conditions:
+
+* You must retain the complete text of this software license in redistributions
+of the Fraunhofer FDK MPEG-H Software or your modifications thereto in source
+code form.
+
+* You must retain the complete text of this software license in the
+documentation and/or other materials provided with redistributions of
+the Fraunhofer FDK MPEG-H Software or your modifications thereto in binary form.
+You must make available free of charge copies of the complete source code of
+the Fraunhofer FDK MPEG-H Software and your modifications thereto to recipients
+of copies in binary form.
+
+* The name of Fraunhofer may not be used to endorse or promote products derived
+from the Fraunhofer FDK MPEG-H Software without prior written permission.
+
+* You may not charge copyright license fees for anyone to use, copy or
+distribute the Fraunhofer FDK MPEG-H Software or your modifications thereto.
+
+* Your modified versions of the Fraunhofer FDK MPEG-H Software must carry
+prominent notices stating that you changed the software and the date of any
+change. For modified versions of the Fraunhofer FDK MPEG-H Software, the term
+"Fraunhofer FDK MPEG-H Software" must be replaced by the term "Third-Party
+Modified Version of the Fraunhofer FDK MPEG-H Software".
+
+3. No PATENT LICENSE
+
+NO EXPRESS OR IMPLIED LICENSES TO ANY PATENT CLAIMS, including without
+limitation the patents of Fraunhofer, ARE GRANTED BY THIS SOFTWARE LICENSE.
+Fraunhofer provides no warranty of patent non-infringement with respect to this
+software. You may use this Fraunhofer FDK MPEG-H Software or modifications
+thereto only for purposes that are authorized by appropriate patent licenses.
+
+4. DISCLAIMER
+
+This Fraunhofer FDK MPEG-H Software is provided by Fraunhofer on behalf of the
+copyright holders and contributors "AS IS" and WITHOUT ANY EXPRESS OR IMPLIED
+WARRANTIES, including but not limited to the implied warranties of
+merchantability and fitness for a particular purpose. IN NO EVENT SHALL THE
+COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE for any direct, indirect,
+incidental, special, exemplary, or consequential damages, including but not
+limited to procurement of substitute goods or services; loss of use, data, or
+profits, or business interruption, however caused and on any theory of
+liability, whether in contract, strict liability, or tort (including
+negligence), arising in any way out of the use of this software, even if
+advised of the possibility of such damage.
+
+5. CONTACT INFORMATION
+
+Fraunhofer Institute for Integrated Circuits IIS
+Attention: Division Audio and Media Technologies - MPEG-H FDK
+Am Wolfsmantel 33
+91058 Erlangen, Germany
+www.iis.fraunhofer.de/amm
+amm-info@iis.fraunhofer.de
+-----------------------------------------------------------------------------*/
+// System includes
+#include <algorithm>
+
+// External includes
+#include "ilo/common_types.h"
+
+// Internal includes
+#include "mmtaudioparser/mpeghstreamthinner.h"
+#include "mpeghparserpimpl.h"
+#include "bitreader.h"
+#include "bitwriter.h"
+#include "common.h"
+#include "parserutils.h"
+#include "logging.h"
+
+namespace mmt {
+namespace audioparser {
+using namespace utils;
+
+namespace {
+// As defined in ISO/IEC 23008-3
+enum class EExtElementType : uint32_t {
+  ID_EXT_ELE_FILL = 0,
+  ID_EXT_ELE_MPEGS = 1,
+  ID_EXT_ELE_SAOC = 2,
+  ID_EXT_ELE_AUDIOPREROLL = 3,
+  ID_EXT_ELE_UNI_DRC = 4,
+  ID_EXT_ELE_OBJ_METADATA = 5,
+  ID_EXT_ELE_SAOC_3D = 6,
+  ID_EXT_ELE_HOA = 7,
+  ID_EXT_ELE_FMT_CNVRTR = 8,
+  ID_EXT_ELE_MCT = 9,
+  ID_EXT_ELE_TCC = 10,
+  ID_EXT_ELE_HOA_ENH_LAYER = 11,
+  ID_EXT_ELE_HREP = 12,
+  ID_EXT_ELE_ENHANCED_OBJ_METADATA = 13,
+};
+
+constexpr uint32_t NUM_SIGNAL_GROUP_TYPES = 4;
+// Largest usacExtElementPayloadLength representable with the escape value of 255
+constexpr size_t MAX_EXT_ELEMENT_PAYLOAD_LENGTH = 255 + 0xFFFF - 2;
+
+SParseResult makeError(EParseError error, const char* syntaxElement) {
+  SParseResult result;
+  result.error = error;
+  result.syntaxElement = syntaxElement;
+  return result;
+}
+
+// Writes the length fields of a present usacExtElement, see mpegh3daExtElement()
+void writeExtElementHeader(CBitWriter& writer, uint32_t payloadLength, bool payloadFrag) {
+  writer.writeBool(true);
+  // usacExtElementUseDefaultLength
+  writer.writeBool(false);
+  if (payloadLength < 255) {
+    writer.write(payloadLength, 8);
+  } else {
+    writer.write(255, 8);
+    writer.write(payloadLength - 253, 16);
+  }
+  if (payloadLength > 0 && payloadFrag) {
+    // usacExtElementStart and usacExtElementStop
+    writer.writeBool(true);
+    writer.writeBool(true);
+  }
+}
+}  // namespace
+
+CMpeghStreamThinner::CMpeghStreamThinner()
+    : m_selectionChanged(false), m_validConfig(false), m_thinning(false) {}
+
+CMpeghStreamThinner::~CMpeghStreamThinner() = default;
+
+void CMpeghStreamThinner::setRemovedSignalGroups(const std::vector<uint32_t>& signalGroupIdxs) {
+  m_removedSignalGroupIdxs = signalGroupIdxs;
+  m_selectionChanged = true;
+}
+
+SParseResult CMpeghStreamThinner::rewriteConfig(const uint8_t* config, size_t configSize,
+                                                ilo::ByteBuffer& thinnedConfig) {
+  if (!m_validConfig || m_selectionChanged ||
+      !m_parser.m_mpeghPimpl->isSameConfig(config, configSize)) {
+    m_validConfig = false;
+    m_selectionChanged = false;
+    SParseResult result = m_parser.tryAddConfig(config, configSize);
+    if (result.isOk()) {
+      result = selectElements();
+    }
+    if (result.isOk()) {
+      result = buildThinnedConfig();
+    }
+    if (!result.isOk()) {
+      thinnedConfig.clear();
+      return result;
+    }
+    m_frameParser.reset(new CMpeghFrameParser(m_parser.getConfigSnapshot()));
+    m_validConfig = true;
+  }
+  thinnedConfig = m_thinnedConfig;
+  return SParseResult{};
+}
+
+SParseResult CMpeghStreamThinner::rewriteFrame(const uint8_t* frame, size_t frameSize,
+                                               ilo::ByteBuffer& thinnedFrame) {
+  ILO_ASSERT(m_validConfig, "A valid config has to be rewritten before the frames");
+  if (!m_thinning) {
+    thinnedFrame.assign(frame, frame + frameSize);
+    return SParseResult{};
+  }
+  SBitView view;
+  view.data = frame;
+  view.bitLength = frameSize * 8;
+  return thinFrame(view, m_layout, thinnedFrame, false);
+}
+
+bool CMpeghStreamThinner::isValidConfig() const noexcept {
+  return m_validConfig;
+}
+
+SParseResult CMpeghStreamThinner::selectElements() {
+  const auto& config = m_parser.m_mpeghPimpl->m_config;
+  const auto& signalGroups = config.signals.signalGroups;
+  const auto& decoderConfig = config.decoderConfig;
+
+  m_removedSignalGroups.assign(signalGroups.size(), false);
+  for (uint32_t signalGroupIdx : m_removedSignalGroupIdxs) {
+    if (signalGroupIdx < signalGroups.size()) {
+      m_removedSignalGroups[signalGroupIdx] = true;
+    }
+  }
+  auto numRemoved = std::count(m_removedSignalGroups.begin(), m_removedSignalGroups.end(), true);
+  if (numRemoved == static_cast<std::ptrdiff_t>(signalGroups.size())) {
+    return makeError(EParseError::invalidValue, "signals3d");
+  }
+  m_thinning = numRemoved > 0;
+
+  // Extension elements bound to a signal group belong to the n-th signal group of their type
+  std::vector<uint32_t> signalGroupsOfType[NUM_SIGNAL_GROUP_TYPES];
+  for (uint32_t signalGroupIdx = 0; signalGroupIdx < signalGroups.size(); ++signalGroupIdx) {
+    signalGroupsOfType[signalGroups[signalGroupIdx].signalGroupType].push_back(signalGroupIdx);
+  }
+  uint32_t numBoundExtElements[NUM_SIGNAL_GROUP_TYPES] = {};
+
+  // The audio elements carry the signals of all signal groups in order
+  m_keptElements.assign(decoderConfig.elementConfigs.size(), true);
+  uint32_t signalGroupIdx = 0;
+  uint32_t signalIdx = 0;
+  for (size_t elementIdx = 0; elementIdx < decoderConfig.elementConfigs.size(); ++elementIdx) {
+    const auto& elementConfig = decoderConfig.elementConfigs[elementIdx];
+    auto elementType = static_cast<EUsacElementType>(elementConfig.usacElementType);
+    if (elementType == EUsacElementType::ID_USAC_EXT) {
+      const auto& extElementConfig = decoderConfig.extElementConfigs[elementConfig.configIdx];
+      uint32_t boundType = NUM_SIGNAL_GROUP_TYPES;
+      switch (static_cast<EExtElementType>(extElementConfig.usacExtElementType)) {
+        case EExtElementType::ID_EXT_ELE_OBJ_METADATA:
+          boundType = 1;
+          break;
+        case EExtElementType::ID_EXT_ELE_SAOC_3D:
+          boundType = 2;
+          break;
+        case EExtElementType::ID_EXT_ELE_HOA:
+          boundType = 3;
+          break;
+        case EExtElementType::ID_EXT_ELE_MPEGS:
+        case EExtElementType::ID_EXT_ELE_SAOC:
+        case EExtElementType::ID_EXT_ELE_MCT:
+        case EExtElementType::ID_EXT_ELE_TCC:
+        case EExtElementType::ID_EXT_ELE_HOA_ENH_LAYER:
+        case EExtElementType::ID_EXT_ELE_HREP:
+        case EExtElementType::ID_EXT_ELE_ENHANCED_OBJ_METADATA:
+          if (m_thinning) {
+            return makeError(EParseError::notSupported, "mpegh3daExtElementConfig");
+          }
+          break;
+        default:
+          break;
+      }
+      if (boundType < NUM_SIGNAL_GROUP_TYPES) {
+        uint32_t& numBound = numBoundExtElements[boundType];
+        if (numBound >= signalGroupsOfType[boundType].size()) {
+          return makeError(EParseError::invalidValue, "mpegh3daExtElementConfig");
+        }
+        m_keptElements[elementIdx] =
+            !m_removedSignalGroups[signalGroupsOfType[boundType][numBound]];
+        ++numBound;
+      }
+      continue;
+    }
+
+    uint32_t numSignals = elementType == EUsacElementType::ID_USAC_CPE ? 2 : 1;
+    bool removed = false;
+    for (uint32_t signal = 0; signal < numSignals; ++signal, ++signalIdx) {
+      while (signalGroupIdx < signalGroups.size() &&
+             signalIdx >= signalGroups[signalGroupIdx].bsNumberOfSignals + 1) {
+        signalIdx -= signalGroups[signalGroupIdx].bsNumberOfSignals + 1;
+        ++signalGroupIdx;
+      }
+      if (signalGroupIdx >= signalGroups.size()) {
+        return makeError(EParseError::invalidValue, "mpegh3daDecoderConfig");
+      }
+      // An element cannot be split between a removed and a kept signal group
+      if (signal > 0 && removed != m_removedSignalGroups[signalGroupIdx]) {
+        return makeError(EParseError::notSupported, "mpegh3daDecoderConfig");
+      }
+      removed = m_removedSignalGroups[signalGroupIdx];
+    }
+    m_keptElements[elementIdx] = !removed;
+
+    // The QCE channel shift refers to the channels by index
+    if (m_thinning && elementType == EUsacElementType::ID_USAC_CPE) {
+      const auto& cpeConfig = decoderConfig.channelPairElementConfigs[elementConfig.configIdx];
+      if (cpeConfig.shiftIndex0 || cpeConfig.shiftIndex1) {
+        return makeError(EParseError::notSupported, "mpegh3daChannelPairElementConfig");
+      }
+    }
+  }
+  return SParseResult{};
+}
+
+SParseResult CMpeghStreamThinner::buildThinnedConfig() {
+  const auto& pimpl = *m_parser.m_mpeghPimpl;
+  const uint8_t* raw = pimpl.m_rawConfig.data();
+  if (!m_thinning) {
+    m_thinnedConfig = pimpl.m_rawConfig;
+    return SParseResult{};
+  }
+
+  using EParseStage = CMpeghParser::CMpeghPimpl::EParseStage;
+  using EUsacConfigExtType = CMpeghParser::CMpeghPimpl::EUsacConfigExtType;
+  const auto& config = pimpl.m_config;
+  const auto& stagePositions = pimpl.m_stageBitPositions;
+  CBitWriter writer(m_thinnedConfig);
+
+  // The header is not affected by the signal groups
+  writer.copyBits(raw, 0, stagePositions[static_cast<size_t>(EParseStage::signals3d)]);
+
+  const auto& signalGroups = config.signals.signalGroups;
+  auto numKeptGroups = static_cast<uint32_t>(
+      std::count(m_removedSignalGroups.begin(), m_removedSignalGroups.end(), false));
+  writer.write(numKeptGroups - 1, 5);
+  for (size_t signalGroupIdx = 0; signalGroupIdx < signalGroups.size(); ++signalGroupIdx) {
+    if (!m_removedSignalGroups[signalGroupIdx]) {
+      const auto& bitRange = signalGroups[signalGroupIdx].bitRange;
+      writer.copyBits(raw, bitRange.bitPosition, bitRange.bitLength);
+    }
+  }
+
+  const auto& elementConfigs = config.decoderConfig.elementConfigs;
+  auto numKeptElements =
+      static_cast<uint32_t>(std::count(m_keptElements.begin(), m_keptElements.end(), true));
+  writer.writeEscapedValue(numKeptElements - 1, 4, 8, 16);
+  writer.writeBool(config.decoderConfig.elementLengthPresent);
+  for (size_t elementIdx = 0; elementIdx < elementConfigs.size(); ++elementIdx) {
+    if (m_keptElements[elementIdx]) {
+      const auto& bitRange = elementConfigs[elementIdx].bitRange;
+      writer.copyBits(raw, bitRange.bitPosition, bitRange.bitLength);
+    }
+  }
+
+  const auto& singleConfigExtensions = config.configExtension.singleConfigExtensions;
+  std::vector<size_t> keptExtensions;
+  for (size_t extIdx = 0; extIdx < singleConfigExtensions.size(); ++extIdx) {
+    switch (singleConfigExtensions[extIdx].usacConfigExtType) {
+      case EUsacConfigExtType::ID_CONFIG_EXT_AUDIOSCENE_INFO:
+        break;
+      case EUsacConfigExtType::ID_CONFIG_EXT_FILL:
+      case EUsacConfigExtType::ID_CONFIG_EXT_SIG_GROUP_INFO:
+      case EUsacConfigExtType::ID_CONFIG_EXT_COMPATIBLE_PROFILELVL_SET:
+        keptExtensions.push_back(extIdx);
+        break;
+      default:
+        // Any other extension, including future ones, may refer to the removed signals
+        return makeError(EParseError::notSupported, "mpegh3daConfigExtension");
+    }
+  }
+  writer.writeBool(!keptExtensions.empty());
+  if (!keptExtensions.empty()) {
+    writer.writeEscapedValue(static_cast<uint32_t>(keptExtensions.size() - 1), 2, 4, 8);
+  }
+  for (size_t extIdx : keptExtensions) {
+    const auto& singleConfigExtension = singleConfigExtensions[extIdx];
+    if (singleConfigExtension.usacConfigExtType !=
+        EUsacConfigExtType::ID_CONFIG_EXT_SIG_GROUP_INFO) {
+      writer.copyBits(raw, singleConfigExtension.bitRange.bitPosition,
+                      singleConfigExtension.bitRange.bitLength);
+      continue;
+    }
+
+    // SignalGroupInformation() holds groupPriority and fixedPosition for every signal group
+    uint32_t payloadLength = (numKeptGroups * 4 + 7) / 8;
+    if (singleConfigExtension.usacConfigExtLength * 8 < signalGroups.size() * 4) {
+      return makeError(EParseError::invalidValue, "SignalGroupInformation");
+    }
+    writer.writeEscapedValue(static_cast<uint32_t>(singleConfigExtension.usacConfigExtType), 4, 8,
+                             16);
+    writer.writeEscapedValue(payloadLength, 4, 8, 16);
+    for (size_t signalGroupIdx = 0; signalGroupIdx < signalGroups.size(); ++signalGroupIdx) {
+      if (!m_removedSignalGroups[signalGroupIdx]) {
+        writer.copyBits(raw, singleConfigExtension.payloadBitPosition + signalGroupIdx * 4, 4);
+      }
+    }
+    if (numKeptGroups % 2 != 0) {
+      writer.write(0, 4);
+    }
+  }
+  writer.byteAlign();
+  return SParseResult{};
+}
+
+SParseResult CMpeghStreamThinner::thinFrame(const SBitView& frame, SFrameLayout& layout,
+                                            ilo::ByteBuffer& thinnedFrame, bool preRollFrame) {
+  SParseResult result = m_frameParser->splitFrame(frame, layout);
+  if (!result.isOk()) {
+    thinnedFrame.clear();
+    return result;
+  }
+
+  const auto& elementConfigs = m_parser.getConfigInfo().elementConfigs;
+  CBitWriter writer(thinnedFrame);
+  writer.writeBool(layout.usacIndependencyFlag);
+  for (const auto& element : layout.elements) {
+    if (!m_keptElements[element.elementIdx]) {
+      continue;
+    }
+    const auto& elementConfig = elementConfigs[element.elementIdx];
+    bool preRoll = elementConfig.usacElementType ==
+                       static_cast<uint32_t>(EUsacElementType::ID_USAC_EXT) &&
+                   elementConfig.extElementType ==
+                       static_cast<uint32_t>(EExtElementType::ID_EXT_ELE_AUDIOPREROLL);
+    if (!preRoll || element.payloadBitLength == 0) {
+      writer.copyBits(frame.data, element.bitOffset, element.bitLength);
+      continue;
+    }
+
+    // The AudioPreRoll payload embeds the config and access units, which are thinned as well.
+    // Access units nested in the AudioPreRoll never get here, so the buffers are not shared with
+    // the nested calls.
+    if (preRollFrame) {
+      thinnedFrame.clear();
+      return makeError(EParseError::notSupported, "AudioPreRoll");
+    }
+    result = m_frameParser->parseAudioPreRoll(frame.data, (frame.bitOffset + frame.bitLength) / 8,
+                                              layout, m_preRoll);
+    if (result.isOk()) {
+      result = thinAudioPreRoll(m_preRoll, m_thinnedPayload);
+    }
+    if (result.isOk() && m_thinnedPayload.size() > MAX_EXT_ELEMENT_PAYLOAD_LENGTH) {
+      result = makeError(EParseError::invalidValue, "usacExtElementPayloadLength");
+    }
+    if (!result.isOk()) {
+      thinnedFrame.clear();
+      return result;
+    }
+    writeExtElementHeader(writer, static_cast<uint32_t>(m_thinnedPayload.size()),
+                          elementConfig.extElementPayloadFrag);
+    writer.copyBits(m_thinnedPayload.data(), 0, m_thinnedPayload.size() * 8);
+  }
+  writer.byteAlign();
+  return SParseResult{};
+}
+
+SParseResult CMpeghStreamThinner::thinAudioPreRoll(const SAudioPreRoll& preRoll,
+                                                   ilo::ByteBuffer& thinnedPayload) {
+  CBitWriter writer(thinnedPayload);
+
+  // Only the current config can be replaced by its thinned counterpart
+  if (preRoll.config.bitLength > 0) {
+    if (!m_parser.m_mpeghPimpl->isSameConfig(preRoll.config)) {
+      SParseResult result = makeError(EParseError::notSupported, "AudioPreRoll");
+      result.bitOffset = preRoll.config.bitOffset;
+      return result;
+    }
+    writer.writeEscapedValue(static_cast<uint32_t>(m_thinnedConfig.size()), 4, 4, 8);
+    writer.copyBits(m_thinnedConfig.data(), 0, m_thinnedConfig.size() * 8);
+  } else {
+    writer.writeEscapedValue(0, 4, 4, 8);
+  }
+  writer.writeBool(preRoll.applyCrossfade);
+  // reserved
+  writer.writeBool(false);
+  writer.writeEscapedValue(static_cast<uint32_t>(preRoll.accessUnits.size()), 2, 4, 0);
+
+  for (const auto& accessUnit : preRoll.accessUnits) {
+    SParseResult result = thinFrame(accessUnit, m_preRollLayout, m_thinnedAccessUnit, true);
+    if (!result.isOk()) {
+      return result;
+    }
+    writer.writeEscapedValue(static_cast<uint32_t>(m_thinnedAccessUnit.size()), 16, 16, 0);
+    writer.copyBits(m_thinnedAccessUnit.data(), 0, m_thinnedAccessUnit.size() * 8);
+  }
+  writer.byteAlign();
+  return SParseResult{};
+}
+}  // namespace audioparser
+}  // namespace mmt
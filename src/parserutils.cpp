@@ -80,51 +80,65 @@ www.iis.fraunhofer.de/amm
 amm-info@iis.fraunhofer.de
 -----------------------------------------------------------------------------*/
 // System includes
-#include <limits>
+#include <cstring>
 
 // External includes
 
 // Internal includes
 #include "parserutils.h"
-#include "logging.h"
 
 namespace mmt {
 namespace audioparser {
 namespace utils {
-void skipBits(ilo::CBitParser& bitParser, uint32_t numBits) {
-  if (numBits == 0) {
-    return;
-  }
-
-  uint32_t pos = bitParser.tell();
-  pos += numBits;
-  bitParser.seek(static_cast<int32_t>(pos), ilo::EPosType::begin);
+void skipBits(CBitReader& bitParser, uint32_t numBits) {
+  bitParser.skip(numBits);
 }
 
-bool readBool(ilo::CBitParser& bitParser) {
-  return (bitParser.read<uint8_t>(1) == 1);
+bool readBool(CBitReader& bitParser) {
+  return bitParser.readBool();
 }
 
-uint32_t escapedValueTo32Bit(ilo::CBitParser& bitParser, uint32_t nBits1, uint32_t nBits2,
-                             uint32_t nBits3) {
-  uint64_t escapedValue64 = escapedValueTo64Bit(bitParser, nBits1, nBits2, nBits3);
-  ILO_ASSERT(escapedValue64 <= std::numeric_limits<uint32_t>::max(),
-             "The escaped value does not fit into 32 bits.");
-  return static_cast<uint32_t>(escapedValue64);
+bool isSameBits(const SBitView& view, const uint8_t* data, size_t size) noexcept {
+  if (view.bitLength != size * 8) {
+    return false;
+  }
+  const uint8_t* source = view.data + view.bitOffset / 8;
+  uint32_t shift = static_cast<uint32_t>(view.bitOffset & 7u);
+  if (shift == 0) {
+    return size == 0 || std::memcmp(source, data, size) == 0;
+  }
+  // Every byte of the range is assembled from two neighbouring source bytes
+  for (size_t i = 0; i < size; ++i) {
+    auto value = static_cast<uint8_t>((source[i] << shift) | (source[i + 1] >> (8 - shift)));
+    if (value != data[i]) {
+      return false;
+    }
+  }
+  return true;
 }
 
-uint64_t escapedValueTo64Bit(ilo::CBitParser& bitParser, uint32_t nBits1, uint32_t nBits2,
-                             uint32_t nBits3) {
-  uint64_t value = bitParser.read<uint64_t>(nBits1);
-  if (value == (1u << nBits1) - 1u) {
-    uint64_t valueAdd = bitParser.read<uint32_t>(nBits2);
-    value += valueAdd;
-    if (valueAdd == (1u << nBits2) - 1u) {
-      valueAdd = bitParser.read<uint32_t>(nBits3);
-      value += valueAdd;
-    }
+const char* errorDescription(EParseError error) noexcept {
+  switch (error) {
+    case EParseError::ok:
+      return "no error";
+    case EParseError::emptyBuffer:
+      return "empty buffer";
+    case EParseError::endOfBuffer:
+      return "unexpected end of buffer";
+    case EParseError::invalidValue:
+      return "invalid value";
+    case EParseError::notSupported:
+      return "not supported";
+    case EParseError::trailingData:
+      return "trailing data";
+    case EParseError::stopped:
+      return "stopped by the visitor";
+    case EParseError::limitExceeded:
+      return "limit exceeded";
+    case EParseError::outOfMemory:
+      return "out of memory";
   }
-  return value;
+  return "unknown error";
 }
 }  // namespace utils
 }  // namespace audioparser
@@ -85,22 +85,20 @@ amm-info@iis.fraunhofer.de
 // System includes
 #include <cstdint>
 
-// External includes
-#include "ilo/bitparser.h"
-
 // Internal includes
 #include "mmtaudioparser/version.h"
+#include "bitreader.h"
 
 namespace mmt {
 namespace audioparser {
 namespace utils {
-void skipBits(ilo::CBitParser& bitParser, uint32_t numBits);
-bool readBool(ilo::CBitParser& bitParser);
+void skipBits(CBitReader& bitParser, uint32_t numBits);
+bool readBool(CBitReader& bitParser);
+
+// Whether the bit range holds exactly the given bytes, compared in place
+bool isSameBits(const SBitView& view, const uint8_t* data, size_t size) noexcept;
 
-uint32_t escapedValueTo32Bit(ilo::CBitParser& bitParser, uint32_t nBits1, uint32_t nBits2,
-                             uint32_t nBits3);
-uint64_t escapedValueTo64Bit(ilo::CBitParser& bitParser, uint32_t nBits1, uint32_t nBits2,
-                             uint32_t nBits3);
+const char* errorDescription(EParseError error) noexcept;
 }  // namespace utils
 }  // namespace audioparser
 }  // namespace mmt
@@ -0,0 +1,191 @@
+/*-----------------------------------------------------------------------------
+Software License for The Fraunhofer FDK MPEG-H Software
+
+Copyright (c) 2024 Fraunhofer-Gesellschaft zur Förderung der angewandten
+Forschung e.V. and Contributors
+All rights reserved.
+
+1. INTRODUCTION
+
+The "Fraunhofer FDK MPEG-H Software" is software that implements the ISO/MPEG
+MPEG-H 3D Audio standard for digital audio or related system features. Patent
+licenses for necessary patent claims for the Fraunhofer FDK MPEG-H Software
+(including those of Fraunhofer), for the use in commercial products and
+services, may be obtained from the respective patent owners individually and/or
+from Via LA (www.via-la.com).
+
+Fraunhofer supports the development of MPEG-H products and services by offering
+additional software, documentation, and technical advice. In addition, it
+operates the MPEG-H Trademark Program to ease interoperability testing of end-
+products. Please visit www.mpegh.com for more information.
+
+2. COPYRIGHT LICENSE
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted without payment of copyright license fees provided that you
+satisfy the following conditions:
+
+* You must retain the complete text of this software license in redistributions
+of the Fraunhofer FDK MPEG-H Software or your modifications thereto in source
+code form.
+
+* You must retain the complete text of this software license in the
+documentation and/or other materials provided with redistributions of
+the Fraunhofer FDK MPEG-H Software or your modifications thereto in binary form.
+You must make available free of charge copies of the complete source code of
+the Fraunhofer FDK MPEG-H Software and your modifications thereto to recipients
+of copies in binary form.
+
+* The name of Fraunhofer may not be used to endorse or promote products derived
+from the Fraunhofer FDK MPEG-H Software without prior written permission.
+
+* You may not charge copyright license fees for anyone to use, copy or
+distribute the Fraunhofer FDK MPEG-H Software or your modifications thereto.
+
+* Your modified versions of the Fraunhofer FDK MPEG-H Software must carry
+prominent notices stating that you changed the software and the date of any
+change. For modified versions of the Fraunhofer FDK MPEG-H Software, the term
+"Fraunhofer FDK MPEG-H Software" must be replaced by the term "Third-Party
+Modified Version of the Fraunhofer FDK MPEG-H Software".
+
+3. No PATENT LICENSE
+
+NO EXPRESS OR IMPLIED LICENSES TO ANY PATENT CLAIMS, including without
+limitation the patents of Fraunhofer, ARE GRANTED BY THIS SOFTWARE LICENSE.
+Fraunhofer provides no warranty of patent non-infringement with respect to this
+software. You may use this Fraunhofer FDK MPEG-H Software or modifications
+thereto only for purposes that are authorized by appropriate patent licenses.
+
+4. DISCLAIMER
+
+This Fraunhofer FDK MPEG-H Software is provided by Fraunhofer on behalf of the
+copyright holders and contributors "AS IS" and WITHOUT ANY EXPRESS OR IMPLIED
+WARRANTIES, including but not limited to the implied warranties of
+merchantability and fitness for a particular purpose. IN NO EVENT SHALL THE
+COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE for any direct, indirect,
+incidental, special, exemplary, or consequential damages, including but not
+limited to procurement of substitute goods or services; loss of use, data, or
+profits, or business interruption, however caused and on any theory of
+liability, whether in contract, strict liability, or tort (including
+negligence), arising in any way out of the use of this software, even if
+advised of the possibility of such damage.
+
+5. CONTACT INFORMATION
+
+Fraunhofer Institute for Integrated Circuits IIS
+Attention: Division Audio and Media Technologies - MPEG-H FDK
+Am Wolfsmantel 33
+91058 Erlangen, Germany
+www.iis.fraunhofer.de/amm
+amm-info@iis.fraunhofer.de
+-----------------------------------------------------------------------------*/
+// System includes
+#if defined(__AVX2__) || defined(__SSE2__) || defined(_M_X64) || \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#define MMTAUDIOPARSER_SYNCSEARCH_X86
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#define MMTAUDIOPARSER_SYNCSEARCH_NEON
+#endif
+
+// External includes
+
+// Internal includes
+#include "syncsearch.h"
+
+namespace mmt {
+namespace audioparser {
+namespace utils {
+// mpeghAudioStreamPacket() with MHASPacketType PACTYP_SYNC, MHASPacketLabel 0, MHASPacketLength 1
+// and the syncword 0xA5 as payload
+static const uint8_t SYNC_PATTERN[MHAS_SYNC_PACKET_SIZE] = {0xC0, 0x01, 0xA5};
+
+static size_t findSyncCandidateScalar(const uint8_t* data, size_t size, size_t offset) noexcept {
+  for (; offset + MHAS_SYNC_PACKET_SIZE <= size; ++offset) {
+    if (data[offset] == SYNC_PATTERN[0] && data[offset + 1] == SYNC_PATTERN[1] &&
+        data[offset + 2] == SYNC_PATTERN[2]) {
+      return offset;
+    }
+  }
+  return size;
+}
+
+#if defined(MMTAUDIOPARSER_SYNCSEARCH_X86)
+static inline size_t lowestSetBit(uint32_t mask) noexcept {
+#if defined(_MSC_VER)
+  unsigned long index;
+  _BitScanForward(&index, mask);
+  return index;
+#else
+  return static_cast<size_t>(__builtin_ctz(mask));
+#endif
+}
+#endif
+
+size_t findSyncCandidate(const uint8_t* data, size_t size) noexcept {
+  if (data == nullptr || size < MHAS_SYNC_PACKET_SIZE) {
+    return size;
+  }
+
+  // The vector loops compare all three pattern bytes at once by loading the block at the offsets
+  // 0, 1 and 2, so they stop MHAS_SYNC_PACKET_SIZE - 1 bytes before the end of the data.
+  size_t offset = 0;
+#if defined(MMTAUDIOPARSER_SYNCSEARCH_X86)
+#if defined(__AVX2__)
+  const __m256i first32 = _mm256_set1_epi8(static_cast<char>(SYNC_PATTERN[0]));
+  const __m256i second32 = _mm256_set1_epi8(static_cast<char>(SYNC_PATTERN[1]));
+  const __m256i third32 = _mm256_set1_epi8(static_cast<char>(SYNC_PATTERN[2]));
+  for (; offset + 32 + MHAS_SYNC_PACKET_SIZE - 1 <= size; offset += 32) {
+    const uint8_t* block = data + offset;
+    __m256i match = _mm256_and_si256(
+        _mm256_cmpeq_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(block)), first32),
+        _mm256_cmpeq_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(block + 1)),
+                          second32));
+    match = _mm256_and_si256(
+        match, _mm256_cmpeq_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(block + 2)),
+                                 third32));
+    uint32_t mask = static_cast<uint32_t>(_mm256_movemask_epi8(match));
+    if (mask != 0) {
+      return offset + lowestSetBit(mask);
+    }
+  }
+#endif
+  const __m128i first = _mm_set1_epi8(static_cast<char>(SYNC_PATTERN[0]));
+  const __m128i second = _mm_set1_epi8(static_cast<char>(SYNC_PATTERN[1]));
+  const __m128i third = _mm_set1_epi8(static_cast<char>(SYNC_PATTERN[2]));
+  for (; offset + 16 + MHAS_SYNC_PACKET_SIZE - 1 <= size; offset += 16) {
+    const uint8_t* block = data + offset;
+    __m128i match = _mm_and_si128(
+        _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(block)), first),
+        _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(block + 1)), second));
+    match = _mm_and_si128(
+        match, _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(block + 2)), third));
+    uint32_t mask = static_cast<uint32_t>(_mm_movemask_epi8(match));
+    if (mask != 0) {
+      return offset + lowestSetBit(mask);
+    }
+  }
+#elif defined(MMTAUDIOPARSER_SYNCSEARCH_NEON)
+  const uint8x16_t first = vdupq_n_u8(SYNC_PATTERN[0]);
+  const uint8x16_t second = vdupq_n_u8(SYNC_PATTERN[1]);
+  const uint8x16_t third = vdupq_n_u8(SYNC_PATTERN[2]);
+  for (; offset + 16 + MHAS_SYNC_PACKET_SIZE - 1 <= size; offset += 16) {
+    const uint8_t* block = data + offset;
+    uint8x16_t match = vandq_u8(vceqq_u8(vld1q_u8(block), first),
+                                vceqq_u8(vld1q_u8(block + 1), second));
+    match = vandq_u8(match, vceqq_u8(vld1q_u8(block + 2), third));
+    if (vmaxvq_u8(match) != 0) {
+      // NEON lacks a movemask, the position within the block is determined by the scalar loop
+      return findSyncCandidateScalar(data, offset + 16 + MHAS_SYNC_PACKET_SIZE - 1, offset);
+    }
+  }
+#endif
+  return findSyncCandidateScalar(data, size, offset);
+}
+}  // namespace utils
+}  // namespace audioparser
+}  // namespace mmt
@@ -0,0 +1,146 @@
+/*-----------------------------------------------------------------------------
+Software License for The Fraunhofer FDK MPEG-H Software
+
+Copyright (c) 2024 Fraunhofer-Gesellschaft zur Förderung der angewandten
+Forschung e.V. and Contributors
+All rights reserved.
+
+1. INTRODUCTION
+
+The "Fraunhofer FDK MPEG-H Software" is software that implements the ISO/MPEG
+MPEG-H 3D Audio standard for digital audio or related system features. Patent
+licenses for necessary patent claims for the Fraunhofer FDK MPEG-H Software
+(including those of Fraunhofer), for the use in commercial products and
+services, may be obtained from the respective patent owners individually and/or
+from Via LA (www.via-la.com).
+
+Fraunhofer supports the development of MPEG-H products and services by offering
+additional software, documentation, and technical advice. In addition, it
+operates the MPEG-H Trademark Program to ease interoperability testing of end-
+products. Please visit www.mpegh.com for more information.
+
+2. COPYRIGHT LICENSE
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted without payment of copyright license fees provided that you
+satisfy the following conditions:
+
+* You must retain the complete text of this software license in redistributions
+of the Fraunhofer FDK MPEG-H Software or your modifications thereto in source
+code form.
+
+* You must retain the complete text of this software license in the
+documentation and/or other materials provided with redistributions of
+the Fraunhofer FDK MPEG-H Software or your modifications thereto in binary form.
+You must make available free of charge copies of the complete source code of
+the Fraunhofer FDK MPEG-H Software and your modifications thereto to recipients
+of copies in binary form.
+
+* The name of Fraunhofer may not be used to endorse or promote products derived
+from the Fraunhofer FDK MPEG-H Software without prior written permission.
+
+* You may not charge copyright license fees for anyone to use, copy or
+distribute the Fraunhofer FDK MPEG-H Software or your modifications thereto.
+
+* Your modified versions of the Fraunhofer FDK MPEG-H Software must carry
+prominent notices stating that you changed the software and the date of any
+change. For modified versions of the Fraunhofer FDK MPEG-H Software, the term
+"Fraunhofer FDK MPEG-H Software" must be replaced by the term "Third-Party
+Modified Version of the Fraunhofer FDK MPEG-H Software".
+
+3. No PATENT LICENSE
+
+NO EXPRESS OR IMPLIED LICENSES TO ANY PATENT CLAIMS, including without
+limitation the patents of Fraunhofer, ARE GRANTED BY THIS SOFTWARE LICENSE.
+Fraunhofer provides no warranty of patent non-infringement with respect to this
+software. You may use this Fraunhofer FDK MPEG-H Software or modifications
+thereto only for purposes that are authorized by appropriate patent licenses.
+
+4. DISCLAIMER
+
+This Fraunhofer FDK MPEG-H Software is provided by Fraunhofer on behalf of the
+copyright holders and contributors "AS IS" and WITHOUT ANY EXPRESS OR IMPLIED
+WARRANTIES, including but not limited to the implied warranties of
+merchantability and fitness for a particular purpose. IN NO EVENT SHALL THE
+COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE for any direct, indirect,
+incidental, special, exemplary, or consequential damages, including but not
+limited to procurement of substitute goods or services; loss of use, data, or
+profits, or business interruption, however caused and on any theory of
+liability, whether in contract, strict liability, or tort (including
+negligence), arising in any way out of the use of this software, even if
+advised of the possibility of such damage.
+
+5. CONTACT INFORMATION
+
+Fraunhofer Institute for Integrated Circuits IIS
+Attention: Division Audio and Media Technologies - MPEG-H FDK
+Am Wolfsmantel 33
+91058 Erlangen, Germany
+www.iis.fraunhofer.de/amm
+amm-info@iis.fraunhofer.de
+-----------------------------------------------------------------------------*/
+// System includes
+#include <new>
+#include <stdexcept>
+
+// External includes
+#include "gtest/gtest.h"
+
+// Internal includes
+#include "mmtaudioparser/mmtaudioparser.h"
+
+using namespace mmt::audioparser;
+
+namespace {
+// Parser only implementing the throwing interface, failing with the configured exception
+class CThrowingParser : public IAudioParser {
+ public:
+  enum class EFailure { none, parseError, outOfMemory, logicError };
+
+  using IAudioParser::addConfig;
+
+  void addConfig(const ilo::ByteBuffer& config) override {
+    switch (failure) {
+      case EFailure::parseError:
+        throw std::runtime_error("invalid config");
+      case EFailure::outOfMemory:
+        throw std::bad_alloc();
+      case EFailure::logicError:
+        throw std::logic_error("precondition violated");
+      case EFailure::none:
+        break;
+    }
+    lastConfig = config;
+  }
+  bool isValidConfig() const override { return !lastConfig.empty(); }
+
+  EFailure failure = EFailure::none;
+  ilo::ByteBuffer lastConfig;
+};
+}  // namespace
+
+TEST(AudioParserTest, DefaultAddConfigCopiesTheMemory) {
+  const uint8_t config[] = {1, 2, 3};
+  CThrowingParser parser;
+  parser.addConfig(config, sizeof(config));
+  EXPECT_EQ(parser.lastConfig, ilo::ByteBuffer(config, config + sizeof(config)));
+}
+
+TEST(AudioParserTest, DefaultTryAddConfigMapsParseExceptions) {
+  const uint8_t config[] = {1, 2, 3};
+  CThrowingParser parser;
+  EXPECT_TRUE(parser.tryAddConfig(config, sizeof(config)).isOk());
+  EXPECT_EQ(parser.tryAddConfig(nullptr, 0).error, EParseError::emptyBuffer);
+
+  parser.failure = CThrowingParser::EFailure::parseError;
+  EXPECT_EQ(parser.tryAddConfig(config, sizeof(config)).error, EParseError::invalidValue);
+  parser.failure = CThrowingParser::EFailure::outOfMemory;
+  EXPECT_EQ(parser.tryAddConfig(config, sizeof(config)).error, EParseError::outOfMemory);
+}
+
+TEST(AudioParserTest, DefaultTryAddConfigPassesOnProgrammingErrors) {
+  const uint8_t config[] = {1, 2, 3};
+  CThrowingParser parser;
+  parser.failure = CThrowingParser::EFailure::logicError;
+  EXPECT_THROW(parser.tryAddConfig(config, sizeof(config)), std::logic_error);
+}
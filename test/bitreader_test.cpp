@@ -0,0 +1,174 @@
+/*-----------------------------------------------------------------------------
+Software License for The Fraunhofer FDK MPEG-H Software
+
+Copyright (c) 2024 Fraunhofer-Gesellschaft zur Förderung der angewandten
+Forschung e.V. and Contributors
+All rights reserved.
+
+1. INTRODUCTION
+
+The "Fraunhofer FDK MPEG-H Software" is software that implements the ISO/MPEG
+MPEG-H 3D Audio standard for digital audio or related system features. Patent
+licenses for necessary patent claims for the Fraunhofer FDK MPEG-H Software
+(including those of Fraunhofer), for the use in commercial products and
+services, may be obtained from the respective patent owners individually and/or
+from Via LA (www.via-la.com).
+
+Fraunhofer supports the development of MPEG-H products and services by offering
+additional software, documentation, and technical advice. In addition, it
+operates the MPEG-H Trademark Program to ease interoperability testing of end-
+products. Please visit www.mpegh.com for more information.
+
+2. COPYRIGHT LICENSE
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted without payment of copyright license fees provided that you
+satisfy the following conditions:
+
+* You must retain the complete text of this software license in redistributions
+of the Fraunhofer FDK MPEG-H Software or your modifications thereto in source
+code form.
+
+* You must retain the complete text of this software license in the
+documentation and/or other materials provided with redistributions of
+the Fraunhofer FDK MPEG-H Software or your modifications thereto in binary form.
+You must make available free of charge copies of the complete source code of
+the Fraunhofer FDK MPEG-H Software and your modifications thereto to recipients
+of copies in binary form.
+
+* The name of Fraunhofer may not be used to endorse or promote products derived
+from the Fraunhofer FDK MPEG-H Software without prior written permission.
+
+* You may not charge copyright license fees for anyone to use, copy or
+distribute the Fraunhofer FDK MPEG-H Software or your modifications thereto.
+
+* Your modified versions of the Fraunhofer FDK MPEG-H Software must carry
+prominent notices stating that you changed the software and the date of any
+change. For modified versions of the Fraunhofer FDK MPEG-H Software, the term
+"Fraunhofer FDK MPEG-H Software" must be replaced by the term "Third-Party
+Modified Version of the Fraunhofer FDK MPEG-H Software".
+
+3. No PATENT LICENSE
+
+NO EXPRESS OR IMPLIED LICENSES TO ANY PATENT CLAIMS, including without
+limitation the patents of Fraunhofer, ARE GRANTED BY THIS SOFTWARE LICENSE.
+Fraunhofer provides no warranty of patent non-infringement with respect to this
+software. You may use this Fraunhofer FDK MPEG-H Software or modifications
+thereto only for purposes that are authorized by appropriate patent licenses.
+
+4. DISCLAIMER
+
+This Fraunhofer FDK MPEG-H Software is provided by Fraunhofer on behalf of the
+copyright holders and contributors "AS IS" and WITHOUT ANY EXPRESS OR IMPLIED
+WARRANTIES, including but not limited to the implied warranties of
+merchantability and fitness for a particular purpose. IN NO EVENT SHALL THE
+COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE for any direct, indirect,
+incidental, special, exemplary, or consequential damages, including but not
+limited to procurement of substitute goods or services; loss of use, data, or
+profits, or business interruption, however caused and on any theory of
+liability, whether in contract, strict liability, or tort (including
+negligence), arising in any way out of the use of this software, even if
+advised of the possibility of such damage.
+
+5. CONTACT INFORMATION
+
+Fraunhofer Institute for Integrated Circuits IIS
+Attention: Division Audio and Media Technologies - MPEG-H FDK
+Am Wolfsmantel 33
+91058 Erlangen, Germany
+www.iis.fraunhofer.de/amm
+amm-info@iis.fraunhofer.de
+-----------------------------------------------------------------------------*/
+// System includes
+#include <cstdint>
+
+// External includes
+#include "gtest/gtest.h"
+
+// Internal includes
+#include "bitreader.h"
+#include "bitwriter.h"
+
+using namespace mmt::audioparser;
+using namespace mmt::audioparser::utils;
+
+TEST(BitReaderTest, ReadsAcrossCacheRefills) {
+  ilo::ByteBuffer data;
+  CBitWriter writer(data);
+  for (uint32_t i = 0; i < 20; ++i) {
+    writer.write(i, 5);
+    writer.write(0xABCDEFu, 24);
+  }
+  writer.byteAlign();
+
+  CBitReader reader(data.data(), data.size());
+  for (uint32_t i = 0; i < 20; ++i) {
+    EXPECT_EQ(reader.read<5>(), i);
+    EXPECT_EQ(reader.read<24>(), 0xABCDEFu);
+  }
+  EXPECT_TRUE(reader.isValid());
+  EXPECT_EQ(reader.tell(), 20u * 29u);
+}
+
+TEST(BitReaderTest, ReadsWideValues) {
+  const uint8_t data[] = {0x01, 0x23, 0x45, 0x67, 0x89, 0xAB, 0xCD, 0xEF, 0xFF};
+  CBitReader reader(data, sizeof(data));
+  reader.skip(4);
+  EXPECT_EQ(reader.read<64>(), 0x123456789ABCDEFFu);
+  EXPECT_EQ(reader.read<uint32_t>(4), 0xFu);
+  EXPECT_EQ(reader.nofBitsLeft(), 0u);
+  EXPECT_TRUE(reader.isValid());
+}
+
+TEST(BitReaderTest, ReadsEscapedValues) {
+  ilo::ByteBuffer data;
+  CBitWriter writer(data);
+  writer.writeEscapedValue(5, 3, 8, 8);
+  writer.writeEscapedValue(7 + 100, 3, 8, 8);
+  writer.writeEscapedValue(7 + 255 + 9, 3, 8, 8);
+  // A tail of zero bits ends the escape after the second field
+  writer.writeEscapedValue(3 + 15, 2, 4, 0);
+  writer.byteAlign();
+
+  CBitReader reader(data.data(), data.size());
+  EXPECT_EQ((reader.escapedValue<3, 8, 8>()), 5u);
+  EXPECT_EQ((reader.escapedValue<3, 8, 8>()), 107u);
+  EXPECT_EQ((reader.escapedValue<3, 8, 8>()), 271u);
+  EXPECT_EQ((reader.escapedValue<2, 4, 0>()), 18u);
+  EXPECT_TRUE(reader.isValid());
+}
+
+TEST(BitReaderTest, ReadsEscapedValuesBeyond32Bits) {
+  // escapedValue(2, 8, 32) with all fields at their maximum
+  const uint8_t data[] = {0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xC0};
+  CBitReader reader(data, sizeof(data));
+  EXPECT_EQ((reader.escapedValue<2, 8, 32>()), uint64_t{3} + 255u + 0xFFFFFFFFu);
+  EXPECT_TRUE(reader.isValid());
+}
+
+TEST(BitReaderTest, ReportsTheEndOfTheBuffer) {
+  const uint8_t data[] = {0xFF, 0x00};
+  CBitReader reader(data, sizeof(data));
+  {
+    CSyntaxElementScope scope(reader, "outer");
+    EXPECT_EQ(reader.read<12>(), 0xFF0u);
+    CSyntaxElementScope innerScope(reader, "inner");
+    EXPECT_EQ(reader.read<8>(), 0u);
+    // All following reads return zero
+    EXPECT_EQ(reader.read<1>(), 0u);
+  }
+  EXPECT_FALSE(reader.isValid());
+  EXPECT_EQ(reader.result().error, EParseError::endOfBuffer);
+  EXPECT_EQ(reader.result().bitOffset, 12u);
+  EXPECT_STREQ(reader.result().syntaxElement, "inner");
+}
+
+TEST(BitReaderTest, ReadsABitViewOnly) {
+  const uint8_t data[] = {0xF0, 0x0F};
+  SBitView view{data, 4, 8};
+  CBitReader reader(view);
+  EXPECT_EQ(reader.tell(), 4u);
+  EXPECT_EQ(reader.read<8>(), 0x00u);
+  EXPECT_EQ(reader.read<1>(), 0u);
+  EXPECT_EQ(reader.result().error, EParseError::endOfBuffer);
+}
@@ -0,0 +1,142 @@
+/*-----------------------------------------------------------------------------
+Software License for The Fraunhofer FDK MPEG-H Software
+
+Copyright (c) 2024 Fraunhofer-Gesellschaft zur Förderung der angewandten
+Forschung e.V. and Contributors
+All rights reserved.
+
+1. INTRODUCTION
+
+The "Fraunhofer FDK MPEG-H Software" is software that implements the ISO/MPEG
+MPEG-H 3D Audio standard for digital audio or related system features. Patent
+licenses for necessary patent claims for the Fraunhofer FDK MPEG-H Software
+(including those of Fraunhofer), for the use in commercial products and
+services, may be obtained from the respective patent owners individually and/or
+from Via LA (www.via-la.com).
+
+Fraunhofer supports the development of MPEG-H products and services by offering
+additional software, documentation, and technical advice. In addition, it
+operates the MPEG-H Trademark Program to ease interoperability testing of end-
+products. Please visit www.mpegh.com for more information.
+
+2. COPYRIGHT LICENSE
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted without payment of copyright license fees provided that you
+satisfy the following conditions:
+
+* You must retain the complete text of this software license in redistributions
+of the Fraunhofer FDK MPEG-H Software or your modifications thereto in source
+code form.
+
+* You must retain the complete text of this software license in the
+documentation and/or other materials provided with redistributions of
+the Fraunhofer FDK MPEG-H Software or your modifications thereto in binary form.
+You must make available free of charge copies of the complete source code of
+the Fraunhofer FDK MPEG-H Software and your modifications thereto to recipients
+of copies in binary form.
+
+* The name of Fraunhofer may not be used to endorse or promote products derived
+from the Fraunhofer FDK MPEG-H Software without prior written permission.
+
+* You may not charge copyright license fees for anyone to use, copy or
+distribute the Fraunhofer FDK MPEG-H Software or your modifications thereto.
+
+* Your modified versions of the Fraunhofer FDK MPEG-H Software must carry
+prominent notices stating that you changed the software and the date of any
+change. For modified versions of the Fraunhofer FDK MPEG-H Software, the term
+"Fraunhofer FDK MPEG-H Software" must be replaced by the term "Third-Party
+Modified Version of the Fraunhofer FDK MPEG-H Software".
+
+3. No PATENT LICENSE
+
+NO EXPRESS OR IMPLIED LICENSES TO ANY PATENT CLAIMS, including without
+limitation the patents of Fraunhofer, ARE GRANTED BY THIS SOFTWARE LICENSE.
+Fraunhofer provides no warranty of patent non-infringement with respect to this
+software. You may use this Fraunhofer FDK MPEG-H Software or modifications
+thereto only for purposes that are authorized by appropriate patent licenses.
+
+4. DISCLAIMER
+
+This Fraunhofer FDK MPEG-H Software is provided by Fraunhofer on behalf of the
+copyright holders and contributors "AS IS" and WITHOUT ANY EXPRESS OR IMPLIED
+WARRANTIES, including but not limited to the implied warranties of
+merchantability and fitness for a particular purpose. IN NO EVENT SHALL THE
+COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE for any direct, indirect,
+incidental, special, exemplary, or consequential damages, including but not
+limited to procurement of substitute goods or services; loss of use, data, or
+profits, or business interruption, however caused and on any theory of
+liability, whether in contract, strict liability, or tort (including
+negligence), arising in any way out of the use of this software, even if
+advised of the possibility of such damage.
+
+5. CONTACT INFORMATION
+
+Fraunhofer Institute for Integrated Circuits IIS
+Attention: Division Audio and Media Technologies - MPEG-H FDK
+Am Wolfsmantel 33
+91058 Erlangen, Germany
+www.iis.fraunhofer.de/amm
+amm-info@iis.fraunhofer.de
+-----------------------------------------------------------------------------*/
+// System includes
+#include <cstdint>
+
+// External includes
+#include "gtest/gtest.h"
+
+// Internal includes
+#include "mmtaudioparser/cicp.h"
+#include "mmtaudioparser/mpeghparser.h"
+#include "testutils.h"
+
+using namespace mmt::audioparser;
+using namespace mmt::audioparser::test;
+
+// The tables are usable in constant expressions
+static_assert(cicp::layoutNumSpeakers(6) == 6, "5.1 has six loudspeakers");
+static_assert(cicp::speakerGeometry(3).isLFE, "Index 3 is the LFE");
+static_assert(!cicp::isValidSpeakerIdx(cicp::NUM_SPEAKER_INDICES), "Larger indices are reserved");
+
+TEST(CicpTest, DescribesLoudspeakers) {
+  cicp::SSpeakerGeometry left = cicp::speakerGeometry(0);
+  EXPECT_TRUE(left.isValid);
+  EXPECT_EQ(left.azimuth, 30);
+  EXPECT_EQ(left.elevation, 0);
+  EXPECT_FALSE(left.isLFE);
+
+  cicp::SSpeakerGeometry topRearRight = cicp::speakerGeometry(21);
+  EXPECT_EQ(topRearRight.azimuth, -135);
+  EXPECT_EQ(topRearRight.elevation, 35);
+
+  EXPECT_TRUE(cicp::speakerGeometry(37).isScreenRelative);
+
+  // Reserved indices within and beyond the table
+  EXPECT_FALSE(cicp::isValidSpeakerIdx(11));
+  EXPECT_FALSE(cicp::speakerGeometry(11).isValid);
+  EXPECT_FALSE(cicp::speakerGeometry(127).isValid);
+}
+
+TEST(CicpTest, CountsLayoutLoudspeakers) {
+  EXPECT_EQ(cicp::layoutNumSpeakers(0), 0u);
+  EXPECT_EQ(cicp::layoutNumSpeakers(1), 1u);
+  EXPECT_EQ(cicp::layoutNumSpeakers(13), 24u);
+  EXPECT_EQ(cicp::layoutNumSpeakers(20), 14u);
+  EXPECT_EQ(cicp::layoutNumSpeakers(cicp::NUM_LAYOUT_INDICES), 0u);
+}
+
+TEST(CicpTest, ParserUsesLayoutTables) {
+  SConfigSpec spec;
+  spec.referenceLayoutCicpIdx = 13;
+  ilo::ByteBuffer config = buildConfig(spec);
+  CMpeghParser parser;
+  ASSERT_TRUE(parser.tryAddConfig(config.data(), config.size()).isOk());
+  EXPECT_EQ(parser.getConfigInfo().referenceLayout.numSpeakers, 24u);
+
+  // Reserved layouts are rejected
+  spec.referenceLayoutCicpIdx = cicp::NUM_LAYOUT_INDICES;
+  config = buildConfig(spec);
+  SParseResult result = parser.tryAddConfig(config.data(), config.size());
+  EXPECT_EQ(result.error, EParseError::invalidValue);
+  EXPECT_STREQ(result.syntaxElement, "CICPspeakerLayoutIdx");
+}
@@ -0,0 +1,178 @@
+/*-----------------------------------------------------------------------------
+Software License for The Fraunhofer FDK MPEG-H Software
+
+Copyright (c) 2024 Fraunhofer-Gesellschaft zur Förderung der angewandten
+Forschung e.V. and Contributors
+All rights reserved.
+
+1. INTRODUCTION
+
+The "Fraunhofer FDK MPEG-H Software" is software that implements the ISO/MPEG
+MPEG-H 3D Audio standard for digital audio or related system features. Patent
+licenses for necessary patent claims for the Fraunhofer FDK MPEG-H Software
+(including those of Fraunhofer), for the use in commercial products and
+services, may be obtained from the respective patent owners individually and/or
+from Via LA (www.via-la.com).
+
+Fraunhofer supports the development of MPEG-H products and services by offering
+additional software, documentation, and technical advice. In addition, it
+operates the MPEG-H Trademark Program to ease interoperability testing of end-
+products. Please visit www.mpegh.com for more information.
+
+2. COPYRIGHT LICENSE
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted without payment of copyright license fees provided that you
+satisfy the following conditions:
+
+* You must retain the complete text of this software license in redistributions
+of the Fraunhofer FDK MPEG-H Software or your modifications thereto in source
+code form.
+
+* You must retain the complete text of this software license in the
+documentation and/or other materials provided with redistributions of
+the Fraunhofer FDK MPEG-H Software or your modifications thereto in binary form.
+You must make available free of charge copies of the complete source code of
+the Fraunhofer FDK MPEG-H Software and your modifications thereto to recipients
+of copies in binary form.
+
+* The name of Fraunhofer may not be used to endorse or promote products derived
+from the Fraunhofer FDK MPEG-H Software without prior written permission.
+
+* You may not charge copyright license fees for anyone to use, copy or
+distribute the Fraunhofer FDK MPEG-H Software or your modifications thereto.
+
+* Your modified versions of the Fraunhofer FDK MPEG-H Software must carry
+prominent notices stating that you changed the software and the date of any
+change. For modified versions of the Fraunhofer FDK MPEG-H Software, the term
+"Fraunhofer FDK MPEG-H Software" must be replaced by the term "Third-Party
+Modified Version of the Fraunhofer FDK MPEG-H Software".
+
+3. No PATENT LICENSE
+
+NO EXPRESS OR IMPLIED LICENSES TO ANY PATENT CLAIMS, including without
+limitation the patents of Fraunhofer, ARE GRANTED BY THIS SOFTWARE LICENSE.
+Fraunhofer provides no warranty of patent non-infringement with respect to this
+software. You may use this Fraunhofer FDK MPEG-H Software or modifications
+thereto only for purposes that are authorized by appropriate patent licenses.
+
+4. DISCLAIMER
+
+This Fraunhofer FDK MPEG-H Software is provided by Fraunhofer on behalf of the
+copyright holders and contributors "AS IS" and WITHOUT ANY EXPRESS OR IMPLIED
+WARRANTIES, including but not limited to the implied warranties of
+merchantability and fitness for a particular purpose. IN NO EVENT SHALL THE
+COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE for any direct, indirect,
+incidental, special, exemplary, or consequential damages, including but not
+limited to procurement of substitute goods or services; loss of use, data, or
+profits, or business interruption, however caused and on any theory of
+liability, whether in contract, strict liability, or tort (including
+negligence), arising in any way out of the use of this software, even if
+advised of the possibility of such damage.
+
+5. CONTACT INFORMATION
+
+Fraunhofer Institute for Integrated Circuits IIS
+Attention: Division Audio and Media Technologies - MPEG-H FDK
+Am Wolfsmantel 33
+91058 Erlangen, Germany
+www.iis.fraunhofer.de/amm
+amm-info@iis.fraunhofer.de
+-----------------------------------------------------------------------------*/
+// System includes
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <vector>
+
+// External includes
+#include "gtest/gtest.h"
+
+// Internal includes
+#include "mmtaudioparser/configarena.h"
+#include "mmtaudioparser/mpeghparser.h"
+#include "testutils.h"
+
+using namespace mmt::audioparser;
+using namespace mmt::audioparser::test;
+
+TEST(ConfigArenaTest, AllocatesAlignedRegions) {
+  CConfigArena arena(64);
+  void* first = arena.allocate(3, 1);
+  void* second = arena.allocate(8, 8);
+  EXPECT_NE(first, second);
+  EXPECT_EQ(reinterpret_cast<uintptr_t>(second) % 8, 0u);
+  // Allocations larger than a block get a block of their own
+  EXPECT_NE(arena.allocate(1000, 16), nullptr);
+  EXPECT_GE(arena.capacity(), 1064u);
+}
+
+TEST(ConfigArenaTest, ResetMergesBlocks) {
+  CConfigArena arena(64);
+  arena.allocate(48, 8);
+  arena.allocate(48, 8);
+  size_t capacity = arena.capacity();
+  arena.reset();
+  EXPECT_EQ(arena.capacity(), capacity);
+
+  // The merged block serves the same allocations without growing
+  arena.allocate(48, 8);
+  arena.allocate(48, 8);
+  EXPECT_EQ(arena.capacity(), capacity);
+}
+
+TEST(ConfigArenaTest, RollbackReleasesLaterAllocations) {
+  CConfigArena arena(64);
+  arena.allocate(16, 8);
+  CConfigArena::SMark mark = arena.mark();
+  void* released = arena.allocate(16, 8);
+  arena.allocate(200, 8);
+  size_t capacity = arena.capacity();
+
+  arena.rollback(mark);
+  EXPECT_EQ(arena.allocate(16, 8), released);
+  // The blocks added after the mark are kept for further allocations
+  arena.allocate(200, 8);
+  EXPECT_EQ(arena.capacity(), capacity);
+}
+
+TEST(ConfigArenaTest, ClaimsOnce) {
+  CConfigArena arena;
+  EXPECT_TRUE(arena.claim());
+  EXPECT_FALSE(arena.claim());
+  arena.unclaim();
+  EXPECT_TRUE(arena.claim());
+}
+
+TEST(ConfigArenaTest, ConcurrentClaimsSucceedOnce) {
+  for (int round = 0; round < 50; ++round) {
+    CConfigArena arena;
+    std::atomic<int> numClaimed{0};
+    std::vector<std::thread> threads;
+    for (int i = 0; i < 4; ++i) {
+      threads.emplace_back([&]() { numClaimed += arena.claim() ? 1 : 0; });
+    }
+    for (auto& thread : threads) {
+      thread.join();
+    }
+    EXPECT_EQ(numClaimed.load(), 1);
+  }
+}
+
+TEST(ConfigArenaTest, ParsersCannotShareAnArena) {
+  CMpeghParser::SParserOptions options;
+  options.arena = std::make_shared<CConfigArena>();
+  {
+    CMpeghParser parser(options);
+    EXPECT_ANY_THROW(CMpeghParser{options});
+
+    ilo::ByteBuffer config = buildConfig();
+    ASSERT_TRUE(parser.tryAddConfig(config.data(), config.size()).isOk());
+    EXPECT_GT(options.arena->capacity(), 0u);
+  }
+  // The arena is released with its parser
+  CMpeghParser parser(options);
+  ilo::ByteBuffer config = buildConfig();
+  EXPECT_TRUE(parser.tryAddConfig(config.data(), config.size()).isOk());
+}
@@ -0,0 +1,156 @@
+/*-----------------------------------------------------------------------------
+Software License for The Fraunhofer FDK MPEG-H Software
+
+Copyright (c) 2024 Fraunhofer-Gesellschaft zur Förderung der angewandten
+Forschung e.V. and Contributors
+All rights reserved.
+
+1. INTRODUCTION
+
+The "Fraunhofer FDK MPEG-H Software" is software that implements the ISO/MPEG
+MPEG-H 3D Audio standard for digital audio or related system features. Patent
+licenses for necessary patent claims for the Fraunhofer FDK MPEG-H Software
+(including those of Fraunhofer), for the use in commercial products and
+services, may be obtained from the respective patent owners individually and/or
+from Via LA (www.via-la.com).
+
+Fraunhofer supports the development of MPEG-H products and services by offering
+additional software, documentation, and technical advice. In addition, it
+operates the MPEG-H Trademark Program to ease interoperability testing of end-
+products. Please visit www.mpegh.com for more information.
+
+2. COPYRIGHT LICENSE
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted without payment of copyright license fees provided that you
+satisfy the following conditions:
+
+* You must retain the complete text of this software license in redistributions
+of the Fraunhofer FDK MPEG-H Software or your modifications thereto in source
+code form.
+
+* You must retain the complete text of this software license in the
+documentation and/or other materials provided with redistributions of
+the Fraunhofer FDK MPEG-H Software or your modifications thereto in binary form.
+You must make available free of charge copies of the complete source code of
+the Fraunhofer FDK MPEG-H Software and your modifications thereto to recipients
+of copies in binary form.
+
+* The name of Fraunhofer may not be used to endorse or promote products derived
+from the Fraunhofer FDK MPEG-H Software without prior written permission.
+
+* You may not charge copyright license fees for anyone to use, copy or
+distribute the Fraunhofer FDK MPEG-H Software or your modifications thereto.
+
+* Your modified versions of the Fraunhofer FDK MPEG-H Software must carry
+prominent notices stating that you changed the software and the date of any
+change. For modified versions of the Fraunhofer FDK MPEG-H Software, the term
+"Fraunhofer FDK MPEG-H Software" must be replaced by the term "Third-Party
+Modified Version of the Fraunhofer FDK MPEG-H Software".
+
+3. No PATENT LICENSE
+
+NO EXPRESS OR IMPLIED LICENSES TO ANY PATENT CLAIMS, including without
+limitation the patents of Fraunhofer, ARE GRANTED BY THIS SOFTWARE LICENSE.
+Fraunhofer provides no warranty of patent non-infringement with respect to this
+software. You may use this Fraunhofer FDK MPEG-H Software or modifications
+thereto only for purposes that are authorized by appropriate patent licenses.
+
+4. DISCLAIMER
+
+This Fraunhofer FDK MPEG-H Software is provided by Fraunhofer on behalf of the
+copyright holders and contributors "AS IS" and WITHOUT ANY EXPRESS OR IMPLIED
+WARRANTIES, including but not limited to the implied warranties of
+merchantability and fitness for a particular purpose. IN NO EVENT SHALL THE
+COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE for any direct, indirect,
+incidental, special, exemplary, or consequential damages, including but not
+limited to procurement of substitute goods or services; loss of use, data, or
+profits, or business interruption, however caused and on any theory of
+liability, whether in contract, strict liability, or tort (including
+negligence), arising in any way out of the use of this software, even if
+advised of the possibility of such damage.
+
+5. CONTACT INFORMATION
+
+Fraunhofer Institute for Integrated Circuits IIS
+Attention: Division Audio and Media Technologies - MPEG-H FDK
+Am Wolfsmantel 33
+91058 Erlangen, Germany
+www.iis.fraunhofer.de/amm
+amm-info@iis.fraunhofer.de
+-----------------------------------------------------------------------------*/
+// System includes
+#include <cstdint>
+
+// External includes
+#include "gtest/gtest.h"
+
+// Internal includes
+#include "mmtaudioparser/constexprconfigparser.h"
+
+using namespace mmt::audioparser;
+
+namespace {
+// Stereo CPE at 48 kHz with CICP layout 2
+constexpr uint8_t STEREO_CONFIG[] = {0x0D, 0x19, 0x00, 0x80, 0x02, 0x02, 0x00};
+// Mono SCE at 48 kHz with CICP layout 1
+constexpr uint8_t MONO_CONFIG[] = {0x0D, 0x19, 0x00, 0x40, 0x00, 0x00, 0x00};
+// Stereo channel group followed by a single object
+constexpr uint8_t OBJECT_CONFIG[] = {0x0D, 0x19, 0x00, 0x82, 0x02, 0x20, 0x12, 0x00, 0x00};
+
+// This translation unit is compiled as C++14, so these checks verify that the header parses
+// configs at compile time.
+constexpr auto STEREO_INFO = compiletime::parseConfig(STEREO_CONFIG);
+static_assert(STEREO_INFO.result.isOk(), "The stereo config is valid");
+static_assert(STEREO_INFO.profileLevelIndicator == 0x0D, "Wrong profile level");
+static_assert(STEREO_INFO.samplingFrequency == 48000, "Wrong sampling frequency");
+static_assert(STEREO_INFO.referenceLayout.CICPIdx == 2, "Wrong reference layout");
+static_assert(STEREO_INFO.numAudioChannels == 2 && STEREO_INFO.numAudioObjects == 0,
+              "Wrong number of signals");
+static_assert(STEREO_INFO.numElements == 1, "Wrong number of elements");
+
+constexpr auto MONO_INFO = compiletime::parseConfig(MONO_CONFIG);
+static_assert(MONO_INFO.result.isOk(), "The mono config is valid");
+static_assert(MONO_INFO.referenceLayout.CICPIdx == 1, "Wrong reference layout");
+static_assert(MONO_INFO.numAudioChannels == 1, "Wrong number of channels");
+
+constexpr auto OBJECT_INFO = compiletime::parseConfig(OBJECT_CONFIG);
+static_assert(OBJECT_INFO.result.isOk(), "The object config is valid");
+static_assert(OBJECT_INFO.numSignalGroups == 2, "Wrong number of signal groups");
+static_assert(OBJECT_INFO.numAudioChannels == 2 && OBJECT_INFO.numAudioObjects == 1,
+              "Wrong number of signals");
+static_assert(OBJECT_INFO.numElements == 2, "Wrong number of elements");
+
+constexpr uint8_t TRUNCATED_CONFIG[] = {0x0D, 0x19, 0x00};
+static_assert(compiletime::parseConfig(TRUNCATED_CONFIG).result.error == EParseError::endOfBuffer,
+              "A truncated config is detected");
+
+// coreSbrFrameLengthIndex of 7 is reserved
+constexpr uint8_t RESERVED_CONFIG[] = {0x0D, 0x1F, 0x00, 0x80, 0x02, 0x02, 0x00};
+static_assert(compiletime::parseConfig(RESERVED_CONFIG).result.error == EParseError::invalidValue,
+              "A reserved value is detected");
+
+constexpr uint8_t TRAILING_CONFIG[] = {0x0D, 0x19, 0x00, 0x80, 0x02, 0x02, 0x00, 0x00};
+static_assert(compiletime::parseConfig(TRAILING_CONFIG).result.error == EParseError::trailingData,
+              "Trailing data is detected");
+}  // namespace
+
+TEST(ConstexprConfigParserTest, MatchesTheRuntimeParser) {
+  const uint8_t* configs[] = {STEREO_CONFIG, MONO_CONFIG, OBJECT_CONFIG};
+  const size_t configSizes[] = {sizeof(STEREO_CONFIG), sizeof(MONO_CONFIG), sizeof(OBJECT_CONFIG)};
+  for (size_t i = 0; i < 3; ++i) {
+    CMpeghParser parser;
+    parser.addConfig(configs[i], configSizes[i]);
+    ASSERT_TRUE(parser.isValidConfig());
+    const CMpeghParser::SConfigInfo& expected = parser.getConfigInfo();
+
+    CMpeghParser::SConfigInfo info =
+        compiletime::toConfigInfo(compiletime::parseConfig(configs[i], configSizes[i]));
+    EXPECT_EQ(info.samplingFrequency, expected.samplingFrequency);
+    EXPECT_EQ(info.referenceLayout.CICPIdx, expected.referenceLayout.CICPIdx);
+    EXPECT_EQ(info.numAudioChannels, expected.numAudioChannels);
+    EXPECT_EQ(info.numAudioObjects, expected.numAudioObjects);
+    EXPECT_EQ(info.signalGroups.size(), expected.signalGroups.size());
+    EXPECT_EQ(info.elementConfigs.size(), expected.elementConfigs.size());
+  }
+}
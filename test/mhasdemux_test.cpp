@@ -0,0 +1,216 @@
+/*-----------------------------------------------------------------------------
+Software License for The Fraunhofer FDK MPEG-H Software
+
+Copyright (c) 2024 Fraunhofer-Gesellschaft zur Förderung der angewandten
+Forschung e.V. and Contributors
+All rights reserved.
+
+1. INTRODUCTION
+
+The "Fraunhofer FDK MPEG-H Software" is software that implements the ISO/MPEG
+MPEG-H 3D Audio standard for digital audio or related system features. Patent
+licenses for necessary patent claims for the Fraunhofer FDK MPEG-H Software
+(including those of Fraunhofer), for the use in commercial products and
+services, may be obtained from the respective patent owners individually and/or
+from Via LA (www.via-la.com).
+
+Fraunhofer supports the development of MPEG-H products and services by offering
+additional software, documentation, and technical advice. In addition, it
+operates the MPEG-H Trademark Program to ease interoperability testing of end-
+products. Please visit www.mpegh.com for more information.
+
+2. COPYRIGHT LICENSE
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted without payment of copyright license fees provided that you
+satisfy the following conditions:
+
+* You must retain the complete text of this software license in redistributions
+of the Fraunhofer FDK MPEG-H Software or your modifications thereto in source
+code form.
+
+* You must retain the complete text of this software license in the
+documentation and/or other materials provided with redistributions of
+the Fraunhofer FDK MPEG-H Software or your modifications thereto in binary form.
+You must make available free of charge copies of the complete source code of
+the Fraunhofer FDK MPEG-H Software and your modifications thereto to recipients
+of copies in binary form.
+
+* The name of Fraunhofer may not be used to endorse or promote products derived
+from the Fraunhofer FDK MPEG-H Software without prior written permission.
+
+* You may not charge copyright license fees for anyone to use, copy or
+distribute the Fraunhofer FDK MPEG-H Software or your modifications thereto.
+
+* Your modified versions of the Fraunhofer FDK MPEG-H Software must carry
+prominent notices stating that you changed the software and the date of any
+change. For modified versions of the Fraunhofer FDK MPEG-H Software, the term
+"Fraunhofer FDK MPEG-H Software" must be replaced by the term "Third-Party
+Modified Version of the Fraunhofer FDK MPEG-H Software".
+
+3. No PATENT LICENSE
+
+NO EXPRESS OR IMPLIED LICENSES TO ANY PATENT CLAIMS, including without
+limitation the patents of Fraunhofer, ARE GRANTED BY THIS SOFTWARE LICENSE.
+Fraunhofer provides no warranty of patent non-infringement with respect to this
+software. You may use this Fraunhofer FDK MPEG-H Software or modifications
+thereto only for purposes that are authorized by appropriate patent licenses.
+
+4. DISCLAIMER
+
+This Fraunhofer FDK MPEG-H Software is provided by Fraunhofer on behalf of the
+copyright holders and contributors "AS IS" and WITHOUT ANY EXPRESS OR IMPLIED
+WARRANTIES, including but not limited to the implied warranties of
+merchantability and fitness for a particular purpose. IN NO EVENT SHALL THE
+COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE for any direct, indirect,
+incidental, special, exemplary, or consequential damages, including but not
+limited to procurement of substitute goods or services; loss of use, data, or
+profits, or business interruption, however caused and on any theory of
+liability, whether in contract, strict liability, or tort (including
+negligence), arising in any way out of the use of this software, even if
+advised of the possibility of such damage.
+
+5. CONTACT INFORMATION
+
+Fraunhofer Institute for Integrated Circuits IIS
+Attention: Division Audio and Media Technologies - MPEG-H FDK
+Am Wolfsmantel 33
+91058 Erlangen, Germany
+www.iis.fraunhofer.de/amm
+amm-info@iis.fraunhofer.de
+-----------------------------------------------------------------------------*/
+// System includes
+#include <memory>
+#include <vector>
+
+// External includes
+#include "gtest/gtest.h"
+
+// Internal includes
+#include "mmtaudioparser/configarena.h"
+#include "mmtaudioparser/mhasdemux.h"
+#include "testutils.h"
+
+using namespace mmt::audioparser;
+using namespace mmt::audioparser::test;
+
+namespace {
+ilo::ByteBuffer monoConfig() {
+  SConfigSpec spec;
+  spec.referenceLayoutCicpIdx = 1;
+  spec.signalGroups = {SSignalGroupSpec{0, 1}};
+  spec.elements = {SElementSpec{ID_USAC_SCE}};
+  return buildConfig(spec);
+}
+
+// Extracts all packets and returns their config results
+std::vector<SParseResult> demuxAll(CMhasDemux& demux, const ilo::ByteBuffer& stream) {
+  std::vector<SParseResult> configResults;
+  demux.setBuffer(stream.data(), stream.size());
+  SMhasDemuxPacket packet;
+  while (demux.nextPacket(packet).isOk()) {
+    if (packet.packet.packetType == EMhasPacketType::PACTYP_MPEGH3DACFG) {
+      configResults.push_back(packet.packet.configResult);
+    }
+  }
+  return configResults;
+}
+}  // namespace
+
+TEST(MhasDemuxTest, KeepsOneConfigPerLabel) {
+  ilo::ByteBuffer stream;
+  appendMhasPacket(stream, EMhasPacketType::PACTYP_MPEGH3DACFG, 1, buildConfig());
+  appendMhasPacket(stream, EMhasPacketType::PACTYP_MPEGH3DACFG, 2, monoConfig());
+  appendMhasPacket(stream, EMhasPacketType::PACTYP_MPEGH3DAFRAME, 2, buildDummyFrame(true));
+
+  CMhasDemux demux;
+  demux.setBuffer(stream.data(), stream.size());
+  SMhasDemuxPacket packet;
+  ASSERT_TRUE(demux.nextPacket(packet).isOk());
+  ASSERT_TRUE(demux.nextPacket(packet).isOk());
+  ASSERT_TRUE(demux.nextPacket(packet).isOk());
+  EXPECT_EQ(packet.packet.packetType, EMhasPacketType::PACTYP_MPEGH3DAFRAME);
+  ASSERT_EQ(packet.configParser, demux.getConfigParser(2));
+  EXPECT_EQ(packet.configParser->getConfigInfo().referenceLayout.CICPIdx, 1u);
+  EXPECT_EQ(demux.getConfigParser(1)->getConfigInfo().referenceLayout.CICPIdx, 2u);
+  EXPECT_EQ(demux.getConfigParser(3), nullptr);
+  EXPECT_EQ(demux.getPacketLabels(), (std::vector<uint64_t>{1, 2}));
+  EXPECT_EQ(demux.nextPacket(packet).error, EParseError::endOfBuffer);
+  EXPECT_EQ(demux.bytesConsumed(), stream.size());
+
+  std::vector<SLabelConfigChange> changes;
+  demux.takeConfigChanges(changes);
+  ASSERT_EQ(changes.size(), 2u);
+  EXPECT_EQ(changes[0].packetLabel, 1u);
+  EXPECT_TRUE(changes[0].firstConfig);
+  EXPECT_EQ(changes[1].packetLabel, 2u);
+  ASSERT_NE(changes[1].configInfo, nullptr);
+  EXPECT_EQ(changes[1].configInfo->referenceLayout.CICPIdx, 1u);
+
+  // The changes are handed out once
+  changes.clear();
+  demux.takeConfigChanges(changes);
+  EXPECT_TRUE(changes.empty());
+}
+
+TEST(MhasDemuxTest, PublishesOnlyChangedConfigs) {
+  ilo::ByteBuffer stream;
+  appendMhasPacket(stream, EMhasPacketType::PACTYP_MPEGH3DACFG, 1, buildConfig());
+  appendMhasPacket(stream, EMhasPacketType::PACTYP_MPEGH3DACFG, 1, buildConfig());
+  // A corrupt config in between invalidates the parser, but the following repetition is no change
+  appendMhasPacket(stream, EMhasPacketType::PACTYP_MPEGH3DACFG, 1, ilo::ByteBuffer{0x0D});
+  appendMhasPacket(stream, EMhasPacketType::PACTYP_MPEGH3DACFG, 1, buildConfig());
+  appendMhasPacket(stream, EMhasPacketType::PACTYP_MPEGH3DACFG, 1, monoConfig());
+
+  CMhasDemux demux;
+  std::vector<SParseResult> configResults = demuxAll(demux, stream);
+  ASSERT_EQ(configResults.size(), 5u);
+  EXPECT_FALSE(configResults[2].isOk());
+
+  std::vector<SLabelConfigChange> changes;
+  demux.takeConfigChanges(changes);
+  ASSERT_EQ(changes.size(), 2u);
+  EXPECT_TRUE(changes[0].firstConfig);
+  EXPECT_FALSE(changes[1].firstConfig);
+  EXPECT_EQ(changes[1].configInfo->referenceLayout.CICPIdx, 1u);
+}
+
+TEST(MhasDemuxTest, RejectsLabelsBeyondTheLimit) {
+  ilo::ByteBuffer stream;
+  for (uint32_t label = 1; label <= 3; ++label) {
+    appendMhasPacket(stream, EMhasPacketType::PACTYP_MPEGH3DACFG, label, buildConfig());
+  }
+  CMhasDemux::SDemuxOptions options;
+  options.maxLabels = 2;
+  CMhasDemux demux(options);
+  std::vector<SParseResult> configResults = demuxAll(demux, stream);
+  ASSERT_EQ(configResults.size(), 3u);
+  EXPECT_TRUE(configResults[1].isOk());
+  EXPECT_EQ(configResults[2].error, EParseError::limitExceeded);
+  EXPECT_EQ(demux.getPacketLabels().size(), 2u);
+}
+
+TEST(MhasDemuxTest, ResyncsToSyncPacket) {
+  ilo::ByteBuffer stream{0x12, 0x34};
+  appendSyncPacket(stream);
+  appendMhasPacket(stream, EMhasPacketType::PACTYP_MPEGH3DACFG, 1, buildConfig());
+  appendMhasPacket(stream, EMhasPacketType::PACTYP_MPEGH3DAFRAME, 1, buildDummyFrame(true));
+
+  CMhasDemux demux;
+  demux.setBuffer(stream.data(), stream.size());
+  ASSERT_TRUE(demux.resync().isOk());
+  EXPECT_EQ(demux.bytesConsumed(), 2u);
+  SMhasDemuxPacket packet;
+  ASSERT_TRUE(demux.nextPacket(packet).isOk());
+  EXPECT_EQ(packet.packet.packetType, EMhasPacketType::PACTYP_SYNC);
+}
+
+TEST(MhasDemuxTest, RejectsSharedArenaAndHeaderOnlyParsing) {
+  CMhasDemux::SDemuxOptions options;
+  options.parserOptions.arena = std::make_shared<CConfigArena>();
+  EXPECT_ANY_THROW(CMhasDemux{options});
+
+  options.parserOptions.arena.reset();
+  options.parserOptions.parseMode = CMpeghParser::EParseMode::headerOnly;
+  EXPECT_ANY_THROW(CMhasDemux{options});
+}
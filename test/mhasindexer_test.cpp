@@ -0,0 +1,295 @@
+/*-----------------------------------------------------------------------------
+Software License for The Fraunhofer FDK MPEG-H Software
+
+Copyright (c) 2024 Fraunhofer-Gesellschaft zur Förderung der angewandten
+Forschung e.V. and Contributors
+All rights reserved.
+
+1. INTRODUCTION
+
+The "Fraunhofer FDK MPEG-H Software" is software that implements the ISO/MPEG
+MPEG-H 3D Audio standard for digital audio or related system features. Patent
+licenses for necessary patent claims for the Fraunhofer FDK MPEG-H Software
+(including those of Fraunhofer), for the use in commercial products and
+services, may be obtained from the respective patent owners individually and/or
+from Via LA (www.via-la.com).
+
+Fraunhofer supports the development of MPEG-H products and services by offering
+additional software, documentation, and technical advice. In addition, it
+operates the MPEG-H Trademark Program to ease interoperability testing of end-
+products. Please visit www.mpegh.com for more information.
+
+2. COPYRIGHT LICENSE
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted without payment of copyright license fees provided that you
+satisfy the following conditions:
+
+* You must retain the complete text of this software license in redistributions
+of the Fraunhofer FDK MPEG-H Software or your modifications thereto in source
+code form.
+
+* You must retain the complete text of this software license in the
+documentation and/or other materials provided with redistributions of
+the Fraunhofer FDK MPEG-H Software or your modifications thereto in binary form.
+You must make available free of charge copies of the complete source code of
+the Fraunhofer FDK MPEG-H Software and your modifications thereto to recipients
+of copies in binary form.
+
+* The name of Fraunhofer may not be used to endorse or promote products derived
+from the Fraunhofer FDK MPEG-H Software without prior written permission.
+
+* You may not charge copyright license fees for anyone to use, copy or
+distribute the Fraunhofer FDK MPEG-H Software or your modifications thereto.
+
+* Your modified versions of the Fraunhofer FDK MPEG-H Software must carry
+prominent notices stating that you changed the software and the date of any
+change. For modified versions of the Fraunhofer FDK MPEG-H Software, the term
+"Fraunhofer FDK MPEG-H Software" must be replaced by the term "Third-Party
+Modified Version of the Fraunhofer FDK MPEG-H Software".
+
+3. No PATENT LICENSE
+
+NO EXPRESS OR IMPLIED LICENSES TO ANY PATENT CLAIMS, including without
+limitation the patents of Fraunhofer, ARE GRANTED BY THIS SOFTWARE LICENSE.
+Fraunhofer provides no warranty of patent non-infringement with respect to this
+software. You may use this Fraunhofer FDK MPEG-H Software or modifications
+thereto only for purposes that are authorized by appropriate patent licenses.
+
+4. DISCLAIMER
+
+This Fraunhofer FDK MPEG-H Software is provided by Fraunhofer on behalf of the
+copyright holders and contributors "AS IS" and WITHOUT ANY EXPRESS OR IMPLIED
+WARRANTIES, including but not limited to the implied warranties of
+merchantability and fitness for a particular purpose. IN NO EVENT SHALL THE
+COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE for any direct, indirect,
+incidental, special, exemplary, or consequential damages, including but not
+limited to procurement of substitute goods or services; loss of use, data, or
+profits, or business interruption, however caused and on any theory of
+liability, whether in contract, strict liability, or tort (including
+negligence), arising in any way out of the use of this software, even if
+advised of the possibility of such damage.
+
+5. CONTACT INFORMATION
+
+Fraunhofer Institute for Integrated Circuits IIS
+Attention: Division Audio and Media Technologies - MPEG-H FDK
+Am Wolfsmantel 33
+91058 Erlangen, Germany
+www.iis.fraunhofer.de/amm
+amm-info@iis.fraunhofer.de
+-----------------------------------------------------------------------------*/
+// System includes
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+// External includes
+#include "gtest/gtest.h"
+
+// Internal includes
+#include "mmtaudioparser/mhasindexer.h"
+#include "testutils.h"
+
+using namespace mmt::audioparser;
+using namespace mmt::audioparser::test;
+
+namespace {
+// Two random access points of label 1, each a SYNC packet, the config and one independent and one
+// dependent frame
+class MhasIndexerTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    for (int i = 0; i < 2; ++i) {
+      rapOffsets.push_back(stream.size());
+      appendSyncPacket(stream);
+      appendMhasPacket(stream, EMhasPacketType::PACTYP_MPEGH3DACFG, 1, buildConfig());
+      frameOffsets.push_back(stream.size());
+      appendMhasPacket(stream, EMhasPacketType::PACTYP_MPEGH3DAFRAME, 1, buildDummyFrame(true));
+      frameOffsets.push_back(stream.size());
+      appendMhasPacket(stream, EMhasPacketType::PACTYP_MPEGH3DAFRAME, 1, buildDummyFrame(false));
+    }
+  }
+
+  ilo::ByteBuffer stream;
+  std::vector<size_t> rapOffsets;
+  std::vector<size_t> frameOffsets;
+};
+
+std::string tempPath(const char* name) {
+  return ::testing::TempDir() + name;
+}
+}  // namespace
+
+TEST_F(MhasIndexerTest, IndexesFramesAndRandomAccessPoints) {
+  CMhasIndexer indexer;
+  SMhasIndex index = indexer.indexBuffer(stream.data(), stream.size());
+
+  EXPECT_EQ(index.streamSize, stream.size());
+  // The repeated config shares the entry of its first occurrence
+  ASSERT_EQ(index.configs.size(), 1u);
+  EXPECT_EQ(index.configs[0].offset, 3u);
+  EXPECT_EQ(index.configs[0].packetLabel, 1u);
+  ASSERT_NE(index.configs[0].configInfo, nullptr);
+  EXPECT_EQ(index.configs[0].configInfo->samplingFrequency, 48000u);
+
+  ASSERT_EQ(index.frames.size(), 4u);
+  ASSERT_EQ(index.randomAccessPoints.size(), 2u);
+  for (size_t i = 0; i < 4; ++i) {
+    EXPECT_EQ(index.frames[i].offset, frameOffsets[i]);
+    EXPECT_EQ(index.frames[i].configIdx, 0u);
+    EXPECT_EQ(index.frames[i].randomAccessPointIdx, i / 2);
+  }
+  for (size_t i = 0; i < 2; ++i) {
+    EXPECT_EQ(index.randomAccessPoints[i].offset, rapOffsets[i]);
+    EXPECT_EQ(index.randomAccessPoints[i].frameIdx, 2 * i);
+  }
+}
+
+TEST_F(MhasIndexerTest, FramesWithoutConfigAreNoRandomAccessPoint) {
+  ilo::ByteBuffer frames;
+  appendMhasPacket(frames, EMhasPacketType::PACTYP_MPEGH3DAFRAME, 1, buildDummyFrame(true));
+  stream.insert(stream.begin(), frames.begin(), frames.end());
+
+  CMhasIndexer indexer;
+  SMhasIndex index = indexer.indexBuffer(stream.data(), stream.size());
+  ASSERT_EQ(index.frames.size(), 5u);
+  EXPECT_EQ(index.frames[0].configIdx, SMhasIndex::NO_ENTRY);
+  EXPECT_EQ(index.frames[0].randomAccessPointIdx, SMhasIndex::NO_ENTRY);
+  EXPECT_EQ(index.randomAccessPoints.size(), 2u);
+}
+
+TEST_F(MhasIndexerTest, InvalidConfigHasNoConfigInfo) {
+  ilo::ByteBuffer invalid;
+  appendMhasPacket(invalid, EMhasPacketType::PACTYP_MPEGH3DACFG, 2, ilo::ByteBuffer{0x0D});
+  stream.insert(stream.end(), invalid.begin(), invalid.end());
+
+  CMhasIndexer indexer;
+  SMhasIndex index = indexer.indexBuffer(stream.data(), stream.size());
+  ASSERT_EQ(index.configs.size(), 2u);
+  EXPECT_EQ(index.configs[1].packetLabel, 2u);
+  EXPECT_EQ(index.configs[1].configInfo, nullptr);
+}
+
+TEST_F(MhasIndexerTest, ResyncsAfterCorruptedPacketLength) {
+  // Escape the packetLength of the second frame, so that it runs past the end of the stream
+  stream[frameOffsets[1]] |= 0x07;
+  stream[frameOffsets[1] + 1] = 0xFF;
+
+  CMhasIndexer indexer;
+  SMhasIndex index = indexer.indexBuffer(stream.data(), stream.size());
+  ASSERT_EQ(index.frames.size(), 3u);
+  EXPECT_EQ(index.frames[1].offset, frameOffsets[2]);
+  EXPECT_EQ(index.frames[2].offset, frameOffsets[3]);
+  ASSERT_EQ(index.randomAccessPoints.size(), 2u);
+  EXPECT_EQ(index.randomAccessPoints[1].offset, rapOffsets[1]);
+  EXPECT_EQ(index.randomAccessPoints[1].frameIdx, 1u);
+}
+
+TEST_F(MhasIndexerTest, ResyncsAfterCorruptedPacketType) {
+  // The escaped packet type 7 + 255 + 0x11 is reserved
+  stream[frameOffsets[1]] = 0xFF;
+
+  CMhasIndexer indexer;
+  SMhasIndex index = indexer.indexBuffer(stream.data(), stream.size());
+  ASSERT_EQ(index.frames.size(), 3u);
+  EXPECT_EQ(index.frames[2].offset, frameOffsets[3]);
+}
+
+TEST_F(MhasIndexerTest, IgnoresTruncatedLastPacket) {
+  stream.resize(stream.size() - 1);
+
+  CMhasIndexer indexer;
+  SMhasIndex index = indexer.indexBuffer(stream.data(), stream.size());
+  EXPECT_EQ(index.frames.size(), 3u);
+  EXPECT_EQ(index.randomAccessPoints.size(), 2u);
+}
+
+TEST_F(MhasIndexerTest, IndexesFile) {
+  std::string path = tempPath("mhasindexer_test.mhas");
+  {
+    std::ofstream file(path, std::ios::binary);
+    file.write(reinterpret_cast<const char*>(stream.data()),
+               static_cast<std::streamsize>(stream.size()));
+  }
+
+  CMhasIndexer indexer;
+  SMhasIndex index = indexer.indexFile(path);
+  EXPECT_EQ(index.frames.size(), 4u);
+  EXPECT_EQ(index.randomAccessPoints.size(), 2u);
+  std::remove(path.c_str());
+}
+
+TEST_F(MhasIndexerTest, SaveAndLoadRoundTrip) {
+  CMhasIndexer indexer;
+  SMhasIndex index = indexer.indexBuffer(stream.data(), stream.size());
+  std::string path = tempPath("mhasindexer_test.mhix");
+  index.save(path);
+
+  // The file holds the header and the entries in the documented layout
+  std::ifstream file(path, std::ios::binary | std::ios::ate);
+  EXPECT_EQ(static_cast<size_t>(file.tellg()), 28u + 1 * 20 + 4 * 16 + 2 * 12);
+
+  SMhasIndex loaded = SMhasIndex::load(path);
+  std::remove(path.c_str());
+  EXPECT_EQ(loaded.streamSize, index.streamSize);
+  ASSERT_EQ(loaded.configs.size(), 1u);
+  EXPECT_EQ(loaded.configs[0].offset, index.configs[0].offset);
+  EXPECT_EQ(loaded.configs[0].size, index.configs[0].size);
+  EXPECT_EQ(loaded.configs[0].packetLabel, index.configs[0].packetLabel);
+  EXPECT_EQ(loaded.configs[0].configInfo, nullptr);
+  ASSERT_EQ(loaded.frames.size(), index.frames.size());
+  for (size_t i = 0; i < index.frames.size(); ++i) {
+    EXPECT_EQ(loaded.frames[i].offset, index.frames[i].offset);
+    EXPECT_EQ(loaded.frames[i].size, index.frames[i].size);
+    EXPECT_EQ(loaded.frames[i].configIdx, index.frames[i].configIdx);
+    EXPECT_EQ(loaded.frames[i].randomAccessPointIdx, index.frames[i].randomAccessPointIdx);
+  }
+  ASSERT_EQ(loaded.randomAccessPoints.size(), index.randomAccessPoints.size());
+  for (size_t i = 0; i < index.randomAccessPoints.size(); ++i) {
+    EXPECT_EQ(loaded.randomAccessPoints[i].offset, index.randomAccessPoints[i].offset);
+    EXPECT_EQ(loaded.randomAccessPoints[i].frameIdx, index.randomAccessPoints[i].frameIdx);
+  }
+}
+
+TEST_F(MhasIndexerTest, LoadRejectsCorruptedFiles) {
+  CMhasIndexer indexer;
+  SMhasIndex index = indexer.indexBuffer(stream.data(), stream.size());
+  std::string path = tempPath("mhasindexer_test.mhix");
+  index.save(path);
+  ilo::ByteBuffer file;
+  {
+    std::ifstream in(path, std::ios::binary);
+    file.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+  }
+  auto writeFile = [&](const ilo::ByteBuffer& content) {
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    out.write(reinterpret_cast<const char*>(content.data()),
+              static_cast<std::streamsize>(content.size()));
+  };
+
+  ilo::ByteBuffer badMagic = file;
+  badMagic[0] = 'X';
+  writeFile(badMagic);
+  EXPECT_ANY_THROW(SMhasIndex::load(path));
+
+  ilo::ByteBuffer badVersion = file;
+  badVersion[4] = 2;
+  writeFile(badVersion);
+  EXPECT_ANY_THROW(SMhasIndex::load(path));
+
+  ilo::ByteBuffer truncated(file.begin(), file.end() - 1);
+  writeFile(truncated);
+  EXPECT_ANY_THROW(SMhasIndex::load(path));
+
+  // The frame index of the last random access point is out of range
+  ilo::ByteBuffer badRap = file;
+  badRap[badRap.size() - 4] = 4;
+  writeFile(badRap);
+  EXPECT_ANY_THROW(SMhasIndex::load(path));
+
+  std::remove(path.c_str());
+  EXPECT_ANY_THROW(SMhasIndex::load(path));
+}
@@ -0,0 +1,182 @@
+/*-----------------------------------------------------------------------------
+Software License for The Fraunhofer FDK MPEG-H Software
+
+Copyright (c) 2024 Fraunhofer-Gesellschaft zur Förderung der angewandten
+Forschung e.V. and Contributors
+All rights reserved.
+
+1. INTRODUCTION
+
+The "Fraunhofer FDK MPEG-H Software" is software that implements the ISO/MPEG
+MPEG-H 3D Audio standard for digital audio or related system features. Patent
+licenses for necessary patent claims for the Fraunhofer FDK MPEG-H Software
+(including those of Fraunhofer), for the use in commercial products and
+services, may be obtained from the respective patent owners individually and/or
+from Via LA (www.via-la.com).
+
+Fraunhofer supports the development of MPEG-H products and services by offering
+additional software, documentation, and technical advice. In addition, it
+operates the MPEG-H Trademark Program to ease interoperability testing of end-
+products. Please visit www.mpegh.com for more information.
+
+2. COPYRIGHT LICENSE
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted without payment of copyright license fees provided that you
+satisfy the following conditions:
+
+* You must retain the complete text of this software license in redistributions
+of the Fraunhofer FDK MPEG-H Software or your modifications thereto in source
+code form.
+
+* You must retain the complete text of this software license in the
+documentation and/or other materials provided with redistributions of
+the Fraunhofer FDK MPEG-H Software or your modifications thereto in binary form.
+You must make available free of charge copies of the complete source code of
+the Fraunhofer FDK MPEG-H Software and your modifications thereto to recipients
+of copies in binary form.
+
+* The name of Fraunhofer may not be used to endorse or promote products derived
+from the Fraunhofer FDK MPEG-H Software without prior written permission.
+
+* You may not charge copyright license fees for anyone to use, copy or
+distribute the Fraunhofer FDK MPEG-H Software or your modifications thereto.
+
+* Your modified versions of the Fraunhofer FDK MPEG-H Software must carry
+prominent notices stating that you changed the software and the date of any
+change. For modified versions of the Fraunhofer FDK MPEG-H Software, the term
+"Fraunhofer FDK MPEG-H Software" must be replaced by the term "Third-Party
+Modified Version of the Fraunhofer FDK MPEG-H Software".
+
+3. No PATENT LICENSE
+
+NO EXPRESS OR IMPLIED LICENSES TO ANY PATENT CLAIMS, including without
+limitation the patents of Fraunhofer, ARE GRANTED BY THIS SOFTWARE LICENSE.
+Fraunhofer provides no warranty of patent non-infringement with respect to this
+software. You may use this Fraunhofer FDK MPEG-H Software or modifications
+thereto only for purposes that are authorized by appropriate patent licenses.
+
+4. DISCLAIMER
+
+This Fraunhofer FDK MPEG-H Software is provided by Fraunhofer on behalf of the
+copyright holders and contributors "AS IS" and WITHOUT ANY EXPRESS OR IMPLIED
+WARRANTIES, including but not limited to the implied warranties of
+merchantability and fitness for a particular purpose. IN NO EVENT SHALL THE
+COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE for any direct, indirect,
+incidental, special, exemplary, or consequential damages, including but not
+limited to procurement of substitute goods or services; loss of use, data, or
+profits, or business interruption, however caused and on any theory of
+liability, whether in contract, strict liability, or tort (including
+negligence), arising in any way out of the use of this software, even if
+advised of the possibility of such damage.
+
+5. CONTACT INFORMATION
+
+Fraunhofer Institute for Integrated Circuits IIS
+Attention: Division Audio and Media Technologies - MPEG-H FDK
+Am Wolfsmantel 33
+91058 Erlangen, Germany
+www.iis.fraunhofer.de/amm
+amm-info@iis.fraunhofer.de
+-----------------------------------------------------------------------------*/
+// System includes
+#include <cstdint>
+
+// External includes
+#include "gtest/gtest.h"
+
+// Internal includes
+#include "mmtaudioparser/mhasparser.h"
+#include "testutils.h"
+
+using namespace mmt::audioparser;
+using namespace mmt::audioparser::test;
+
+TEST(MhasParserTest, ExtractsPackets) {
+  ilo::ByteBuffer frame = buildDummyFrame(true, 3000);
+  ilo::ByteBuffer stream;
+  appendSyncPacket(stream);
+  appendMhasPacket(stream, EMhasPacketType::PACTYP_MPEGH3DACFG, 1, buildConfig());
+  // An escaped label and length
+  appendMhasPacket(stream, EMhasPacketType::PACTYP_MPEGH3DAFRAME, 1000, frame);
+
+  CMhasParser parser;
+  parser.setBuffer(stream.data(), stream.size());
+  SMhasPacket packet;
+  ASSERT_TRUE(parser.nextPacket(packet).isOk());
+  EXPECT_EQ(packet.packetType, EMhasPacketType::PACTYP_SYNC);
+  EXPECT_EQ(packet.packetSize, 3u);
+  ASSERT_TRUE(parser.nextPacket(packet).isOk());
+  EXPECT_EQ(packet.packetType, EMhasPacketType::PACTYP_MPEGH3DACFG);
+  EXPECT_EQ(packet.packetLabel, 1u);
+  EXPECT_TRUE(packet.configResult.isOk());
+
+  ASSERT_TRUE(parser.nextPacket(packet).isOk());
+  EXPECT_EQ(packet.packetType, EMhasPacketType::PACTYP_MPEGH3DAFRAME);
+  EXPECT_EQ(packet.packetLabel, 1000u);
+  ASSERT_EQ(packet.packetLength, frame.size());
+  // The payload points into the stream
+  EXPECT_EQ(packet.payload + packet.packetLength, stream.data() + stream.size());
+  EXPECT_EQ(parser.bytesConsumed(), stream.size());
+
+  EXPECT_EQ(parser.nextPacket(packet).error, EParseError::endOfBuffer);
+}
+
+TEST(MhasParserTest, ContinuesWithTheNextChunk) {
+  ilo::ByteBuffer stream;
+  appendMhasPacket(stream, EMhasPacketType::PACTYP_MPEGH3DACFG, 1, buildConfig());
+  size_t firstPacketSize = stream.size();
+  appendMhasPacket(stream, EMhasPacketType::PACTYP_MPEGH3DAFRAME, 1, buildDummyFrame(true));
+
+  // The first chunk ends within the payload of the second packet
+  size_t chunkSize = stream.size() - 2;
+  CMhasParser parser;
+  parser.setBuffer(stream.data(), chunkSize);
+  SMhasPacket packet;
+  ASSERT_TRUE(parser.nextPacket(packet).isOk());
+  SParseResult result = parser.nextPacket(packet);
+  EXPECT_EQ(result.error, EParseError::endOfBuffer);
+  EXPECT_STREQ(result.syntaxElement, "mpeghAudioStreamPacketPayload");
+  ASSERT_EQ(parser.bytesConsumed(), firstPacketSize);
+
+  // The unconsumed bytes are handed in again together with the rest of the stream
+  parser.setBuffer(stream.data() + parser.bytesConsumed(), stream.size() - firstPacketSize);
+  ASSERT_TRUE(parser.nextPacket(packet).isOk());
+  EXPECT_EQ(packet.packetType, EMhasPacketType::PACTYP_MPEGH3DAFRAME);
+  EXPECT_EQ(parser.bytesConsumed(), stream.size() - firstPacketSize);
+}
+
+TEST(MhasParserTest, RoutesConfigsIntoTheConfigParser) {
+  ilo::ByteBuffer stream;
+  appendMhasPacket(stream, EMhasPacketType::PACTYP_MPEGH3DACFG, 1, buildConfig());
+  appendMhasPacket(stream, EMhasPacketType::PACTYP_MPEGH3DACFG, 1, ilo::ByteBuffer{0x0D, 0x1F});
+
+  CMpeghParser configParser;
+  CMhasParser parser(configParser);
+  parser.setBuffer(stream.data(), stream.size());
+  SMhasPacket packet;
+  ASSERT_TRUE(parser.nextPacket(packet).isOk());
+  EXPECT_TRUE(packet.configResult.isOk());
+  EXPECT_TRUE(configParser.isValidConfig());
+  EXPECT_EQ(configParser.getConfigInfo().samplingFrequency, 48000u);
+
+  // An invalid config is reported with the packet, the packet itself is extracted
+  ASSERT_TRUE(parser.nextPacket(packet).isOk());
+  EXPECT_FALSE(packet.configResult.isOk());
+  EXPECT_FALSE(configParser.isValidConfig());
+  EXPECT_EQ(parser.bytesConsumed(), stream.size());
+}
+
+TEST(MhasParserTest, ReportsTruncatedHeaders) {
+  // The packet type escapes into a second field which is cut off
+  const uint8_t data[] = {0xFF};
+  SMhasPacket packet;
+  SParseResult result = CMhasParser::parsePacket(data, sizeof(data), packet);
+  EXPECT_EQ(result.error, EParseError::endOfBuffer);
+  EXPECT_STREQ(result.syntaxElement, "mpeghAudioStreamPacket");
+
+  CMhasParser parser;
+  parser.setBuffer(nullptr, 10);
+  EXPECT_EQ(parser.nextPacket(packet).error, EParseError::endOfBuffer);
+  EXPECT_EQ(parser.bytesConsumed(), 0u);
+}
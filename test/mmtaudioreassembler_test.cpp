@@ -0,0 +1,309 @@
+/*-----------------------------------------------------------------------------
+Software License for The Fraunhofer FDK MPEG-H Software
+
+Copyright (c) 2024 Fraunhofer-Gesellschaft zur Förderung der angewandten
+Forschung e.V. and Contributors
+All rights reserved.
+
+1. INTRODUCTION
+
+The "Fraunhofer FDK MPEG-H Software" is software that implements the ISO/MPEG
+MPEG-H 3D Audio standard for digital audio or related system features. Patent
+licenses for necessary patent claims for the Fraunhofer FDK MPEG-H Software
+(including those of Fraunhofer), for the use in commercial products and
+services, may be obtained from the respective patent owners individually and/or
+from Via LA (www.via-la.com).
+
+Fraunhofer supports the development of MPEG-H products and services by offering
+additional software, documentation, and technical advice. In addition, it
+operates the MPEG-H Trademark Program to ease interoperability testing of end-
+products. Please visit www.mpegh.com for more information.
+
+2. COPYRIGHT LICENSE
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted without payment of copyright license fees provided that you
+satisfy the following conditions:
+
+* You must retain the complete text of this software license in redistributions
+of the Fraunhofer FDK MPEG-H Software or your modifications thereto in source
+code form.
+
+* You must retain the complete text of this software license in the
+documentation and/or other materials provided with redistributions of
+the Fraunhofer FDK MPEG-H Software or your modifications thereto in binary form.
+You must make available free of charge copies of the complete source code of
+the Fraunhofer FDK MPEG-H Software and your modifications thereto to recipients
+of copies in binary form.
+
+* The name of Fraunhofer may not be used to endorse or promote products derived
+from the Fraunhofer FDK MPEG-H Software without prior written permission.
+
+* You may not charge copyright license fees for anyone to use, copy or
+distribute the Fraunhofer FDK MPEG-H Software or your modifications thereto.
+
+* Your modified versions of the Fraunhofer FDK MPEG-H Software must carry
+prominent notices stating that you changed the software and the date of any
+change. For modified versions of the Fraunhofer FDK MPEG-H Software, the term
+"Fraunhofer FDK MPEG-H Software" must be replaced by the term "Third-Party
+Modified Version of the Fraunhofer FDK MPEG-H Software".
+
+3. No PATENT LICENSE
+
+NO EXPRESS OR IMPLIED LICENSES TO ANY PATENT CLAIMS, including without
+limitation the patents of Fraunhofer, ARE GRANTED BY THIS SOFTWARE LICENSE.
+Fraunhofer provides no warranty of patent non-infringement with respect to this
+software. You may use this Fraunhofer FDK MPEG-H Software or modifications
+thereto only for purposes that are authorized by appropriate patent licenses.
+
+4. DISCLAIMER
+
+This Fraunhofer FDK MPEG-H Software is provided by Fraunhofer on behalf of the
+copyright holders and contributors "AS IS" and WITHOUT ANY EXPRESS OR IMPLIED
+WARRANTIES, including but not limited to the implied warranties of
+merchantability and fitness for a particular purpose. IN NO EVENT SHALL THE
+COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE for any direct, indirect,
+incidental, special, exemplary, or consequential damages, including but not
+limited to procurement of substitute goods or services; loss of use, data, or
+profits, or business interruption, however caused and on any theory of
+liability, whether in contract, strict liability, or tort (including
+negligence), arising in any way out of the use of this software, even if
+advised of the possibility of such damage.
+
+5. CONTACT INFORMATION
+
+Fraunhofer Institute for Integrated Circuits IIS
+Attention: Division Audio and Media Technologies - MPEG-H FDK
+Am Wolfsmantel 33
+91058 Erlangen, Germany
+www.iis.fraunhofer.de/amm
+amm-info@iis.fraunhofer.de
+-----------------------------------------------------------------------------*/
+// System includes
+#include <algorithm>
+#include <vector>
+
+// External includes
+#include "gtest/gtest.h"
+
+// Internal includes
+#include "mmtaudioparser/mmtaudioreassembler.h"
+#include "mmtaudioparser/mhasparser.h"
+#include "testutils.h"
+#include "bitwriter.h"
+
+using namespace mmt::audioparser;
+using namespace mmt::audioparser::test;
+using mmt::audioparser::utils::CBitWriter;
+
+namespace {
+constexpr uint16_t PACKET_ID = 0x0123;
+constexpr uint8_t FRAGMENT_COMPLETE = 0;
+constexpr uint8_t FRAGMENT_FIRST = 1;
+constexpr uint8_t FRAGMENT_MIDDLE = 2;
+constexpr uint8_t FRAGMENT_LAST = 3;
+
+struct SMfuSpec {
+  uint32_t sampleNumber = 0;
+  ilo::ByteBuffer sample;
+};
+
+// Timed MFU data unit header followed by the sample
+ilo::ByteBuffer buildDataUnit(const SMfuSpec& mfu) {
+  ilo::ByteBuffer dataUnit;
+  CBitWriter writer(dataUnit);
+  writer.write(0, 32);  // movie_fragment_sequence_number
+  writer.write(mfu.sampleNumber, 32);
+  writer.write(0, 32);  // offset
+  writer.write(0, 16);  // priority, dep_counter
+  dataUnit.insert(dataUnit.end(), mfu.sample.begin(), mfu.sample.end());
+  return dataUnit;
+}
+
+// MMTP packet in MPU mode carrying timed MFU data units
+ilo::ByteBuffer buildPacket(uint32_t mpuSequenceNumber, uint8_t fragmentationIndicator,
+                            uint8_t fragmentCounter, const std::vector<ilo::ByteBuffer>& dataUnits,
+                            uint16_t packetId = PACKET_ID) {
+  bool aggregation = dataUnits.size() > 1;
+  ilo::ByteBuffer payload;
+  for (const auto& dataUnit : dataUnits) {
+    if (aggregation) {
+      payload.push_back(static_cast<uint8_t>(dataUnit.size() >> 8));
+      payload.push_back(static_cast<uint8_t>(dataUnit.size()));
+    }
+    payload.insert(payload.end(), dataUnit.begin(), dataUnit.end());
+  }
+
+  ilo::ByteBuffer packet;
+  CBitWriter writer(packet);
+  // version, packet_counter_flag, FEC_type, reserved, extension_flag, RAP_flag, reserved, type
+  writer.write(0, 16);
+  writer.write(packetId, 16);
+  writer.write(0, 32);  // timestamp
+  writer.write(0, 32);  // packet_sequence_number
+  writer.write(static_cast<uint32_t>(6 + payload.size()), 16);
+  writer.write(2, 4);  // MFU
+  writer.writeBool(true);
+  writer.write(fragmentationIndicator, 2);
+  writer.writeBool(aggregation);
+  writer.write(fragmentCounter, 8);
+  writer.write(mpuSequenceNumber, 32);
+  packet.insert(packet.end(), payload.begin(), payload.end());
+  return packet;
+}
+
+ilo::ByteBuffer buildSample(const ilo::ByteBuffer& frame) {
+  ilo::ByteBuffer sample;
+  appendMhasPacket(sample, EMhasPacketType::PACTYP_MPEGH3DACFG, 1, buildConfig());
+  appendMhasPacket(sample, EMhasPacketType::PACTYP_MPEGH3DAFRAME, 1, frame);
+  return sample;
+}
+
+class MmtAudioReassemblerTest : public ::testing::Test {
+ protected:
+  SParseResult addPacket(const ilo::ByteBuffer& packet) {
+    return reassembler.addPacket(packet.data(), packet.size(), accessUnits);
+  }
+
+  // Sends the data unit of the given sample split into numFragments fragments, skipping the
+  // fragments flagged in lost
+  void addFragments(uint32_t mpuSequenceNumber, const SMfuSpec& mfu, size_t numFragments,
+                    const std::vector<bool>& lost = {}) {
+    ilo::ByteBuffer dataUnit = buildDataUnit(mfu);
+    // Every fragment repeats the DU header, only the sample is split
+    size_t headerSize = dataUnit.size() - mfu.sample.size();
+    size_t fragmentSize = (mfu.sample.size() + numFragments - 1) / numFragments;
+    for (size_t i = 0; i < numFragments; ++i) {
+      size_t begin = std::min(i * fragmentSize, mfu.sample.size());
+      size_t end = std::min(begin + fragmentSize, mfu.sample.size());
+      ilo::ByteBuffer fragment(dataUnit.begin(), dataUnit.begin() + headerSize);
+      fragment.insert(fragment.end(), mfu.sample.begin() + begin, mfu.sample.begin() + end);
+      uint8_t indicator = i == 0 ? FRAGMENT_FIRST
+                                 : i + 1 == numFragments ? FRAGMENT_LAST : FRAGMENT_MIDDLE;
+      if (i < lost.size() && lost[i]) {
+        continue;
+      }
+      ASSERT_TRUE(addPacket(buildPacket(mpuSequenceNumber, indicator,
+                                        static_cast<uint8_t>(numFragments - 1 - i), {fragment}))
+                      .isOk());
+    }
+  }
+
+  CMpeghParser configParser;
+  CMmtAudioReassembler reassembler{configParser, PACKET_ID};
+  std::vector<SMmtAccessUnit> accessUnits;
+};
+}  // namespace
+
+TEST_F(MmtAudioReassemblerTest, ExtractsCompleteMfu) {
+  ilo::ByteBuffer frame = buildDummyFrame(true);
+  SMfuSpec mfu{7, buildSample(frame)};
+  ilo::ByteBuffer packet = buildPacket(3, FRAGMENT_COMPLETE, 0, {buildDataUnit(mfu)});
+  ASSERT_TRUE(addPacket(packet).isOk());
+
+  ASSERT_EQ(accessUnits.size(), 1u);
+  const SMmtAccessUnit& accessUnit = accessUnits[0];
+  EXPECT_EQ(accessUnit.mpuSequenceNumber, 3u);
+  EXPECT_EQ(accessUnit.sampleNumber, 7u);
+  // Unfragmented MFUs are views into the packet
+  EXPECT_EQ(accessUnit.data, packet.data() + packet.size() - mfu.sample.size());
+  EXPECT_EQ(ilo::ByteBuffer(accessUnit.data, accessUnit.data + accessUnit.size), mfu.sample);
+  EXPECT_EQ(ilo::ByteBuffer(accessUnit.frame, accessUnit.frame + accessUnit.frameSize), frame);
+  EXPECT_TRUE(accessUnit.configPresent);
+  EXPECT_TRUE(accessUnit.configResult.isOk());
+  EXPECT_TRUE(configParser.isValidConfig());
+}
+
+TEST_F(MmtAudioReassemblerTest, ExtractsAggregatedMfus) {
+  SMfuSpec first{1, buildSample(buildDummyFrame(true))};
+  ilo::ByteBuffer second;
+  appendMhasPacket(second, EMhasPacketType::PACTYP_MPEGH3DAFRAME, 1, buildDummyFrame(false));
+  ASSERT_TRUE(addPacket(buildPacket(0, FRAGMENT_COMPLETE, 0,
+                                    {buildDataUnit(first), buildDataUnit(SMfuSpec{2, second})}))
+                  .isOk());
+
+  ASSERT_EQ(accessUnits.size(), 2u);
+  EXPECT_EQ(accessUnits[0].sampleNumber, 1u);
+  EXPECT_TRUE(accessUnits[0].configPresent);
+  EXPECT_EQ(accessUnits[1].sampleNumber, 2u);
+  EXPECT_FALSE(accessUnits[1].configPresent);
+  EXPECT_NE(accessUnits[1].frame, nullptr);
+}
+
+TEST_F(MmtAudioReassemblerTest, ReassemblesFragmentedMfu) {
+  SMfuSpec mfu{5, buildSample(buildDummyFrame(true, 40))};
+  addFragments(2, mfu, 3);
+
+  ASSERT_EQ(accessUnits.size(), 1u);
+  EXPECT_EQ(accessUnits[0].mpuSequenceNumber, 2u);
+  EXPECT_EQ(accessUnits[0].sampleNumber, 5u);
+  EXPECT_EQ(ilo::ByteBuffer(accessUnits[0].data, accessUnits[0].data + accessUnits[0].size),
+            mfu.sample);
+  EXPECT_TRUE(accessUnits[0].configResult.isOk());
+  EXPECT_EQ(reassembler.numDroppedUnits(), 0u);
+}
+
+TEST_F(MmtAudioReassemblerTest, DropsMfuWithLostMiddleFragment) {
+  SMfuSpec mfu{5, buildSample(buildDummyFrame(true, 40))};
+  addFragments(2, mfu, 4, {false, true});
+  EXPECT_TRUE(accessUnits.empty());
+  EXPECT_EQ(reassembler.numDroppedUnits(), 1u);
+
+  // The next MFU is not affected
+  addFragments(2, SMfuSpec{6, mfu.sample}, 2);
+  ASSERT_EQ(accessUnits.size(), 1u);
+  EXPECT_EQ(accessUnits[0].sampleNumber, 6u);
+  EXPECT_EQ(reassembler.numDroppedUnits(), 1u);
+}
+
+TEST_F(MmtAudioReassemblerTest, CountsMfuWithLostFirstFragmentOnce) {
+  SMfuSpec mfu{5, buildSample(buildDummyFrame(true, 40))};
+  addFragments(2, mfu, 4, {true});
+  EXPECT_TRUE(accessUnits.empty());
+  EXPECT_EQ(reassembler.numDroppedUnits(), 1u);
+
+  addFragments(2, SMfuSpec{6, mfu.sample}, 3, {true});
+  EXPECT_EQ(reassembler.numDroppedUnits(), 2u);
+}
+
+TEST_F(MmtAudioReassemblerTest, DropsPendingFragmentsOnNewMfu) {
+  SMfuSpec mfu{5, buildSample(buildDummyFrame(true, 40))};
+  addFragments(2, mfu, 3, {false, false, true});
+  EXPECT_EQ(reassembler.numDroppedUnits(), 0u);
+
+  ilo::ByteBuffer packet = buildPacket(2, FRAGMENT_COMPLETE, 0, {buildDataUnit({6, mfu.sample})});
+  ASSERT_TRUE(addPacket(packet).isOk());
+  ASSERT_EQ(accessUnits.size(), 1u);
+  EXPECT_EQ(accessUnits[0].sampleNumber, 6u);
+  EXPECT_EQ(reassembler.numDroppedUnits(), 1u);
+}
+
+TEST_F(MmtAudioReassemblerTest, SkipsOtherAssets) {
+  SMfuSpec mfu{1, buildSample(buildDummyFrame(true))};
+  ASSERT_TRUE(
+      addPacket(buildPacket(0, FRAGMENT_COMPLETE, 0, {buildDataUnit(mfu)}, PACKET_ID + 1)).isOk());
+  EXPECT_TRUE(accessUnits.empty());
+  EXPECT_FALSE(configParser.isValidConfig());
+}
+
+TEST_F(MmtAudioReassemblerTest, RejectsMalformedPackets) {
+  SMfuSpec mfu{1, buildSample(buildDummyFrame(true))};
+  ilo::ByteBuffer packet = buildPacket(0, FRAGMENT_COMPLETE, 0, {buildDataUnit(mfu)});
+
+  ilo::ByteBuffer truncated(packet.begin(), packet.begin() + 10);
+  EXPECT_EQ(addPacket(truncated).error, EParseError::endOfBuffer);
+
+  ilo::ByteBuffer version = packet;
+  version[0] |= 0x40;
+  EXPECT_EQ(addPacket(version).error, EParseError::notSupported);
+
+  // The length field exceeds the packet
+  ilo::ByteBuffer length = packet;
+  length[12] = 0xFF;
+  EXPECT_EQ(addPacket(length).error, EParseError::invalidValue);
+
+  // The data unit is shorter than the MFU header
+  ilo::ByteBuffer shortUnit = buildPacket(0, FRAGMENT_COMPLETE, 0, {ilo::ByteBuffer(4, 0)});
+  EXPECT_EQ(addPacket(shortUnit).error, EParseError::endOfBuffer);
+  EXPECT_TRUE(accessUnits.empty());
+}
@@ -0,0 +1,234 @@
+/*-----------------------------------------------------------------------------
+Software License for The Fraunhofer FDK MPEG-H Software
+
+Copyright (c) 2024 Fraunhofer-Gesellschaft zur Förderung der angewandten
+Forschung e.V. and Contributors
+All rights reserved.
+
+1. INTRODUCTION
+
+The "Fraunhofer FDK MPEG-H Software" is software that implements the ISO/MPEG
+MPEG-H 3D Audio standard for digital audio or related system features. Patent
+licenses for necessary patent claims for the Fraunhofer FDK MPEG-H Software
+(including those of Fraunhofer), for the use in commercial products and
+services, may be obtained from the respective patent owners individually and/or
+from Via LA (www.via-la.com).
+
+Fraunhofer supports the development of MPEG-H products and services by offering
+additional software, documentation, and technical advice. In addition, it
+operates the MPEG-H Trademark Program to ease interoperability testing of end-
+products. Please visit www.mpegh.com for more information.
+
+2. COPYRIGHT LICENSE
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted without payment of copyright license fees provided that you
+satisfy the following conditions:
+
+* You must retain the complete text of this software license in redistributions
+of the Fraunhofer FDK MPEG-H Software or your modifications thereto in source
+code form.
+
+* You must retain the complete text of this software license in the
+documentation and/or other materials provided with redistributions of
+the Fraunhofer FDK MPEG-H Software or your modifications thereto in binary form.
+You must make available free of charge copies of the complete source code of
+the Fraunhofer FDK MPEG-H Software and your modifications thereto to recipients
+of copies in binary form.
+
+* The name of Fraunhofer may not be used to endorse or promote products derived
+from the Fraunhofer FDK MPEG-H Software without prior written permission.
+
+* You may not charge copyright license fees for anyone to use, copy or
+distribute the Fraunhofer FDK MPEG-H Software or your modifications thereto.
+
+* Your modified versions of the Fraunhofer FDK MPEG-H Software must carry
+prominent notices stating that you changed the software and the date of any
+change. For modified versions of the Fraunhofer FDK MPEG-H Software, the term
+"Fraunhofer FDK MPEG-H Software" must be replaced by the term "Third-Party
+Modified Version of the Fraunhofer FDK MPEG-H Software".
+
+3. No PATENT LICENSE
+
+NO EXPRESS OR IMPLIED LICENSES TO ANY PATENT CLAIMS, including without
+limitation the patents of Fraunhofer, ARE GRANTED BY THIS SOFTWARE LICENSE.
+Fraunhofer provides no warranty of patent non-infringement with respect to this
+software. You may use this Fraunhofer FDK MPEG-H Software or modifications
+thereto only for purposes that are authorized by appropriate patent licenses.
+
+4. DISCLAIMER
+
+This Fraunhofer FDK MPEG-H Software is provided by Fraunhofer on behalf of the
+copyright holders and contributors "AS IS" and WITHOUT ANY EXPRESS OR IMPLIED
+WARRANTIES, including but not limited to the implied warranties of
+merchantability and fitness for a particular purpose. IN NO EVENT SHALL THE
+COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE for any direct, indirect,
+incidental, special, exemplary, or consequential damages, including but not
+limited to procurement of substitute goods or services; loss of use, data, or
+profits, or business interruption, however caused and on any theory of
+liability, whether in contract, strict liability, or tort (including
+negligence), arising in any way out of the use of this software, even if
+advised of the possibility of such damage.
+
+5. CONTACT INFORMATION
+
+Fraunhofer Institute for Integrated Circuits IIS
+Attention: Division Audio and Media Technologies - MPEG-H FDK
+Am Wolfsmantel 33
+91058 Erlangen, Germany
+www.iis.fraunhofer.de/amm
+amm-info@iis.fraunhofer.de
+-----------------------------------------------------------------------------*/
+// System includes
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+
+// External includes
+#include "gtest/gtest.h"
+
+// Internal includes
+#include "mmtaudioparser/mp4configreader.h"
+#include "testutils.h"
+
+using namespace mmt::audioparser;
+using namespace mmt::audioparser::test;
+
+namespace {
+uint32_t fourCC(const char* type) {
+  return (static_cast<uint32_t>(type[0]) << 24) | (static_cast<uint32_t>(type[1]) << 16) |
+         (static_cast<uint32_t>(type[2]) << 8) | static_cast<uint32_t>(type[3]);
+}
+
+void appendBe(ilo::ByteBuffer& buffer, uint32_t value, size_t numBytes) {
+  for (size_t i = numBytes; i > 0; --i) {
+    buffer.push_back(static_cast<uint8_t>(value >> (8 * (i - 1))));
+  }
+}
+
+ilo::ByteBuffer box(const char* type, const ilo::ByteBuffer& payload) {
+  ilo::ByteBuffer result;
+  appendBe(result, static_cast<uint32_t>(payload.size() + 8), 4);
+  appendBe(result, fourCC(type), 4);
+  result.insert(result.end(), payload.begin(), payload.end());
+  return result;
+}
+
+ilo::ByteBuffer concat(const std::vector<ilo::ByteBuffer>& parts) {
+  ilo::ByteBuffer result;
+  for (const auto& part : parts) {
+    result.insert(result.end(), part.begin(), part.end());
+  }
+  return result;
+}
+
+ilo::ByteBuffer mhaC(const ilo::ByteBuffer& config) {
+  ilo::ByteBuffer payload = {1, 0x0D, 2};
+  appendBe(payload, static_cast<uint32_t>(config.size()), 2);
+  payload.insert(payload.end(), config.begin(), config.end());
+  return box("mhaC", payload);
+}
+
+ilo::ByteBuffer sampleEntry(const char* type, const ilo::ByteBuffer& children) {
+  // SampleEntry and AudioSampleEntry fields
+  ilo::ByteBuffer payload(28, 0);
+  payload.insert(payload.end(), children.begin(), children.end());
+  return box(type, payload);
+}
+
+ilo::ByteBuffer track(uint32_t trackId, const std::vector<ilo::ByteBuffer>& sampleEntries) {
+  // Version 0 track header with track_ID after the creation and modification times
+  ilo::ByteBuffer tkhd(12, 0);
+  appendBe(tkhd, trackId, 4);
+  tkhd.resize(84, 0);
+
+  ilo::ByteBuffer stsd;
+  appendBe(stsd, 0, 4);
+  appendBe(stsd, static_cast<uint32_t>(sampleEntries.size()), 4);
+  ilo::ByteBuffer entries = concat(sampleEntries);
+  stsd.insert(stsd.end(), entries.begin(), entries.end());
+
+  ilo::ByteBuffer stbl = box("stbl", box("stsd", stsd));
+  return box("trak", concat({box("tkhd", tkhd), box("mdia", box("minf", stbl))}));
+}
+
+ilo::ByteBuffer file(const std::vector<ilo::ByteBuffer>& tracks) {
+  // The media data precedes the movie box and is skipped
+  return concat({box("ftyp", {'m', 'p', '4', '2', 0, 0, 0, 0}),
+                 box("mdat", ilo::ByteBuffer(100, 0xFF)), box("moov", concat(tracks))});
+}
+}  // namespace
+
+TEST(Mp4ConfigReaderTest, ReadsConfigsOfAllTracks) {
+  ilo::ByteBuffer mp4 =
+      file({track(1, {sampleEntry("mha1", mhaC(buildConfig()))}),
+            track(2, {sampleEntry("mp4a", {}), sampleEntry("mhm1", {})}),
+            track(3, {sampleEntry("mhm2", mhaC(ilo::ByteBuffer{0x0D, 0x1F}))})});
+
+  CMp4ConfigReader reader;
+  std::vector<SMhaTrackConfig> configs = reader.readBuffer(mp4.data(), mp4.size());
+  ASSERT_EQ(configs.size(), 3u);
+
+  EXPECT_EQ(configs[0].trackId, 1u);
+  EXPECT_EQ(configs[0].sampleEntryType, fourCC("mha1"));
+  EXPECT_TRUE(configs[0].configPresent);
+  EXPECT_EQ(configs[0].profileLevelIndication, 0x0D);
+  EXPECT_EQ(configs[0].referenceChannelLayout, 2);
+  EXPECT_TRUE(configs[0].parseResult.isOk());
+  ASSERT_NE(configs[0].configInfo, nullptr);
+  EXPECT_EQ(configs[0].configInfo->samplingFrequency, 48000u);
+
+  // The configuration of mhm1 is carried in-band
+  EXPECT_EQ(configs[1].trackId, 2u);
+  EXPECT_EQ(configs[1].sampleEntryType, fourCC("mhm1"));
+  EXPECT_FALSE(configs[1].configPresent);
+
+  // Invalid configurations are reported per track
+  EXPECT_EQ(configs[2].trackId, 3u);
+  EXPECT_TRUE(configs[2].configPresent);
+  EXPECT_FALSE(configs[2].parseResult.isOk());
+  EXPECT_EQ(configs[2].configInfo, nullptr);
+}
+
+TEST(Mp4ConfigReaderTest, ReadsFile) {
+  ilo::ByteBuffer mp4 = file({track(7, {sampleEntry("mha2", mhaC(buildConfig()))})});
+  std::string path = ::testing::TempDir() + "mp4configreader_test.mp4";
+  {
+    std::ofstream out(path, std::ios::binary);
+    out.write(reinterpret_cast<const char*>(mp4.data()), static_cast<std::streamsize>(mp4.size()));
+  }
+
+  CMp4ConfigReader reader;
+  std::vector<SMhaTrackConfig> configs = reader.readFile(path);
+  ASSERT_EQ(configs.size(), 1u);
+  EXPECT_EQ(configs[0].trackId, 7u);
+  EXPECT_TRUE(configs[0].parseResult.isOk());
+  std::remove(path.c_str());
+}
+
+TEST(Mp4ConfigReaderTest, IgnoresFilesWithoutMovieBox) {
+  ilo::ByteBuffer mp4 = box("ftyp", {'m', 'p', '4', '2', 0, 0, 0, 0});
+  CMp4ConfigReader reader;
+  EXPECT_TRUE(reader.readBuffer(mp4.data(), mp4.size()).empty());
+  EXPECT_TRUE(reader.readBuffer(nullptr, 0).empty());
+}
+
+TEST(Mp4ConfigReaderTest, ThrowsOnMalformedBoxes) {
+  CMp4ConfigReader reader;
+
+  // A box claiming more bytes than available
+  ilo::ByteBuffer mp4 = file({track(1, {sampleEntry("mha1", mhaC(buildConfig()))})});
+  mp4.pop_back();
+  EXPECT_THROW(reader.readBuffer(mp4.data(), mp4.size()), std::runtime_error);
+
+  // The mhaC box is mandatory for mha1
+  mp4 = file({track(1, {sampleEntry("mha1", {})})});
+  EXPECT_THROW(reader.readBuffer(mp4.data(), mp4.size()), std::runtime_error);
+
+  // A config length beyond the mhaC box
+  ilo::ByteBuffer record = mhaC(buildConfig());
+  record[8 + 4] = 0xFF;
+  mp4 = file({track(1, {sampleEntry("mha1", record)})});
+  EXPECT_THROW(reader.readBuffer(mp4.data(), mp4.size()), std::runtime_error);
+}
@@ -0,0 +1,191 @@
+/*-----------------------------------------------------------------------------
+Software License for The Fraunhofer FDK MPEG-H Software
+
+Copyright (c) 2024 Fraunhofer-Gesellschaft zur Förderung der angewandten
+Forschung e.V. and Contributors
+All rights reserved.
+
+1. INTRODUCTION
+
+The "Fraunhofer FDK MPEG-H Software" is software that implements the ISO/MPEG
+MPEG-H 3D Audio standard for digital audio or related system features. Patent
+licenses for necessary patent claims for the Fraunhofer FDK MPEG-H Software
+(including those of Fraunhofer), for the use in commercial products and
+services, may be obtained from the respective patent owners individually and/or
+from Via LA (www.via-la.com).
+
+Fraunhofer supports the development of MPEG-H products and services by offering
+additional software, documentation, and technical advice. In addition, it
+operates the MPEG-H Trademark Program to ease interoperability testing of end-
+products. Please visit www.mpegh.com for more information.
+
+2. COPYRIGHT LICENSE
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted without payment of copyright license fees provided that you
+satisfy the following conditions:
+
+* You must retain the complete text of this software license in redistributions
+of the Fraunhofer FDK MPEG-H Software or your modifications thereto in source
+code form.
+
+* You must retain the complete text of this software license in the
+documentation and/or other materials provided with redistributions of
+the Fraunhofer FDK MPEG-H Software or your modifications thereto in binary form.
+You must make available free of charge copies of the complete source code of
+the Fraunhofer FDK MPEG-H Software and your modifications thereto to recipients
+of copies in binary form.
+
+* The name of Fraunhofer may not be used to endorse or promote products derived
+from the Fraunhofer FDK MPEG-H Software without prior written permission.
+
+* You may not charge copyright license fees for anyone to use, copy or
+distribute the Fraunhofer FDK MPEG-H Software or your modifications thereto.
+
+* Your modified versions of the Fraunhofer FDK MPEG-H Software must carry
+prominent notices stating that you changed the software and the date of any
+change. For modified versions of the Fraunhofer FDK MPEG-H Software, the term
+"Fraunhofer FDK MPEG-H Software" must be replaced by the term "Third-Party
+Modified Version of the Fraunhofer FDK MPEG-H Software".
+
+3. No PATENT LICENSE
+
+NO EXPRESS OR IMPLIED LICENSES TO ANY PATENT CLAIMS, including without
+limitation the patents of Fraunhofer, ARE GRANTED BY THIS SOFTWARE LICENSE.
+Fraunhofer provides no warranty of patent non-infringement with respect to this
+software. You may use this Fraunhofer FDK MPEG-H Software or modifications
+thereto only for purposes that are authorized by appropriate patent licenses.
+
+4. DISCLAIMER
+
+This Fraunhofer FDK MPEG-H Software is provided by Fraunhofer on behalf of the
+copyright holders and contributors "AS IS" and WITHOUT ANY EXPRESS OR IMPLIED
+WARRANTIES, including but not limited to the implied warranties of
+merchantability and fitness for a particular purpose. IN NO EVENT SHALL THE
+COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE for any direct, indirect,
+incidental, special, exemplary, or consequential damages, including but not
+limited to procurement of substitute goods or services; loss of use, data, or
+profits, or business interruption, however caused and on any theory of
+liability, whether in contract, strict liability, or tort (including
+negligence), arising in any way out of the use of this software, even if
+advised of the possibility of such damage.
+
+5. CONTACT INFORMATION
+
+Fraunhofer Institute for Integrated Circuits IIS
+Attention: Division Audio and Media Technologies - MPEG-H FDK
+Am Wolfsmantel 33
+91058 Erlangen, Germany
+www.iis.fraunhofer.de/amm
+amm-info@iis.fraunhofer.de
+-----------------------------------------------------------------------------*/
+// System includes
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// External includes
+#include "gtest/gtest.h"
+
+// Internal includes
+#include "mmtaudioparser/mpeghconfigvisitor.h"
+#include "mmtaudioparser/mpeghparser.h"
+#include "testutils.h"
+
+using namespace mmt::audioparser;
+using namespace mmt::audioparser::test;
+
+namespace {
+// Records the visited structures, optionally stopping after a number of them
+class CRecordingVisitor : public IMpeghConfigVisitor {
+ public:
+  explicit CRecordingVisitor(size_t stopAfter = SIZE_MAX) : m_stopAfter(stopAfter) {}
+
+  bool visitHeader(const SHeader& header) noexcept override {
+    return record("header " + std::to_string(header.samplingFrequency));
+  }
+  bool visitSpeakerLayout(const SSpeakerLayout& layout) noexcept override {
+    return record("layout " + std::to_string(layout.CICPIdx));
+  }
+  bool visitSignalGroup(const SSignalGroup& signalGroup) noexcept override {
+    return record("group " + std::to_string(signalGroup.numSignals));
+  }
+  bool visitElement(const SElement& element) noexcept override {
+    return record("element " + std::to_string(element.usacElementType));
+  }
+  bool visitConfigExtension(const SConfigExtension& configExtension) noexcept override {
+    return record("extension " + std::to_string(configExtension.usacConfigExtType));
+  }
+
+  std::vector<std::string> events;
+
+ private:
+  bool record(const std::string& event) noexcept {
+    events.push_back(event);
+    return events.size() < m_stopAfter;
+  }
+
+  size_t m_stopAfter;
+};
+
+// Counts the elements without allocating
+class CElementCounter : public IMpeghConfigVisitor {
+ public:
+  bool visitElement(const SElement& /*element*/) noexcept override {
+    ++numElements;
+    return true;
+  }
+
+  uint32_t numElements = 0;
+};
+
+SConfigSpec visitorSpec() {
+  SConfigSpec spec;
+  spec.signalGroups = {SSignalGroupSpec{0, 2}, SSignalGroupSpec{1, 1}};
+  spec.elements = {SElementSpec{ID_USAC_CPE}, SElementSpec{ID_USAC_SCE}};
+  spec.configExtensions = {SConfigExtensionSpec{0, {0xA5}}};
+  return spec;
+}
+}  // namespace
+
+TEST(MpeghConfigVisitorTest, ReportsStructuresInBitstreamOrder) {
+  ilo::ByteBuffer config = buildConfig(visitorSpec());
+  CRecordingVisitor visitor;
+  ASSERT_TRUE(CMpeghParser::scanConfig(config.data(), config.size(), visitor).isOk());
+  EXPECT_EQ(visitor.events,
+            (std::vector<std::string>{"header 48000", "layout 2", "group 2", "group 1",
+                                      "element 1", "element 0", "extension 0"}));
+}
+
+TEST(MpeghConfigVisitorTest, StopsWhenRequested) {
+  ilo::ByteBuffer config = buildConfig(visitorSpec());
+  CRecordingVisitor visitor(3);
+  SParseResult result = CMpeghParser::scanConfig(config.data(), config.size(), visitor);
+  EXPECT_EQ(result.error, EParseError::stopped);
+  EXPECT_EQ(visitor.events.size(), 3u);
+}
+
+TEST(MpeghConfigVisitorTest, ReportsInvalidConfigs) {
+  ilo::ByteBuffer config = buildConfig(visitorSpec());
+  CRecordingVisitor visitor;
+  SParseResult result = CMpeghParser::scanConfig(config.data(), 4, visitor);
+  EXPECT_EQ(result.error, EParseError::endOfBuffer);
+  // The structures decoded before the error have been reported
+  EXPECT_FALSE(visitor.events.empty());
+
+  CRecordingVisitor emptyVisitor;
+  EXPECT_EQ(CMpeghParser::scanConfig(nullptr, 0, emptyVisitor).error, EParseError::emptyBuffer);
+  EXPECT_TRUE(emptyVisitor.events.empty());
+}
+
+TEST(MpeghConfigVisitorTest, ScansWithoutAllocating) {
+  ilo::ByteBuffer config = buildConfig(visitorSpec());
+  CElementCounter counter;
+  SParseResult result;
+  {
+    CFailAllocations failAllocations;
+    result = CMpeghParser::scanConfig(config.data(), config.size(), counter);
+  }
+  EXPECT_TRUE(result.isOk());
+  EXPECT_EQ(counter.numElements, 2u);
+}
@@ -0,0 +1,176 @@
+/*-----------------------------------------------------------------------------
+Software License for The Fraunhofer FDK MPEG-H Software
+
+Copyright (c) 2024 Fraunhofer-Gesellschaft zur Förderung der angewandten
+Forschung e.V. and Contributors
+All rights reserved.
+
+1. INTRODUCTION
+
+The "Fraunhofer FDK MPEG-H Software" is software that implements the ISO/MPEG
+MPEG-H 3D Audio standard for digital audio or related system features. Patent
+licenses for necessary patent claims for the Fraunhofer FDK MPEG-H Software
+(including those of Fraunhofer), for the use in commercial products and
+services, may be obtained from the respective patent owners individually and/or
+from Via LA (www.via-la.com).
+
+Fraunhofer supports the development of MPEG-H products and services by offering
+additional software, documentation, and technical advice. In addition, it
+operates the MPEG-H Trademark Program to ease interoperability testing of end-
+products. Please visit www.mpegh.com for more information.
+
+2. COPYRIGHT LICENSE
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted without payment of copyright license fees provided that you
+satisfy the following conditions:
+
+* You must retain the complete text of this software license in redistributions
+of the Fraunhofer FDK MPEG-H Software or your modifications thereto in source
+code form.
+
+* You must retain the complete text of this software license in the
+documentation and/or other materials provided with redistributions of
+the Fraunhofer FDK MPEG-H Software or your modifications thereto in binary form.
+You must make available free of charge copies of the complete source code of
+the Fraunhofer FDK MPEG-H Software and your modifications thereto to recipients
+of copies in binary form.
+
+* The name of Fraunhofer may not be used to endorse or promote products derived
+from the Fraunhofer FDK MPEG-H Software without prior written permission.
+
+* You may not charge copyright license fees for anyone to use, copy or
+distribute the Fraunhofer FDK MPEG-H Software or your modifications thereto.
+
+* Your modified versions of the Fraunhofer FDK MPEG-H Software must carry
+prominent notices stating that you changed the software and the date of any
+change. For modified versions of the Fraunhofer FDK MPEG-H Software, the term
+"Fraunhofer FDK MPEG-H Software" must be replaced by the term "Third-Party
+Modified Version of the Fraunhofer FDK MPEG-H Software".
+
+3. No PATENT LICENSE
+
+NO EXPRESS OR IMPLIED LICENSES TO ANY PATENT CLAIMS, including without
+limitation the patents of Fraunhofer, ARE GRANTED BY THIS SOFTWARE LICENSE.
+Fraunhofer provides no warranty of patent non-infringement with respect to this
+software. You may use this Fraunhofer FDK MPEG-H Software or modifications
+thereto only for purposes that are authorized by appropriate patent licenses.
+
+4. DISCLAIMER
+
+This Fraunhofer FDK MPEG-H Software is provided by Fraunhofer on behalf of the
+copyright holders and contributors "AS IS" and WITHOUT ANY EXPRESS OR IMPLIED
+WARRANTIES, including but not limited to the implied warranties of
+merchantability and fitness for a particular purpose. IN NO EVENT SHALL THE
+COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE for any direct, indirect,
+incidental, special, exemplary, or consequential damages, including but not
+limited to procurement of substitute goods or services; loss of use, data, or
+profits, or business interruption, however caused and on any theory of
+liability, whether in contract, strict liability, or tort (including
+negligence), arising in any way out of the use of this software, even if
+advised of the possibility of such damage.
+
+5. CONTACT INFORMATION
+
+Fraunhofer Institute for Integrated Circuits IIS
+Attention: Division Audio and Media Technologies - MPEG-H FDK
+Am Wolfsmantel 33
+91058 Erlangen, Germany
+www.iis.fraunhofer.de/amm
+amm-info@iis.fraunhofer.de
+-----------------------------------------------------------------------------*/
+// System includes
+#include <cstdint>
+#include <vector>
+
+// External includes
+#include "gtest/gtest.h"
+
+// Internal includes
+#include "mmtaudioparser/mpeghdescriptor.h"
+#include "testutils.h"
+
+using namespace mmt::audioparser;
+using namespace mmt::audioparser::test;
+
+namespace {
+// profileLevelIndication 0x0D, interactivity, compatible sets 0x0B and 0x0C, CICP layout 6
+const ilo::ByteBuffer DESCRIPTOR_BODY = {0x0D, 0xC0, 0x06, 0x02, 0x0B, 0x0C};
+}  // namespace
+
+TEST(MpeghDescriptorTest, ParsesTsDescriptor) {
+  ilo::ByteBuffer data = {0x3F, static_cast<uint8_t>(DESCRIPTOR_BODY.size() + 1), 0x08};
+  data.insert(data.end(), DESCRIPTOR_BODY.begin(), DESCRIPTOR_BODY.end());
+
+  SMpegh3daDescriptor descriptor;
+  ASSERT_TRUE(CMpeghDescriptorParser::parseTsDescriptor(data.data(), data.size(), descriptor)
+                  .isOk());
+  EXPECT_EQ(descriptor.descriptorTag, 0x3F);
+  EXPECT_EQ(descriptor.profileLevelIndication, 0x0D);
+  EXPECT_TRUE(descriptor.interactivityEnabled);
+  EXPECT_EQ(descriptor.referenceChannelLayout, 6);
+  EXPECT_EQ(descriptor.compatibleSetIndications, (std::vector<uint8_t>{0x0B, 0x0C}));
+}
+
+TEST(MpeghDescriptorTest, RejectsOtherTsDescriptors) {
+  ilo::ByteBuffer data = {0x3F, static_cast<uint8_t>(DESCRIPTOR_BODY.size() + 1), 0x09};
+  data.insert(data.end(), DESCRIPTOR_BODY.begin(), DESCRIPTOR_BODY.end());
+  SMpegh3daDescriptor descriptor;
+  EXPECT_EQ(CMpeghDescriptorParser::parseTsDescriptor(data.data(), data.size(), descriptor).error,
+            EParseError::notSupported);
+
+  // The descriptor_length exceeds the data
+  data[1] = 0x20;
+  data[2] = 0x08;
+  SParseResult result =
+      CMpeghDescriptorParser::parseTsDescriptor(data.data(), data.size(), descriptor);
+  EXPECT_EQ(result.error, EParseError::endOfBuffer);
+  EXPECT_STREQ(result.syntaxElement, "descriptor_length");
+
+  EXPECT_EQ(CMpeghDescriptorParser::parseTsDescriptor(data.data(), 2, descriptor).error,
+            EParseError::endOfBuffer);
+}
+
+TEST(MpeghDescriptorTest, ParsesMmtDescriptor) {
+  ilo::ByteBuffer data = {0x80, 0x14, static_cast<uint8_t>(DESCRIPTOR_BODY.size())};
+  data.insert(data.end(), DESCRIPTOR_BODY.begin(), DESCRIPTOR_BODY.end());
+
+  SMpegh3daDescriptor descriptor;
+  ASSERT_TRUE(CMpeghDescriptorParser::parseMmtDescriptor(data.data(), data.size(), descriptor)
+                  .isOk());
+  EXPECT_EQ(descriptor.descriptorTag, 0x8014);
+  EXPECT_EQ(descriptor.referenceChannelLayout, 6);
+  EXPECT_EQ(descriptor.compatibleSetIndications.size(), 2u);
+
+  // The compatible sets signalled are cut off by the descriptor_length
+  data[2] = static_cast<uint8_t>(DESCRIPTOR_BODY.size() - 1);
+  SParseResult result =
+      CMpeghDescriptorParser::parseMmtDescriptor(data.data(), data.size(), descriptor);
+  EXPECT_EQ(result.error, EParseError::endOfBuffer);
+  EXPECT_EQ(result.bitOffset, 8u * (data.size() - 1));
+}
+
+TEST(MpeghDescriptorTest, ProvidesPreliminaryConfig) {
+  ilo::ByteBuffer data = {0x80, 0x14, static_cast<uint8_t>(DESCRIPTOR_BODY.size())};
+  data.insert(data.end(), DESCRIPTOR_BODY.begin(), DESCRIPTOR_BODY.end());
+  SMpegh3daDescriptor descriptor;
+  ASSERT_TRUE(CMpeghDescriptorParser::parseMmtDescriptor(data.data(), data.size(), descriptor)
+                  .isOk());
+
+  CMpeghParser::SConfigInfo info = CMpeghDescriptorParser::toConfigInfo(descriptor);
+  EXPECT_EQ(info.profileLevelIndicator, 0x0D);
+  EXPECT_EQ(info.referenceLayout.CICPIdx, 6);
+  // CICP layout 6 is 5.1
+  EXPECT_EQ(info.referenceLayout.numSpeakers, 6u);
+  EXPECT_EQ(info.compatibleProfileLevels, (std::vector<uint8_t>{0x0B, 0x0C}));
+
+  CMpeghParser parser;
+  parser.setPreliminaryConfig(info);
+  EXPECT_TRUE(parser.isPreliminaryConfig());
+  EXPECT_EQ(parser.getConfigInfo().referenceLayout.CICPIdx, 6);
+
+  // The in-band configuration replaces the preliminary one
+  parser.addConfig(buildConfig());
+  EXPECT_FALSE(parser.isPreliminaryConfig());
+  EXPECT_EQ(parser.getConfigInfo().referenceLayout.CICPIdx, 2);
+}
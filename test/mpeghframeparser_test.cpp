@@ -0,0 +1,276 @@
+/*-----------------------------------------------------------------------------
+Software License for The Fraunhofer FDK MPEG-H Software
+
+Copyright (c) 2024 Fraunhofer-Gesellschaft zur Förderung der angewandten
+Forschung e.V. and Contributors
+All rights reserved.
+
+1. INTRODUCTION
+
+The "Fraunhofer FDK MPEG-H Software" is software that implements the ISO/MPEG
+MPEG-H 3D Audio standard for digital audio or related system features. Patent
+licenses for necessary patent claims for the Fraunhofer FDK MPEG-H Software
+(including those of Fraunhofer), for the use in commercial products and
+services, may be obtained from the respective patent owners individually and/or
+from Via LA (www.via-la.com).
+
+Fraunhofer supports the development of MPEG-H products and services by offering
+additional software, documentation, and technical advice. In addition, it
+operates the MPEG-H Trademark Program to ease interoperability testing of end-
+products. Please visit www.mpegh.com for more information.
+
+2. COPYRIGHT LICENSE
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted without payment of copyright license fees provided that you
+satisfy the following conditions:
+
+* You must retain the complete text of this software license in redistributions
+of the Fraunhofer FDK MPEG-H Software or your modifications thereto in source
+code form.
+
+* You must retain the complete text of this software license in the
+documentation and/or other materials provided with redistributions of
+the Fraunhofer FDK MPEG-H Software or your modifications thereto in binary form.
+You must make available free of charge copies of the complete source code of
+the Fraunhofer FDK MPEG-H Software and your modifications thereto to recipients
+of copies in binary form.
+
+* The name of Fraunhofer may not be used to endorse or promote products derived
+from the Fraunhofer FDK MPEG-H Software without prior written permission.
+
+* You may not charge copyright license fees for anyone to use, copy or
+distribute the Fraunhofer FDK MPEG-H Software or your modifications thereto.
+
+* Your modified versions of the Fraunhofer FDK MPEG-H Software must carry
+prominent notices stating that you changed the software and the date of any
+change. For modified versions of the Fraunhofer FDK MPEG-H Software, the term
+"Fraunhofer FDK MPEG-H Software" must be replaced by the term "Third-Party
+Modified Version of the Fraunhofer FDK MPEG-H Software".
+
+3. No PATENT LICENSE
+
+NO EXPRESS OR IMPLIED LICENSES TO ANY PATENT CLAIMS, including without
+limitation the patents of Fraunhofer, ARE GRANTED BY THIS SOFTWARE LICENSE.
+Fraunhofer provides no warranty of patent non-infringement with respect to this
+software. You may use this Fraunhofer FDK MPEG-H Software or modifications
+thereto only for purposes that are authorized by appropriate patent licenses.
+
+4. DISCLAIMER
+
+This Fraunhofer FDK MPEG-H Software is provided by Fraunhofer on behalf of the
+copyright holders and contributors "AS IS" and WITHOUT ANY EXPRESS OR IMPLIED
+WARRANTIES, including but not limited to the implied warranties of
+merchantability and fitness for a particular purpose. IN NO EVENT SHALL THE
+COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE for any direct, indirect,
+incidental, special, exemplary, or consequential damages, including but not
+limited to procurement of substitute goods or services; loss of use, data, or
+profits, or business interruption, however caused and on any theory of
+liability, whether in contract, strict liability, or tort (including
+negligence), arising in any way out of the use of this software, even if
+advised of the possibility of such damage.
+
+5. CONTACT INFORMATION
+
+Fraunhofer Institute for Integrated Circuits IIS
+Attention: Division Audio and Media Technologies - MPEG-H FDK
+Am Wolfsmantel 33
+91058 Erlangen, Germany
+www.iis.fraunhofer.de/amm
+amm-info@iis.fraunhofer.de
+-----------------------------------------------------------------------------*/
+// System includes
+#include <memory>
+#include <vector>
+
+// External includes
+#include "gtest/gtest.h"
+
+// Internal includes
+#include "mmtaudioparser/mpeghframeparser.h"
+#include "testutils.h"
+
+using namespace mmt::audioparser;
+using namespace mmt::audioparser::test;
+
+namespace {
+constexpr uint32_t ID_EXT_ELE_AUDIOPREROLL = 3;
+
+// An AudioPreRoll element, a stereo group carried by a CPE and a stereo group carried by two SCEs
+SConfigSpec frameSpec() {
+  SConfigSpec spec;
+  spec.signalGroups = {SSignalGroupSpec{0, 2}, SSignalGroupSpec{0, 2}};
+  spec.elementLengthPresent = true;
+  SElementSpec preRoll;
+  preRoll.usacElementType = ID_USAC_EXT;
+  preRoll.extElementType = ID_EXT_ELE_AUDIOPREROLL;
+  spec.elements = {preRoll, SElementSpec{ID_USAC_CPE}, SElementSpec{ID_USAC_SCE},
+                   SElementSpec{ID_USAC_SCE}};
+  return spec;
+}
+
+std::shared_ptr<const CMpeghParser::SConfigInfo> parseConfigInfo(const SConfigSpec& spec) {
+  CMpeghParser parser;
+  parser.addConfig(buildConfig(spec));
+  return parser.getConfigSnapshot();
+}
+
+ilo::ByteBuffer buildSpecFrame(ilo::ByteBuffer preRollPayload = {}) {
+  SFrameElementSpec preRoll;
+  preRoll.extElement = true;
+  preRoll.extPayload = std::move(preRollPayload);
+  return buildFrame(true, {preRoll, SFrameElementSpec{20, 0xAA}, SFrameElementSpec{12, 0x55},
+                           SFrameElementSpec{4, 0xFF}});
+}
+}  // namespace
+
+TEST(MpeghFrameParserTest, SplitsFrameIntoElements) {
+  CMpeghFrameParser frameParser(parseConfigInfo(frameSpec()));
+  ilo::ByteBuffer frame = buildSpecFrame();
+  SFrameLayout layout;
+  ASSERT_TRUE(frameParser.splitFrame(frame.data(), frame.size(), layout).isOk());
+  EXPECT_TRUE(layout.usacIndependencyFlag);
+  ASSERT_EQ(layout.elements.size(), 4u);
+
+  // The absent extension element only holds its presence flag
+  const SFrameElement& preRoll = layout.elements[0];
+  EXPECT_FALSE(preRoll.present);
+  EXPECT_EQ(preRoll.signalGroupIdx, SFrameElement::NO_SIGNAL_GROUP);
+  EXPECT_EQ(preRoll.bitOffset, 1u);
+  EXPECT_EQ(preRoll.bitLength, 1u);
+
+  const SFrameElement& cpe = layout.elements[1];
+  EXPECT_EQ(cpe.elementIdx, 1u);
+  EXPECT_EQ(cpe.signalGroupIdx, 0u);
+  EXPECT_EQ(cpe.bitOffset, 2u);
+  EXPECT_EQ(cpe.bitLength, 36u);
+  EXPECT_EQ(cpe.payloadBitOffset, 18u);
+  EXPECT_EQ(cpe.payloadBitLength, 20u);
+
+  // Both SCEs carry the signals of the second group
+  EXPECT_EQ(layout.elements[2].signalGroupIdx, 1u);
+  EXPECT_EQ(layout.elements[2].bitOffset, 38u);
+  EXPECT_EQ(layout.elements[2].payloadBitLength, 12u);
+  EXPECT_EQ(layout.elements[3].signalGroupIdx, 1u);
+  EXPECT_EQ(layout.elements[3].bitOffset, 66u);
+  EXPECT_EQ(layout.elements[3].payloadBitLength, 4u);
+}
+
+TEST(MpeghFrameParserTest, SplitsPresentExtensionElements) {
+  CMpeghFrameParser frameParser(parseConfigInfo(frameSpec()));
+  ilo::ByteBuffer frame = buildSpecFrame(ilo::ByteBuffer(300, 0x11));
+  SFrameLayout layout;
+  ASSERT_TRUE(frameParser.splitFrame(frame.data(), frame.size(), layout).isOk());
+  ASSERT_EQ(layout.elements.size(), 4u);
+
+  // Presence and default length flags and the escaped 8 + 16 bit payload length
+  const SFrameElement& preRoll = layout.elements[0];
+  EXPECT_TRUE(preRoll.present);
+  EXPECT_EQ(preRoll.payloadBitOffset, 1u + 2u + 24u);
+  EXPECT_EQ(preRoll.payloadBitLength, 300u * 8u);
+  EXPECT_EQ(layout.elements[1].bitOffset, preRoll.payloadBitOffset + preRoll.payloadBitLength);
+}
+
+TEST(MpeghFrameParserTest, RequiresElementLengths) {
+  SConfigSpec spec = frameSpec();
+  spec.elementLengthPresent = false;
+  CMpeghFrameParser frameParser(parseConfigInfo(spec));
+  ilo::ByteBuffer frame = buildSpecFrame();
+  SFrameLayout layout;
+  SParseResult result = frameParser.splitFrame(frame.data(), frame.size(), layout);
+  EXPECT_EQ(result.error, EParseError::notSupported);
+  EXPECT_STREQ(result.syntaxElement, "elementLengthPresent");
+
+  EXPECT_THROW(CMpeghFrameParser{nullptr}, std::runtime_error);
+}
+
+TEST(MpeghFrameParserTest, ReportsTruncatedFrames) {
+  CMpeghFrameParser frameParser(parseConfigInfo(frameSpec()));
+  ilo::ByteBuffer frame = buildSpecFrame();
+  // The frame ends within the first SCE
+  frame.resize(5);
+  SFrameLayout layout;
+  SParseResult result = frameParser.splitFrame(frame.data(), frame.size(), layout);
+  EXPECT_EQ(result.error, EParseError::endOfBuffer);
+  EXPECT_STREQ(result.syntaxElement, "elementLength");
+  EXPECT_EQ(layout.elements.size(), 2u);
+
+  EXPECT_EQ(frameParser.splitFrame(nullptr, 10, layout).error, EParseError::endOfBuffer);
+}
+
+TEST(MpeghFrameParserTest, ParsesAudioPreRoll) {
+  ilo::ByteBuffer config = buildConfig(frameSpec());
+  std::vector<ilo::ByteBuffer> accessUnits = {buildSpecFrame(), buildSpecFrame()};
+  ilo::ByteBuffer frame = buildSpecFrame(buildAudioPreRoll(config, accessUnits, true));
+
+  CMpeghParser parser;
+  parser.addConfig(config);
+  CMpeghFrameParser frameParser(parser.getConfigSnapshot());
+  SFrameLayout layout;
+  ASSERT_TRUE(frameParser.splitFrame(frame.data(), frame.size(), layout).isOk());
+  SAudioPreRoll preRoll;
+  ASSERT_TRUE(frameParser.parseAudioPreRoll(frame.data(), frame.size(), layout, preRoll).isOk());
+  EXPECT_TRUE(preRoll.present);
+  EXPECT_TRUE(preRoll.applyCrossfade);
+  // The config follows the fields of the first element and the 4 bit configLen
+  ASSERT_LT(config.size(), 15u);
+  EXPECT_EQ(preRoll.config.bitOffset, 1u + 2u + 8u + 4u);
+  EXPECT_EQ(preRoll.config.bitLength, config.size() * 8);
+  ASSERT_EQ(preRoll.accessUnits.size(), 2u);
+
+  // The access units are split in place although they are not byte-aligned
+  SFrameLayout accessUnitLayout;
+  ASSERT_TRUE(frameParser.splitFrame(preRoll.accessUnits[1], accessUnitLayout).isOk());
+  ASSERT_EQ(accessUnitLayout.elements.size(), 4u);
+  EXPECT_EQ(accessUnitLayout.elements[1].bitOffset, preRoll.accessUnits[1].bitOffset + 2);
+  EXPECT_EQ(accessUnitLayout.elements[1].payloadBitLength, 20u);
+}
+
+TEST(MpeghFrameParserTest, RecognizesTheCurrentConfigInPreRoll) {
+  ilo::ByteBuffer config = buildConfig(frameSpec());
+  SConfigSpec otherSpec = frameSpec();
+  otherSpec.referenceLayoutCicpIdx = 6;
+  ilo::ByteBuffer otherConfig = buildConfig(otherSpec);
+
+  CMpeghParser parser;
+  parser.addConfig(config);
+  CMpeghFrameParser frameParser(parser.getConfigSnapshot());
+  SFrameLayout layout;
+  SAudioPreRoll preRoll;
+
+  ilo::ByteBuffer frame = buildSpecFrame(buildAudioPreRoll(config, {}));
+  ASSERT_TRUE(frameParser.splitFrame(frame.data(), frame.size(), layout).isOk());
+  ASSERT_TRUE(frameParser.parseAudioPreRoll(frame.data(), frame.size(), layout, preRoll).isOk());
+  EXPECT_TRUE(preRoll.accessUnits.empty());
+  ASSERT_TRUE(parser.tryAddConfig(preRoll.config).isOk());
+  EXPECT_FALSE(parser.hasConfigChanged());
+
+  frame = buildSpecFrame(buildAudioPreRoll(otherConfig, {}));
+  ASSERT_TRUE(frameParser.splitFrame(frame.data(), frame.size(), layout).isOk());
+  ASSERT_TRUE(frameParser.parseAudioPreRoll(frame.data(), frame.size(), layout, preRoll).isOk());
+  ASSERT_TRUE(parser.tryAddConfig(preRoll.config).isOk());
+  EXPECT_TRUE(parser.hasConfigChanged());
+  EXPECT_EQ(parser.getConfigInfo().referenceLayout.CICPIdx, 6u);
+}
+
+TEST(MpeghFrameParserTest, ReportsMissingAndTruncatedPreRoll) {
+  CMpeghFrameParser frameParser(parseConfigInfo(frameSpec()));
+  SFrameLayout layout;
+  SAudioPreRoll preRoll;
+
+  ilo::ByteBuffer frame = buildSpecFrame();
+  ASSERT_TRUE(frameParser.splitFrame(frame.data(), frame.size(), layout).isOk());
+  ASSERT_TRUE(frameParser.parseAudioPreRoll(frame.data(), frame.size(), layout, preRoll).isOk());
+  EXPECT_FALSE(preRoll.present);
+
+  // The access unit length exceeds the payload
+  ilo::ByteBuffer payload = buildAudioPreRoll(buildConfig(frameSpec()), {ilo::ByteBuffer(4, 0)});
+  payload.resize(payload.size() - 2);
+  frame = buildSpecFrame(payload);
+  ASSERT_TRUE(frameParser.splitFrame(frame.data(), frame.size(), layout).isOk());
+  SParseResult result = frameParser.parseAudioPreRoll(frame.data(), frame.size(), layout, preRoll);
+  EXPECT_EQ(result.error, EParseError::endOfBuffer);
+  EXPECT_STREQ(result.syntaxElement, "AudioPreRoll");
+  EXPECT_FALSE(preRoll.present);
+  EXPECT_TRUE(preRoll.accessUnits.empty());
+}
@@ -0,0 +1,483 @@
+/*-----------------------------------------------------------------------------
+Software License for The Fraunhofer FDK MPEG-H Software
+
+Copyright (c) 2024 Fraunhofer-Gesellschaft zur Förderung der angewandten
+Forschung e.V. and Contributors
+All rights reserved.
+
+1. INTRODUCTION
+
+The "Fraunhofer FDK MPEG-H Software" is software that implements the ISO/MPEG
+MPEG-H 3D Audio standard for digital audio or related system features. Patent
+licenses for necessary patent claims for the Fraunhofer FDK MPEG-H Software
+(including those of Fraunhofer), for the use in commercial products and
+services, may be obtained from the respective patent owners individually and/or
+from Via LA (www.via-la.com).
+
+Fraunhofer supports the development of MPEG-H products and services by offering
+additional software, documentation, and technical advice. In addition, it
+operates the MPEG-H Trademark Program to ease interoperability testing of end-
+products. Please visit www.mpegh.com for more information.
+
+2. COPYRIGHT LICENSE
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted without payment of copyright license fees provided that you
+satisfy the following conditions:
+
+* You must retain the complete text of this software license in redistributions
+of the Fraunhofer FDK MPEG-H Software or your modifications thereto in source
+code form.
+
+* You must retain the complete text of this software license in the
+documentation and/or other materials provided with redistributions of
+the Fraunhofer FDK MPEG-H Software or your modifications thereto in binary form.
+You must make available free of charge copies of the complete source code of
+the Fraunhofer FDK MPEG-H Software and your modifications thereto to recipients
+of copies in binary form.
+
+* The name of Fraunhofer may not be used to endorse or promote products derived
+from the Fraunhofer FDK MPEG-H Software without prior written permission.
+
+* You may not charge copyright license fees for anyone to use, copy or
+distribute the Fraunhofer FDK MPEG-H Software or your modifications thereto.
+
+* Your modified versions of the Fraunhofer FDK MPEG-H Software must carry
+prominent notices stating that you changed the software and the date of any
+change. For modified versions of the Fraunhofer FDK MPEG-H Software, the term
+"Fraunhofer FDK MPEG-H Software" must be replaced by the term "Third-Party
+Modified Version of the Fraunhofer FDK MPEG-H Software".
+
+3. No PATENT LICENSE
+
+NO EXPRESS OR IMPLIED LICENSES TO ANY PATENT CLAIMS, including without
+limitation the patents of Fraunhofer, ARE GRANTED BY THIS SOFTWARE LICENSE.
+Fraunhofer provides no warranty of patent non-infringement with respect to this
+software. You may use this Fraunhofer FDK MPEG-H Software or modifications
+thereto only for purposes that are authorized by appropriate patent licenses.
+
+4. DISCLAIMER
+
+This Fraunhofer FDK MPEG-H Software is provided by Fraunhofer on behalf of the
+copyright holders and contributors "AS IS" and WITHOUT ANY EXPRESS OR IMPLIED
+WARRANTIES, including but not limited to the implied warranties of
+merchantability and fitness for a particular purpose. IN NO EVENT SHALL THE
+COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE for any direct, indirect,
+incidental, special, exemplary, or consequential damages, including but not
+limited to procurement of substitute goods or services; loss of use, data, or
+profits, or business interruption, however caused and on any theory of
+liability, whether in contract, strict liability, or tort (including
+negligence), arising in any way out of the use of this software, even if
+advised of the possibility of such damage.
+
+5. CONTACT INFORMATION
+
+Fraunhofer Institute for Integrated Circuits IIS
+Attention: Division Audio and Media Technologies - MPEG-H FDK
+Am Wolfsmantel 33
+91058 Erlangen, Germany
+www.iis.fraunhofer.de/amm
+amm-info@iis.fraunhofer.de
+-----------------------------------------------------------------------------*/
+// System includes
+#include <atomic>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+// External includes
+#include "gtest/gtest.h"
+
+// Internal includes
+#include "mmtaudioparser/mpeghparser.h"
+#include "testutils.h"
+
+using namespace mmt::audioparser;
+using namespace mmt::audioparser::test;
+
+TEST(MpeghParserTest, TryAddConfigReportsOutOfMemory) {
+  ilo::ByteBuffer config = buildConfig();
+  CMpeghParser parser;
+  SParseResult result;
+  {
+    CFailAllocations failAllocations;
+    result = parser.tryAddConfig(config.data(), config.size());
+  }
+  EXPECT_EQ(result.error, EParseError::outOfMemory);
+  EXPECT_FALSE(parser.isValidConfig());
+
+  // The failed config is no candidate for skipping the parse of an identical one
+  EXPECT_TRUE(parser.tryAddConfig(config.data(), config.size()).isOk());
+  EXPECT_TRUE(parser.isValidConfig());
+  EXPECT_EQ(parser.getConfigInfo().samplingFrequency, 48000u);
+}
+
+TEST(MpeghParserTest, TryAddConfigOfBitViewReportsOutOfMemory) {
+  // Shift the config by 3 bits, so that it has to be copied to be byte-aligned
+  ilo::ByteBuffer config = buildConfig();
+  ilo::ByteBuffer shifted(config.size() + 1, 0);
+  for (size_t i = 0; i < config.size(); ++i) {
+    shifted[i] |= config[i] >> 3;
+    shifted[i + 1] |= static_cast<uint8_t>(config[i] << 5);
+  }
+  SBitView view;
+  view.data = shifted.data();
+  view.bitOffset = 3;
+  view.bitLength = 8 * config.size();
+
+  CMpeghParser parser;
+  SParseResult result;
+  {
+    CFailAllocations failAllocations;
+    result = parser.tryAddConfig(view);
+  }
+  EXPECT_EQ(result.error, EParseError::outOfMemory);
+  EXPECT_FALSE(parser.isValidConfig());
+  EXPECT_TRUE(parser.tryAddConfig(view).isOk());
+}
+
+TEST(MpeghParserTest, AddConfigFragmentReportsOutOfMemory) {
+  ilo::ByteBuffer config = buildConfig();
+  CMpeghParser parser;
+  SParseResult result;
+  {
+    CFailAllocations failAllocations;
+    result = parser.addConfigFragment(config.data(), config.size(), true);
+  }
+  EXPECT_EQ(result.error, EParseError::outOfMemory);
+  EXPECT_FALSE(parser.isValidConfig());
+  EXPECT_TRUE(parser.addConfigFragment(config.data(), config.size(), true).isOk());
+}
+
+TEST(MpeghParserTest, AddConfigThrowsBadAlloc) {
+  ilo::ByteBuffer config = buildConfig();
+  CMpeghParser parser;
+  bool thrown = false;
+  {
+    CFailAllocations failAllocations;
+    try {
+      parser.addConfig(config.data(), config.size());
+    } catch (const std::bad_alloc&) {
+      thrown = true;
+    }
+  }
+  EXPECT_TRUE(thrown);
+}
+
+TEST(MpeghParserTest, FailedDeferredParsingInvalidatesTheConfig) {
+  SConfigSpec spec;
+  // Signal group type 4 is reserved, which is only detected when parsing signals3d()
+  spec.signalGroups = {SSignalGroupSpec{4, 2}};
+  ilo::ByteBuffer config = buildConfig(spec);
+  CMpeghParser::SParserOptions options;
+  options.parseMode = CMpeghParser::EParseMode::headerOnly;
+  CMpeghParser parser(options);
+
+  ASSERT_TRUE(parser.tryAddConfig(config.data(), config.size()).isOk());
+  EXPECT_TRUE(parser.isValidConfig());
+  EXPECT_ANY_THROW(parser.getConfigInfo());
+  EXPECT_FALSE(parser.isValidConfig());
+
+  // The identical config is parsed again instead of being taken as the current valid one
+  SParseResult result = parser.tryAddConfig(config.data(), config.size());
+  EXPECT_TRUE(result.isOk());
+  EXPECT_TRUE(parser.hasConfigChanged());
+  EXPECT_ANY_THROW(parser.getConfigInfo());
+  EXPECT_FALSE(parser.isValidConfig());
+
+  ilo::ByteBuffer validConfig = buildConfig();
+  ASSERT_TRUE(parser.tryAddConfig(validConfig.data(), validConfig.size()).isOk());
+  EXPECT_EQ(parser.getConfigInfo().signalGroups.size(), 1u);
+}
+
+TEST(MpeghParserTest, ParsesConfigInPlace) {
+  // The config is embedded in a larger buffer, only its range is handed in
+  ilo::ByteBuffer config = buildConfig();
+  ilo::ByteBuffer buffer(3, 0xEE);
+  buffer.insert(buffer.end(), config.begin(), config.end());
+  buffer.resize(buffer.size() + 5, 0xEE);
+
+  CMpeghParser parser;
+  parser.addConfig(buffer.data() + 3, config.size());
+  ASSERT_TRUE(parser.isValidConfig());
+  EXPECT_EQ(parser.getConfigInfo().referenceLayout.CICPIdx, 2u);
+
+  // The bytes following the range are not part of the config
+  SParseResult result = parser.tryAddConfig(buffer.data() + 3, config.size() + 5);
+  EXPECT_EQ(result.error, EParseError::trailingData);
+  EXPECT_FALSE(parser.isValidConfig());
+
+  EXPECT_EQ(parser.tryAddConfig(nullptr, 0).error, EParseError::emptyBuffer);
+  EXPECT_THROW(parser.addConfig(buffer.data(), 2), std::runtime_error);
+}
+
+TEST(MpeghParserTest, SkipsIdenticalConfigs) {
+  ilo::ByteBuffer config = buildConfig();
+  SConfigSpec otherSpec;
+  otherSpec.referenceLayoutCicpIdx = 6;
+  ilo::ByteBuffer otherConfig = buildConfig(otherSpec);
+
+  CMpeghParser parser;
+  parser.addConfig(config);
+  EXPECT_TRUE(parser.hasConfigChanged());
+  const CMpeghParser::SConfigInfo* info = &parser.getConfigInfo();
+
+  // An identical copy keeps the extracted configuration
+  ilo::ByteBuffer copy = config;
+  parser.addConfig(copy);
+  EXPECT_FALSE(parser.hasConfigChanged());
+  EXPECT_EQ(&parser.getConfigInfo(), info);
+
+  parser.addConfig(otherConfig);
+  EXPECT_TRUE(parser.hasConfigChanged());
+  EXPECT_EQ(parser.getConfigInfo().referenceLayout.CICPIdx, 6u);
+
+  // An invalid config is no candidate for skipping, so the valid one is parsed again afterwards
+  EXPECT_FALSE(parser.tryAddConfig(otherConfig.data(), otherConfig.size() - 2).isOk());
+  parser.addConfig(otherConfig);
+  EXPECT_TRUE(parser.hasConfigChanged());
+  EXPECT_TRUE(parser.isValidConfig());
+}
+
+TEST(MpeghParserTest, ParsesHeaderOnlyUntilNeeded) {
+  SConfigSpec spec;
+  spec.referenceLayoutCicpIdx = 6;
+  ilo::ByteBuffer config = buildConfig(spec);
+  CMpeghParser::SParserOptions options;
+  options.parseMode = CMpeghParser::EParseMode::headerOnly;
+  CMpeghParser parser(options);
+
+  ASSERT_TRUE(parser.tryAddConfig(config.data(), config.size()).isOk());
+  CMpeghParser::SConfigHeader header = parser.getConfigHeader();
+  EXPECT_EQ(header.profileLevelIndicator, 0x0D);
+  EXPECT_EQ(header.samplingFrequency, 48000u);
+  EXPECT_EQ(header.referenceLayout.CICPIdx, 6u);
+
+  // The remaining structures are parsed by the first accessor needing them
+  EXPECT_EQ(parser.getConfigInfo().signalGroups.size(), 1u);
+  EXPECT_EQ(parser.getConfigInfo().numAudioChannels, 2u);
+  EXPECT_TRUE(parser.isValidConfig());
+
+  // Errors in the header are reported right away
+  spec.coreSbrFrameLengthIndex = 7;
+  config = buildConfig(spec);
+  SParseResult result = parser.tryAddConfig(config.data(), config.size());
+  EXPECT_EQ(result.error, EParseError::invalidValue);
+  EXPECT_STREQ(result.syntaxElement, "coreSbrFrameLengthIndex");
+  EXPECT_FALSE(parser.isValidConfig());
+}
+
+TEST(MpeghParserTest, ReportsAllElementTypes) {
+  SConfigSpec spec;
+  spec.signalGroups = {SSignalGroupSpec{0, 4}};
+  SElementSpec preRoll;
+  preRoll.usacElementType = ID_USAC_EXT;
+  preRoll.extElementType = 3;
+  SElementSpec extension;
+  extension.usacElementType = ID_USAC_EXT;
+  extension.extElementType = 7;
+  extension.extElementConfig = {0x12, 0x34};
+  spec.elements = {preRoll, SElementSpec{ID_USAC_CPE}, SElementSpec{ID_USAC_SCE},
+                   SElementSpec{ID_USAC_LFE}, extension};
+  ilo::ByteBuffer config = buildConfig(spec);
+
+  CMpeghParser parser;
+  ASSERT_TRUE(parser.tryAddConfig(config.data(), config.size()).isOk());
+  const CMpeghParser::SConfigInfo& info = parser.getConfigInfo();
+  EXPECT_TRUE(info.audioPreRollPresent);
+  ASSERT_EQ(info.elementConfigs.size(), 5u);
+  EXPECT_EQ(info.elementConfigs[0].usacElementType, static_cast<uint32_t>(ID_USAC_EXT));
+  EXPECT_EQ(info.elementConfigs[0].extElementType, 3u);
+  EXPECT_EQ(info.elementConfigs[1].usacElementType, static_cast<uint32_t>(ID_USAC_CPE));
+  EXPECT_EQ(info.elementConfigs[2].usacElementType, static_cast<uint32_t>(ID_USAC_SCE));
+  EXPECT_EQ(info.elementConfigs[3].usacElementType, static_cast<uint32_t>(ID_USAC_LFE));
+  EXPECT_EQ(info.elementConfigs[4].extElementType, 7u);
+  EXPECT_FALSE(info.elementConfigs[4].extElementPayloadFrag);
+
+  // The elements of the next config replace all previous ones
+  parser.addConfig(buildConfig());
+  ASSERT_EQ(parser.getConfigInfo().elementConfigs.size(), 1u);
+  EXPECT_EQ(parser.getConfigInfo().elementConfigs[0].usacElementType,
+            static_cast<uint32_t>(ID_USAC_CPE));
+}
+
+TEST(MpeghParserTest, CachesTheConfigInfo) {
+  CMpeghParser parser;
+  EXPECT_ANY_THROW(parser.getConfigInfo());
+
+  parser.addConfig(buildConfig());
+  const CMpeghParser::SConfigInfo& info = parser.getConfigInfo();
+  EXPECT_EQ(&parser.getConfigInfo(), &info);
+  // The snapshot shares the cached info
+  std::shared_ptr<const CMpeghParser::SConfigInfo> snapshot = parser.getConfigSnapshot();
+  EXPECT_EQ(snapshot.get(), &info);
+
+  // A changed config builds a new info, the snapshot of the previous one stays valid
+  SConfigSpec spec;
+  spec.referenceLayoutCicpIdx = 6;
+  parser.addConfig(buildConfig(spec));
+  EXPECT_EQ(parser.getConfigInfo().referenceLayout.CICPIdx, 6u);
+  EXPECT_EQ(snapshot->referenceLayout.CICPIdx, 2u);
+}
+
+TEST(MpeghParserTest, PublishesSnapshotsToConcurrentReaders) {
+  SConfigSpec spec;
+  spec.referenceLayoutCicpIdx = 6;
+  const ilo::ByteBuffer configs[] = {buildConfig(), buildConfig(spec)};
+  CMpeghParser::SParserOptions options;
+  options.publishSnapshots = true;
+  CMpeghParser parser(options);
+  EXPECT_ANY_THROW(parser.getConfigSnapshot());
+  parser.addConfig(configs[0]);
+
+  std::atomic<bool> done{false};
+  std::atomic<int> numInvalid{0};
+  std::vector<std::thread> readers;
+  for (int i = 0; i < 3; ++i) {
+    readers.emplace_back([&]() {
+      while (!done) {
+        std::shared_ptr<const CMpeghParser::SConfigInfo> snapshot = parser.getConfigSnapshot();
+        uint8_t layout = snapshot->referenceLayout.CICPIdx;
+        if (snapshot->signalGroups.size() != 1 || (layout != 2 && layout != 6)) {
+          ++numInvalid;
+        }
+      }
+    });
+  }
+  for (int i = 0; i < 1000; ++i) {
+    parser.addConfig(configs[i % 2]);
+  }
+  done = true;
+  for (auto& reader : readers) {
+    reader.join();
+  }
+  EXPECT_EQ(numInvalid.load(), 0);
+
+  // A failing config leaves the last valid snapshot published
+  std::shared_ptr<const CMpeghParser::SConfigInfo> snapshot = parser.getConfigSnapshot();
+  EXPECT_FALSE(parser.tryAddConfig(configs[0].data(), 3).isOk());
+  EXPECT_EQ(parser.getConfigSnapshot(), snapshot);
+}
+
+TEST(MpeghParserTest, ParsesConfigFragments) {
+  SConfigSpec spec;
+  spec.referenceLayoutCicpIdx = 6;
+  ilo::ByteBuffer config = buildConfig(spec);
+  CMpeghParser parser;
+  parser.addConfig(buildConfig());
+
+  // Byte-sized fragments, the last one completes the config
+  for (size_t i = 0; i + 1 < config.size(); ++i) {
+    ASSERT_TRUE(parser.addConfigFragment(&config[i], 1, false).isOk()) << "fragment " << i;
+    // The previous config is discarded by the first fragment
+    EXPECT_FALSE(parser.isValidConfig());
+  }
+  ASSERT_TRUE(parser.addConfigFragment(&config.back(), 1, true).isOk());
+  EXPECT_TRUE(parser.isValidConfig());
+  EXPECT_EQ(parser.getConfigInfo().referenceLayout.CICPIdx, 6u);
+
+  // An empty last fragment completes the config as well
+  ASSERT_TRUE(parser.addConfigFragment(config.data(), config.size(), false).isOk());
+  ASSERT_TRUE(parser.addConfigFragment(nullptr, 0, true).isOk());
+  EXPECT_TRUE(parser.isValidConfig());
+}
+
+TEST(MpeghParserTest, ReportsFragmentErrorsEarly) {
+  SConfigSpec spec;
+  spec.coreSbrFrameLengthIndex = 7;
+  ilo::ByteBuffer config = buildConfig(spec);
+  CMpeghParser parser;
+
+  // The invalid value is detected before the last fragment arrives
+  ASSERT_TRUE(parser.addConfigFragment(config.data(), 1, false).isOk());
+  SParseResult result = parser.addConfigFragment(config.data() + 1, config.size() - 2, false);
+  EXPECT_EQ(result.error, EParseError::invalidValue);
+  EXPECT_FALSE(parser.isValidConfig());
+
+  // A config missing its end is reported by the last fragment
+  ilo::ByteBuffer validConfig = buildConfig();
+  ASSERT_TRUE(parser.addConfigFragment(validConfig.data(), 3, false).isOk());
+  EXPECT_EQ(parser.addConfigFragment(nullptr, 0, true).error, EParseError::endOfBuffer);
+  EXPECT_FALSE(parser.isValidConfig());
+
+  // A complete config drops a config in progress
+  ASSERT_TRUE(parser.addConfigFragment(validConfig.data(), 3, false).isOk());
+  parser.addConfig(validConfig);
+  EXPECT_TRUE(parser.isValidConfig());
+}
+
+TEST(MpeghParserTest, ProfilesAgreeOnValidConfigs) {
+  SConfigSpec spec;
+  spec.signalGroups = {SSignalGroupSpec{0, 2}, SSignalGroupSpec{1, 1}};
+  spec.elements = {SElementSpec{ID_USAC_CPE}, SElementSpec{ID_USAC_SCE}};
+  spec.configExtensions = {SConfigExtensionSpec{0, {0xA5, 0xA5}}};
+  ilo::ByteBuffer config = buildConfig(spec);
+
+  CMpeghParser::SParserOptions options;
+  options.profile = CMpeghParser::EParserProfile::minimal;
+  CMpeghParser minimalParser(options);
+  CMpeghParser strictParser;
+  ASSERT_TRUE(minimalParser.tryAddConfig(config.data(), config.size()).isOk());
+  ASSERT_TRUE(strictParser.tryAddConfig(config.data(), config.size()).isOk());
+
+  const CMpeghParser::SConfigInfo& minimalInfo = minimalParser.getConfigInfo();
+  const CMpeghParser::SConfigInfo& strictInfo = strictParser.getConfigInfo();
+  EXPECT_EQ(minimalInfo.numAudioChannels, strictInfo.numAudioChannels);
+  EXPECT_EQ(minimalInfo.numAudioObjects, strictInfo.numAudioObjects);
+  EXPECT_EQ(minimalInfo.elementConfigs.size(), strictInfo.elementConfigs.size());
+  EXPECT_EQ(minimalInfo.configExtensions.size(), strictInfo.configExtensions.size());
+}
+
+TEST(MpeghParserTest, MinimalProfileSkipsConsistencyChecks) {
+  // A fill element must not carry a config
+  SConfigSpec spec;
+  SElementSpec fill;
+  fill.usacElementType = ID_USAC_EXT;
+  fill.extElementConfig = {0x00};
+  spec.elements = {SElementSpec{ID_USAC_CPE}, fill};
+  ilo::ByteBuffer config = buildConfig(spec);
+
+  CMpeghParser strictParser;
+  SParseResult result = strictParser.tryAddConfig(config.data(), config.size());
+  EXPECT_EQ(result.error, EParseError::invalidValue);
+  EXPECT_STREQ(result.syntaxElement, "usacExtElementConfigLength");
+
+  CMpeghParser::SParserOptions options;
+  options.profile = CMpeghParser::EParserProfile::minimal;
+  CMpeghParser minimalParser(options);
+  EXPECT_TRUE(minimalParser.tryAddConfig(config.data(), config.size()).isOk());
+  EXPECT_EQ(minimalParser.getConfigInfo().elementConfigs.size(), 2u);
+
+  // Trailing data is only rejected by the strict profile
+  ilo::ByteBuffer padded = buildConfig();
+  padded.push_back(0);
+  EXPECT_EQ(strictParser.tryAddConfig(padded.data(), padded.size()).error,
+            EParseError::trailingData);
+  EXPECT_TRUE(minimalParser.tryAddConfig(padded.data(), padded.size()).isOk());
+
+  // Errors preventing the parsing are still detected
+  result = minimalParser.tryAddConfig(padded.data(), 3);
+  EXPECT_EQ(result.error, EParseError::endOfBuffer);
+}
+
+TEST(MpeghParserTest, TryAddConfigReportsErrorPosition) {
+  SConfigSpec spec;
+  spec.coreSbrFrameLengthIndex = 7;
+  ilo::ByteBuffer config = buildConfig(spec);
+  CMpeghParser parser;
+  SParseResult result = parser.tryAddConfig(config.data(), config.size());
+  EXPECT_EQ(result.error, EParseError::invalidValue);
+  EXPECT_STREQ(result.syntaxElement, "coreSbrFrameLengthIndex");
+  // The value is checked after the two flags following it
+  EXPECT_EQ(result.bitOffset, 18u);
+  EXPECT_FALSE(parser.isValidConfig());
+
+  // A truncated config is reported at the start of the field crossing its end, the 6 bit
+  // CICPspeakerLayoutIdx
+  ilo::ByteBuffer validConfig = buildConfig();
+  result = parser.tryAddConfig(validConfig.data(), 3);
+  EXPECT_EQ(result.error, EParseError::endOfBuffer);
+  EXPECT_EQ(result.bitOffset, 20u);
+}
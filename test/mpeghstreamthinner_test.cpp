@@ -0,0 +1,275 @@
+/*-----------------------------------------------------------------------------
+Software License for The Fraunhofer FDK MPEG-H Software
+
+Copyright (c) 2024 Fraunhofer-Gesellschaft zur Förderung der angewandten
+Forschung e.V. and Contributors
+All rights reserved.
+
+1. INTRODUCTION
+
+The "Fraunhofer FDK MPEG-H Software" is software that implements the ISO/MPEG
+MPEG-H 3D Audio standard for digital audio or related system features. Patent
+licenses for necessary patent claims for the Fraunhofer FDK MPEG-H Software
+(including those of Fraunhofer), for the use in commercial products and
+services, may be obtained from the respective patent owners individually and/or
+from Via LA (www.via-la.com).
+
+Fraunhofer supports the development of MPEG-H products and services by offering
+additional software, documentation, and technical advice. In addition, it
+operates the MPEG-H Trademark Program to ease interoperability testing of end-
+products. Please visit www.mpegh.com for more information.
+
+2. COPYRIGHT LICENSE
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted without payment of copyright license fees provided that you
+satisfy the following conditions:
+
+* You must retain the complete text of this software license in redistributions
+of the Fraunhofer FDK MPEG-H Software or your modifications thereto in source
+code form.
+
+* You must retain the complete text of this software license in the
+documentation and/or other materials provided with redistributions of
+the Fraunhofer FDK MPEG-H Software or your modifications thereto in binary form.
+You must make available free of charge copies of the complete source code of
+the Fraunhofer FDK MPEG-H Software and your modifications thereto to recipients
+of copies in binary form.
+
+* The name of Fraunhofer may not be used to endorse or promote products derived
+from the Fraunhofer FDK MPEG-H Software without prior written permission.
+
+* You may not charge copyright license fees for anyone to use, copy or
+distribute the Fraunhofer FDK MPEG-H Software or your modifications thereto.
+
+* Your modified versions of the Fraunhofer FDK MPEG-H Software must carry
+prominent notices stating that you changed the software and the date of any
+change. For modified versions of the Fraunhofer FDK MPEG-H Software, the term
+"Fraunhofer FDK MPEG-H Software" must be replaced by the term "Third-Party
+Modified Version of the Fraunhofer FDK MPEG-H Software".
+
+3. No PATENT LICENSE
+
+NO EXPRESS OR IMPLIED LICENSES TO ANY PATENT CLAIMS, including without
+limitation the patents of Fraunhofer, ARE GRANTED BY THIS SOFTWARE LICENSE.
+Fraunhofer provides no warranty of patent non-infringement with respect to this
+software. You may use this Fraunhofer FDK MPEG-H Software or modifications
+thereto only for purposes that are authorized by appropriate patent licenses.
+
+4. DISCLAIMER
+
+This Fraunhofer FDK MPEG-H Software is provided by Fraunhofer on behalf of the
+copyright holders and contributors "AS IS" and WITHOUT ANY EXPRESS OR IMPLIED
+WARRANTIES, including but not limited to the implied warranties of
+merchantability and fitness for a particular purpose. IN NO EVENT SHALL THE
+COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE for any direct, indirect,
+incidental, special, exemplary, or consequential damages, including but not
+limited to procurement of substitute goods or services; loss of use, data, or
+profits, or business interruption, however caused and on any theory of
+liability, whether in contract, strict liability, or tort (including
+negligence), arising in any way out of the use of this software, even if
+advised of the possibility of such damage.
+
+5. CONTACT INFORMATION
+
+Fraunhofer Institute for Integrated Circuits IIS
+Attention: Division Audio and Media Technologies - MPEG-H FDK
+Am Wolfsmantel 33
+91058 Erlangen, Germany
+www.iis.fraunhofer.de/amm
+amm-info@iis.fraunhofer.de
+-----------------------------------------------------------------------------*/
+// System includes
+#include <vector>
+
+// External includes
+#include "gtest/gtest.h"
+
+// Internal includes
+#include "mmtaudioparser/mpeghstreamthinner.h"
+#include "testutils.h"
+
+using namespace mmt::audioparser;
+using namespace mmt::audioparser::test;
+
+namespace {
+// USAC configuration extension types of ISO/IEC 23008-3 table 14
+constexpr uint32_t ID_CONFIG_EXT_FILL = 0;
+constexpr uint32_t ID_CONFIG_EXT_DOWNMIX = 1;
+constexpr uint32_t ID_CONFIG_EXT_LOUDNESS_INFO = 2;
+constexpr uint32_t ID_CONFIG_EXT_AUDIOSCENE_INFO = 3;
+constexpr uint32_t ID_CONFIG_EXT_SIG_GROUP_INFO = 6;
+constexpr uint32_t ID_CONFIG_EXT_COMPATIBLE_PROFILELVL_SET = 7;
+constexpr uint32_t ID_EXT_ELE_AUDIOPREROLL = 3;
+
+// An AudioPreRoll element followed by two stereo signal groups carried by one CPE each
+SConfigSpec twoGroupSpec() {
+  SConfigSpec spec;
+  spec.signalGroups = {SSignalGroupSpec{0, 2}, SSignalGroupSpec{0, 2}};
+  spec.elementLengthPresent = true;
+  SElementSpec preRoll;
+  preRoll.usacElementType = ID_USAC_EXT;
+  preRoll.extElementType = ID_EXT_ELE_AUDIOPREROLL;
+  spec.elements = {preRoll, SElementSpec{}, SElementSpec{}};
+  spec.configExtensions = {SConfigExtensionSpec{ID_CONFIG_EXT_FILL, {0xA5}},
+                           SConfigExtensionSpec{ID_CONFIG_EXT_SIG_GROUP_INFO, {0x12}},
+                           SConfigExtensionSpec{ID_CONFIG_EXT_COMPATIBLE_PROFILELVL_SET,
+                                                {0x00, 0x0B}}};
+  return spec;
+}
+
+// The same config with the first signal group removed
+SConfigSpec thinnedSpec() {
+  SConfigSpec spec = twoGroupSpec();
+  spec.signalGroups.pop_back();
+  spec.elements.pop_back();
+  spec.configExtensions[1].payload = {0x20};
+  return spec;
+}
+
+SFrameElementSpec absentExtElement() {
+  SFrameElementSpec element;
+  element.extElement = true;
+  return element;
+}
+
+ilo::ByteBuffer twoGroupFrame(ilo::ByteBuffer preRollPayload = {}) {
+  SFrameElementSpec preRoll = absentExtElement();
+  preRoll.extPayload = std::move(preRollPayload);
+  return buildFrame(true, {preRoll, SFrameElementSpec{20, 0xAA}, SFrameElementSpec{12, 0x55}});
+}
+
+ilo::ByteBuffer thinnedFrame(ilo::ByteBuffer preRollPayload = {}) {
+  SFrameElementSpec preRoll = absentExtElement();
+  preRoll.extPayload = std::move(preRollPayload);
+  return buildFrame(true, {preRoll, SFrameElementSpec{12, 0x55}});
+}
+
+SParseResult rewrite(CMpeghStreamThinner& thinner, const ilo::ByteBuffer& config,
+                     ilo::ByteBuffer& thinnedConfig) {
+  return thinner.rewriteConfig(config.data(), config.size(), thinnedConfig);
+}
+}  // namespace
+
+TEST(MpeghStreamThinnerTest, RemovesSignalGroupFromConfigAndFrames) {
+  CMpeghStreamThinner thinner;
+  thinner.setRemovedSignalGroups({0});
+  ilo::ByteBuffer thinnedConfig;
+  ASSERT_TRUE(rewrite(thinner, buildConfig(twoGroupSpec()), thinnedConfig).isOk());
+  EXPECT_TRUE(thinner.isValidConfig());
+  EXPECT_EQ(thinnedConfig, buildConfig(thinnedSpec()));
+
+  ilo::ByteBuffer frame = twoGroupFrame();
+  ilo::ByteBuffer thinned;
+  ASSERT_TRUE(thinner.rewriteFrame(frame.data(), frame.size(), thinned).isOk());
+  EXPECT_EQ(thinned, thinnedFrame());
+
+  // The reduced config is a valid config of its own
+  CMpeghParser parser;
+  ASSERT_TRUE(parser.tryAddConfig(thinnedConfig.data(), thinnedConfig.size()).isOk());
+  EXPECT_EQ(parser.getConfigInfo().signalGroups.size(), 1u);
+}
+
+TEST(MpeghStreamThinnerTest, RewritesAudioPreRoll) {
+  ilo::ByteBuffer config = buildConfig(twoGroupSpec());
+  CMpeghStreamThinner thinner;
+  thinner.setRemovedSignalGroups({0});
+  ilo::ByteBuffer thinnedConfig;
+  ASSERT_TRUE(rewrite(thinner, config, thinnedConfig).isOk());
+
+  ilo::ByteBuffer frame = twoGroupFrame(buildAudioPreRoll(config, {twoGroupFrame()}));
+  ilo::ByteBuffer thinned;
+  ASSERT_TRUE(thinner.rewriteFrame(frame.data(), frame.size(), thinned).isOk());
+  EXPECT_EQ(thinned, thinnedFrame(buildAudioPreRoll(thinnedConfig, {thinnedFrame()})));
+
+  // Only the current config can be replaced in the AudioPreRoll
+  frame = twoGroupFrame(buildAudioPreRoll(buildConfig(), {}));
+  EXPECT_EQ(thinner.rewriteFrame(frame.data(), frame.size(), thinned).error,
+            EParseError::notSupported);
+}
+
+TEST(MpeghStreamThinnerTest, PassesStreamThroughWithoutRemovedGroups) {
+  ilo::ByteBuffer config = buildConfig(twoGroupSpec());
+  CMpeghStreamThinner thinner;
+  // Indices not present in the config are ignored
+  thinner.setRemovedSignalGroups({7});
+  ilo::ByteBuffer thinnedConfig;
+  ASSERT_TRUE(rewrite(thinner, config, thinnedConfig).isOk());
+  EXPECT_EQ(thinnedConfig, config);
+
+  ilo::ByteBuffer frame = twoGroupFrame();
+  ilo::ByteBuffer thinned;
+  ASSERT_TRUE(thinner.rewriteFrame(frame.data(), frame.size(), thinned).isOk());
+  EXPECT_EQ(thinned, frame);
+}
+
+TEST(MpeghStreamThinnerTest, AppliesNewSelectionToRepeatedConfig) {
+  ilo::ByteBuffer config = buildConfig(twoGroupSpec());
+  CMpeghStreamThinner thinner;
+  ilo::ByteBuffer thinnedConfig;
+  ASSERT_TRUE(rewrite(thinner, config, thinnedConfig).isOk());
+  EXPECT_EQ(thinnedConfig, config);
+
+  thinner.setRemovedSignalGroups({0});
+  ASSERT_TRUE(rewrite(thinner, config, thinnedConfig).isOk());
+  EXPECT_EQ(thinnedConfig, buildConfig(thinnedSpec()));
+  ASSERT_TRUE(rewrite(thinner, config, thinnedConfig).isOk());
+  EXPECT_EQ(thinnedConfig, buildConfig(thinnedSpec()));
+}
+
+TEST(MpeghStreamThinnerTest, RejectsRemovingAllGroups) {
+  CMpeghStreamThinner thinner;
+  thinner.setRemovedSignalGroups({0, 1});
+  ilo::ByteBuffer thinnedConfig;
+  EXPECT_EQ(rewrite(thinner, buildConfig(twoGroupSpec()), thinnedConfig).error,
+            EParseError::invalidValue);
+  EXPECT_FALSE(thinner.isValidConfig());
+  EXPECT_TRUE(thinnedConfig.empty());
+}
+
+TEST(MpeghStreamThinnerTest, RejectsInvalidConfig) {
+  CMpeghStreamThinner thinner;
+  ilo::ByteBuffer thinnedConfig;
+  EXPECT_EQ(rewrite(thinner, ilo::ByteBuffer{0x0D}, thinnedConfig).error,
+            EParseError::endOfBuffer);
+  EXPECT_FALSE(thinner.isValidConfig());
+}
+
+TEST(MpeghStreamThinnerTest, DropsAudioSceneInformation) {
+  SConfigSpec spec = twoGroupSpec();
+  spec.configExtensions.push_back(SConfigExtensionSpec{ID_CONFIG_EXT_AUDIOSCENE_INFO, {0x00}});
+  CMpeghStreamThinner thinner;
+  thinner.setRemovedSignalGroups({0});
+  ilo::ByteBuffer thinnedConfig;
+  ASSERT_TRUE(rewrite(thinner, buildConfig(spec), thinnedConfig).isOk());
+  EXPECT_EQ(thinnedConfig, buildConfig(thinnedSpec()));
+}
+
+TEST(MpeghStreamThinnerTest, RejectsConfigExtensionsReferringToSignals) {
+  // Loudness info refers to downmixes and presets, unknown extensions may refer to anything
+  for (uint32_t extType : {ID_CONFIG_EXT_DOWNMIX, ID_CONFIG_EXT_LOUDNESS_INFO, uint32_t{9}}) {
+    SConfigSpec spec = twoGroupSpec();
+    spec.configExtensions.push_back(SConfigExtensionSpec{extType, {0x00}});
+    ilo::ByteBuffer config = buildConfig(spec);
+    ilo::ByteBuffer thinnedConfig;
+
+    CMpeghStreamThinner thinner;
+    thinner.setRemovedSignalGroups({0});
+    EXPECT_EQ(rewrite(thinner, config, thinnedConfig).error, EParseError::notSupported)
+        << extType;
+
+    // Without removed groups the config is passed on unchanged
+    thinner.setRemovedSignalGroups({});
+    ASSERT_TRUE(rewrite(thinner, config, thinnedConfig).isOk()) << extType;
+    EXPECT_EQ(thinnedConfig, config);
+  }
+}
+
+TEST(MpeghStreamThinnerTest, RejectsElementsSpanningKeptAndRemovedGroups) {
+  SConfigSpec spec;
+  spec.signalGroups = {SSignalGroupSpec{0, 1}, SSignalGroupSpec{0, 1}};
+  CMpeghStreamThinner thinner;
+  thinner.setRemovedSignalGroups({1});
+  ilo::ByteBuffer thinnedConfig;
+  EXPECT_EQ(rewrite(thinner, buildConfig(spec), thinnedConfig).error, EParseError::notSupported);
+}
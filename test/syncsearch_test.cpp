@@ -0,0 +1,155 @@
+/*-----------------------------------------------------------------------------
+Software License for The Fraunhofer FDK MPEG-H Software
+
+Copyright (c) 2024 Fraunhofer-Gesellschaft zur Förderung der angewandten
+Forschung e.V. and Contributors
+All rights reserved.
+
+1. INTRODUCTION
+
+The "Fraunhofer FDK MPEG-H Software" is software that implements the ISO/MPEG
+MPEG-H 3D Audio standard for digital audio or related system features. Patent
+licenses for necessary patent claims for the Fraunhofer FDK MPEG-H Software
+(including those of Fraunhofer), for the use in commercial products and
+services, may be obtained from the respective patent owners individually and/or
+from Via LA (www.via-la.com).
+
+Fraunhofer supports the development of MPEG-H products and services by offering
+additional software, documentation, and technical advice. In addition, it
+operates the MPEG-H Trademark Program to ease interoperability testing of end-
+products. Please visit www.mpegh.com for more information.
+
+2. COPYRIGHT LICENSE
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted without payment of copyright license fees provided that you
+satisfy the following conditions:
+
+* You must retain the complete text of this software license in redistributions
+of the Fraunhofer FDK MPEG-H Software or your modifications thereto in source
+code form.
+
+* You must retain the complete text of this software license in the
+documentation and/or other materials provided with redistributions of
+the Fraunhofer FDK MPEG-H Software or your modifications thereto in binary form.
+You must make available free of charge copies of the complete source code of
+the Fraunhofer FDK MPEG-H Software and your modifications thereto to recipients
+of copies in binary form.
+
+* The name of Fraunhofer may not be used to endorse or promote products derived
+from the Fraunhofer FDK MPEG-H Software without prior written permission.
+
+* You may not charge copyright license fees for anyone to use, copy or
+distribute the Fraunhofer FDK MPEG-H Software or your modifications thereto.
+
+* Your modified versions of the Fraunhofer FDK MPEG-H Software must carry
+prominent notices stating that you changed the software and the date of any
+change. For modified versions of the Fraunhofer FDK MPEG-H Software, the term
+"Fraunhofer FDK MPEG-H Software" must be replaced by the term "Third-Party
+Modified Version of the Fraunhofer FDK MPEG-H Software".
+
+3. No PATENT LICENSE
+
+NO EXPRESS OR IMPLIED LICENSES TO ANY PATENT CLAIMS, including without
+limitation the patents of Fraunhofer, ARE GRANTED BY THIS SOFTWARE LICENSE.
+Fraunhofer provides no warranty of patent non-infringement with respect to this
+software. You may use this Fraunhofer FDK MPEG-H Software or modifications
+thereto only for purposes that are authorized by appropriate patent licenses.
+
+4. DISCLAIMER
+
+This Fraunhofer FDK MPEG-H Software is provided by Fraunhofer on behalf of the
+copyright holders and contributors "AS IS" and WITHOUT ANY EXPRESS OR IMPLIED
+WARRANTIES, including but not limited to the implied warranties of
+merchantability and fitness for a particular purpose. IN NO EVENT SHALL THE
+COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE for any direct, indirect,
+incidental, special, exemplary, or consequential damages, including but not
+limited to procurement of substitute goods or services; loss of use, data, or
+profits, or business interruption, however caused and on any theory of
+liability, whether in contract, strict liability, or tort (including
+negligence), arising in any way out of the use of this software, even if
+advised of the possibility of such damage.
+
+5. CONTACT INFORMATION
+
+Fraunhofer Institute for Integrated Circuits IIS
+Attention: Division Audio and Media Technologies - MPEG-H FDK
+Am Wolfsmantel 33
+91058 Erlangen, Germany
+www.iis.fraunhofer.de/amm
+amm-info@iis.fraunhofer.de
+-----------------------------------------------------------------------------*/
+// System includes
+#include <cstdint>
+
+// External includes
+#include "gtest/gtest.h"
+
+// Internal includes
+#include "mmtaudioparser/mhasparser.h"
+#include "syncsearch.h"
+#include "testutils.h"
+
+using namespace mmt::audioparser;
+using namespace mmt::audioparser::test;
+using namespace mmt::audioparser::utils;
+
+TEST(SyncSearchTest, FindsTheFirstCandidateAtEveryPosition) {
+  // Covers the vector loops as well as the scalar tail for all positions
+  for (size_t size = 0; size <= 80; ++size) {
+    for (size_t position = 0; position + MHAS_SYNC_PACKET_SIZE <= size; ++position) {
+      ilo::ByteBuffer data(size, 0xC0);
+      data[position + 1] = 0x01;
+      data[position + 2] = 0xA5;
+      ASSERT_EQ(findSyncCandidate(data.data(), data.size()), position) << "size " << size;
+    }
+    ilo::ByteBuffer noSync(size, 0xC0);
+    EXPECT_EQ(findSyncCandidate(noSync.data(), noSync.size()), size);
+  }
+  EXPECT_EQ(findSyncCandidate(nullptr, 10), 10u);
+}
+
+TEST(SyncSearchTest, IgnoresSplitPatterns) {
+  ilo::ByteBuffer data(64, 0x00);
+  data[30] = 0xC0;
+  data[31] = 0x01;
+  // The pattern cut off by the end of the data is no candidate
+  data[62] = 0xC0;
+  data[63] = 0x01;
+  EXPECT_EQ(findSyncCandidate(data.data(), data.size()), 64u);
+}
+
+TEST(SyncSearchTest, FindsConfirmedSyncPackets) {
+  ilo::ByteBuffer stream(40, 0x00);
+  // A pattern followed by reserved packet type 4 is rejected
+  stream.insert(stream.end(), {0xC0, 0x01, 0xA5, 0x80, 0x00});
+  size_t syncOffset = stream.size();
+  appendSyncPacket(stream);
+  appendMhasPacket(stream, EMhasPacketType::PACTYP_MPEGH3DACFG, 1, buildConfig());
+  appendMhasPacket(stream, EMhasPacketType::PACTYP_MPEGH3DAFRAME, 1, buildDummyFrame(true));
+
+  EXPECT_EQ(CMhasParser::findSyncPacket(stream.data(), stream.size()), syncOffset);
+  // Packets cut off by the end of the buffer do not reject the candidate
+  EXPECT_EQ(CMhasParser::findSyncPacket(stream.data(), syncOffset + 5), syncOffset);
+}
+
+TEST(SyncSearchTest, ResynchronizesTheParser) {
+  ilo::ByteBuffer stream(100, 0x5A);
+  size_t syncOffset = stream.size();
+  appendSyncPacket(stream);
+  appendMhasPacket(stream, EMhasPacketType::PACTYP_MPEGH3DACFG, 1, buildConfig());
+
+  CMhasParser parser;
+  parser.setBuffer(stream.data(), stream.size());
+  ASSERT_TRUE(parser.resync().isOk());
+  EXPECT_EQ(parser.bytesConsumed(), syncOffset);
+  SMhasPacket packet;
+  ASSERT_TRUE(parser.nextPacket(packet).isOk());
+  EXPECT_EQ(packet.packetType, EMhasPacketType::PACTYP_SYNC);
+
+  // Without a SYNC packet, only the bytes which may start one are kept
+  ilo::ByteBuffer noSync(100, 0x5A);
+  parser.setBuffer(noSync.data(), noSync.size());
+  EXPECT_EQ(parser.resync().error, EParseError::endOfBuffer);
+  EXPECT_EQ(parser.bytesConsumed(), noSync.size() - (MHAS_SYNC_PACKET_SIZE - 1));
+}
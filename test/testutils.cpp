@@ -0,0 +1,271 @@
+/*-----------------------------------------------------------------------------
+Software License for The Fraunhofer FDK MPEG-H Software
+
+Copyright (c) 2024 Fraunhofer-Gesellschaft zur Förderung der angewandten
+Forschung e.V. and Contributors
+All rights reserved.
+
+1. INTRODUCTION
+
+The "Fraunhofer FDK MPEG-H Software" is software that implements the ISO/MPEG
+MPEG-H 3D Audio standard for digital audio or related system features. Patent
+licenses for necessary patent claims for the Fraunhofer FDK MPEG-H Software
+(including those of Fraunhofer), for the use in commercial products and
+services, may be obtained from the respective patent owners individually and/or
+from Via LA (www.via-la.com).
+
+Fraunhofer supports the development of MPEG-H products and services by offering
+additional software, documentation, and technical advice. In addition, it
+operates the MPEG-H Trademark Program to ease interoperability testing of end-
+products. Please visit www.mpegh.com for more information.
+
+2. COPYRIGHT LICENSE
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted without payment of copyright license fees provided that you
+satisfy the following conditions:
+
+* You must retain the complete text of this software license in redistributions
+of the Fraunhofer FDK MPEG-H Software or your modifications thereto in source
+code form.
+
+* You must retain the complete text of this software license in the
+documentation and/or other materials provided with redistributions of
+the Fraunhofer FDK MPEG-H Software or your modifications thereto in binary form.
+You must make available free of charge copies of the complete source code of
+the Fraunhofer FDK MPEG-H Software and your modifications thereto to recipients
+of copies in binary form.
+
+* The name of Fraunhofer may not be used to endorse or promote products derived
+from the Fraunhofer FDK MPEG-H Software without prior written permission.
+
+* You may not charge copyright license fees for anyone to use, copy or
+distribute the Fraunhofer FDK MPEG-H Software or your modifications thereto.
+
+* Your modified versions of the Fraunhofer FDK MPEG-H Software must carry
+prominent notices stating that you changed the software and the date of any
+change. For modified versions of the Fraunhofer FDK MPEG-H Software, the term
+"Fraunhofer FDK MPEG-H Software" must be replaced by the term "Third-Party
+Modified Version of the Fraunhofer FDK MPEG-H Software".
+
+3. No PATENT LICENSE
+
+NO EXPRESS OR IMPLIED LICENSES TO ANY PATENT CLAIMS, including without
+limitation the patents of Fraunhofer, ARE GRANTED BY THIS SOFTWARE LICENSE.
+Fraunhofer provides no warranty of patent non-infringement with respect to this
+software. You may use this Fraunhofer FDK MPEG-H Software or modifications
+thereto only for purposes that are authorized by appropriate patent licenses.
+
+4. DISCLAIMER
+
+This Fraunhofer FDK MPEG-H Software is provided by Fraunhofer on behalf of the
+copyright holders and contributors "AS IS" and WITHOUT ANY EXPRESS OR IMPLIED
+WARRANTIES, including but not limited to the implied warranties of
+merchantability and fitness for a particular purpose. IN NO EVENT SHALL THE
+COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE for any direct, indirect,
+incidental, special, exemplary, or consequential damages, including but not
+limited to procurement of substitute goods or services; loss of use, data, or
+profits, or business interruption, however caused and on any theory of
+liability, whether in contract, strict liability, or tort (including
+negligence), arising in any way out of the use of this software, even if
+advised of the possibility of such damage.
+
+5. CONTACT INFORMATION
+
+Fraunhofer Institute for Integrated Circuits IIS
+Attention: Division Audio and Media Technologies - MPEG-H FDK
+Am Wolfsmantel 33
+91058 Erlangen, Germany
+www.iis.fraunhofer.de/amm
+amm-info@iis.fraunhofer.de
+-----------------------------------------------------------------------------*/
+// System includes
+#include <cstdlib>
+#include <new>
+
+// External includes
+
+// Internal includes
+#include "testutils.h"
+#include "bitwriter.h"
+
+namespace {
+thread_local bool failAllocations = false;
+}  // namespace
+
+void* operator new(std::size_t size) {
+  void* memory = failAllocations ? nullptr : std::malloc(size != 0 ? size : 1);
+  if (memory == nullptr) {
+    throw std::bad_alloc();
+  }
+  return memory;
+}
+
+void operator delete(void* memory) noexcept {
+  std::free(memory);
+}
+
+void operator delete(void* memory, std::size_t) noexcept {
+  std::free(memory);
+}
+
+namespace mmt {
+namespace audioparser {
+namespace test {
+CFailAllocations::CFailAllocations() noexcept {
+  failAllocations = true;
+}
+
+CFailAllocations::~CFailAllocations() {
+  failAllocations = false;
+}
+
+ilo::ByteBuffer buildConfig(const SConfigSpec& spec) {
+  ilo::ByteBuffer config;
+  utils::CBitWriter writer(config);
+  writer.write(spec.profileLevelIndicator, 8);
+  writer.write(spec.samplingFrequencyIndex, 5);
+  writer.write(spec.coreSbrFrameLengthIndex, 3);
+  // cfg_reserved, receiverDelayCompensation
+  writer.write(0, 2);
+  // speakerConfig3d() with speakerLayoutType 0
+  writer.write(0, 2);
+  writer.write(spec.referenceLayoutCicpIdx, 6);
+
+  writer.write(static_cast<uint32_t>(spec.signalGroups.size() - 1), 5);
+  for (const auto& signalGroup : spec.signalGroups) {
+    writer.write(signalGroup.signalGroupType, 3);
+    writer.writeEscapedValue(signalGroup.numSignals - 1, 5, 8, 16);
+    // differsFromReferenceLayout, saocDmxLayoutPresent
+    if (signalGroup.signalGroupType == 0 || signalGroup.signalGroupType == 2) {
+      writer.writeBool(false);
+    }
+  }
+
+  writer.writeEscapedValue(static_cast<uint32_t>(spec.elements.size() - 1), 4, 8, 16);
+  writer.writeBool(spec.elementLengthPresent);
+  for (const auto& element : spec.elements) {
+    writer.write(element.usacElementType, 2);
+    switch (element.usacElementType) {
+      case ID_USAC_SCE:
+        // tw_mdct, fullbandLpd, noiseFilling, enhancedNoiseFilling
+        writer.write(0, 4);
+        break;
+      case ID_USAC_CPE:
+        // Core config, qceIndex, shiftIndex1, lpdStereoIndex
+        writer.write(0, 4);
+        writer.write(0, 2);
+        writer.write(0, 1);
+        writer.write(0, 1);
+        break;
+      case ID_USAC_LFE:
+        break;
+      default:
+        writer.writeEscapedValue(element.extElementType, 4, 8, 16);
+        writer.writeEscapedValue(static_cast<uint32_t>(element.extElementConfig.size()), 4, 8, 16);
+        // usacExtElementDefaultLengthPresent, usacExtElementPayloadFrag
+        writer.write(0, 2);
+        for (uint8_t byte : element.extElementConfig) {
+          writer.write(byte, 8);
+        }
+        break;
+    }
+  }
+
+  writer.writeBool(!spec.configExtensions.empty());
+  if (!spec.configExtensions.empty()) {
+    writer.writeEscapedValue(static_cast<uint32_t>(spec.configExtensions.size() - 1), 2, 4, 8);
+    for (const auto& configExtension : spec.configExtensions) {
+      writer.writeEscapedValue(configExtension.usacConfigExtType, 4, 8, 16);
+      writer.writeEscapedValue(static_cast<uint32_t>(configExtension.payload.size()), 4, 8, 16);
+      for (uint8_t byte : configExtension.payload) {
+        writer.write(byte, 8);
+      }
+    }
+  }
+  writer.byteAlign();
+  return config;
+}
+
+void appendMhasPacket(ilo::ByteBuffer& stream, EMhasPacketType packetType, uint32_t packetLabel,
+                      const ilo::ByteBuffer& payload) {
+  ilo::ByteBuffer header;
+  utils::CBitWriter writer(header);
+  writer.writeEscapedValue(static_cast<uint32_t>(packetType), 3, 8, 8);
+  writer.writeEscapedValue(packetLabel, 2, 8, 32);
+  writer.writeEscapedValue(static_cast<uint32_t>(payload.size()), 11, 24, 24);
+  writer.byteAlign();
+  stream.insert(stream.end(), header.begin(), header.end());
+  stream.insert(stream.end(), payload.begin(), payload.end());
+}
+
+void appendSyncPacket(ilo::ByteBuffer& stream) {
+  appendMhasPacket(stream, EMhasPacketType::PACTYP_SYNC, 0, ilo::ByteBuffer{0xA5});
+}
+
+ilo::ByteBuffer buildFrame(bool usacIndependencyFlag,
+                           const std::vector<SFrameElementSpec>& elements) {
+  ilo::ByteBuffer frame;
+  utils::CBitWriter writer(frame);
+  writer.writeBool(usacIndependencyFlag);
+  for (const auto& element : elements) {
+    if (!element.extElement) {
+      writer.write(element.payloadBits, 16);
+      for (uint32_t bit = 0; bit < element.payloadBits; ++bit) {
+        writer.write(element.fill >> (7 - bit % 8), 1);
+      }
+      continue;
+    }
+
+    writer.writeBool(!element.extPayload.empty());
+    if (element.extPayload.empty()) {
+      continue;
+    }
+    // usacExtElementUseDefaultLength
+    writer.writeBool(false);
+    auto payloadLength = static_cast<uint32_t>(element.extPayload.size());
+    if (payloadLength < 255) {
+      writer.write(payloadLength, 8);
+    } else {
+      writer.write(255, 8);
+      writer.write(payloadLength - 253, 16);
+    }
+    for (uint8_t byte : element.extPayload) {
+      writer.write(byte, 8);
+    }
+  }
+  writer.byteAlign();
+  return frame;
+}
+
+ilo::ByteBuffer buildAudioPreRoll(const ilo::ByteBuffer& config,
+                                  const std::vector<ilo::ByteBuffer>& accessUnits,
+                                  bool applyCrossfade) {
+  ilo::ByteBuffer payload;
+  utils::CBitWriter writer(payload);
+  writer.writeEscapedValue(static_cast<uint32_t>(config.size()), 4, 4, 8);
+  for (uint8_t byte : config) {
+    writer.write(byte, 8);
+  }
+  writer.writeBool(applyCrossfade);
+  // reserved
+  writer.writeBool(false);
+  writer.writeEscapedValue(static_cast<uint32_t>(accessUnits.size()), 2, 4, 0);
+  for (const auto& accessUnit : accessUnits) {
+    writer.writeEscapedValue(static_cast<uint32_t>(accessUnit.size()), 16, 16, 0);
+    for (uint8_t byte : accessUnit) {
+      writer.write(byte, 8);
+    }
+  }
+  writer.byteAlign();
+  return payload;
+}
+
+ilo::ByteBuffer buildDummyFrame(bool independent, size_t size) {
+  ilo::ByteBuffer frame(size, 0x11);
+  frame[0] = independent ? 0x80 : 0x00;
+  return frame;
+}
+}  // namespace test
+}  // namespace audioparser
+}  // namespace mmt
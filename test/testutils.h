@@ -0,0 +1,192 @@
+/*-----------------------------------------------------------------------------
+Software License for The Fraunhofer FDK MPEG-H Software
+
+Copyright (c) 2024 Fraunhofer-Gesellschaft zur Förderung der angewandten
+Forschung e.V. and Contributors
+All rights reserved.
+
+1. INTRODUCTION
+
+The "Fraunhofer FDK MPEG-H Software" is software that implements the ISO/MPEG
+MPEG-H 3D Audio standard for digital audio or related system features. Patent
+licenses for necessary patent claims for the Fraunhofer FDK MPEG-H Software
+(including those of Fraunhofer), for the use in commercial products and
+services, may be obtained from the respective patent owners individually and/or
+from Via LA (www.via-la.com).
+
+Fraunhofer supports the development of MPEG-H products and services by offering
+additional software, documentation, and technical advice. In addition, it
+operates the MPEG-H Trademark Program to ease interoperability testing of end-
+products. Please visit www.mpegh.com for more information.
+
+2. COPYRIGHT LICENSE
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted without payment of copyright license fees provided that you
+satisfy the following conditions:
+
+* You must retain the complete text of this software license in redistributions
+of the Fraunhofer FDK MPEG-H Software or your modifications thereto in source
+code form.
+
+* You must retain the complete text of this software license in the
+documentation and/or other materials provided with redistributions of
+the Fraunhofer FDK MPEG-H Software or your modifications thereto in binary form.
+You must make available free of charge copies of the complete source code of
+the Fraunhofer FDK MPEG-H Software and your modifications thereto to recipients
+of copies in binary form.
+
+* The name of Fraunhofer may not be used to endorse or promote products derived
+from the Fraunhofer FDK MPEG-H Software without prior written permission.
+
+* You may not charge copyright license fees for anyone to use, copy or
+distribute the Fraunhofer FDK MPEG-H Software or your modifications thereto.
+
+* Your modified versions of the Fraunhofer FDK MPEG-H Software must carry
+prominent notices stating that you changed the software and the date of any
+change. For modified versions of the Fraunhofer FDK MPEG-H Software, the term
+"Fraunhofer FDK MPEG-H Software" must be replaced by the term "Third-Party
+Modified Version of the Fraunhofer FDK MPEG-H Software".
+
+3. No PATENT LICENSE
+
+NO EXPRESS OR IMPLIED LICENSES TO ANY PATENT CLAIMS, including without
+limitation the patents of Fraunhofer, ARE GRANTED BY THIS SOFTWARE LICENSE.
+Fraunhofer provides no warranty of patent non-infringement with respect to this
+software. You may use this Fraunhofer FDK MPEG-H Software or modifications
+thereto only for purposes that are authorized by appropriate patent licenses.
+
+4. DISCLAIMER
+
+This Fraunhofer FDK MPEG-H Software is provided by Fraunhofer on behalf of the
+copyright holders and contributors "AS IS" and WITHOUT ANY EXPRESS OR IMPLIED
+WARRANTIES, including but not limited to the implied warranties of
+merchantability and fitness for a particular purpose. IN NO EVENT SHALL THE
+COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE for any direct, indirect,
+incidental, special, exemplary, or consequential damages, including but not
+limited to procurement of substitute goods or services; loss of use, data, or
+profits, or business interruption, however caused and on any theory of
+liability, whether in contract, strict liability, or tort (including
+negligence), arising in any way out of the use of this software, even if
+advised of the possibility of such damage.
+
+5. CONTACT INFORMATION
+
+Fraunhofer Institute for Integrated Circuits IIS
+Attention: Division Audio and Media Technologies - MPEG-H FDK
+Am Wolfsmantel 33
+91058 Erlangen, Germany
+www.iis.fraunhofer.de/amm
+amm-info@iis.fraunhofer.de
+-----------------------------------------------------------------------------*/
+
+/*!
+ * @file testutils.h
+ *
+ * @brief Builders for the bitstreams used by the unit tests.
+ */
+
+#pragma once
+
+// System includes
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// External includes
+#include "ilo/common_types.h"
+
+// Internal includes
+#include "mmtaudioparser/mhasparser.h"
+
+namespace mmt {
+namespace audioparser {
+namespace test {
+//! usacElementType values of ISO/IEC 23008-3 table 19.
+enum EElementType : uint32_t { ID_USAC_SCE = 0, ID_USAC_CPE = 1, ID_USAC_LFE = 2, ID_USAC_EXT = 3 };
+
+//! One signal group of the signals3d() structure, only channel groups may carry a layout.
+struct SSignalGroupSpec {
+  uint32_t signalGroupType = 0;
+  uint32_t numSignals = 2;
+};
+
+//! One element of the mpegh3daDecoderConfig() structure, using the default core config.
+struct SElementSpec {
+  uint32_t usacElementType = ID_USAC_CPE;
+  //! Extension elements only.
+  uint32_t extElementType = 0;
+  ilo::ByteBuffer extElementConfig;
+};
+
+//! One entry of the mpegh3daConfigExtension() structure.
+struct SConfigExtensionSpec {
+  uint32_t usacConfigExtType = 0;
+  ilo::ByteBuffer payload;
+};
+
+//! Description of an mpegh3daConfig() structure, a stereo config by default.
+struct SConfigSpec {
+  uint8_t profileLevelIndicator = 0x0D;
+  //! 48 kHz
+  uint32_t samplingFrequencyIndex = 3;
+  //! 1024 samples per frame without SBR
+  uint32_t coreSbrFrameLengthIndex = 1;
+  uint32_t referenceLayoutCicpIdx = 2;
+  std::vector<SSignalGroupSpec> signalGroups = {SSignalGroupSpec{}};
+  bool elementLengthPresent = false;
+  std::vector<SElementSpec> elements = {SElementSpec{}};
+  std::vector<SConfigExtensionSpec> configExtensions;
+};
+
+//! @returns the mpegh3daConfig() structure described by spec, padded to full bytes.
+ilo::ByteBuffer buildConfig(const SConfigSpec& spec = SConfigSpec{});
+
+//! Appends an mpeghAudioStreamPacket() structure to stream.
+void appendMhasPacket(ilo::ByteBuffer& stream, EMhasPacketType packetType, uint32_t packetLabel,
+                      const ilo::ByteBuffer& payload);
+
+//! Appends a PACTYP_SYNC packet to stream.
+void appendSyncPacket(ilo::ByteBuffer& stream);
+
+//! One element of an mpegh3daFrame() structure of a config with elementLengthPresent.
+struct SFrameElementSpec {
+  //! Audio elements carry payloadBits bits of the fill pattern.
+  uint32_t payloadBits = 0;
+  uint8_t fill = 0;
+  //! Extension elements carry the payload, an empty one is not present.
+  bool extElement = false;
+  ilo::ByteBuffer extPayload;
+};
+
+//! @returns the mpegh3daFrame() structure with the given elements, padded to full bytes.
+ilo::ByteBuffer buildFrame(bool usacIndependencyFlag,
+                           const std::vector<SFrameElementSpec>& elements);
+
+//! @returns the AudioPreRoll() payload embedding the given config and access units.
+ilo::ByteBuffer buildAudioPreRoll(const ilo::ByteBuffer& config,
+                                  const std::vector<ilo::ByteBuffer>& accessUnits,
+                                  bool applyCrossfade = false);
+
+/*!
+ * @brief Lets every allocation of the current thread fail with std::bad_alloc during its lifetime.
+ *
+ * The test executable replaces the global operator new to this end.
+ */
+class CFailAllocations {
+ public:
+  CFailAllocations() noexcept;
+  ~CFailAllocations();
+
+  CFailAllocations(const CFailAllocations&) = delete;
+  CFailAllocations& operator=(const CFailAllocations&) = delete;
+};
+
+/*!
+ * @returns the payload of an independent (or dependent) PACTYP_MPEGH3DAFRAME packet. Only the
+ * usacIndependencyFlag is meaningful.
+ */
+ilo::ByteBuffer buildDummyFrame(bool independent, size_t size = 8);
+}  // namespace test
+}  // namespace audioparser
+}  // namespace mmt